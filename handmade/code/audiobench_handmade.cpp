@@ -0,0 +1,552 @@
+/*
+	NOTE: Headless audio benchmark
+
+	Drives the game's mixer directly, with no platform sound output.
+
+	audiobench_handmade [-seconds N] [-frame N] [-wav file.wav]
+
+	The first table is what one second of 48kHz stereo output costs at 1, 64 and 512 simultaneous
+	voices. Output is pulled in frame sized pieces (800 samples, one 60Hz frame, by default) the way
+	the platform layers ask for it. The voices loop test tones of odd lengths with spread pans, and
+	every fourth one keeps fading between two volumes, so loop wraps and fade ends split spans the
+	way they would in the game.
+
+	The second pair of tables is the resampler. Quality is THD+N of a looped sine, everything in the
+	output that isn't the tone relative to the tone, for a 44.1kHz sound played at 48kHz and for a
+	48kHz one pitched down and up, in each mode. A 1:1 row gives the floor the int16 source and
+	output quantization set on their own. Cost is the same 64 voice mix as the first table with
+	every voice resampled, per voice per output sample.
+
+	The last table streams a WAV, by default a 10 minute stereo track written to the current
+	directory first and removed afterwards. It reads every chunk in order to get decode throughput and
+	per chunk fetch latency, then plays the whole track through the mixer to see what the fetches
+	do to individual frames. The file was just written or read, so these are warm page cache
+	numbers, not disk numbers.
+*/
+
+#if _WIN32
+#define _CRT_SECURE_NO_WARNINGS
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "handmade.cpp"
+#include "handmade_frame_pacer.h"
+
+#define AUDIOBENCH_SAMPLES_PER_SECOND 48000
+#define AUDIOBENCH_TONE_COUNT 8
+#define AUDIOBENCH_STREAM_SECONDS 600
+
+//
+// NOTE: Platform bits
+//
+
+PLATFORM_OPEN_FILE(AudioBenchOpenFile)
+{
+	platform_file_handle Result = {};
+#if _WIN32
+	HANDLE FileHandle = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+	Result.NoErrors = (FileHandle != INVALID_HANDLE_VALUE);
+	Result.Platform = FileHandle;
+#else
+	int FileHandle = open(Filename, O_RDONLY);
+	Result.NoErrors = (FileHandle >= 0);
+	Result.Platform = (void *)(intptr_t)FileHandle;
+#endif
+	return Result;
+}
+
+PLATFORM_READ_DATA_FROM_FILE(AudioBenchReadDataFromFile)
+{
+	uint64 Result = 0;
+	if(Handle->NoErrors)
+	{
+#if _WIN32
+		OVERLAPPED Overlapped = {};
+		Overlapped.Offset = (uint32)(Offset & 0xFFFFFFFF);
+		Overlapped.OffsetHigh = (uint32)(Offset >> 32);
+		DWORD BytesRead;
+		if(ReadFile((HANDLE)Handle->Platform, Dest, SafeTruncateUInt64(Size), &BytesRead, &Overlapped))
+		{
+			Result = BytesRead;
+		}
+#else
+		while(Result < Size)
+		{
+			ssize_t ReadCount = pread((int)(intptr_t)Handle->Platform, (uint8 *)Dest + Result, Size - Result, (off_t)(Offset + Result));
+			if(ReadCount <= 0)
+			{
+				break;
+			}
+			Result += (uint64)ReadCount;
+		}
+#endif
+	}
+
+	return Result;
+}
+
+PLATFORM_CLOSE_FILE(AudioBenchCloseFile)
+{
+#if _WIN32
+	CloseHandle((HANDLE)Handle->Platform);
+#else
+	close((int)(intptr_t)Handle->Platform);
+#endif
+	Handle->NoErrors = false;
+}
+
+internal int AudioBenchCompareU64(const void *A, const void *B)
+{
+	uint64 ValueA = *(uint64 *)A;
+	uint64 ValueB = *(uint64 *)B;
+	int Result = (ValueA < ValueB) ? -1 : ((ValueA > ValueB) ? 1 : 0);
+	return Result;
+}
+
+// NOTE: Sorts Values in place
+internal uint64 AudioBenchPercentile(uint64 *Values, uint32 Count, uint32 Percent)
+{
+	qsort(Values, Count, sizeof(uint64), AudioBenchCompareU64);
+	uint32 Index = Minimum((Count*Percent) / 100, Count - 1);
+	uint64 Result = Values[Index];
+	return Result;
+}
+
+// NOTE: A tone on each side, written in 1MB pieces so the whole track never sits in memory here either
+internal bool32 AudioBenchWriteWAV(char *Filename, uint32 Seconds)
+{
+	bool32 Result = false;
+	FILE *File = fopen(Filename, "wb");
+	if(File)
+	{
+		uint32 SampleCount = Seconds*AUDIOBENCH_SAMPLES_PER_SECOND;
+		uint32 FrameSize = 2*(uint32)sizeof(int16);
+		uint32 DataSize = SampleCount*FrameSize;
+
+		wave_header Header = {WAVE_ChunkID_RIFF, 4 + 2*(uint32)sizeof(wave_chunk) + (uint32)sizeof(wave_fmt) + DataSize, WAVE_ChunkID_WAVE};
+		wave_chunk FormatChunk = {WAVE_ChunkID_fmt, (uint32)sizeof(wave_fmt)};
+		wave_fmt Format = {1, 2, AUDIOBENCH_SAMPLES_PER_SECOND, AUDIOBENCH_SAMPLES_PER_SECOND*FrameSize, (uint16)FrameSize, 16};
+		wave_chunk DataChunk = {WAVE_ChunkID_data, DataSize};
+		fwrite(&Header, sizeof(Header), 1, File);
+		fwrite(&FormatChunk, sizeof(FormatChunk), 1, File);
+		fwrite(&Format, sizeof(Format), 1, File);
+		fwrite(&DataChunk, sizeof(DataChunk), 1, File);
+
+		uint32 BlockSampleCount = Megabytes(1) / FrameSize;
+		int16 *Block = (int16 *)malloc(Megabytes(1));
+		real32 tLeft = 0.0f;
+		real32 tRight = 0.0f;
+		real32 dtLeft = 2.0f*PI*220.0f / (real32)AUDIOBENCH_SAMPLES_PER_SECOND;
+		real32 dtRight = 2.0f*PI*330.0f / (real32)AUDIOBENCH_SAMPLES_PER_SECOND;
+		Result = true;
+		for(uint32 SamplesDone = 0; SamplesDone < SampleCount; SamplesDone += BlockSampleCount)
+		{
+			uint32 Count = Minimum(BlockSampleCount, SampleCount - SamplesDone);
+			for(uint32 SampleIndex = 0; SampleIndex < Count; ++SampleIndex)
+			{
+				Block[2*SampleIndex + 0] = (int16)(8000.0f*Sin(tLeft));
+				Block[2*SampleIndex + 1] = (int16)(8000.0f*Sin(tRight));
+				tLeft += dtLeft;
+				tRight += dtRight;
+				if(tLeft > 2.0f*PI) tLeft -= 2.0f*PI;
+				if(tRight > 2.0f*PI) tRight -= 2.0f*PI;
+			}
+			if(fwrite(Block, FrameSize, Count, File) != Count)
+			{
+				Result = false;
+				break;
+			}
+		}
+		free(Block);
+		fclose(File);
+	}
+
+	return Result;
+}
+
+//
+// NOTE: Benchmarks
+//
+
+internal void AudioBenchMixer(memory_arena *Arena, uint32 Seconds, uint32 FrameSampleCount)
+{
+	loaded_sound Tones[AUDIOBENCH_TONE_COUNT];
+	for(uint32 ToneIndex = 0; ToneIndex < AUDIOBENCH_TONE_COUNT; ++ToneIndex)
+	{
+		// NOTE: Lengths that aren't multiples of four, so loop wraps land mid chunk
+		real32 ToneSeconds = 0.25f + 0.1371f*(real32)ToneIndex;
+		Tones[ToneIndex] = DEBUGMakeTestTone(Arena, AUDIOBENCH_SAMPLES_PER_SECOND, 220.0f + 55.0f*(real32)ToneIndex, ToneSeconds);
+	}
+
+	game_sound_output_buffer SoundBuffer = {};
+	SoundBuffer.SamplesPerSecond = AUDIOBENCH_SAMPLES_PER_SECOND;
+	int16 *Samples = PushArray(Arena, 2*FrameSampleCount, int16);
+
+	printf("voices,seconds,ms_per_second,cpu_percent,ns_per_voice_sample,cycles_per_voice_sample,peak\n");
+
+	uint32 VoiceCounts[] = {1, 64, 512};
+	for(uint32 CountIndex = 0; CountIndex < ArrayCount(VoiceCounts); ++CountIndex)
+	{
+		uint32 VoiceCount = VoiceCounts[CountIndex];
+		temporary_memory RunMemory = BeginTemporaryMemory(Arena);
+
+		audio_state Audio;
+		InitializeAudioState(&Audio, Arena, VoiceCount);
+		sound_handle *Handles = PushArray(Arena, VoiceCount, sound_handle);
+		real32 Gain = 1.0f / SquareRoot((real32)VoiceCount);
+		for(uint32 VoiceIndex = 0; VoiceIndex < VoiceCount; ++VoiceIndex)
+		{
+			real32 Pan = (VoiceCount > 1) ? (-1.0f + 2.0f*(real32)VoiceIndex / (real32)(VoiceCount - 1)) : 0.0f;
+			Handles[VoiceIndex] = StartSound(&Audio, &Tones[VoiceIndex % AUDIOBENCH_TONE_COUNT],
+											 PannedVolume(Gain, Pan), true);
+		}
+
+		uint32 TotalSamples = Seconds*AUDIOBENCH_SAMPLES_PER_SECOND;
+		uint32 FrameIndex = 0;
+		int32 Peak = 0;
+		uint64 StartTime = FramePacerGetClock();
+		uint64 StartCycles = __rdtsc();
+		for(uint32 SamplesDone = 0; SamplesDone < TotalSamples; SamplesDone += FrameSampleCount, ++FrameIndex)
+		{
+			for(uint32 VoiceIndex = 0; VoiceIndex < VoiceCount; VoiceIndex += 4)
+			{
+				if(((FrameIndex + VoiceIndex) % 15) == 0)
+				{
+					real32 Volume = (FrameIndex & 16) ? 0.25f*Gain : Gain;
+					ChangeVolume(&Audio, Handles[VoiceIndex], 0.2f, V2(Volume, Volume));
+				}
+			}
+
+			SoundBuffer.SampleCount = (int)Minimum(FrameSampleCount, TotalSamples - SamplesDone);
+			SoundBuffer.Samples = Samples;
+			OutputPlayingSounds(&Audio, &SoundBuffer, Arena);
+
+			// NOTE: Cheap enough next to the mix, and keeps the output from being optimized away
+			for(int SampleIndex = 0; SampleIndex < 2*SoundBuffer.SampleCount; ++SampleIndex)
+			{
+				int32 Magnitude = Samples[SampleIndex] < 0 ? -Samples[SampleIndex] : Samples[SampleIndex];
+				Peak = Maximum(Peak, Magnitude);
+			}
+		}
+		uint64 Cycles = __rdtsc() - StartCycles;
+		uint64 Nanoseconds = FramePacerGetClock() - StartTime;
+
+		real64 VoiceSamples = (real64)VoiceCount*(real64)TotalSamples;
+		real64 MSPerSecond = ((real64)Nanoseconds / 1000000.0) / (real64)Seconds;
+		printf("%u,%u,%.3f,%.2f,%.3f,%.2f,%d\n", VoiceCount, Seconds, MSPerSecond, MSPerSecond / 10.0,
+			   (real64)Nanoseconds / VoiceSamples, (real64)Cycles / VoiceSamples, Peak);
+
+		EndTemporaryMemory(RunMemory);
+	}
+}
+
+// NOTE: One second of a mono sine, a whole number of cycles so it loops without a seam
+internal loaded_sound AudioBenchMakeSine(memory_arena *Arena, uint32 SamplesPerSecond, uint32 ToneHz)
+{
+	loaded_sound Result = {};
+	Result.SampleCount = SamplesPerSecond;
+	Result.ChannelCount = 1;
+	Result.SamplesPerSecond = SamplesPerSecond;
+	Result.Samples[0] = PushArray(Arena, Result.SampleCount, int16);
+	for(uint32 SampleIndex = 0; SampleIndex < Result.SampleCount; ++SampleIndex)
+	{
+		real64 Angle = 2.0*3.14159265358979*(real64)ToneHz*(real64)SampleIndex / (real64)SamplesPerSecond;
+		Result.Samples[0][SampleIndex] = (int16)floor(16384.0*sin(Angle) + 0.5);
+	}
+
+	return Result;
+}
+
+// NOTE: Fits the tone out of the left channel by projecting onto it, which is exact when Count
+// covers a whole number of its cycles, and returns what's left over against it in dB
+internal real64 AudioBenchTHDN(int16 *Samples, uint32 Count, real64 ToneHz, real64 SamplesPerSecond)
+{
+	real64 Omega = 2.0*3.14159265358979*ToneHz / SamplesPerSecond;
+	real64 Mean = 0.0;
+	real64 CosSum = 0.0;
+	real64 SinSum = 0.0;
+	for(uint32 SampleIndex = 0; SampleIndex < Count; ++SampleIndex)
+	{
+		real64 Value = (real64)Samples[2*SampleIndex];
+		Mean += Value;
+		CosSum += Value*cos(Omega*(real64)SampleIndex);
+		SinSum += Value*sin(Omega*(real64)SampleIndex);
+	}
+	Mean /= (real64)Count;
+	real64 A = 2.0*CosSum / (real64)Count;
+	real64 B = 2.0*SinSum / (real64)Count;
+
+	real64 ToneEnergy = 0.0;
+	real64 ResidualEnergy = 0.0;
+	for(uint32 SampleIndex = 0; SampleIndex < Count; ++SampleIndex)
+	{
+		real64 Tone = A*cos(Omega*(real64)SampleIndex) + B*sin(Omega*(real64)SampleIndex);
+		real64 Residual = (real64)Samples[2*SampleIndex] - Mean - Tone;
+		ToneEnergy += Tone*Tone;
+		ResidualEnergy += Residual*Residual;
+	}
+
+	real64 Result = 10.0*log10(ResidualEnergy / ToneEnergy);
+	return Result;
+}
+
+internal void AudioBenchResampler(memory_arena *Arena, uint32 Seconds, uint32 FrameSampleCount)
+{
+	char *ModeNames[] = {"sinc", "linear"};
+	resample_mode Modes[] = {ResampleMode_Sinc, ResampleMode_Linear};
+
+	struct resample_case
+	{
+		char *Name;
+		uint32 SoundSamplesPerSecond;
+		real32 Pitch;
+	};
+	resample_case Cases[] =
+	{
+		{"1:1", 48000, 1.0f},
+		{"44100_to_48000", 44100, 1.0f},
+		{"pitch_0.75", 48000, 0.75f},
+		{"pitch_1.5", 48000, 1.5f},
+	};
+	uint32 ToneHz[] = {1000, 10000};
+
+	// NOTE: A tenth of a second of output first, then one second measured
+	uint32 SkipSamples = AUDIOBENCH_SAMPLES_PER_SECOND / 10;
+	uint32 MeasureSamples = AUDIOBENCH_SAMPLES_PER_SECOND;
+	uint32 TotalSamples = SkipSamples + MeasureSamples;
+
+	printf("\nresample,case,tone_hz,thd_n_db\n");
+	for(uint32 ModeIndex = 0; ModeIndex < ArrayCount(Modes); ++ModeIndex)
+	{
+		for(uint32 CaseIndex = 0; CaseIndex < ArrayCount(Cases); ++CaseIndex)
+		{
+			resample_case *Case = Cases + CaseIndex;
+			for(uint32 ToneIndex = 0; ToneIndex < ArrayCount(ToneHz); ++ToneIndex)
+			{
+				temporary_memory RunMemory = BeginTemporaryMemory(Arena);
+
+				loaded_sound Sound = AudioBenchMakeSine(Arena, Case->SoundSamplesPerSecond, ToneHz[ToneIndex]);
+				audio_state Audio;
+				InitializeAudioState(&Audio, Arena, 1);
+				Audio.ResampleMode = Modes[ModeIndex];
+				sound_handle Handle = StartSound(&Audio, &Sound, V2(1.0f, 1.0f), true);
+				ChangePitch(&Audio, Handle, Case->Pitch);
+
+				int16 *Output = PushArray(Arena, 2*TotalSamples, int16);
+				game_sound_output_buffer SoundBuffer = {};
+				SoundBuffer.SamplesPerSecond = AUDIOBENCH_SAMPLES_PER_SECOND;
+				for(uint32 SamplesDone = 0; SamplesDone < TotalSamples; SamplesDone += FrameSampleCount)
+				{
+					SoundBuffer.SampleCount = (int)Minimum(FrameSampleCount, TotalSamples - SamplesDone);
+					SoundBuffer.Samples = Output + 2*SamplesDone;
+					OutputPlayingSounds(&Audio, &SoundBuffer, Arena);
+				}
+
+				real64 OutputToneHz = (real64)ToneHz[ToneIndex]*(real64)Case->Pitch;
+				real64 THDN = AudioBenchTHDN(Output + 2*SkipSamples, MeasureSamples, OutputToneHz, AUDIOBENCH_SAMPLES_PER_SECOND);
+				printf("%s,%s,%u,%.1f\n", ModeNames[ModeIndex], Case->Name, ToneHz[ToneIndex], THDN);
+
+				EndTemporaryMemory(RunMemory);
+			}
+		}
+	}
+
+	printf("\nresample,voices,seconds,ms_per_second,ns_per_voice_sample,cycles_per_voice_sample\n");
+	uint32 VoiceCount = 64;
+	for(uint32 ModeIndex = 0; ModeIndex <= ArrayCount(Modes); ++ModeIndex)
+	{
+		temporary_memory RunMemory = BeginTemporaryMemory(Arena);
+
+		// NOTE: The extra pass is the same voices at 1:1, for reference
+		bool32 Direct = (ModeIndex == ArrayCount(Modes));
+		loaded_sound Sound = AudioBenchMakeSine(Arena, Direct ? AUDIOBENCH_SAMPLES_PER_SECOND : 44100, 1000);
+		audio_state Audio;
+		InitializeAudioState(&Audio, Arena, VoiceCount);
+		Audio.ResampleMode = Direct ? ResampleMode_Sinc : Modes[ModeIndex];
+		real32 Gain = 1.0f / SquareRoot((real32)VoiceCount);
+		for(uint32 VoiceIndex = 0; VoiceIndex < VoiceCount; ++VoiceIndex)
+		{
+			real32 Pan = -1.0f + 2.0f*(real32)VoiceIndex / (real32)(VoiceCount - 1);
+			sound_handle Handle = StartSound(&Audio, &Sound, PannedVolume(Gain, Pan), true);
+			if(!Direct)
+			{
+				ChangePitch(&Audio, Handle, 0.5f + (real32)VoiceIndex / (real32)VoiceCount);
+			}
+		}
+
+		game_sound_output_buffer SoundBuffer = {};
+		SoundBuffer.SamplesPerSecond = AUDIOBENCH_SAMPLES_PER_SECOND;
+		int16 *Samples = PushArray(Arena, 2*FrameSampleCount, int16);
+		uint32 RunSamples = Seconds*AUDIOBENCH_SAMPLES_PER_SECOND;
+		uint64 StartTime = FramePacerGetClock();
+		uint64 StartCycles = __rdtsc();
+		for(uint32 SamplesDone = 0; SamplesDone < RunSamples; SamplesDone += FrameSampleCount)
+		{
+			SoundBuffer.SampleCount = (int)Minimum(FrameSampleCount, RunSamples - SamplesDone);
+			SoundBuffer.Samples = Samples;
+			OutputPlayingSounds(&Audio, &SoundBuffer, Arena);
+		}
+		uint64 Cycles = __rdtsc() - StartCycles;
+		uint64 Nanoseconds = FramePacerGetClock() - StartTime;
+
+		real64 VoiceSamples = (real64)VoiceCount*(real64)RunSamples;
+		printf("%s,%u,%u,%.3f,%.3f,%.2f\n", Direct ? "none" : ModeNames[ModeIndex], VoiceCount, Seconds,
+			   ((real64)Nanoseconds / 1000000.0) / (real64)Seconds, (real64)Nanoseconds / VoiceSamples,
+			   (real64)Cycles / VoiceSamples);
+
+		EndTemporaryMemory(RunMemory);
+	}
+}
+
+internal bool32 AudioBenchStream(memory_arena *Arena, char *Filename, uint32 FrameSampleCount)
+{
+	game_memory Memory = {};
+	Memory.PlatformOpenFile = AudioBenchOpenFile;
+	Memory.PlatformReadDataFromFile = AudioBenchReadDataFromFile;
+	Memory.PlatformCloseFile = AudioBenchCloseFile;
+
+	audio_state Audio;
+	InitializeAudioState(&Audio, Arena, 1);
+	BindAudioPlatform(&Audio, &Memory);
+
+	// NOTE: Sequential fetch of every chunk, which is all decoding amounts to for PCM
+	memory_index UsedBeforeOpen = Arena->Used;
+	uint64 OpenStart = FramePacerGetClock();
+	loaded_sound Sound = OpenSoundStream(&Memory, Arena, Filename);
+	uint64 OpenNanoseconds = FramePacerGetClock() - OpenStart;
+	memory_index ResidentBytes = Arena->Used - UsedBeforeOpen;
+	if(!Sound.SampleCount)
+	{
+		fprintf(stderr, "%s: not a 16 bit PCM WAV\n", Filename);
+		return false;
+	}
+
+	uint32 ChunkCount = (Sound.SampleCount + SOUND_STREAM_CHUNK_SAMPLES - 1) / SOUND_STREAM_CHUNK_SAMPLES;
+	uint64 *FetchTimes = (uint64 *)malloc(ChunkCount*sizeof(uint64));
+	uint64 FetchStart = FramePacerGetClock();
+	for(uint32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+	{
+		uint64 Start = FramePacerGetClock();
+		FetchSoundStreamChunk(&Audio, &Sound, ChunkIndex*SOUND_STREAM_CHUNK_SAMPLES);
+		FetchTimes[ChunkIndex] = FramePacerGetClock() - Start;
+	}
+	uint64 FetchNanoseconds = FramePacerGetClock() - FetchStart;
+	uint64 BytesRead = Sound.Stream->BytesRead;
+	uint32 ShortReads = Sound.Stream->ShortReadCount;
+	uint64 FetchP50 = AudioBenchPercentile(FetchTimes, ChunkCount, 50);
+	uint64 FetchP99 = AudioBenchPercentile(FetchTimes, ChunkCount, 99);
+	uint64 FetchMax = FetchTimes[ChunkCount - 1];
+	CloseSoundStream(&Memory, &Sound);
+
+	// NOTE: The same track played through the mixer from a fresh stream
+	Sound = OpenSoundStream(&Memory, Arena, Filename);
+	StartSound(&Audio, &Sound, V2(1.0f, 1.0f), false);
+
+	game_sound_output_buffer SoundBuffer = {};
+	SoundBuffer.SamplesPerSecond = AUDIOBENCH_SAMPLES_PER_SECOND;
+	SoundBuffer.Samples = PushArray(Arena, 2*FrameSampleCount, int16);
+	uint32 FrameCount = (Sound.SampleCount + FrameSampleCount - 1) / FrameSampleCount;
+	uint64 *FrameTimes = (uint64 *)malloc(FrameCount*sizeof(uint64));
+	for(uint32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+	{
+		SoundBuffer.SampleCount = (int)FrameSampleCount;
+		uint64 Start = FramePacerGetClock();
+		OutputPlayingSounds(&Audio, &SoundBuffer, Arena);
+		FrameTimes[FrameIndex] = FramePacerGetClock() - Start;
+	}
+	uint64 FrameP50 = AudioBenchPercentile(FrameTimes, FrameCount, 50);
+	uint64 FrameP99 = AudioBenchPercentile(FrameTimes, FrameCount, 99);
+	uint64 FrameMax = FrameTimes[FrameCount - 1];
+	CloseSoundStream(&Memory, &Sound);
+
+	real64 TrackSeconds = (real64)Sound.SampleCount / (real64)Sound.SamplesPerSecond;
+	real64 FetchSeconds = (real64)FetchNanoseconds / 1e9;
+	printf("\nstream_seconds,file_mb,resident_kb,open_us,chunks,short_reads,decode_mb_per_s,realtime_x,"
+		   "fetch_p50_us,fetch_p99_us,fetch_max_us,mix_frame_p50_us,mix_frame_p99_us,mix_frame_max_us\n");
+	printf("%.1f,%.1f,%.1f,%.1f,%u,%u,%.0f,%.0f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+		   TrackSeconds, (real64)BytesRead / (1024.0*1024.0), (real64)ResidentBytes / 1024.0, (real64)OpenNanoseconds / 1000.0,
+		   ChunkCount, ShortReads, ((real64)BytesRead / (1024.0*1024.0)) / FetchSeconds, TrackSeconds / FetchSeconds,
+		   FetchP50 / 1000.0, FetchP99 / 1000.0, FetchMax / 1000.0,
+		   FrameP50 / 1000.0, FrameP99 / 1000.0, FrameMax / 1000.0);
+
+	free(FetchTimes);
+	free(FrameTimes);
+
+	return true;
+}
+
+int main(int ArgCount, char **Args)
+{
+	uint32 Seconds = 10;
+	uint32 FrameSampleCount = 800;
+	char *WAVFilename = 0;
+	for(int ArgIndex = 1; ArgIndex < ArgCount; ArgIndex++)
+	{
+		char *Arg = Args[ArgIndex];
+		if((strcmp(Arg, "-seconds") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			Seconds = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-frame") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			FrameSampleCount = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-wav") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			WAVFilename = Args[++ArgIndex];
+		}
+		else
+		{
+			Seconds = 0;
+			break;
+		}
+	}
+	if((Seconds < 1) || (FrameSampleCount < 1))
+	{
+		fprintf(stderr, "usage: %s [-seconds N] [-frame N] [-wav file.wav]\n", Args[0]);
+		return 2;
+	}
+
+	memory_arena Arena;
+	memory_index ArenaSize = Megabytes(64);
+	InitializeArena(&Arena, ArenaSize, (uint8 *)malloc(ArenaSize), "Bench");
+
+	AudioBenchMixer(&Arena, Seconds, FrameSampleCount);
+	AudioBenchResampler(&Arena, Seconds, FrameSampleCount);
+
+	int Result = 0;
+	char *GeneratedFilename = "audiobench_stream.wav";
+	if(!WAVFilename)
+	{
+		if(AudioBenchWriteWAV(GeneratedFilename, AUDIOBENCH_STREAM_SECONDS))
+		{
+			WAVFilename = GeneratedFilename;
+		}
+		else
+		{
+			fprintf(stderr, "could not write %s\n", GeneratedFilename);
+			Result = 1;
+		}
+	}
+	if(WAVFilename)
+	{
+		if(!AudioBenchStream(&Arena, WAVFilename, FrameSampleCount))
+		{
+			Result = 1;
+		}
+		if(WAVFilename == GeneratedFilename)
+		{
+			remove(GeneratedFilename);
+		}
+	}
+
+	return Result;
+}
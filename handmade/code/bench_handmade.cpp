@@ -0,0 +1,1814 @@
+/*
+	NOTE: Headless frame benchmark over canned scenes
+
+	Each scene starts from fresh game memory, lets the game initialize and spawn a player the way
+	pressing Start would, sets the scene up on top of that, and then runs GameUpdateAndRender into
+	an offscreen buffer for a fixed number of frames after a short warmup.
+
+	bench_handmade [-frames N] [-scene name] [-baseline results.csv] [-threshold percent] [-hugepages]
+	bench_handmade -worldgen
+	bench_handmade -checkworld
+	bench_handmade -tilescan
+	bench_handmade -dirtypages
+
+	empty_room       the player standing in the first room
+	rooms_100        the 100 room path world generated up front, with the player walking through it
+	entities_1k      1000 wandering entities spread over the 36 screens up and right of the player
+	entities_10k     the same with 10000
+	sprite_overdraw  64 heroes and the player packed onto the screen, all of them drawn
+	offscreen_10k    10000 entities standing where the camera never looks, half of them a level up,
+	                 so drawing them is all culling
+	levels_1         scrolling on the top level of a four level world, drawing only that level
+	levels_2         the same drawing the level below it faded underneath
+	levels_4         the same drawing all four
+	scrolling        the player carried through the lazy room grid at a steady speed, walls and
+	                 all, so the camera never stops scrolling
+	world_large      the whole 128 by 128 chunk room grid generated up front, both levels, with the
+	                 player carried across it
+
+	Results go to stdout as scene,metric,value lines: the median, p99 and mean frame in
+	milliseconds, the peak megabytes of each game arena and the tile chunks holding storage at the
+	end, how many entities the last frame drew and culled, how many tile layer pixels got drawn
+	per frame and how often the whole layer was redrawn (tile_layer_kpixels_per_frame and
+	tile_layer_full_redraws, a still camera draws none), and in a HANDMADE_PROFILE build the
+	milliseconds per frame of each block directly under GameUpdateAndRender. A summary goes to
+	stderr.
+
+	Every scene also reports what the tile map costs to keep and to read. tile_chunk_bytes is the
+	average over all the chunks that exist, the chunk header included, against the 1024 bytes a
+	16 by 16 chunk of uint32 tiles took before chunks were palettized. tile_loop_us is one pass of
+	the render loop's tile lookups over the screen at the camera, every visible level, without the
+	drawing, and tile_draw_us the whole uncached tile layer drawn the same way, each the median of
+	BENCH_TILE_LOOP_PASSES in microseconds. On Linux both come with l1d_misses and llc_misses per pass when the
+	counters can be read.
+
+	-hugepages puts game memory and the framebuffer on 2MB pages (handmade_large_pages.h), the
+	bitmaps included since they are loaded into game memory. On Linux every scene also reports
+	dtlb_misses_per_frame if the CPU's counters can be read, and huge_pages_mb, how much of the
+	process the kernel had on transparent huge pages at the end. A run without -hugepages kept as
+	the baseline for a run with it shows what they buy scene by scene.
+
+	Redirect a run into a file to keep it as a baseline. With -baseline, every scene's median is
+	checked against the same scene in that file and the exit code is 1 if any got slower by more
+	than -threshold percent (10 by default). Only the median decides, p99 moves too much from run
+	to run to fail on. Baselines only mean something on the machine they were taken on.
+	bench_handmade_baseline.csv next to this file is a reference run of every scene at the default
+	frame count, built by misc/build.sh and run on a single core Xeon VM where the medians move by
+	up to a third from run to run. It shows roughly what each scene costs, and whether a change
+	moved one by a lot; for a threshold worth failing on, take a baseline on your own machine.
+
+	The game loads its bitmaps from test/ under the working directory, so the scenes run from
+	handmade/data. If any bitmap fails to load the bench stops with exit code 2 rather than time
+	scenes that draw nothing.
+
+	Like the replay runner, the game is linked in directly and gets no work queues, so everything
+	runs on one thread.
+
+	-worldgen times the room path generation instead, GenerateWorld alone in fresh arenas, for
+	100, 10k and 1M rooms on 1, 4 and 16 threads (the bench's own work queue, this thread helping
+	out). Each room count reports the best time per thread count as threads_N_ms, along with the
+	chunks in the map, the chunks the rooms filled and the rooms that didn't fit in the map. The
+	planned path climbs diagonally, so a dense chunk table only covers about the first 10k rooms
+	and at 1M almost every room falls outside it. Most of that case's time is the planner and the
+	rooms it drops, not chunk fills, so every thread count also reports the rooms that did fit
+	per second as threads_N_placed_rooms_per_s; compare that across room counts, not the raw ms.
+	Generation is meant to come out the same on any number of threads, so the whole tile map is
+	hashed after every run and the exit code is 1 if any two thread counts disagree.
+
+	-checkworld generates the four level room grid both ways, eagerly up front on this thread and
+	lazily with four threads racing to generate the same chunks in different orders, then compares
+	the two tile by tile over every chunk. The exit code is 1 if a single tile differs.
+
+	-tilescan compares tile lookups with the chunk size fixed at compile time against the runtime
+	sized lookups they replaced, which the bench keeps a copy of, over the eagerly generated two
+	level room grid. full_scan reads every tile of the map in rows, window_scan reads 40 by 20
+	tile windows at random places like the render loop does, and collision replays the tiles
+	MovePlayer swept over BENCH_COLLISION_STEPS steps of a player wandering the grid, each in
+	nanoseconds per tile or per step, the best of BENCH_TILE_SCAN_RUNS interleaved runs.
+	moveplayer_ns_per_step is the whole of MovePlayer for those steps. Both lookups have to read
+	the same values, the exit code is 1 if they don't.
+
+	-dirtypages times restoring a 64MB, 1GB and 4GB block from a snapshot after writes to 1% of its
+	pages, a full copy against copying only the pages handmade_dirty_pages.h saw written, along with
+	what the tracking adds to the writes themselves (a fault per page on Linux). keyframe_compress_ms
+	and keyframe_shadow_copy_ms are the same writes over a block of zeroes seen by a recording
+	keyframe, compressing the whole block on the spot against copying the dirty pages into a shadow
+	for a thread of its own to compress. Sizes that don't fit in the memory available are skipped.
+	The exit code is 1 if the dirty copy missed a write.
+*/
+
+#if _WIN32
+#define _CRT_SECURE_NO_WARNINGS
+#include <windows.h>
+#else
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "handmade.cpp"
+#include "handmade_frame_pacer.h"
+#include "handmade_profiler.h"
+#include "handmade_large_pages.h"
+#include "handmade_dirty_pages.h"
+#include "handmade_recording.h"
+
+#define BENCH_WARMUP_FRAMES 10
+#define BENCH_MAX_SCENE_RESULTS 48
+#define BENCH_TILE_LOOP_PASSES 31
+#define BENCH_WORLDGEN_RUNS 3
+#define BENCH_TILE_SCAN_RUNS 5
+#define BENCH_COLLISION_STEPS 200000
+#define BENCH_DIRTY_PAGE_RUNS 3
+
+enum bench_entity_placement
+{
+	// NOTE: Six screens square up and right of the player's
+	BenchPlacement_AroundPlayer,
+	// NOTE: On the screen the camera starts on
+	BenchPlacement_OnScreen,
+	// NOTE: Like AroundPlayer but starting two screens to the right, half of them on the level
+	// above, so none of them are ever on screen
+	BenchPlacement_OffScreen,
+};
+
+struct bench_scene
+{
+	char *Name;
+	world_generation_mode GenerationMode;
+	uint32 RoomCount;
+
+	uint32 EntityCount;
+	bool32 EntitiesWander;
+	bench_entity_placement EntityPlacement;
+
+	bool32 PlayerWalks;
+	// NOTE: Meters per second the player is moved at regardless of walls, see BenchCarryPlayer
+	real32 PlayerCarrySpeed;
+
+	// NOTE: Zero keeps the game's own. With WorldLevelCount the player starts on the top level.
+	uint32 WorldLevelCount;
+	uint32 VisibleLevelCount;
+};
+
+global_variable bench_scene BenchScenes[] =
+{
+	{"empty_room", WorldGeneration_RoomGridLazy, 0, 0, false, BenchPlacement_AroundPlayer, false, 0.0f, 0, 0},
+	{"rooms_100", WorldGeneration_RoomPath, 100, 0, false, BenchPlacement_AroundPlayer, true, 0.0f, 0, 0},
+	{"entities_1k", WorldGeneration_RoomGridLazy, 0, 1000, true, BenchPlacement_AroundPlayer, false, 0.0f, 0, 0},
+	{"entities_10k", WorldGeneration_RoomGridLazy, 0, 10000, true, BenchPlacement_AroundPlayer, false, 0.0f, 0, 0},
+	{"sprite_overdraw", WorldGeneration_RoomGridLazy, 0, 64, false, BenchPlacement_OnScreen, false, 0.0f, 0, 0},
+	{"scrolling", WorldGeneration_RoomGridLazy, 0, 0, false, BenchPlacement_AroundPlayer, false, 8.0f, 0, 0},
+	{"offscreen_10k", WorldGeneration_RoomGridLazy, 0, 10000, false, BenchPlacement_OffScreen, false, 0.0f, 0, 0},
+	{"levels_1", WorldGeneration_RoomGridLazy, 0, 0, false, BenchPlacement_AroundPlayer, false, 8.0f, 4, 1},
+	{"levels_2", WorldGeneration_RoomGridLazy, 0, 0, false, BenchPlacement_AroundPlayer, false, 8.0f, 4, 2},
+	{"levels_4", WorldGeneration_RoomGridLazy, 0, 0, false, BenchPlacement_AroundPlayer, false, 8.0f, 4, 4},
+	{"world_large", WorldGeneration_RoomGridEager, 0, 0, false, BenchPlacement_AroundPlayer, false, 8.0f, 0, 0},
+};
+
+struct bench_result
+{
+	char Name[64];
+	real64 Value;
+};
+
+struct bench_scene_results
+{
+	bool32 BitmapsMissing;
+	uint32 ResultCount;
+	bench_result Results[BENCH_MAX_SCENE_RESULTS];
+};
+
+//
+// NOTE: Platform bits
+//
+
+internal void *BenchAllocate(memory_index Size)
+{
+	void *Result = 0;
+#if _WIN32
+	Result = VirtualAlloc(0, Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	Result = mmap(0, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if(Result == MAP_FAILED)
+	{
+		Result = 0;
+	}
+#endif
+
+	return Result;
+}
+
+internal void BenchFree(void *Memory, memory_index Size)
+{
+#if _WIN32
+	VirtualFree(Memory, 0, MEM_RELEASE);
+#else
+	munmap(Memory, Size);
+#endif
+}
+
+/*
+	NOTE: Hardware cache event counts on this thread, every event the counter was opened with added
+	together. Invalid when none of them can be opened, which is the case under most hypervisors and
+	with perf_event_paranoid above 2.
+*/
+struct bench_perf_counter
+{
+	bool32 IsValid;
+#if !_WIN32
+	int Handles[2];
+#endif
+};
+
+#if !_WIN32
+#define BENCH_CACHE_MISS_EVENT(Cache, Op) ((Cache) | ((Op) << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+#endif
+
+internal bench_perf_counter BenchOpenPerfCounter(uint64 *Events, uint32 EventCount)
+{
+	bench_perf_counter Result = {};
+#if !_WIN32
+	for(uint32 EventIndex = 0; EventIndex < ArrayCount(Result.Handles); ++EventIndex)
+	{
+		Result.Handles[EventIndex] = -1;
+		if(EventIndex < EventCount)
+		{
+			struct perf_event_attr Attributes = {};
+			Attributes.type = PERF_TYPE_HW_CACHE;
+			Attributes.size = sizeof(Attributes);
+			Attributes.config = Events[EventIndex];
+			Attributes.exclude_kernel = 1;
+			Attributes.exclude_hv = 1;
+			Result.Handles[EventIndex] = (int)syscall(SYS_perf_event_open, &Attributes, 0, -1, -1, 0);
+			if(Result.Handles[EventIndex] >= 0)
+			{
+				Result.IsValid = true;
+			}
+		}
+	}
+#endif
+
+	return Result;
+}
+
+// NOTE: Data TLB misses, loads and stores added together where the CPU counts both
+internal bench_perf_counter BenchOpenTLBCounter(void)
+{
+#if !_WIN32
+	uint64 Events[] =
+	{
+		BENCH_CACHE_MISS_EVENT(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ),
+		BENCH_CACHE_MISS_EVENT(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_WRITE),
+	};
+	bench_perf_counter Result = BenchOpenPerfCounter(Events, ArrayCount(Events));
+#else
+	bench_perf_counter Result = BenchOpenPerfCounter(0, 0);
+#endif
+
+	return Result;
+}
+
+// NOTE: Load misses in the level 1 data cache, or in the last level cache
+internal bench_perf_counter BenchOpenCacheMissCounter(bool32 LastLevel)
+{
+#if !_WIN32
+	uint64 Event = BENCH_CACHE_MISS_EVENT(LastLevel ? PERF_COUNT_HW_CACHE_LL : PERF_COUNT_HW_CACHE_L1D,
+										  PERF_COUNT_HW_CACHE_OP_READ);
+	bench_perf_counter Result = BenchOpenPerfCounter(&Event, 1);
+#else
+	bench_perf_counter Result = BenchOpenPerfCounter(0, 0);
+#endif
+
+	return Result;
+}
+
+internal uint64 BenchReadPerfCounter(bench_perf_counter *Counter)
+{
+	uint64 Result = 0;
+#if !_WIN32
+	for(uint32 OpIndex = 0; OpIndex < ArrayCount(Counter->Handles); ++OpIndex)
+	{
+		uint64 Count;
+		if((Counter->Handles[OpIndex] >= 0) && (read(Counter->Handles[OpIndex], &Count, sizeof(Count)) == sizeof(Count)))
+		{
+			Result += Count;
+		}
+	}
+#endif
+
+	return Result;
+}
+
+internal void BenchClosePerfCounter(bench_perf_counter *Counter)
+{
+#if !_WIN32
+	for(uint32 OpIndex = 0; OpIndex < ArrayCount(Counter->Handles); ++OpIndex)
+	{
+		if(Counter->Handles[OpIndex] >= 0)
+		{
+			close(Counter->Handles[OpIndex]);
+		}
+	}
+#endif
+}
+
+//
+// NOTE: Work queue, the same as the platform layers' but only used by -worldgen
+//
+
+struct platform_work_queue_entry
+{
+	platform_work_queue_callback *Callback;
+	void *Data;
+};
+
+struct platform_work_queue
+{
+	uint32 volatile CompletionGoal;
+	uint32 volatile CompletionCount;
+
+	uint32 volatile NextEntryToWrite;
+	uint32 volatile NextEntryToRead;
+#if _WIN32
+	HANDLE SemaphoreHandle;
+#else
+	sem_t Semaphore;
+#endif
+
+	platform_work_queue_entry Entries[256];
+};
+
+internal void BenchAddEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
+{
+	uint32 NewNextEntryToWrite = (Queue->NextEntryToWrite + 1) % ArrayCount(Queue->Entries);
+	Assert(NewNextEntryToWrite != Queue->NextEntryToRead);
+	platform_work_queue_entry *Entry = Queue->Entries + Queue->NextEntryToWrite;
+	Entry->Callback = Callback;
+	Entry->Data = Data;
+	++Queue->CompletionGoal;
+
+	CompletePreviousWritesBeforeFutureWrites;
+	Queue->NextEntryToWrite = NewNextEntryToWrite;
+#if _WIN32
+	ReleaseSemaphore(Queue->SemaphoreHandle, 1, 0);
+#else
+	sem_post(&Queue->Semaphore);
+#endif
+}
+
+internal bool32 BenchDoNextWorkQueueEntry(platform_work_queue *Queue)
+{
+	bool32 WeShouldSleep = false;
+
+	uint32 OriginalNextEntryToRead = Queue->NextEntryToRead;
+	uint32 NewNextEntryToRead = (OriginalNextEntryToRead + 1) % ArrayCount(Queue->Entries);
+	if(OriginalNextEntryToRead != Queue->NextEntryToWrite)
+	{
+		uint32 Index = AtomicCompareExchangeUInt32(&Queue->NextEntryToRead,
+												   NewNextEntryToRead, OriginalNextEntryToRead);
+		if(Index == OriginalNextEntryToRead)
+		{
+			platform_work_queue_entry Entry = Queue->Entries[Index];
+			Entry.Callback(Queue, Entry.Data);
+#if _WIN32
+			InterlockedIncrement((LONG volatile *)&Queue->CompletionCount);
+#else
+			__sync_fetch_and_add(&Queue->CompletionCount, 1);
+#endif
+		}
+	}
+	else
+	{
+		WeShouldSleep = true;
+	}
+
+	return WeShouldSleep;
+}
+
+internal void BenchCompleteAllWork(platform_work_queue *Queue)
+{
+	while(Queue->CompletionGoal != Queue->CompletionCount)
+	{
+		BenchDoNextWorkQueueEntry(Queue);
+	}
+
+	Queue->CompletionGoal = 0;
+	Queue->CompletionCount = 0;
+}
+
+#if _WIN32
+DWORD WINAPI BenchWorkerThreadProc(LPVOID Parameter)
+#else
+internal void *BenchWorkerThreadProc(void *Parameter)
+#endif
+{
+	platform_work_queue *Queue = (platform_work_queue *)Parameter;
+	for(;;)
+	{
+		if(BenchDoNextWorkQueueEntry(Queue))
+		{
+#if _WIN32
+			WaitForSingleObjectEx(Queue->SemaphoreHandle, INFINITE, FALSE);
+#else
+			sem_wait(&Queue->Semaphore);
+#endif
+		}
+	}
+}
+
+// NOTE: The workers sleep on the queue until the process exits
+internal void BenchMakeQueue(platform_work_queue *Queue, uint32 ThreadCount)
+{
+	Queue->CompletionGoal = 0;
+	Queue->CompletionCount = 0;
+	Queue->NextEntryToWrite = 0;
+	Queue->NextEntryToRead = 0;
+
+#if _WIN32
+	Queue->SemaphoreHandle = CreateSemaphoreEx(0, 0, ThreadCount + 1, 0, 0, SEMAPHORE_ALL_ACCESS);
+#else
+	sem_init(&Queue->Semaphore, 0, 0);
+#endif
+	for(uint32 ThreadIndex = 0; ThreadIndex < ThreadCount; ThreadIndex++)
+	{
+#if _WIN32
+		DWORD ThreadID;
+		HANDLE ThreadHandle = CreateThread(0, 0, BenchWorkerThreadProc, Queue, 0, &ThreadID);
+		CloseHandle(ThreadHandle);
+#else
+		pthread_t ThreadID;
+		pthread_create(&ThreadID, 0, BenchWorkerThreadProc, Queue);
+		pthread_detach(ThreadID);
+#endif
+	}
+}
+
+DEBUG_PLATFORM_FREE_FILE_MEMORY(DEBUGPlatformFreeFileMemory)
+{
+	free(Memory);
+}
+
+DEBUG_PLATFORM_READ_ENTIRE_FILE(DEBUGPlatformReadEntireFile)
+{
+	debug_read_file_result Result = {};
+
+	FILE *File = fopen(Filename, "rb");
+	if(File)
+	{
+		fseek(File, 0, SEEK_END);
+		long FileSize = ftell(File);
+		fseek(File, 0, SEEK_SET);
+		if(FileSize > 0)
+		{
+			Result.Contents = malloc(FileSize);
+			if(Result.Contents && (fread(Result.Contents, 1, FileSize, File) == (size_t)FileSize))
+			{
+				Result.ContentsSize = (uint32)FileSize;
+			}
+			else
+			{
+				free(Result.Contents);
+				Result.Contents = 0;
+			}
+		}
+		fclose(File);
+	}
+
+	return Result;
+}
+
+DEBUG_PLATFORM_WRITE_ENTIRE_FILE(DEBUGPlatformWriteEntireFile)
+{
+	return false;
+}
+
+//
+// NOTE: Scenes
+//
+
+internal void BenchSetUpScene(game_memory *Memory, bench_scene *Scene)
+{
+	game_state *GameState = (game_state *)Memory->PermanentStorage;
+	transient_state *TranState = (transient_state *)Memory->TransientStorage;
+
+	uint32 WorldLevelCount = Scene->WorldLevelCount ? Scene->WorldLevelCount : GameState->World->TileMap->TileChunkCountZ;
+	if((Scene->GenerationMode != GameState->World->GenerationMode) ||
+	   (WorldLevelCount != GameState->World->TileMap->TileChunkCountZ))
+	{
+		// NOTE: The old world and its chunk arena are the last things on WorldArena, so the new one
+		// goes back in their place. What the old one wrote is zeroed first, a fresh chunk table
+		// counts on that, and nothing past its chunk arena's Used was ever committed to zero.
+		world *OldWorld = GameState->World;
+		memory_arena *WorldArena = &GameState->WorldArena;
+		if((OldWorld->ChunkArena.Base + OldWorld->ChunkArena.Size) == (WorldArena->Base + WorldArena->Used))
+		{
+			uint8 *OldWorldStart = (uint8 *)OldWorld;
+			memset(OldWorldStart, 0, (OldWorld->ChunkArena.Base + OldWorld->ChunkArena.Used) - OldWorldStart);
+			WorldArena->Used = OldWorldStart - WorldArena->Base;
+		}
+		GameState->World = InitializeWorld(Memory, &GameState->WorldArena, &TranState->TranArena,
+										   Scene->GenerationMode, Scene->RoomCount, WorldLevelCount);
+
+		// NOTE: The new world is at the old one's address, which the tile layer would take for the
+		// world it already drew
+		TranState->TileLayer.IsValid = false;
+	}
+	if(Scene->VisibleLevelCount)
+	{
+		GameState->VisibleLevelCount = Scene->VisibleLevelCount;
+	}
+
+	entity *Player = GetEntity(GameState, GameState->PlayerIndexForController[0]);
+	if(Scene->WorldLevelCount)
+	{
+		Player->P.AbsTileZ = Scene->WorldLevelCount - 1;
+		Player->PrevP = Player->P;
+	}
+	if(Scene->EntityPlacement == BenchPlacement_OnScreen)
+	{
+		// NOTE: The camera follows the player, so the player goes to the middle of the first
+		// screen where the camera starts and the heroes around it stay on screen
+		Player->P = GameState->CameraP;
+		Player->PrevP = Player->P;
+	}
+	random_series Series = RandomSeed(1234);
+	for(uint32 Index = 0; Index < Scene->EntityCount; ++Index)
+	{
+		uint32 EntityIndex = AddEntity(GameState);
+		InitializePlayer(GameState, EntityIndex);
+
+		entity *Entity = GetEntity(GameState, EntityIndex);
+		Entity->Wanders = Scene->EntitiesWander;
+		Entity->FacingDirection = RandomChoice(&Series, 4);
+		if(Scene->EntityPlacement == BenchPlacement_OnScreen)
+		{
+			// NOTE: Feet somewhere on the 16 by 9 tile screen around the camera, so every hero is drawn
+			Entity->P.AbsTileX = GameState->CameraP.AbsTileX + RandomBetween(&Series, -7, 7);
+			Entity->P.AbsTileY = GameState->CameraP.AbsTileY + RandomBetween(&Series, -4, 3);
+		}
+		else if(Scene->EntityPlacement == BenchPlacement_OffScreen)
+		{
+			Entity->P.AbsTileX = Player->P.AbsTileX + 2*17 + RandomChoice(&Series, 6*17);
+			Entity->P.AbsTileY = Player->P.AbsTileY + RandomChoice(&Series, 6*9);
+			Entity->P.AbsTileZ = RandomChoice(&Series, 2);
+		}
+		else
+		{
+			// NOTE: The tile map stops at 0, so only up and right
+			Entity->P.AbsTileX = Player->P.AbsTileX + RandomChoice(&Series, 6*17);
+			Entity->P.AbsTileY = Player->P.AbsTileY + RandomChoice(&Series, 6*9);
+		}
+		Entity->PrevP = Entity->P;
+	}
+}
+
+// NOTE: The game loads its bitmaps relative to the working directory and quietly draws nothing for
+// the ones that didn't load, which would make every scene look cheaper than it is
+internal bool32 BenchBitmapsLoaded(game_state *GameState)
+{
+	bool32 Result = (GameState->Backdrop.Width > 0);
+	for(uint32 Index = 0; Index < ArrayCount(GameState->HeroBitmaps); ++Index)
+	{
+		hero_bitmaps *Hero = GameState->HeroBitmaps + Index;
+		Result = Result && (Hero->Head.Width > 0) && (Hero->Cape.Width > 0) && (Hero->Torso.Width > 0);
+	}
+
+	return Result;
+}
+
+internal void BenchSetInput(game_input *Input, bench_scene *Scene, uint32 FrameIndex)
+{
+	game_controller_input *Controller = GetController(Input, 0);
+	Controller->IsConnected = true;
+	Controller->Start.EndedDown = (FrameIndex == 0);
+
+	// NOTE: Right, up, right, down, a second each, so the camera keeps moving on to new rooms
+	Controller->MoveRight.EndedDown = false;
+	Controller->MoveUp.EndedDown = false;
+	Controller->MoveDown.EndedDown = false;
+	if(Scene->PlayerWalks && (FrameIndex > 0))
+	{
+		uint32 Leg = (FrameIndex / 60) % 4;
+		Controller->MoveRight.EndedDown = ((Leg == 0) || (Leg == 2));
+		Controller->MoveUp.EndedDown = (Leg == 1);
+		Controller->MoveDown.EndedDown = (Leg == 3);
+	}
+}
+
+// NOTE: Walking gets stopped by the walls of the room grid, so the scrolling scene moves the
+// player itself, right the whole time and up and down by half as much on alternate seconds
+internal void BenchCarryPlayer(game_memory *Memory, bench_scene *Scene, real32 dt, uint32 FrameIndex)
+{
+	game_state *GameState = (game_state *)Memory->PermanentStorage;
+	entity *Player = GetEntity(GameState, GameState->PlayerIndexForController[0]);
+	if(Player && (Scene->PlayerCarrySpeed > 0.0f))
+	{
+		uint32 Leg = (FrameIndex / 60) % 4;
+		v2 Direction = {1.0f, (Leg == 1) ? 0.5f : ((Leg == 3) ? -0.5f : 0.0f)};
+		Player->P = Offset(GameState->World->TileMap, Player->P, (Scene->PlayerCarrySpeed*dt)*Direction);
+	}
+}
+
+internal void BenchAddResult(bench_scene_results *Results, char *Name, real64 Value)
+{
+	if(Results->ResultCount < BENCH_MAX_SCENE_RESULTS)
+	{
+		bench_result *Result = Results->Results + Results->ResultCount++;
+		snprintf(Result->Name, sizeof(Result->Name), "%s", Name);
+		Result->Value = Value;
+	}
+}
+
+internal int BenchCompareNanoseconds(const void *A, const void *B)
+{
+	uint64 ValueA = *(uint64 *)A;
+	uint64 ValueB = *(uint64 *)B;
+	int Result = (ValueA < ValueB) ? -1 : ((ValueA > ValueB) ? 1 : 0);
+	return Result;
+}
+
+// NOTE: Every chunk that exists, uniform ones at the cost of their header alone
+internal void BenchAddTileChunkBytes(tile_map *TileMap, bench_scene_results *Results)
+{
+	uint64 ChunkCount = 0;
+	uint32 TotalChunkCount = TileMap->TileChunkCountX*TileMap->TileChunkCountY*TileMap->TileChunkCountZ;
+	for(uint32 ChunkIndex = 0; ChunkIndex < TotalChunkCount; ++ChunkIndex)
+	{
+		tile_chunk *TileChunk = TileMap->TileChunks + ChunkIndex;
+		if(TileChunk->Storage || TileChunk->UniformValue)
+		{
+			++ChunkCount;
+		}
+	}
+
+	if(ChunkCount)
+	{
+		BenchAddResult(Results, "tile_chunk_bytes",
+					   (real64)(ChunkCount*sizeof(tile_chunk) + TileMap->ResidentChunkBytes) / (real64)ChunkCount);
+	}
+}
+
+/*
+	NOTE: The render loop's tile lookups and then the whole tile layer, for the screen around the
+	camera the way GameUpdateAndRender draws it, but without the tile layer cache in between.
+	Each gets BENCH_TILE_LOOP_PASSES passes and reports the median one, with the cache misses
+	counted over all of them.
+*/
+internal void BenchMeasureTileLoop(game_memory *Memory, game_offscreen_buffer *Buffer, bench_scene_results *Results)
+{
+	game_state *GameState = (game_state *)Memory->PermanentStorage;
+	tile_map *TileMap = GameState->World->TileMap;
+	tile_map_position CameraP = GameState->CameraP;
+	int32 TileSideInPixels = 60;
+	uint32 LevelCount = (uint32)Clamp((int32)GameState->VisibleLevelCount, 1, MAX_VISIBLE_LEVEL_COUNT);
+	int32 OriginX = (int32)CameraP.AbsTileX*TileSideInPixels - Buffer->Width/2;
+	int32 OriginY = -(int32)CameraP.AbsTileY*TileSideInPixels - Buffer->Height/2;
+	tile_rect Tiles = GetVisibleTileRect(OriginX, OriginY, Buffer->Width, Buffer->Height, TileSideInPixels);
+	uint32 Depth = Minimum(LevelCount, CameraP.AbsTileZ + 1) - 1;
+
+	char *LoopNames[] = {"tile_loop", "tile_draw"};
+	for(uint32 LoopIndex = 0; LoopIndex < ArrayCount(LoopNames); ++LoopIndex)
+	{
+		bench_perf_counter L1DCounter = BenchOpenCacheMissCounter(false);
+		bench_perf_counter LLCCounter = BenchOpenCacheMissCounter(true);
+		uint64 L1DMissesBefore = BenchReadPerfCounter(&L1DCounter);
+		uint64 LLCMissesBefore = BenchReadPerfCounter(&LLCCounter);
+
+		uint64 Timings[BENCH_TILE_LOOP_PASSES];
+		uint32 volatile NonEmptyCount = 0;
+		for(uint32 PassIndex = 0; PassIndex < BENCH_TILE_LOOP_PASSES; ++PassIndex)
+		{
+			uint64 PassStart = FramePacerGetClock();
+			if(LoopIndex == 0)
+			{
+				uint32 Count = 0;
+				for(uint32 Level = CameraP.AbsTileZ - Depth; Level <= CameraP.AbsTileZ; ++Level)
+				{
+					for(int32 Row = Tiles.MinRow; Row <= Tiles.MaxRow; ++Row)
+					{
+						for(int32 Col = Tiles.MinCol; Col <= Tiles.MaxCol; ++Col)
+						{
+							Count += (GetTileValue(TileMap, (uint32)Col, (uint32)Row, Level) > 1);
+						}
+					}
+				}
+				NonEmptyCount = Count;
+			}
+			else
+			{
+				DrawTileLayer(Buffer, OriginX, OriginY, GameState, TileMap, CameraP.AbsTileZ, LevelCount, TileSideInPixels);
+			}
+			Timings[PassIndex] = FramePacerGetClock() - PassStart;
+		}
+
+		uint64 L1DMisses = BenchReadPerfCounter(&L1DCounter) - L1DMissesBefore;
+		uint64 LLCMisses = BenchReadPerfCounter(&LLCCounter) - LLCMissesBefore;
+		qsort(Timings, BENCH_TILE_LOOP_PASSES, sizeof(uint64), BenchCompareNanoseconds);
+
+		char Name[64];
+		snprintf(Name, sizeof(Name), "%s_us", LoopNames[LoopIndex]);
+		BenchAddResult(Results, Name, (real64)Timings[BENCH_TILE_LOOP_PASSES / 2] / 1000.0);
+		if(L1DCounter.IsValid)
+		{
+			snprintf(Name, sizeof(Name), "%s_l1d_misses", LoopNames[LoopIndex]);
+			BenchAddResult(Results, Name, (real64)L1DMisses / (real64)BENCH_TILE_LOOP_PASSES);
+		}
+		if(LLCCounter.IsValid)
+		{
+			snprintf(Name, sizeof(Name), "%s_llc_misses", LoopNames[LoopIndex]);
+			BenchAddResult(Results, Name, (real64)LLCMisses / (real64)BENCH_TILE_LOOP_PASSES);
+		}
+		BenchClosePerfCounter(&L1DCounter);
+		BenchClosePerfCounter(&LLCCounter);
+	}
+}
+
+internal bool32 BenchRunScene(bench_scene *Scene, uint32 FrameCount, bool32 UseLargePages, bench_scene_results *Results)
+{
+	bool32 Result = false;
+
+	game_memory GameMemory = {};
+	GameMemory.PermanentStorageSize = Megabytes(64);
+	GameMemory.TransientStorageSize = Gigabytes((uint64)1);
+	memory_index TotalSize = (memory_index)(GameMemory.PermanentStorageSize + GameMemory.TransientStorageSize);
+	large_page_backing MemoryBacking = LargePages_None;
+	void *GameMemoryBlock = UseLargePages ? AllocateLargePages(TotalSize, &MemoryBacking) : BenchAllocate(TotalSize);
+	if(GameMemoryBlock)
+	{
+		GameMemory.PermanentStorage = GameMemoryBlock;
+		GameMemory.TransientStorage = (uint8 *)GameMemoryBlock + GameMemory.PermanentStorageSize;
+		GameMemory.DEBUGPlatformFreeFileMemory = DEBUGPlatformFreeFileMemory;
+		GameMemory.DEBUGPlatformReadEntireFile = DEBUGPlatformReadEntireFile;
+		GameMemory.DEBUGPlatformWriteEntireFile = DEBUGPlatformWriteEntireFile;
+
+#if HANDMADE_PROFILE
+		debug_table *DebugTable = (debug_table *)BenchAllocate(sizeof(debug_table));
+		debug_profile *Profile = (debug_profile *)BenchAllocate(sizeof(debug_profile));
+		InitializeProfile(Profile, DebugTable);
+		GlobalDebugTable = DebugTable;
+		GameMemory.DebugTable = DebugTable;
+		UpdateProfileClockRate(Profile, FramePacerGetClock());
+#endif
+
+		game_offscreen_buffer Buffer = {};
+		Buffer.Width = 960;
+		Buffer.Height = 540;
+		Buffer.BytesPerPixel = 4;
+		Buffer.Pitch = Buffer.Width*Buffer.BytesPerPixel;
+		memory_index BufferSize = (memory_index)Buffer.Pitch*Buffer.Height;
+		large_page_backing BufferBacking = LargePages_None;
+		Buffer.Memory = UseLargePages ? AllocateLargePages(BufferSize, &BufferBacking) : BenchAllocate(BufferSize);
+		if(UseLargePages)
+		{
+			fprintf(stderr, "%s: game memory on %s, framebuffer on %s\n", Scene->Name,
+					LargePageBackingNames[MemoryBacking], LargePageBackingNames[BufferBacking]);
+		}
+
+		thread_context Thread = {};
+		game_input Input = {};
+		Input.dtForFrame = 1.0f / 60.0f;
+
+		// NOTE: The first frame initializes and spawns the player, the scene goes on top of that
+		BenchSetInput(&Input, Scene, 0);
+		GameUpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+		Results->BitmapsMissing = !BenchBitmapsLoaded((game_state *)GameMemory.PermanentStorage);
+		uint64 SetUpStart = FramePacerGetClock();
+		BenchSetUpScene(&GameMemory, Scene);
+		uint64 SetUpNanoseconds = FramePacerGetClock() - SetUpStart;
+
+		uint64 *Timings = (uint64 *)calloc(FrameCount, sizeof(uint64));
+		uint64 TotalNanoseconds = 0;
+		bench_perf_counter TLBCounter = BenchOpenTLBCounter();
+		uint64 TotalTLBMisses = 0;
+		tile_layer_cache *TileLayer = &((transient_state *)GameMemory.TransientStorage)->TileLayer;
+		tile_layer_cache TileLayerAtStart = {};
+		for(uint32 FrameIndex = 1; FrameIndex < BENCH_WARMUP_FRAMES + FrameCount; ++FrameIndex)
+		{
+			BenchSetInput(&Input, Scene, FrameIndex);
+			BenchCarryPlayer(&GameMemory, Scene, Input.dtForFrame, FrameIndex);
+
+			uint64 TLBMissesBefore = BenchReadPerfCounter(&TLBCounter);
+			uint64 FrameStart = FramePacerGetClock();
+			GameUpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+			uint64 FrameNanoseconds = FramePacerGetClock() - FrameStart;
+			uint64 TLBMisses = BenchReadPerfCounter(&TLBCounter) - TLBMissesBefore;
+
+#if HANDMADE_PROFILE
+			CollateDebugFrame(Profile);
+			UpdateProfileClockRate(Profile, FramePacerGetClock());
+			if(FrameIndex == BENCH_WARMUP_FRAMES - 1)
+			{
+				ResetProfile(Profile);
+			}
+#endif
+			if(FrameIndex == BENCH_WARMUP_FRAMES - 1)
+			{
+				TileLayerAtStart = *TileLayer;
+			}
+			if(FrameIndex >= BENCH_WARMUP_FRAMES)
+			{
+				Timings[FrameIndex - BENCH_WARMUP_FRAMES] = FrameNanoseconds;
+				TotalNanoseconds += FrameNanoseconds;
+				TotalTLBMisses += TLBMisses;
+			}
+		}
+		uint64 LargePageBytes = GetLargePageResidentBytes();
+
+		qsort(Timings, FrameCount, sizeof(uint64), BenchCompareNanoseconds);
+		BenchAddResult(Results, "median_ms", (real64)Timings[FrameCount / 2] / 1000000.0);
+		BenchAddResult(Results, "p99_ms", (real64)Timings[((uint64)FrameCount*99) / 100] / 1000000.0);
+		BenchAddResult(Results, "mean_ms", (real64)TotalNanoseconds / (1000000.0*(real64)FrameCount));
+		BenchAddResult(Results, "setup_ms", (real64)SetUpNanoseconds / 1000000.0);
+
+		game_memory_telemetry *Telemetry = &GameMemory.Telemetry;
+		for(uint32 ArenaIndex = 0; ArenaIndex < Telemetry->ArenaCount; ++ArenaIndex)
+		{
+			char Name[64];
+			snprintf(Name, sizeof(Name), "arena_%s_peak_mb", Telemetry->Arenas[ArenaIndex].Name);
+			BenchAddResult(Results, Name, (real64)Telemetry->Arenas[ArenaIndex].PeakUsed / (1024.0*1024.0));
+		}
+		BenchAddResult(Results, "tile_chunks_resident", (real64)Telemetry->ResidentChunkCount);
+		BenchAddResult(Results, "tile_chunks_kb", (real64)Telemetry->ResidentChunkBytes / 1024.0);
+		BenchAddTileChunkBytes(((game_state *)GameMemory.PermanentStorage)->World->TileMap, Results);
+		BenchAddResult(Results, "entities_drawn", (real64)Telemetry->DrawnEntityCount);
+		BenchAddResult(Results, "entities_culled_off_screen", (real64)Telemetry->OffScreenEntityCount);
+		BenchAddResult(Results, "entities_culled_other_level", (real64)Telemetry->OtherLevelEntityCount);
+		BenchAddResult(Results, "tile_layer_kpixels_per_frame",
+					   (real64)(TileLayer->DrawnPixelCount - TileLayerAtStart.DrawnPixelCount) / (1000.0*(real64)FrameCount));
+		BenchAddResult(Results, "tile_layer_full_redraws", (real64)(TileLayer->FullRedrawCount - TileLayerAtStart.FullRedrawCount));
+		BenchMeasureTileLoop(&GameMemory, &Buffer, Results);
+
+#if !_WIN32
+		if(TLBCounter.IsValid)
+		{
+			BenchAddResult(Results, "dtlb_misses_per_frame", (real64)TotalTLBMisses / (real64)FrameCount);
+		}
+		BenchAddResult(Results, "huge_pages_mb", (real64)LargePageBytes / (1024.0*1024.0));
+#endif
+		BenchClosePerfCounter(&TLBCounter);
+
+#if HANDMADE_PROFILE
+		// NOTE: The game runs on this thread only, so the only tree with GameUpdateAndRender in it
+		for(uint32 ThreadIndex = 0; ThreadIndex < DEBUG_MAX_THREAD_COUNT; ++ThreadIndex)
+		{
+			profile_node *Root = Profile->Threads[ThreadIndex].Root;
+			for(profile_node *Top = Root ? Root->FirstChild : 0; Top; Top = Top->NextSibling)
+			{
+				if(strcmp(Top->Name, "GameUpdateAndRender") == 0)
+				{
+					for(profile_node *Block = Top->FirstChild; Block; Block = Block->NextSibling)
+					{
+						if(Block->HitCount)
+						{
+							char Name[64];
+							snprintf(Name, sizeof(Name), "block_%s_ms", Block->Name);
+							BenchAddResult(Results, Name, (real64)Block->Cycles /
+										   (1000.0*Profile->CyclesPerMicrosecond*(real64)Profile->FrameCount));
+						}
+					}
+				}
+			}
+		}
+		if(Profile->DroppedCount)
+		{
+			fprintf(stderr, "%s: %u timed block events dropped, the breakdown is short\n", Scene->Name, Profile->DroppedCount);
+		}
+
+		GlobalDebugTable = 0;
+		BenchFree(Profile, sizeof(debug_profile));
+		BenchFree(DebugTable, sizeof(debug_table));
+#endif
+
+		free(Timings);
+		if(UseLargePages)
+		{
+			FreeLargePages(Buffer.Memory, BufferSize);
+			FreeLargePages(GameMemoryBlock, TotalSize);
+		}
+		else
+		{
+			BenchFree(Buffer.Memory, BufferSize);
+			BenchFree(GameMemoryBlock, TotalSize);
+		}
+		Result = true;
+	}
+
+	return Result;
+}
+
+//
+// NOTE: World generation
+//
+
+// NOTE: FNV-1a over the index and tiles of every chunk that exists
+internal uint64 BenchHashTileMap(tile_map *TileMap)
+{
+	uint64 Result = 14695981039346656037ull;
+
+	uint32 TotalChunkCount = TileMap->TileChunkCountX*TileMap->TileChunkCountY*TileMap->TileChunkCountZ;
+	for(uint32 ChunkIndex = 0; ChunkIndex < TotalChunkCount; ++ChunkIndex)
+	{
+		tile_chunk *TileChunk = TileMap->TileChunks + ChunkIndex;
+		if(TileChunk->Storage || TileChunk->UniformValue)
+		{
+			Result = (Result ^ ChunkIndex)*1099511628211ull;
+			for(uint32 TileY = 0; TileY < TILE_CHUNK_DIM; ++TileY)
+			{
+				for(uint32 TileX = 0; TileX < TILE_CHUNK_DIM; ++TileX)
+				{
+					Result = (Result ^ GetTileValueUnchecked(TileMap, TileChunk, TileX, TileY))*1099511628211ull;
+				}
+			}
+		}
+	}
+
+	return Result;
+}
+
+struct bench_chunk_touch_work
+{
+	tile_map *TileMap;
+	uint32 FirstChunk;
+};
+
+// NOTE: Touches one tile of every chunk, starting at FirstChunk and wrapping around
+internal PLATFORM_WORK_QUEUE_CALLBACK(BenchTouchTileChunks)
+{
+	bench_chunk_touch_work *Work = (bench_chunk_touch_work *)Data;
+	tile_map *TileMap = Work->TileMap;
+	uint32 ChunkCountXY = TileMap->TileChunkCountX*TileMap->TileChunkCountY;
+	uint32 TotalChunkCount = ChunkCountXY*TileMap->TileChunkCountZ;
+	for(uint32 Step = 0; Step < TotalChunkCount; ++Step)
+	{
+		uint32 ChunkIndex = (Work->FirstChunk + Step) % TotalChunkCount;
+		uint32 ChunkZ = ChunkIndex / ChunkCountXY;
+		uint32 ChunkY = (ChunkIndex % ChunkCountXY) / TileMap->TileChunkCountX;
+		uint32 ChunkX = ChunkIndex % TileMap->TileChunkCountX;
+		GetTileValue(TileMap, ChunkX*TILE_CHUNK_DIM, ChunkY*TILE_CHUNK_DIM, ChunkZ);
+	}
+}
+
+internal bool32 BenchCheckLazyWorld(void)
+{
+	uint32 LevelCount = 4;
+	uint32 TouchWorkCount = 4;
+	platform_work_queue Queue = {};
+	BenchMakeQueue(&Queue, TouchWorkCount - 1);
+
+	memory_index ArenaSize = Megabytes(256);
+	uint8 *EagerBase = (uint8 *)BenchAllocate(ArenaSize);
+	uint8 *LazyBase = (uint8 *)BenchAllocate(ArenaSize);
+	if(!EagerBase || !LazyBase)
+	{
+		fprintf(stderr, "could not allocate the arenas\n");
+		return false;
+	}
+	memory_arena EagerArena;
+	memory_arena LazyArena;
+	InitializeArena(&EagerArena, ArenaSize, EagerBase, "Eager");
+	InitializeArena(&LazyArena, ArenaSize, LazyBase, "Lazy");
+
+	game_memory Memory = {};
+	world *EagerWorld = InitializeWorld(&Memory, &EagerArena, 0, WorldGeneration_RoomGridEager, 0, LevelCount);
+	world *LazyWorld = InitializeWorld(&Memory, &LazyArena, 0, WorldGeneration_RoomGridLazy, 0, LevelCount);
+	tile_map *EagerMap = EagerWorld->TileMap;
+	tile_map *LazyMap = LazyWorld->TileMap;
+
+	uint32 TotalChunkCount = LazyMap->TileChunkCountX*LazyMap->TileChunkCountY*LazyMap->TileChunkCountZ;
+	bench_chunk_touch_work TouchWorks[4];
+	for(uint32 WorkIndex = 0; WorkIndex < ArrayCount(TouchWorks); ++WorkIndex)
+	{
+		TouchWorks[WorkIndex].TileMap = LazyMap;
+		TouchWorks[WorkIndex].FirstChunk = (TotalChunkCount / ArrayCount(TouchWorks))*WorkIndex;
+		BenchAddEntry(&Queue, BenchTouchTileChunks, TouchWorks + WorkIndex);
+	}
+	BenchCompleteAllWork(&Queue);
+
+	uint32 MismatchedChunkCount = 0;
+	uint64 MismatchedTileCount = 0;
+	for(uint32 ChunkIndex = 0; ChunkIndex < TotalChunkCount; ++ChunkIndex)
+	{
+		tile_chunk *EagerChunk = EagerMap->TileChunks + ChunkIndex;
+		tile_chunk *LazyChunk = LazyMap->TileChunks + ChunkIndex;
+		uint32 MismatchedTilesInChunk = 0;
+		if((EagerChunk->State != TileChunkState_Generated) || (LazyChunk->State != TileChunkState_Generated))
+		{
+			MismatchedTilesInChunk = TILE_CHUNK_DIM*TILE_CHUNK_DIM;
+		}
+		else
+		{
+			for(uint32 TileY = 0; TileY < TILE_CHUNK_DIM; ++TileY)
+			{
+				for(uint32 TileX = 0; TileX < TILE_CHUNK_DIM; ++TileX)
+				{
+					if(GetTileValueUnchecked(EagerMap, EagerChunk, TileX, TileY) !=
+					   GetTileValueUnchecked(LazyMap, LazyChunk, TileX, TileY))
+					{
+						++MismatchedTilesInChunk;
+					}
+				}
+			}
+		}
+
+		if(MismatchedTilesInChunk)
+		{
+			if(MismatchedChunkCount < 8)
+			{
+				fprintf(stderr, "chunk %u: %u tiles differ\n", ChunkIndex, MismatchedTilesInChunk);
+			}
+			++MismatchedChunkCount;
+			MismatchedTileCount += MismatchedTilesInChunk;
+		}
+	}
+
+	printf("checkworld,chunks,%u\n", TotalChunkCount);
+	printf("checkworld,mismatched_chunks,%u\n", MismatchedChunkCount);
+	printf("checkworld,mismatched_tiles,%llu\n", (unsigned long long)MismatchedTileCount);
+	fprintf(stderr, "eager and lazy room grid, %u chunks on %u levels: %s\n", TotalChunkCount, LevelCount,
+			MismatchedChunkCount ? "MISMATCH" : "identical");
+
+	BenchFree(LazyBase, ArenaSize);
+	BenchFree(EagerBase, ArenaSize);
+
+	bool32 Result = (MismatchedChunkCount == 0);
+	return Result;
+}
+
+internal bool32 BenchWorldGeneration(void)
+{
+	bool32 Result = true;
+
+	uint32 RoomCounts[] = {100, 10000, 1000000};
+	uint32 ThreadCounts[] = {1, 4, 16};
+	platform_work_queue *Queues = (platform_work_queue *)calloc(ArrayCount(ThreadCounts), sizeof(platform_work_queue));
+	for(uint32 ThreadIndex = 0; ThreadIndex < ArrayCount(ThreadCounts); ++ThreadIndex)
+	{
+		BenchMakeQueue(Queues + ThreadIndex, ThreadCounts[ThreadIndex] - 1);
+	}
+
+	memory_index WorldArenaSize = Gigabytes((memory_index)2);
+	memory_index TempArenaSize = Gigabytes((memory_index)1);
+	for(uint32 RoomIndex = 0; RoomIndex < ArrayCount(RoomCounts); ++RoomIndex)
+	{
+		uint32 RoomCount = RoomCounts[RoomIndex];
+		char SceneName[64];
+		snprintf(SceneName, sizeof(SceneName), "worldgen_%u", RoomCount);
+
+		uint64 FirstHash = 0;
+		bool32 HashesMatch = true;
+		uint32 MapChunkCount = 0;
+		uint64 FilledChunkCount = 0;
+		uint32 DroppedRoomCount = 0;
+		fprintf(stderr, "%-16s", SceneName);
+		for(uint32 ThreadIndex = 0; ThreadIndex < ArrayCount(ThreadCounts); ++ThreadIndex)
+		{
+			game_memory Memory = {};
+			Memory.HighPriorityQueue = Queues + ThreadIndex;
+			Memory.PlatformAddEntry = BenchAddEntry;
+			Memory.PlatformCompleteAllWork = BenchCompleteAllWork;
+
+			uint64 BestNanoseconds = 0;
+			for(uint32 RunIndex = 0; RunIndex < ((RoomCount <= 10000) ? BENCH_WORLDGEN_RUNS : 1); ++RunIndex)
+			{
+				// NOTE: Fresh arenas every run, the chunk table counts on starting out zeroed
+				uint8 *WorldBase = (uint8 *)BenchAllocate(WorldArenaSize);
+				uint8 *TempBase = (uint8 *)BenchAllocate(TempArenaSize);
+				if(!WorldBase || !TempBase)
+				{
+					fprintf(stderr, "\n%s: could not allocate the arenas\n", SceneName);
+					return false;
+				}
+				memory_arena WorldArena;
+				memory_arena TempArena;
+				InitializeArena(&WorldArena, WorldArenaSize, WorldBase, "World");
+				InitializeArena(&TempArena, TempArenaSize, TempBase, "Temp");
+
+				uint64 Start = FramePacerGetClock();
+				world *World = InitializeWorld(&Memory, &WorldArena, &TempArena, WorldGeneration_RoomPath, RoomCount, 2);
+				uint64 Nanoseconds = FramePacerGetClock() - Start;
+				if(!RunIndex || (Nanoseconds < BestNanoseconds))
+				{
+					BestNanoseconds = Nanoseconds;
+				}
+
+				tile_map *TileMap = World->TileMap;
+				uint64 Hash = BenchHashTileMap(TileMap);
+				if(!ThreadIndex && !RunIndex)
+				{
+					FirstHash = Hash;
+					MapChunkCount = TileMap->TileChunkCountX*TileMap->TileChunkCountY*TileMap->TileChunkCountZ;
+					FilledChunkCount = TileMap->ResidentChunkCount;
+					DroppedRoomCount = World->DroppedRoomCount;
+				}
+				else if(Hash != FirstHash)
+				{
+					HashesMatch = false;
+				}
+
+				BenchFree(TempBase, TempArenaSize);
+				BenchFree(WorldBase, WorldArenaSize);
+			}
+
+			real64 PlacedRoomsPerSecond = (real64)(RoomCount - DroppedRoomCount) / ((real64)BestNanoseconds / 1000000000.0);
+			char Name[64];
+			snprintf(Name, sizeof(Name), "threads_%u_ms", ThreadCounts[ThreadIndex]);
+			printf("%s,%s,%.4f\n", SceneName, Name, (real64)BestNanoseconds / 1000000.0);
+			snprintf(Name, sizeof(Name), "threads_%u_placed_rooms_per_s", ThreadCounts[ThreadIndex]);
+			printf("%s,%s,%.0f\n", SceneName, Name, PlacedRoomsPerSecond);
+			fprintf(stderr, " %2u threads %9.3fms (%6.2fM placed rooms/s)", ThreadCounts[ThreadIndex],
+					(real64)BestNanoseconds / 1000000.0, PlacedRoomsPerSecond / 1000000.0);
+		}
+
+		printf("%s,map_chunks,%u\n", SceneName, MapChunkCount);
+		printf("%s,filled_chunks,%llu\n", SceneName, (unsigned long long)FilledChunkCount);
+		printf("%s,dropped_rooms,%u\n", SceneName, DroppedRoomCount);
+		printf("%s,placed_rooms,%u\n", SceneName, RoomCount - DroppedRoomCount);
+		fflush(stdout);
+		fprintf(stderr, ", hash %016llx%s", (unsigned long long)FirstHash, HashesMatch ? "" : " DIFFERS BY THREAD COUNT");
+		if(DroppedRoomCount)
+		{
+			fprintf(stderr, ", %u rooms didn't fit", DroppedRoomCount);
+		}
+		fprintf(stderr, "\n");
+
+		if(!HashesMatch)
+		{
+			Result = false;
+		}
+	}
+
+	return Result;
+}
+
+//
+// NOTE: Tile lookups against the runtime sized ones
+//
+
+// NOTE: What tile_map carried before the chunk size became TILE_CHUNK_SHIFT, with the lookups
+// that went through it copied from then
+struct bench_runtime_chunk_size
+{
+	uint32 ChunkShift;
+	uint32 ChunkMask;
+	uint32 ChunkDim;
+};
+
+internal uint32 BenchRuntimeGetTileValue(bench_runtime_chunk_size *Size, tile_map *TileMap,
+										 uint32 AbsTileX, uint32 AbsTileY, uint32 AbsTileZ)
+{
+	uint32 TileChunkX = AbsTileX >> Size->ChunkShift;
+	uint32 TileChunkY = AbsTileY >> Size->ChunkShift;
+	uint32 RelTileX = AbsTileX & Size->ChunkMask;
+	uint32 RelTileY = AbsTileY & Size->ChunkMask;
+
+	uint32 Result = 0;
+	tile_chunk *TileChunk = GetTileChunk(TileMap, TileChunkX, TileChunkY, AbsTileZ);
+	if(TileChunk && TileMap->GenerateChunk && (TileChunk->State != TileChunkState_Generated))
+	{
+		EnsureTileChunkGenerated(TileMap, TileChunk, TileChunkX, TileChunkY, AbsTileZ);
+	}
+	if(TileChunk)
+	{
+		Assert(RelTileX < Size->ChunkDim);
+		Assert(RelTileY < Size->ChunkDim);
+
+		Result = TileChunk->UniformValue;
+		if(TileChunk->Storage)
+		{
+			uint32 TileIndex = RelTileY*Size->ChunkDim + RelTileX;
+			uint8 *Indices = GetChunkIndices(TileChunk);
+
+			uint32 PaletteIndex;
+			if(GetTileIndexSize(TileChunk->PaletteCapacity) == 1)
+			{
+				PaletteIndex = Indices[TileIndex];
+			}
+			else
+			{
+				PaletteIndex = ((uint16 *)Indices)[TileIndex];
+			}
+			Result = GetChunkPalette(TileChunk)[PaletteIndex];
+		}
+	}
+
+	return Result;
+}
+
+// NOTE: Size is null for the compile time lookups
+inline uint32 BenchGetTileValue(bench_runtime_chunk_size *Size, tile_map *TileMap,
+								uint32 AbsTileX, uint32 AbsTileY, uint32 AbsTileZ)
+{
+	uint32 Result = Size ? BenchRuntimeGetTileValue(Size, TileMap, AbsTileX, AbsTileY, AbsTileZ) :
+		GetTileValue(TileMap, AbsTileX, AbsTileY, AbsTileZ);
+	return Result;
+}
+
+struct bench_collision_step
+{
+	uint32 StartTileX;
+	uint32 StartTileY;
+	uint32 EndTileX;
+	uint32 EndTileY;
+	uint32 AbsTileZ;
+};
+
+// NOTE: Returns the sum of every value read, which both kinds of lookup have to agree on
+internal uint64 BenchScanTiles(uint32 Pass, bench_runtime_chunk_size *Size, tile_map *TileMap,
+							   bench_collision_step *Steps, uint32 StepCount, uint64 *Count)
+{
+	uint64 Sum = 0;
+	*Count = 0;
+	if(Pass == 0)
+	{
+		uint32 TileCountX = TileMap->TileChunkCountX*TILE_CHUNK_DIM;
+		uint32 TileCountY = TileMap->TileChunkCountY*TILE_CHUNK_DIM;
+		for(uint32 AbsTileZ = 0; AbsTileZ < TileMap->TileChunkCountZ; ++AbsTileZ)
+		{
+			for(uint32 AbsTileY = 0; AbsTileY < TileCountY; ++AbsTileY)
+			{
+				for(uint32 AbsTileX = 0; AbsTileX < TileCountX; ++AbsTileX)
+				{
+					Sum += BenchGetTileValue(Size, TileMap, AbsTileX, AbsTileY, AbsTileZ);
+				}
+			}
+		}
+		*Count = (uint64)TileCountX*TileCountY*TileMap->TileChunkCountZ;
+	}
+	else if(Pass == 1)
+	{
+		random_series Series = RandomSeed(30);
+		uint32 MaxX = TileMap->TileChunkCountX*TILE_CHUNK_DIM - 40;
+		uint32 MaxY = TileMap->TileChunkCountY*TILE_CHUNK_DIM - 20;
+		for(uint32 WindowIndex = 0; WindowIndex < 4096; ++WindowIndex)
+		{
+			uint32 MinX = RandomChoice(&Series, MaxX);
+			uint32 MinY = RandomChoice(&Series, MaxY);
+			uint32 AbsTileZ = RandomChoice(&Series, TileMap->TileChunkCountZ);
+			for(uint32 AbsTileY = MinY; AbsTileY < MinY + 20; ++AbsTileY)
+			{
+				for(uint32 AbsTileX = MinX; AbsTileX < MinX + 40; ++AbsTileX)
+				{
+					Sum += BenchGetTileValue(Size, TileMap, AbsTileX, AbsTileY, AbsTileZ);
+				}
+			}
+		}
+		*Count = 4096*40*20;
+	}
+	else
+	{
+		// NOTE: The same walk over the swept tiles as MovePlayer's, without the wall tests
+		for(uint32 StepIndex = 0; StepIndex < StepCount; ++StepIndex)
+		{
+			bench_collision_step *Step = Steps + StepIndex;
+			int32 DeltaX = SignOf(Step->EndTileX - Step->StartTileX);
+			int32 DeltaY = SignOf(Step->EndTileY - Step->StartTileY);
+			for(uint32 AbsTileY = Step->StartTileY; ; AbsTileY += DeltaY)
+			{
+				for(uint32 AbsTileX = Step->StartTileX; ; AbsTileX += DeltaX)
+				{
+					Sum += !IsTileValueEmpty(BenchGetTileValue(Size, TileMap, AbsTileX, AbsTileY, Step->AbsTileZ));
+					if(AbsTileX == Step->EndTileX)
+					{
+						break;
+					}
+				}
+				if(AbsTileY == Step->EndTileY)
+				{
+					break;
+				}
+			}
+		}
+		*Count = StepCount;
+	}
+
+	return Sum;
+}
+
+internal bool32 BenchTileScan(void)
+{
+	memory_index ArenaSize = Megabytes(256);
+	uint8 *Base = (uint8 *)BenchAllocate(ArenaSize);
+	game_state *GameState = (game_state *)calloc(1, sizeof(game_state));
+	if(!Base || !GameState)
+	{
+		fprintf(stderr, "could not allocate the world\n");
+		return false;
+	}
+	InitializeArena(&GameState->WorldArena, ArenaSize, Base, "World");
+
+	game_memory Memory = {};
+	GameState->World = InitializeWorld(&Memory, &GameState->WorldArena, 0, WorldGeneration_RoomGridEager, 0, 2);
+	tile_map *TileMap = GameState->World->TileMap;
+
+	// NOTE: Loaded through a volatile so the compiler can't fold them back into constants
+	uint32 volatile ChunkShift = TILE_CHUNK_SHIFT;
+	bench_runtime_chunk_size RuntimeSize;
+	RuntimeSize.ChunkShift = ChunkShift;
+	RuntimeSize.ChunkMask = (1 << RuntimeSize.ChunkShift) - 1;
+	RuntimeSize.ChunkDim = 1 << RuntimeSize.ChunkShift;
+
+	// NOTE: A player wandering from the middle of a room in the middle of the map, changing
+	// direction every half second of 60Hz steps, with the tiles each step swept over kept for the
+	// collision replay. Entity 0 is the null entity.
+	GameState->Entities = PushArray(&GameState->WorldArena, 2, entity);
+	AddEntity(GameState);
+	uint32 EntityIndex = AddEntity(GameState);
+	InitializePlayer(GameState, EntityIndex);
+	entity *Player = GetEntity(GameState, EntityIndex);
+	Player->P.AbsTileX = 60*17 + 8;
+	Player->P.AbsTileY = 110*9 + 4;
+	bench_collision_step *Steps = (bench_collision_step *)malloc(BENCH_COLLISION_STEPS*sizeof(bench_collision_step));
+	random_series Series = RandomSeed(31);
+	v2 ddP = {};
+	uint64 MoveStart = FramePacerGetClock();
+	for(uint32 StepIndex = 0; StepIndex < BENCH_COLLISION_STEPS; ++StepIndex)
+	{
+		if((StepIndex % 30) == 0)
+		{
+			ddP = V2(RandomBilateral(&Series), RandomBilateral(&Series));
+		}
+		tile_map_position OldP = Player->P;
+		MovePlayer(GameState, Player, 1.0f / 60.0f, ddP);
+
+		bench_collision_step *Step = Steps + StepIndex;
+		Step->StartTileX = OldP.AbsTileX;
+		Step->StartTileY = OldP.AbsTileY;
+		Step->EndTileX = Player->P.AbsTileX;
+		Step->EndTileY = Player->P.AbsTileY;
+		Step->AbsTileZ = OldP.AbsTileZ;
+	}
+	uint64 MoveNanoseconds = FramePacerGetClock() - MoveStart;
+
+	bool32 Result = true;
+	char *PassNames[] = {"full_scan", "window_scan", "collision"};
+	char *PassUnits[] = {"tile", "tile", "step"};
+	for(uint32 Pass = 0; Pass < ArrayCount(PassNames); ++Pass)
+	{
+		real64 Best[2] = {};
+		uint64 Sums[2] = {};
+		for(uint32 RunIndex = 0; RunIndex < BENCH_TILE_SCAN_RUNS; ++RunIndex)
+		{
+			for(uint32 Runtime = 0; Runtime < 2; ++Runtime)
+			{
+				uint64 Count;
+				uint64 Start = FramePacerGetClock();
+				Sums[Runtime] = BenchScanTiles(Pass, Runtime ? &RuntimeSize : 0, TileMap, Steps, BENCH_COLLISION_STEPS, &Count);
+				real64 Nanoseconds = (real64)(FramePacerGetClock() - Start) / (real64)Count;
+				if(!RunIndex || (Nanoseconds < Best[Runtime]))
+				{
+					Best[Runtime] = Nanoseconds;
+				}
+			}
+		}
+
+		printf("tilescan,%s_ns_per_%s,%.4f\n", PassNames[Pass], PassUnits[Pass], Best[0]);
+		printf("tilescan,%s_runtime_ns_per_%s,%.4f\n", PassNames[Pass], PassUnits[Pass], Best[1]);
+		fprintf(stderr, "%-12s %8.3fns per %s, runtime sized %8.3fns (%+.1f%%)%s\n", PassNames[Pass], Best[0],
+				PassUnits[Pass], Best[1], 100.0*(Best[0] - Best[1]) / Best[1],
+				(Sums[0] == Sums[1]) ? "" : " LOOKUPS DISAGREE");
+		if(Sums[0] != Sums[1])
+		{
+			Result = false;
+		}
+	}
+	printf("tilescan,moveplayer_ns_per_step,%.4f\n", (real64)MoveNanoseconds / (real64)BENCH_COLLISION_STEPS);
+	fprintf(stderr, "%-12s %8.3fns per step\n", "moveplayer", (real64)MoveNanoseconds / (real64)BENCH_COLLISION_STEPS);
+
+	free(Steps);
+	free(GameState);
+	BenchFree(Base, ArenaSize);
+
+	return Result;
+}
+
+//
+// NOTE: Dirty page tracking
+//
+
+internal uint64 BenchGetAvailableMemory(void)
+{
+	uint64 Result = 0;
+#if _WIN32
+	MEMORYSTATUSEX Status = {};
+	Status.dwLength = sizeof(Status);
+	if(GlobalMemoryStatusEx(&Status))
+	{
+		Result = Status.ullAvailPhys;
+	}
+#else
+	FILE *MemInfo = fopen("/proc/meminfo", "r");
+	if(MemInfo)
+	{
+		char Line[256];
+		while(fgets(Line, sizeof(Line), MemInfo))
+		{
+			unsigned long long KilobyteCount;
+			if(sscanf(Line, "MemAvailable: %llu kB", &KilobyteCount) == 1)
+			{
+				Result = (uint64)KilobyteCount*1024;
+				break;
+			}
+		}
+		fclose(MemInfo);
+	}
+#endif
+
+	return Result;
+}
+
+/*
+	NOTE: A block the size of game memory and a snapshot of it, the way a host restores a replay
+	loop: one byte written in 1% of the pages at random, then either the whole snapshot copied back
+	or the dirty pages collected and only those copied back. The block is allocated with
+	MEM_WRITE_WATCH on Windows. A size is skipped when the block won't fit in the memory available,
+	and when the snapshot won't fit alongside it, it is left unwritten so every read of it comes
+	from the kernel's zero page, which makes the full copy look cheaper than it is.
+*/
+internal bool32 BenchDirtyPages(void)
+{
+	bool32 Result = true;
+
+	uint64 Sizes[] = {Megabytes(64), Gigabytes((uint64)1), Gigabytes((uint64)4)};
+	char *SizeNames[] = {"64mb", "1gb", "4gb"};
+	for(uint32 SizeIndex = 0; SizeIndex < ArrayCount(Sizes); ++SizeIndex)
+	{
+		uint64 Size = Sizes[SizeIndex];
+		uint64 Available = BenchGetAvailableMemory();
+		if((Size + Megabytes(256)) > Available)
+		{
+			fprintf(stderr, "dirtypages_%s skipped, only %lluMB available\n", SizeNames[SizeIndex],
+					(unsigned long long)(Available / Megabytes(1)));
+			continue;
+		}
+		bool32 SnapshotWritten = ((2*Size + Megabytes(256)) <= Available);
+
+#if _WIN32
+		uint8 *Block = (uint8 *)VirtualAlloc(0, (SIZE_T)Size, MEM_RESERVE | MEM_COMMIT | MEM_WRITE_WATCH, PAGE_READWRITE);
+#else
+		uint8 *Block = (uint8 *)BenchAllocate(Size);
+#endif
+		uint8 *Snapshot = (uint8 *)BenchAllocate(Size);
+		if(!Block || !Snapshot)
+		{
+			fprintf(stderr, "could not allocate %s twice\n", SizeNames[SizeIndex]);
+			Result = false;
+			break;
+		}
+		memset(Block, 1, Size);
+		if(SnapshotWritten)
+		{
+			memset(Snapshot, 2, Size);
+		}
+
+		uint64 PageSize = 4096;
+		uint32 WriteCount = (uint32)(Size / PageSize / 100);
+		uint64 *WriteOffsets = (uint64 *)malloc(WriteCount*sizeof(uint64));
+		random_series Series = RandomSeed(SizeIndex + 1);
+		for(uint32 WriteIndex = 0; WriteIndex < WriteCount; ++WriteIndex)
+		{
+			uint64 Page = (((uint64)RandomNextUInt32(&Series) << 32) | RandomNextUInt32(&Series)) % (Size / PageSize);
+			WriteOffsets[WriteIndex] = Page*PageSize + (WriteIndex % PageSize);
+		}
+
+		real64 FullCopy = 0.0;
+		real64 PlainWrite = 0.0;
+		for(uint32 RunIndex = 0; RunIndex < BENCH_DIRTY_PAGE_RUNS; ++RunIndex)
+		{
+			uint64 Start = FramePacerGetClock();
+			for(uint32 WriteIndex = 0; WriteIndex < WriteCount; ++WriteIndex)
+			{
+				++Block[WriteOffsets[WriteIndex]];
+			}
+			real64 Milliseconds = (real64)(FramePacerGetClock() - Start) / 1000000.0;
+			PlainWrite = RunIndex ? Minimum(PlainWrite, Milliseconds) : Milliseconds;
+
+			Start = FramePacerGetClock();
+			memcpy(Block, Snapshot, Size);
+			Milliseconds = (real64)(FramePacerGetClock() - Start) / 1000000.0;
+			FullCopy = RunIndex ? Minimum(FullCopy, Milliseconds) : Milliseconds;
+		}
+
+		dirty_page_tracker Tracker = {};
+		if(BeginDirtyPageTracking(&Tracker, Block, Size))
+		{
+			real64 TrackedWrite = 0.0;
+			real64 Sync = 0.0;
+			uint64 PagesCopied = 0;
+			for(uint32 RunIndex = 0; RunIndex < BENCH_DIRTY_PAGE_RUNS; ++RunIndex)
+			{
+				uint64 Start = FramePacerGetClock();
+				for(uint32 WriteIndex = 0; WriteIndex < WriteCount; ++WriteIndex)
+				{
+					++Block[WriteOffsets[WriteIndex]];
+				}
+				real64 Milliseconds = (real64)(FramePacerGetClock() - Start) / 1000000.0;
+				TrackedWrite = RunIndex ? Minimum(TrackedWrite, Milliseconds) : Milliseconds;
+
+				// NOTE: The same steps as a host's loop restore, including collecting the pages
+				// the copy itself wrote
+				Start = FramePacerGetClock();
+				CollectDirtyPages(&Tracker);
+				PagesCopied = CopyDirtyPages(&Tracker, 0, Block, Snapshot);
+				CollectDirtyPages(&Tracker);
+				ClearDirtyPages(&Tracker, 0);
+				Milliseconds = (real64)(FramePacerGetClock() - Start) / 1000000.0;
+				Sync = RunIndex ? Minimum(Sync, Milliseconds) : Milliseconds;
+
+				for(uint32 WriteIndex = 0; WriteIndex < WriteCount; ++WriteIndex)
+				{
+					uint64 Offset = WriteOffsets[WriteIndex];
+					if(Block[Offset] != Snapshot[Offset])
+					{
+						Result = false;
+					}
+				}
+			}
+			EndDirtyPageTracking(&Tracker);
+
+			// NOTE: What a recording keyframe costs the frame it lands on, compressing the whole
+			// block there and then against bringing a shadow copy up to date with the dirty pages
+			// for another thread to compress. Mostly zeroes, like game memory.
+			memset(Block, 0, Size);
+			real64 Compress = 0.0;
+			real64 ShadowCopy = 0.0;
+			uint64 SnapshotBytes = 0;
+			uint8 *Scratch = (uint8 *)malloc(RECORDING_MAX_SNAPSHOT_BLOCK_SIZE(RECORDING_SNAPSHOT_BLOCK_SIZE));
+			if(Scratch && BeginDirtyPageTracking(&Tracker, Block, Size))
+			{
+				for(uint32 RunIndex = 0; RunIndex < BENCH_DIRTY_PAGE_RUNS; ++RunIndex)
+				{
+					for(uint32 WriteIndex = 0; WriteIndex < WriteCount; ++WriteIndex)
+					{
+						++Block[WriteOffsets[WriteIndex]];
+					}
+
+					uint64 Start = FramePacerGetClock();
+					SnapshotBytes = 0;
+					for(uint64 Offset = 0; Offset < Size; Offset += RECORDING_SNAPSHOT_BLOCK_SIZE)
+					{
+						SnapshotBytes += CompressSnapshotBlock(Block + Offset, Minimum(RECORDING_SNAPSHOT_BLOCK_SIZE, Size - Offset), Scratch);
+					}
+					real64 Milliseconds = (real64)(FramePacerGetClock() - Start) / 1000000.0;
+					Compress = RunIndex ? Minimum(Compress, Milliseconds) : Milliseconds;
+
+					Start = FramePacerGetClock();
+					CollectDirtyPages(&Tracker);
+					CopyDirtyPages(&Tracker, 1, Snapshot, Block);
+					Milliseconds = (real64)(FramePacerGetClock() - Start) / 1000000.0;
+					ShadowCopy = RunIndex ? Minimum(ShadowCopy, Milliseconds) : Milliseconds;
+					ClearDirtyPages(&Tracker, 0);
+				}
+				EndDirtyPageTracking(&Tracker);
+			}
+			free(Scratch);
+
+			printf("dirtypages_%s,full_copy_ms,%.3f\n", SizeNames[SizeIndex], FullCopy);
+			printf("dirtypages_%s,plain_write_ms,%.3f\n", SizeNames[SizeIndex], PlainWrite);
+			printf("dirtypages_%s,tracked_write_ms,%.3f\n", SizeNames[SizeIndex], TrackedWrite);
+			printf("dirtypages_%s,dirty_copy_ms,%.3f\n", SizeNames[SizeIndex], Sync);
+			printf("dirtypages_%s,dirty_pages,%llu\n", SizeNames[SizeIndex], (unsigned long long)PagesCopied);
+			printf("dirtypages_%s,snapshot_written,%u\n", SizeNames[SizeIndex], SnapshotWritten ? 1 : 0);
+			printf("dirtypages_%s,keyframe_compress_ms,%.3f\n", SizeNames[SizeIndex], Compress);
+			printf("dirtypages_%s,keyframe_shadow_copy_ms,%.3f\n", SizeNames[SizeIndex], ShadowCopy);
+			printf("dirtypages_%s,keyframe_kb,%llu\n", SizeNames[SizeIndex], (unsigned long long)(SnapshotBytes / 1024));
+			fprintf(stderr, "%-5s full copy %9.3fms, %llu dirty pages copied in %8.3fms, "
+					"writes %.3fms tracked against %.3fms%s\n",
+					SizeNames[SizeIndex], FullCopy, (unsigned long long)PagesCopied, Sync, TrackedWrite, PlainWrite,
+					SnapshotWritten ? "" : " (snapshot on the zero page)");
+			fprintf(stderr, "%-5s keyframe compressed in place %9.3fms, dirty pages into a shadow %8.3fms\n",
+					SizeNames[SizeIndex], Compress, ShadowCopy);
+		}
+		else
+		{
+			fprintf(stderr, "could not track the dirty pages of %s\n", SizeNames[SizeIndex]);
+			Result = false;
+		}
+		if(!Result)
+		{
+			fprintf(stderr, "dirtypages_%s: the dirty copy missed a write\n", SizeNames[SizeIndex]);
+		}
+
+		free(WriteOffsets);
+		BenchFree(Snapshot, Size);
+		BenchFree(Block, Size);
+	}
+
+	return Result;
+}
+
+//
+// NOTE: Baseline
+//
+
+// NOTE: Returns a negative number when the file has no such line
+internal real64 BenchFindBaseline(char *Baseline, char *SceneName, char *ResultName)
+{
+	real64 Result = -1.0;
+
+	char Prefix[128];
+	snprintf(Prefix, sizeof(Prefix), "%s,%s,", SceneName, ResultName);
+	size_t PrefixLength = strlen(Prefix);
+	for(char *Line = Baseline; Line && *Line; )
+	{
+		if(strncmp(Line, Prefix, PrefixLength) == 0)
+		{
+			Result = atof(Line + PrefixLength);
+			break;
+		}
+		Line = strchr(Line, '\n');
+		if(Line)
+		{
+			++Line;
+		}
+	}
+
+	return Result;
+}
+
+int main(int ArgCount, char **Args)
+{
+	uint32 FrameCount = 300;
+	char *SceneFilter = 0;
+	char *BaselineFilename = 0;
+	real64 ThresholdPercent = 10.0;
+	bool32 UseLargePages = false;
+	bool32 TimeWorldGeneration = false;
+	bool32 CheckLazyWorld = false;
+	bool32 CompareTileScans = false;
+	bool32 TimeDirtyPages = false;
+	for(int ArgIndex = 1; ArgIndex < ArgCount; ArgIndex++)
+	{
+		char *Arg = Args[ArgIndex];
+		if((strcmp(Arg, "-frames") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			FrameCount = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-scene") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			SceneFilter = Args[++ArgIndex];
+		}
+		else if((strcmp(Arg, "-baseline") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			BaselineFilename = Args[++ArgIndex];
+		}
+		else if((strcmp(Arg, "-threshold") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			ThresholdPercent = atof(Args[++ArgIndex]);
+		}
+		else if(strcmp(Arg, "-hugepages") == 0)
+		{
+			UseLargePages = true;
+		}
+		else if(strcmp(Arg, "-worldgen") == 0)
+		{
+			TimeWorldGeneration = true;
+		}
+		else if(strcmp(Arg, "-checkworld") == 0)
+		{
+			CheckLazyWorld = true;
+		}
+		else if(strcmp(Arg, "-tilescan") == 0)
+		{
+			CompareTileScans = true;
+		}
+		else if(strcmp(Arg, "-dirtypages") == 0)
+		{
+			TimeDirtyPages = true;
+		}
+		else
+		{
+			FrameCount = 0;
+			break;
+		}
+	}
+	if(FrameCount < 1)
+	{
+		fprintf(stderr, "usage: %s [-frames N] [-scene name] [-baseline results.csv] [-threshold percent] [-hugepages]\n"
+				"       %s -worldgen\n"
+				"       %s -checkworld\n"
+				"       %s -tilescan\n"
+				"       %s -dirtypages\n", Args[0], Args[0], Args[0], Args[0], Args[0]);
+		return 2;
+	}
+
+	if(TimeWorldGeneration)
+	{
+		printf("scene,metric,value\n");
+		int Result = BenchWorldGeneration() ? 0 : 1;
+		return Result;
+	}
+	if(CheckLazyWorld)
+	{
+		printf("scene,metric,value\n");
+		int Result = BenchCheckLazyWorld() ? 0 : 1;
+		return Result;
+	}
+	if(CompareTileScans)
+	{
+		printf("scene,metric,value\n");
+		int Result = BenchTileScan() ? 0 : 1;
+		return Result;
+	}
+	if(TimeDirtyPages)
+	{
+		printf("scene,metric,value\n");
+		int Result = BenchDirtyPages() ? 0 : 1;
+		return Result;
+	}
+
+	char *Baseline = 0;
+	if(BaselineFilename)
+	{
+		debug_read_file_result File = DEBUGPlatformReadEntireFile(0, BaselineFilename);
+		if(!File.Contents)
+		{
+			fprintf(stderr, "%s: could not read the baseline\n", BaselineFilename);
+			return 2;
+		}
+		Baseline = (char *)malloc(File.ContentsSize + 1);
+		memcpy(Baseline, File.Contents, File.ContentsSize);
+		Baseline[File.ContentsSize] = 0;
+		DEBUGPlatformFreeFileMemory(0, File.Contents);
+	}
+
+	bench_perf_counter TLBCounter = BenchOpenTLBCounter();
+	if(!TLBCounter.IsValid)
+	{
+		fprintf(stderr, "no dTLB or cache miss counters on this machine, times only\n");
+	}
+	BenchClosePerfCounter(&TLBCounter);
+
+	int Result = 0;
+	uint32 SceneRunCount = 0;
+	printf("scene,metric,value\n");
+	for(uint32 SceneIndex = 0; SceneIndex < ArrayCount(BenchScenes); ++SceneIndex)
+	{
+		bench_scene *Scene = BenchScenes + SceneIndex;
+		if(SceneFilter && (strcmp(SceneFilter, Scene->Name) != 0))
+		{
+			continue;
+		}
+		++SceneRunCount;
+
+		bench_scene_results Results = {};
+		if(!BenchRunScene(Scene, FrameCount, UseLargePages, &Results))
+		{
+			fprintf(stderr, "%s: could not allocate game memory\n", Scene->Name);
+			return 2;
+		}
+		if(Results.BitmapsMissing)
+		{
+			fprintf(stderr, "%s: the game's bitmaps did not load, run the bench from handmade/data\n", Scene->Name);
+			return 2;
+		}
+
+		for(uint32 ResultIndex = 0; ResultIndex < Results.ResultCount; ++ResultIndex)
+		{
+			bench_result *SceneResult = Results.Results + ResultIndex;
+			printf("%s,%s,%.4f\n", Scene->Name, SceneResult->Name, SceneResult->Value);
+		}
+		fflush(stdout);
+
+		real64 Median = Results.Results[0].Value;
+		fprintf(stderr, "%-16s median %7.3fms p99 %7.3fms mean %7.3fms", Scene->Name, Median,
+				Results.Results[1].Value, Results.Results[2].Value);
+		if(Baseline)
+		{
+			real64 BaselineMedian = BenchFindBaseline(Baseline, Scene->Name, "median_ms");
+			if(BaselineMedian > 0.0)
+			{
+				real64 ChangePercent = 100.0*(Median - BaselineMedian) / BaselineMedian;
+				bool32 Regressed = (ChangePercent > ThresholdPercent);
+				fprintf(stderr, ", baseline %7.3fms (%+.1f%%)%s", BaselineMedian, ChangePercent,
+						Regressed ? " REGRESSED" : "");
+				if(Regressed)
+				{
+					Result = 1;
+				}
+			}
+			else
+			{
+				fprintf(stderr, ", not in the baseline");
+			}
+		}
+		fprintf(stderr, "\n");
+	}
+
+	if(!SceneRunCount)
+	{
+		fprintf(stderr, "no scene called %s\n", SceneFilter);
+		Result = 2;
+	}
+
+	return Result;
+}
@@ -1,40 +1,14 @@
 #include "handmade.h"
 
 #include "handmade_tile.cpp"
+#include "handmade_audio.cpp"
 #include <stdio.h>
 
-internal void GameOutputSound(game_sound_output_buffer *SoundBuffer, game_state *GameState)
-{	
-	int16 ToneVolume = 3000; 	
-	//int WavePeriod = SoundBuffer->SamplesPerSecond / GameState->ToneHz;
-
-	int16 *SampleOut = SoundBuffer->Samples;
-
-	for (int SampleIndex = 0; SampleIndex < SoundBuffer->SampleCount; SampleIndex++)
-	{
-		// Region 1			
-#if 0
-		real32 SineValue = sinf(GameState->tSine);
-		int16 SampleValue = (int16)(SineValue * ToneVolume);
-#else 
-		int16 SampleValue = 0;
-#endif
-		*SampleOut++ = SampleValue;
-		*SampleOut++ = SampleValue;
-
-#if 0
-		GameState->tSine += 2.0f*PI/(real32)WavePeriod;	
-		if(GameState->tSine > (2.0f*PI))
-		{
-			GameState->tSine -= (2.0f*PI);
-		}	
-#endif
-	}
-}
-
-internal void DrawRectangle(game_offscreen_buffer *Buffer, v2 vMin, v2 vMax, RGBReal RGB)
+// NOTE: Alpha below 1 blends the color over what is already there
+internal void DrawRectangle(game_offscreen_buffer *Buffer, v2 vMin, v2 vMax, RGBReal RGB, real32 Alpha = 1.0f)
 {
-	
+	TIMED_FUNCTION();
+
 	int32 MinX = RoundReal32ToInt32(fClamp(vMin.X, 0.0f, (real32)Buffer->Width));
 	int32 MaxX = RoundReal32ToInt32(fClamp(vMax.X, 0.0f, (real32)Buffer->Width));
 
@@ -43,13 +17,38 @@ internal void DrawRectangle(game_offscreen_buffer *Buffer, v2 vMin, v2 vMax, RGB
 
 	uint32 Color = RGBReal32ToUInt32(RGB.d[0], RGB.d[1], RGB.d[2]);
 	
-	for(int Y = MinY; Y < MaxY; Y++)
-	{		
-		uint8 *Pixel = ((uint8 *)Buffer->Memory + MinX*Buffer->BytesPerPixel + Y*Buffer->Pitch);
-		for(int X = MinX; X < MaxX; X++)
-		{
-			*(uint32 *)Pixel = Color;
-			Pixel += Buffer->BytesPerPixel;
+	if(Alpha >= 1.0f)
+	{
+		for(int Y = MinY; Y < MaxY; Y++)
+		{		
+			uint8 *Pixel = ((uint8 *)Buffer->Memory + MinX*Buffer->BytesPerPixel + Y*Buffer->Pitch);
+			for(int X = MinX; X < MaxX; X++)
+			{
+				*(uint32 *)Pixel = Color;
+				Pixel += Buffer->BytesPerPixel;
+			}
+		}
+	}
+	else
+	{
+		real32 SR = Alpha*(real32)((Color >> 16) & 0xFF);
+		real32 SG = Alpha*(real32)((Color >> 8) & 0xFF);
+		real32 SB = Alpha*(real32)((Color >> 0) & 0xFF);
+		for(int Y = MinY; Y < MaxY; Y++)
+		{		
+			uint32 *Pixel = (uint32 *)((uint8 *)Buffer->Memory + MinX*Buffer->BytesPerPixel + Y*Buffer->Pitch);
+			for(int X = MinX; X < MaxX; X++)
+			{
+				real32 DR = (real32)((*Pixel >> 16) & 0xFF);
+				real32 DG = (real32)((*Pixel >> 8) & 0xFF);
+				real32 DB = (real32)((*Pixel >> 0) & 0xFF);
+
+				*Pixel = ((*Pixel & 0xFF000000) |
+						  ((uint32)((1.0f - Alpha)*DR + SR + 0.5f) << 16) |
+						  ((uint32)((1.0f - Alpha)*DG + SG + 0.5f) << 8) |
+						  (uint32)((1.0f - Alpha)*DB + SB + 0.5f));
+				++Pixel;
+			}
 		}
 	}
 }
@@ -80,16 +79,15 @@ struct bitmap_header
 };
 #pragma pack(pop)
 
-internal loaded_bitmap DEBUGLoadBMP(thread_context *Thread, debug_platform_read_entire_file *ReadEntireFile, char *Filename)
+internal loaded_bitmap DEBUGLoadBMP(thread_context *Thread, game_memory *Memory, memory_arena *Arena, char *Filename)
 {
 	loaded_bitmap Result = {};
 
-	debug_read_file_result ReadResult = ReadEntireFile(Thread, Filename);	
+	debug_read_file_result ReadResult = Memory->DEBUGPlatformReadEntireFile(Thread, Filename);	
 	if(ReadResult.ContentsSize != 0)
 	{
 		bitmap_header *Header = (bitmap_header *)ReadResult.Contents;
 		uint32 *Pixels = (uint32*)((uint8 *)ReadResult.Contents + Header->BitmapOffset);
-		Result.Pixels = Pixels;
 		Result.Width = Header->Width;
 		Result.Height = Header->Height;
 
@@ -97,55 +95,86 @@ internal loaded_bitmap DEBUGLoadBMP(thread_context *Thread, debug_platform_read_
 		// and the height will be negative for top down
 		// Also, there can be compression, etc. Not complete BMP loading code.				
 
-		// Early break if compression value is not 3
-		if(Header->Compression != 3) return Result;
-
-
-		// NOTE: Byte order in memory is determined by the Header itself when compression = 3,
-		// we have to read out the masks and convert the pixels ourselves
-		uint32 RedMask = Header->RedMask;
-		uint32 GreenMask = Header->GreenMask;
-		uint32 BlueMask = Header->BlueMask;
-		uint32 AlphaMask = ~(RedMask | GreenMask | BlueMask);
-
-		bit_scan_result RedScan = FindLeastSignificantSetBit(RedMask);
-		bit_scan_result GreenScan = FindLeastSignificantSetBit(GreenMask);
-		bit_scan_result BlueScan = FindLeastSignificantSetBit(BlueMask);
-		bit_scan_result AlphaScan = FindLeastSignificantSetBit(AlphaMask);		
-
-		Assert(RedScan.Found);
-		Assert(GreenScan.Found);
-		Assert(BlueScan.Found);
-		Assert(AlphaScan.Found);
-		
-		int32 RedShift = 16 - (int32)RedScan.Index;
-		int32 GreenShift = 8 - (int32)GreenScan.Index;
-		int32 BlueShift = 0 - (int32)BlueScan.Index;
-		int32 AlphaShift = 24 - (int32)AlphaScan.Index;
-
-		uint32 *SourceDest = Pixels;
-		for(int32 Y = 0; Y < Header->Height; Y++)
+		if(Header->Compression == 3)
 		{
-			for(int32 X = 0; X < Header->Width; X++)
-			{
-				uint32 C = *SourceDest;
+			// NOTE: Byte order in memory is determined by the Header itself when compression = 3,
+			// we have to read out the masks and convert the pixels ourselves
+			uint32 RedMask = Header->RedMask;
+			uint32 GreenMask = Header->GreenMask;
+			uint32 BlueMask = Header->BlueMask;
+			uint32 AlphaMask = ~(RedMask | GreenMask | BlueMask);
+
+			bit_scan_result RedScan = FindLeastSignificantSetBit(RedMask);
+			bit_scan_result GreenScan = FindLeastSignificantSetBit(GreenMask);
+			bit_scan_result BlueScan = FindLeastSignificantSetBit(BlueMask);
+			bit_scan_result AlphaScan = FindLeastSignificantSetBit(AlphaMask);		
+
+			Assert(RedScan.Found);
+			Assert(GreenScan.Found);
+			Assert(BlueScan.Found);
+			Assert(AlphaScan.Found);
+			
+			int32 RedShift = 16 - (int32)RedScan.Index;
+			int32 GreenShift = 8 - (int32)GreenScan.Index;
+			int32 BlueShift = 0 - (int32)BlueScan.Index;
+			int32 AlphaShift = 24 - (int32)AlphaScan.Index;
 
-				uint32 Result = _rotl(RedMask, RedShift);
+			uint32 *SourceDest = Pixels;
+			for(int32 Y = 0; Y < Header->Height; Y++)
+			{
+				for(int32 X = 0; X < Header->Width; X++)
+				{
+					uint32 C = *SourceDest;
 
-				*SourceDest++ = (RotateLeft(C & RedMask, RedShift) |
-								RotateLeft(C & GreenMask, GreenShift) | 
-								RotateLeft(C & BlueMask, BlueShift) | 
-								RotateLeft(C & AlphaMask, AlphaShift));	
+					*SourceDest++ = (RotateLeft(C & RedMask, RedShift) |
+									RotateLeft(C & GreenMask, GreenShift) | 
+									RotateLeft(C & BlueMask, BlueShift) | 
+									RotateLeft(C & AlphaMask, AlphaShift));	
+				}
 			}
 		}
+
+		// NOTE: Pixels are copied into game memory so a snapshot of game memory is complete on
+		// its own and can be restored in another process
+		uint32 PixelCount = (uint32)(Result.Width*Result.Height);
+		Result.Pixels = PushArray(Arena, PixelCount, uint32);
+		for(uint32 PixelIndex = 0; PixelIndex < PixelCount; PixelIndex++)
+		{
+			Result.Pixels[PixelIndex] = Pixels[PixelIndex];
+		}
+
+		Memory->DEBUGPlatformFreeFileMemory(Thread, ReadResult.Contents);
 	}	
 
+	return Result;
+}
+
+// NOTE: Stand-in until sounds are loaded from files, a mono tone with a short attack and an
+// exponential decay
+internal loaded_sound DEBUGMakeTestTone(memory_arena *Arena, uint32 SamplesPerSecond, real32 ToneHz, real32 Seconds)
+{
+	loaded_sound Result = {};
+	Result.SampleCount = (uint32)(Seconds*(real32)SamplesPerSecond);
+	Result.ChannelCount = 1;
+	Result.SamplesPerSecond = SamplesPerSecond;
+	Result.Samples[0] = PushArray(Arena, Result.SampleCount, int16);
+
+	real32 AttackSamples = 0.005f*(real32)SamplesPerSecond;
+	real32 DecayPerSample = 5.0f / (real32)Result.SampleCount;
+	for(uint32 SampleIndex = 0; SampleIndex < Result.SampleCount; ++SampleIndex)
+	{
+		real32 t = (real32)SampleIndex;
+		real32 Envelope = fClamp(t / AttackSamples, 0.0f, 1.0f)*expf(-t*DecayPerSample);
+		real32 SineValue = Sin(2.0f*PI*ToneHz*t / (real32)SamplesPerSecond);
+		Result.Samples[0][SampleIndex] = (int16)(6000.0f*Envelope*SineValue);
+	}
 
 	return Result;
 }
 
 internal void DrawBitmap(game_offscreen_buffer *Buffer, loaded_bitmap *Bitmap, real32 RealX, real32 RealY, int32 AlignX = 0, int32 AlignY = 0)
 {	
+	TIMED_FUNCTION();
 
 	RealX -= (real32)AlignX;
 	RealY -= (real32)AlignY;	
@@ -216,7 +245,7 @@ internal void DrawBitmap(game_offscreen_buffer *Buffer, loaded_bitmap *Bitmap, r
 internal entity* GetEntity(game_state *GameState, uint32 Index)
 {
 	entity *Entity = 0;
-	if((Index > 0) & (Index < ArrayCount(GameState->Entities)))
+	if((Index > 0) & (Index < GameState->EntityCount))
 	{
 		Entity = &GameState->Entities[Index];
 	}
@@ -227,7 +256,7 @@ internal entity* GetEntity(game_state *GameState, uint32 Index)
 internal uint32 AddEntity(game_state *GameState)
 {
 	uint32 EntityIndex = GameState->EntityCount++;
-	Assert(GameState->EntityCount < ArrayCount(GameState->Entities));
+	Assert(GameState->EntityCount <= MAX_ENTITY_COUNT);
 	entity *Entity = &GameState->Entities[EntityIndex];
 	*Entity = {};
 
@@ -242,6 +271,7 @@ internal void InitializePlayer(game_state *GameState, uint32 EntityIndex)
 	Entity->P.AbsTileY = 3;
 	Entity->P.Offset_.X = 0;
 	Entity->P.Offset_.Y = 0;
+	Entity->PrevP = Entity->P;
 	Entity->Height = 1.4f;
 	Entity->Width = Entity->Height*0.75f;
 
@@ -272,6 +302,7 @@ internal void TestWall(real32 Wall, real32 RelX, real32 RelY, real32 PlayerDelta
 
 internal void MovePlayer(game_state *GameState, entity *Entity, real32 dt, v2 ddP)
 {	
+	TIMED_FUNCTION();
 	tile_map *TileMap = GameState->World->TileMap;
 
 	real32 ddPLength2 = LengthSq(ddP);
@@ -461,388 +492,1412 @@ internal void MovePlayer(game_state *GameState, entity *Entity, real32 dt, v2 dd
 }
 
 
-// extern "C": Prevents name mangling of compiled function
-extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
-{    
-
-	// Assert that the Buttons[] and button struct in the game_controller_input are identical sizes
-	// Take the last know button, subtract the base address, and the value should be equal the the number of entries
-	Assert((&Input->Controllers[0].Start - &Input->Controllers[0].Buttons[0]) == 
-			(ArrayCount(Input->Controllers[0].Buttons) - 1));
-
-	// Assert that our game state will fit in the allocated permanent memory
-	Assert(sizeof(game_state) <= Memory->PermanentStorageSize);	
-
-	game_state *GameState = (game_state*)Memory->PermanentStorage;
-	if(!Memory->IsInitialized)
-	{	
-		//NOTE:  Reserve slot 0	for null entity
-		AddEntity(GameState);
-
-		GameState->Backdrop = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_background.bmp");
-
-		hero_bitmaps *Bitmap;
-
-		Bitmap = &GameState->HeroBitmaps[0];
-		Bitmap->Head = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_right_head.bmp");
-		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_right_cape.bmp");
-		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_right_torso.bmp");
-		Bitmap->AlignX = 76;
-		Bitmap->AlignY = 182;		
-
-		Bitmap++;
-		Bitmap->Head = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_back_head.bmp");
-		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_back_cape.bmp");
-		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_back_torso.bmp");
-		Bitmap->AlignX = 71;
-		Bitmap->AlignY = 181;				
-
-		Bitmap++;
-		Bitmap->Head = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_left_head.bmp");
-		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_left_cape.bmp");
-		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_left_torso.bmp");
-		Bitmap->AlignX = 66;
-		Bitmap->AlignY = 181;					
-
-		Bitmap++;
-		Bitmap->Head = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_front_head.bmp");
-		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_front_cape.bmp");
-		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory->DEBUGPlatformReadEntireFile, "test/test_hero_front_torso.bmp");
-		Bitmap->AlignX = 71;
-		Bitmap->AlignY = 181;					
-
-		GameState->CameraP.AbsTileX = 17/2;
-		GameState->CameraP.AbsTileY = 9/2;				
-
-		InitializeArena(&GameState->WorldArena, Memory->PermanentStorageSize - sizeof(game_state), 
-						(uint8 *)Memory->PermanentStorage + sizeof(game_state));
-
-		GameState->World = PushStruct(&GameState->WorldArena, world);
-		world *World = GameState->World;
-		World->TileMap = PushStruct(&GameState->WorldArena, tile_map);
-
-		tile_map *TileMap = World->TileMap;
-
-		// Set to using 256x256 Tile Chunks
-		TileMap->ChunkShift = 4;
-		TileMap->ChunkMask = (0x1 << TileMap->ChunkShift) - 1; // bit magic B)
-		TileMap->ChunkDim = 0x1 << TileMap->ChunkShift;
-
-		TileMap->TileChunkCountX = 128;
-		TileMap->TileChunkCountY = 128;
-		TileMap->TileChunkCountZ = 2;
-
-		TileMap->TileChunks = PushArray(&GameState->WorldArena, 
-										TileMap->TileChunkCountX*TileMap->TileChunkCountY*TileMap->TileChunkCountZ, 
-										tile_chunk);
-
-		TileMap->TileSideInMeters = 1.4f;					
-
-		uint32 TilesPerWidth = 17;
-		uint32 TilesPerHeight = 9;
-
+internal void PlanWorldRooms(world_gen *Gen)
+{
 // TODO wait for full sparseness
 #if 0
-		uint32 ScreenX = INT32_MAX / 2;
-		uint32 ScreenY = INT32_MAX / 2;
+	uint32 ScreenX = INT32_MAX / 2;
+	uint32 ScreenY = INT32_MAX / 2;
 #else
-		uint32 ScreenX = 0;
-		uint32 ScreenY = 0;
+	uint32 ScreenX = 0;
+	uint32 ScreenY = 0;
 #endif
-		uint32 RandomNumberIndex = 0;
-		bool32 DoorLeft = false;
-		bool32 DoorRight = false;
-		bool32 DoorTop = false;
-		bool32 DoorBottom = false;
-		bool32 DoorUp = false;
-		bool32 DoorDown = false;
-		uint32 AbsTileZ = 0;
-		for(uint32 ScreenIndex = 0; ScreenIndex < 100; ScreenIndex++)
-		{
-			// TODO Random Number Generator
-			Assert(RandomNumberIndex < ArrayCount(RandomNumberTable));
-			uint32 RandomChoice;
-			if(DoorUp || DoorDown)
-			{
-				RandomChoice = RandomNumberTable[RandomNumberIndex++] % 2;
-			}
-			else{
-				RandomChoice = RandomNumberTable[RandomNumberIndex++] % 3;
-			}
+	bool32 DoorLeft = false;
+	bool32 DoorRight = false;
+	bool32 DoorTop = false;
+	bool32 DoorBottom = false;
+	bool32 DoorUp = false;
+	bool32 DoorDown = false;
+	uint32 AbsTileZ = 0;
+	for(uint32 RoomIndex = 0; RoomIndex < Gen->RoomCount; RoomIndex++)
+	{
+		// NOTE: Every room draws from its own series, so the layout doesn't depend on draw order
+		random_series Series = RandomSeed(RoomIndex);
+		uint32 DoorChoice;
+		if(DoorUp || DoorDown)
+		{
+			DoorChoice = RandomChoice(&Series, 2);
+		}
+		else
+		{
+			DoorChoice = RandomChoice(&Series, 3);
+		}
 
-			bool32 CreatedZDoor = false;
-			if(RandomChoice == 2)
-			{
-				CreatedZDoor = true;
-				if(AbsTileZ == 0)
-				{
-					DoorUp = true;
-				}
-				else{
-					DoorDown = true;
-				}
-			}
-			else if(RandomChoice == 1)
+		bool32 CreatedZDoor = false;
+		if(DoorChoice == 2)
+		{
+			CreatedZDoor = true;
+			if(AbsTileZ == 0)
 			{
-				DoorRight = true;
+				DoorUp = true;
 			}
 			else
 			{
-				DoorTop = true;
+				DoorDown = true;
 			}
-			
-			for(uint32 TileY = 0; TileY < TilesPerHeight; TileY++)
-			{
-				for(uint32 TileX = 0; TileX < TilesPerWidth; TileX++)
-				{
-					uint32 AbsTileX = ScreenX*TilesPerWidth + TileX;
-					uint32 AbsTileY = ScreenY*TilesPerHeight + TileY;					
+		}
+		else if(DoorChoice == 1)
+		{
+			DoorRight = true;
+		}
+		else
+		{
+			DoorTop = true;
+		}
 
-					uint32 TileValue = 1;
-					if((TileX == 0) && (!DoorLeft || (TileY != (TilesPerHeight/2))))
-					{
-						TileValue = 2;					
-					}
-					if((TileX == (TilesPerWidth - 1)) && (!DoorRight || (TileY != (TilesPerHeight/2))))
-					{
-						TileValue = 2;					
-					}								
-					if((TileY == 0) && (!DoorBottom ||TileX != (TilesPerWidth/2)))
-					{						
-						TileValue = 2;							
-					}					
-					if((TileY == (TilesPerHeight - 1)) && (!DoorTop ||TileX != (TilesPerWidth/2)))
-					{						
-						TileValue = 2;							
-					}
+		world_room *Room = Gen->Rooms + RoomIndex;
+		Room->ScreenX = ScreenX;
+		Room->ScreenY = ScreenY;
+		Room->AbsTileZ = AbsTileZ;
+		Room->DoorLeft = DoorLeft;
+		Room->DoorRight = DoorRight;
+		Room->DoorTop = DoorTop;
+		Room->DoorBottom = DoorBottom;
+		Room->DoorUp = DoorUp;
+		Room->DoorDown = DoorDown;
+
+		DoorLeft = DoorRight;
+		DoorBottom = DoorTop;
+
+		if(CreatedZDoor)
+		{			
+			DoorDown = !DoorDown;
+			DoorUp = !DoorUp;
+		}
+		else
+		{
+			DoorUp = false;
+			DoorDown = false;
+		}
 
-					if((TileX == 10) && (TileY == 6))
-					{
-						if(DoorUp)
-						{
-							TileValue = 3;
-						}
-						
-						if(DoorDown)
-						{
-							TileValue = 4;
-						}
-						
-					}	
-					SetTileValue(&GameState->WorldArena, World->TileMap, 
-								AbsTileX, AbsTileY, AbsTileZ,
-								TileValue);
-				}
-			}
-			
-			DoorLeft = DoorRight;
-			DoorBottom = DoorTop;
+		DoorRight = false;
+		DoorTop = false;
 
-			if(CreatedZDoor)
-			{			
-				DoorDown = !DoorDown;
-				DoorUp = !DoorUp;
+		if(DoorChoice == 2)
+		{
+			if(AbsTileZ == 0)
+			{
+				AbsTileZ = 1;
 			}
 			else
 			{
-				DoorUp = false;
-				DoorDown = false;
+				AbsTileZ = 0;
 			}
+		}
+		else if(DoorChoice == 1)
+		{
+			ScreenX += 1;
+		}
+		else
+		{
+			ScreenY += 1;
+		}
+	}
+}
+
+inline uint32 GetRoomTileValue(world *World, world_room *Room, uint32 TileX, uint32 TileY)
+{
+	uint32 TilesPerWidth = World->TilesPerWidth;
+	uint32 TilesPerHeight = World->TilesPerHeight;
+
+	uint32 TileValue = 1;
+	if((TileX == 0) && (!Room->DoorLeft || (TileY != (TilesPerHeight/2))))
+	{
+		TileValue = 2;					
+	}
+	if((TileX == (TilesPerWidth - 1)) && (!Room->DoorRight || (TileY != (TilesPerHeight/2))))
+	{
+		TileValue = 2;					
+	}								
+	if((TileY == 0) && (!Room->DoorBottom || TileX != (TilesPerWidth/2)))
+	{						
+		TileValue = 2;							
+	}					
+	if((TileY == (TilesPerHeight - 1)) && (!Room->DoorTop || TileX != (TilesPerWidth/2)))
+	{						
+		TileValue = 2;							
+	}
 
-			DoorRight = false;
-			DoorTop = false;
+	if((TileX == 10) && (TileY == 6))
+	{
+		if(Room->DoorUp)
+		{
+			TileValue = 3;
+		}
 		
-			if(RandomChoice == 2)
-			{
-				if(AbsTileZ == 0)
-				{
-					AbsTileZ = 1;
-				}
-				else
-				{
-					AbsTileZ = 0;
-				}
-			}
-			else if(RandomChoice == 1)
-			{
-				ScreenX += 1;
-			}
-			else{
-				ScreenY += 1;
-			}
+		if(Room->DoorDown)
+		{
+			TileValue = 4;
 		}
+	}
 
-		Memory->IsInitialized = true;
-	}						
+	return TileValue;
+}
 
-	world *World = GameState->World;
-	tile_map *TileMap = World->TileMap;
+internal PLATFORM_WORK_QUEUE_CALLBACK(FillWorldChunks)
+{
+	TIMED_FUNCTION();
 
-	int32 TileSideInPixels = 60;
-	real32 MetersToPixels = (real32)(TileSideInPixels / TileMap->TileSideInMeters);	
+	world_gen_work *Work = (world_gen_work *)Data;
+	world_gen *Gen = Work->Gen;
+	world *World = Gen->World;
+	tile_map *TileMap = Gen->TileMap;
 
-	for(int ControllerIndex = 0; ControllerIndex < ArrayCount(Input->Controllers); ++ControllerIndex)
-	{	
-		game_controller_input *Controller = GetController(Input, ControllerIndex);
-		entity *ControllingEntity = GetEntity(GameState, GameState->PlayerIndexForController[ControllerIndex]);
-		if(ControllingEntity)	
-		{
-			v2 ddP = {};
-			bool32 didInputMovement = false;
-			if(Controller->IsAnalog)
-			{	
-				// NOTE: analog movement tuning
-				ddP = V2(Controller->StickAverageX, Controller->StickAverageY);
-			}
-			else
-			{								
-				
-				if(Controller->MoveUp.EndedDown)
-				{
-					ddP.Y = 1.0f;		
-					didInputMovement = true;		
-				}
-				if(Controller->MoveDown.EndedDown)
-				{
-					ddP.Y = -1.0f;
-					didInputMovement = true;
-				}
-				if(Controller->MoveLeft.EndedDown)
-				{
-					ddP.X = -1.0f;
-					didInputMovement = true;
-				}
-				if(Controller->MoveRight.EndedDown)
-				{
-					ddP.X = 1.0f;
-					didInputMovement = true;
-				}							
-			}
+	for(uint32 ChunkIndex = Work->FirstChunk; ChunkIndex < Work->OnePastLastChunk; ChunkIndex++)
+	{
+		world_gen_chunk *GenChunk = Gen->Chunks + ChunkIndex;
+		for(world_gen_room_link *Link = GenChunk->FirstRoom; Link; Link = Link->Next)
+		{
+			world_room *Room = Gen->Rooms + Link->RoomIndex;
+			uint32 RoomMinX = Room->ScreenX*World->TilesPerWidth;
+			uint32 RoomMinY = Room->ScreenY*World->TilesPerHeight;
 
-			if(didInputMovement){
-				MovePlayer(GameState, ControllingEntity, Input->dtForFrame, ddP);
-			}			
-			else
+			// NOTE: Only touch the part of the room that lies inside this chunk
+			uint32 MinX = Maximum(RoomMinX, GenChunk->AbsTileMinX);
+			uint32 MinY = Maximum(RoomMinY, GenChunk->AbsTileMinY);
+			uint32 OnePastMaxX = Minimum(RoomMinX + World->TilesPerWidth, GenChunk->AbsTileMinX + TILE_CHUNK_DIM);
+			uint32 OnePastMaxY = Minimum(RoomMinY + World->TilesPerHeight, GenChunk->AbsTileMinY + TILE_CHUNK_DIM);
+
+			for(uint32 AbsTileY = MinY; AbsTileY < OnePastMaxY; AbsTileY++)
 			{
-				MovePlayer(GameState, ControllingEntity, Input->dtForFrame, ddP);
+				for(uint32 AbsTileX = MinX; AbsTileX < OnePastMaxX; AbsTileX++)
+				{
+					uint32 TileValue = GetRoomTileValue(World, Room, AbsTileX - RoomMinX, AbsTileY - RoomMinY);
+
+					// NOTE: Chunks were palettized up front, so this only allocates when a room
+					// brings more tile values than the palette holds
+					SetTileValueUnchecked(&World->ChunkArena, TileMap, GenChunk->TileChunk, 
+										  AbsTileX - GenChunk->AbsTileMinX, AbsTileY - GenChunk->AbsTileMinY,
+										  TileValue);
+				}
 			}
-		}		
-		else
-		{
-			if(Controller->Start.EndedDown)
-			{
-				uint32 EntityIndex = AddEntity(GameState);				
-				InitializePlayer(GameState, EntityIndex);
-				GameState->PlayerIndexForController[ControllerIndex] = EntityIndex;
-			}		
 		}
-	}	
+	}
+}
 
-	entity *CameraFollowingEntity = GetEntity(GameState, GameState->CameraFollowingEntityIndex);
-	if(CameraFollowingEntity)
-	{		
-		GameState->CameraP.AbsTileZ = CameraFollowingEntity->P.AbsTileZ;	
+/*
+	NOTE: Sizes the tile map to cover every planned room, never smaller than the 128 by 128 chunks
+	the other modes use. The chunk table may take up to a quarter of what is left in the chunk
+	arena, and when the rooms need more than that the longer side is cut down until it fits and
+	GenerateWorld drops the rooms beyond the edge.
+*/
+internal void SizeTileMapForRooms(world_gen *Gen)
+{
+	world *World = Gen->World;
+	tile_map *TileMap = Gen->TileMap;
 
-		tile_map_difference Diff = Subtract(TileMap, &CameraFollowingEntity->P, &GameState->CameraP);
-		if(Diff.dXY.X > (9.0f*TileMap->TileSideInMeters))
-		{
-			GameState->CameraP.AbsTileX += 17;
-		}
-		if(Diff.dXY.X < -(9.0f*TileMap->TileSideInMeters))
+	uint32 MaxScreenX = 0;
+	uint32 MaxScreenY = 0;
+	for(uint32 RoomIndex = 0; RoomIndex < Gen->RoomCount; RoomIndex++)
+	{
+		world_room *Room = Gen->Rooms + RoomIndex;
+		MaxScreenX = Maximum(MaxScreenX, Room->ScreenX);
+		MaxScreenY = Maximum(MaxScreenY, Room->ScreenY);
+	}
+
+	uint64 ChunkCountX = (((uint64)MaxScreenX + 1)*World->TilesPerWidth + TILE_CHUNK_MASK) >> TILE_CHUNK_SHIFT;
+	uint64 ChunkCountY = (((uint64)MaxScreenY + 1)*World->TilesPerHeight + TILE_CHUNK_MASK) >> TILE_CHUNK_SHIFT;
+	ChunkCountX = Maximum(ChunkCountX, 128);
+	ChunkCountY = Maximum(ChunkCountY, 128);
+
+	memory_arena *Arena = &World->ChunkArena;
+	uint64 MaxChunkCount = ((Arena->Size - Arena->Used) / 4) / sizeof(tile_chunk);
+	while((ChunkCountX*ChunkCountY*TileMap->TileChunkCountZ > MaxChunkCount) &&
+		  ((ChunkCountX > 128) || (ChunkCountY > 128)))
+	{
+		if(ChunkCountX > ChunkCountY)
 		{
-			GameState->CameraP.AbsTileX -= 17;
+			ChunkCountX = Maximum(ChunkCountX - ChunkCountX / 8 - 1, 128);
 		}
-		if(Diff.dXY.Y > (5.0f*TileMap->TileSideInMeters))
+		else
 		{
-			GameState->CameraP.AbsTileY += 9;
+			ChunkCountY = Maximum(ChunkCountY - ChunkCountY / 8 - 1, 128);
 		}
-		if(Diff.dXY.Y < -(5.0f*TileMap->TileSideInMeters))
-		{
-			GameState->CameraP.AbsTileY -= 9;
-		}		
-	}	
+	}
 
-	// NOTE: Render
-	DrawBitmap(Buffer, &GameState->Backdrop, 0.0f, 0.0f);
+	TileMap->TileChunkCountX = (uint32)ChunkCountX;
+	TileMap->TileChunkCountY = (uint32)ChunkCountY;
+	TileMap->TileChunks = PushArrayAtomic(Arena, ChunkCountX*ChunkCountY*TileMap->TileChunkCountZ, tile_chunk);
+}
+
+inline world_gen_chunk_slot *GetWorldGenChunkSlot(world_gen *Gen, uint32 TileChunkIndex)
+{
+	uint32 SlotIndex = (TileChunkIndex*2654435761u) & Gen->ChunkSlotMask;
+	world_gen_chunk_slot *Slot = Gen->ChunkSlots + SlotIndex;
+	while(Slot->TileChunkIndexPlusOne && (Slot->TileChunkIndexPlusOne != (TileChunkIndex + 1)))
+	{
+		SlotIndex = (SlotIndex + 1) & Gen->ChunkSlotMask;
+		Slot = Gen->ChunkSlots + SlotIndex;
+	}
+
+	return Slot;
+}
 
-	real32 ScreenCenterX = 0.5f*(real32)Buffer->Width;
-	real32 ScreenCenterY = 0.5f*(real32)Buffer->Height;
+/*
+	NOTE: World generation runs in two passes. The serial pass plans the room layout and
+	door connectivity, sizes the tile map to it, then creates every tile chunk a room touches
+	(the only place that allocates). The parallel pass fills chunks, and since each chunk belongs
+	to exactly one work entry the result is identical no matter how many threads run it.
+	Everything the serial pass keeps grows with the room count, not with the size of the map.
+*/
+internal void GenerateWorld(game_memory *Memory, world *World, memory_arena *TempArena, uint32 RoomCount)
+{
+	TIMED_FUNCTION();
 
-	for(int32 RelRow = -10; RelRow < 10; RelRow++)
+	temporary_memory GenMemory = BeginTemporaryMemory(TempArena);
+
+	tile_map *TileMap = World->TileMap;
+	world_gen Gen = {};
+	Gen.World = World;
+	Gen.TileMap = TileMap;
+	Gen.RoomCount = RoomCount;
+	Gen.Rooms = PushArray(TempArena, RoomCount, world_room);
+
+	PlanWorldRooms(&Gen);
+	SizeTileMapForRooms(&Gen);
+
+	// NOTE: A room spans at most this many chunks, three by two for 17 by 9 tile rooms
+	uint32 MaxChunksPerRoom = (((World->TilesPerWidth - 1) >> TILE_CHUNK_SHIFT) + 2)*
+		(((World->TilesPerHeight - 1) >> TILE_CHUNK_SHIFT) + 2);
+	uint64 TotalChunkCount = (uint64)TileMap->TileChunkCountX*TileMap->TileChunkCountY*TileMap->TileChunkCountZ;
+	Gen.ChunkCapacity = (uint32)Minimum((uint64)RoomCount*MaxChunksPerRoom, TotalChunkCount);
+	Gen.Chunks = PushArray(TempArena, Gen.ChunkCapacity, world_gen_chunk);
+
+	// NOTE: At most half full
+	uint32 SlotCount = 1;
+	while(SlotCount < 2*Gen.ChunkCapacity)
 	{
-		for(int32 RelCol = -20; RelCol < 20; RelCol++)
-		{
+		SlotCount *= 2;
+	}
+	Gen.ChunkSlotMask = SlotCount - 1;
+	Gen.ChunkSlots = PushArray(TempArena, SlotCount, world_gen_chunk_slot);
+	for(uint32 SlotIndex = 0; SlotIndex < SlotCount; SlotIndex++)
+	{
+		Gen.ChunkSlots[SlotIndex].TileChunkIndexPlusOne = 0;
+	}
 
-			uint32 Col = RelCol + GameState->CameraP.AbsTileX;
-			uint32 Row = RelRow  + GameState->CameraP.AbsTileY;
-			uint32 TileID = GetTileValue(TileMap, Col, Row, GameState->CameraP.AbsTileZ);
-			if(TileID > 1){		
-				real32 Gray = 0.5f;				
-				if(TileID == 2)
-				{
-					Gray = 1.0f;
-				}	
-				if(TileID > 2)
+	World->DroppedRoomCount = 0;
+	for(uint32 RoomIndex = 0; RoomIndex < Gen.RoomCount; RoomIndex++)
+	{
+		world_room *Room = Gen.Rooms + RoomIndex;
+		uint32 RoomMinX = Room->ScreenX*World->TilesPerWidth;
+		uint32 RoomMinY = Room->ScreenY*World->TilesPerHeight;
+
+		// NOTE: Whatever part of a room is inside the map still gets filled
+		bool32 Dropped = false;
+		tile_chunk_position MinChunkP = GetChunkPositionFor(TileMap, RoomMinX, RoomMinY, Room->AbsTileZ);
+		tile_chunk_position MaxChunkP = GetChunkPositionFor(TileMap, RoomMinX + World->TilesPerWidth - 1,
+															RoomMinY + World->TilesPerHeight - 1, Room->AbsTileZ);
+		for(uint32 ChunkY = MinChunkP.TileChunkY; ChunkY <= MaxChunkP.TileChunkY; ChunkY++)
+		{
+			for(uint32 ChunkX = MinChunkP.TileChunkX; ChunkX <= MaxChunkP.TileChunkX; ChunkX++)
+			{
+				tile_chunk *TileChunk = GetTileChunk(TileMap, ChunkX, ChunkY, Room->AbsTileZ);
+				if(!TileChunk)
 				{
-					Gray = 0.2f;
-				}	
+					Dropped = true;
+					continue;
+				}
 
-				if((Row == GameState->CameraP.AbsTileY) && (Col == GameState->CameraP.AbsTileX))
+				world_gen_chunk_slot *Slot = GetWorldGenChunkSlot(&Gen, (uint32)(TileChunk - TileMap->TileChunks));
+				world_gen_chunk *GenChunk;
+				if(Slot->TileChunkIndexPlusOne)
 				{
-					Gray = 0.0f;
+					GenChunk = Gen.Chunks + Slot->GenChunkIndex;
 				}
+				else
+				{
+					Assert(Gen.ChunkCount < Gen.ChunkCapacity);
+					Slot->TileChunkIndexPlusOne = (uint32)(TileChunk - TileMap->TileChunks) + 1;
+					Slot->GenChunkIndex = Gen.ChunkCount;
 
-				
+					GenChunk = Gen.Chunks + Gen.ChunkCount++;
+					GenChunk->TileChunk = TileChunk;
+					GenChunk->AbsTileMinX = ChunkX*TILE_CHUNK_DIM;
+					GenChunk->AbsTileMinY = ChunkY*TILE_CHUNK_DIM;
+					GenChunk->FirstRoom = 0;
 
-				v2 HalfTileSide = {0.5f*TileSideInPixels, 0.5f*TileSideInPixels};
-				v2 Cen = {ScreenCenterX - MetersToPixels*GameState->CameraP.Offset_.X + (real32)RelCol*TileSideInPixels,
-							ScreenCenterY + MetersToPixels*GameState->CameraP.Offset_.Y - (real32)RelRow*TileSideInPixels};
-				v2 Min = Cen - HalfTileSide;				
-				v2 Max = Cen + HalfTileSide;				
-				RGBReal TileColor = {Gray, Gray, Gray};
-				DrawRectangle(Buffer, Min, Max, TileColor);
+					if(!TileChunk->Storage)
+					{
+						if(!TileChunk->UniformValue)
+						{
+							TileChunk->UniformValue = 1;
+						}
+						PalettizeTileChunk(&World->ChunkArena, TileMap, TileChunk);
+					}
+				}
+
+				world_gen_room_link *Link = PushStruct(TempArena, world_gen_room_link);
+				Link->RoomIndex = RoomIndex;
+				Link->Next = GenChunk->FirstRoom;
+				GenChunk->FirstRoom = Link;
 			}
 		}
-	}		
 
-	entity *Entity = GameState->Entities;
-	for(uint32 EntityIndex = 0; EntityIndex < GameState->EntityCount; EntityIndex++, ++Entity)
+		if(Dropped)
+		{
+			++World->DroppedRoomCount;
+		}
+	}
+
+	// NOTE: Split the chunks into a bounded number of entries so the queue can't overflow
+	uint32 WorkCount = Minimum(Gen.ChunkCount, 128);
+	world_gen_work *Works = PushArray(TempArena, WorkCount, world_gen_work);
+	for(uint32 WorkIndex = 0; WorkIndex < WorkCount; WorkIndex++)
+	{
+		world_gen_work *Work = Works + WorkIndex;
+		Work->Gen = &Gen;
+		Work->FirstChunk = (uint32)(((uint64)Gen.ChunkCount*WorkIndex) / WorkCount);
+		Work->OnePastLastChunk = (uint32)(((uint64)Gen.ChunkCount*(WorkIndex + 1)) / WorkCount);
+
+		if(Memory->PlatformAddEntry)
+		{
+			Memory->PlatformAddEntry(Memory->HighPriorityQueue, FillWorldChunks, Work);
+		}
+		else
+		{
+			FillWorldChunks(0, Work);
+		}
+	}
+	if(Memory->PlatformCompleteAllWork)
+	{
+		Memory->PlatformCompleteAllWork(Memory->HighPriorityQueue);
+	}
+
+	EndTemporaryMemory(GenMemory);
+}
+
+inline uint32 HashGridCoordinate(uint32 ScreenX, uint32 ScreenY, uint32 AbsTileZ, uint32 Salt)
+{
+	uint32 Result = (ScreenX*73856093) ^ (ScreenY*19349663) ^ (AbsTileZ*83492791) ^ (Salt*2654435761u);
+	return Result;
+}
+
+// NOTE: True one time in OneIn, always the same answer for the same coordinate
+internal bool32 GridRoll(uint32 ScreenX, uint32 ScreenY, uint32 AbsTileZ, uint32 Salt, uint32 OneIn)
+{
+	random_series Series = RandomSeed(HashGridCoordinate(ScreenX, ScreenY, AbsTileZ, Salt));
+	bool32 Result = (RandomChoice(&Series, OneIn) == 0);
+	return Result;
+}
+
+internal world_room GetGridRoom(tile_map *TileMap, uint32 ScreenX, uint32 ScreenY, uint32 AbsTileZ)
+{
+	world_room Room = {};
+	Room.ScreenX = ScreenX;
+	Room.ScreenY = ScreenY;
+	Room.AbsTileZ = AbsTileZ;
+
+	// NOTE: Each shared wall or stairwell is rolled once, by the room to the left, below or beneath,
+	// so both sides of a door always agree
+	Room.DoorRight = !GridRoll(ScreenX, ScreenY, AbsTileZ, 0, 3);
+	Room.DoorTop = !GridRoll(ScreenX, ScreenY, AbsTileZ, 1, 3);
+	Room.DoorLeft = (ScreenX > 0) && !GridRoll(ScreenX - 1, ScreenY, AbsTileZ, 0, 3);
+	Room.DoorBottom = (ScreenY > 0) && !GridRoll(ScreenX, ScreenY - 1, AbsTileZ, 1, 3);
+	Room.DoorUp = ((AbsTileZ + 1) < TileMap->TileChunkCountZ) && GridRoll(ScreenX, ScreenY, AbsTileZ, 2, 4);
+	Room.DoorDown = (AbsTileZ > 0) && GridRoll(ScreenX, ScreenY, AbsTileZ - 1, 2, 4);
+
+	return Room;
+}
+
+internal TILE_CHUNK_GENERATOR(GenerateGridTileChunk)
+{
+	TIMED_FUNCTION();
+
+	world *World = (world *)TileMap->GeneratorContext;
+
+	uint32 TileValues[TILE_CHUNK_DIM*TILE_CHUNK_DIM];
+
+	uint32 AbsTileMinX = TileChunkX*TILE_CHUNK_DIM;
+	uint32 AbsTileMinY = TileChunkY*TILE_CHUNK_DIM;
+	world_room Room = GetGridRoom(TileMap, AbsTileMinX / World->TilesPerWidth, 
+								  AbsTileMinY / World->TilesPerHeight, TileChunkZ);
+	for(uint32 TileY = 0; TileY < TILE_CHUNK_DIM; TileY++)
+	{
+		for(uint32 TileX = 0; TileX < TILE_CHUNK_DIM; TileX++)
+		{
+			uint32 AbsTileX = AbsTileMinX + TileX;
+			uint32 AbsTileY = AbsTileMinY + TileY;
+			uint32 ScreenX = AbsTileX / World->TilesPerWidth;
+			uint32 ScreenY = AbsTileY / World->TilesPerHeight;
+			if((ScreenX != Room.ScreenX) || (ScreenY != Room.ScreenY))
+			{
+				Room = GetGridRoom(TileMap, ScreenX, ScreenY, TileChunkZ);
+			}
+
+			TileValues[TileY*TILE_CHUNK_DIM + TileX] = 
+				GetRoomTileValue(World, &Room, AbsTileX - ScreenX*World->TilesPerWidth, 
+								 AbsTileY - ScreenY*World->TilesPerHeight);
+		}
+	}
+
+	StoreTileChunk(&World->ChunkArena, TileMap, TileChunk, TileValues);
+}
+
+internal void GenerateAllTileChunks(tile_map *TileMap)
+{
+	for(uint32 ChunkZ = 0; ChunkZ < TileMap->TileChunkCountZ; ChunkZ++)
+	{
+		for(uint32 ChunkY = 0; ChunkY < TileMap->TileChunkCountY; ChunkY++)
+		{
+			for(uint32 ChunkX = 0; ChunkX < TileMap->TileChunkCountX; ChunkX++)
+			{
+				tile_chunk *TileChunk = GetTileChunk(TileMap, ChunkX, ChunkY, ChunkZ);
+				EnsureTileChunkGenerated(TileMap, TileChunk, ChunkX, ChunkY, ChunkZ);
+			}
+		}
+	}
+}
+
+internal PLATFORM_WORK_QUEUE_CALLBACK(DoChunkPrefetch)
+{
+	TIMED_FUNCTION();
+	world_chunk_prefetch *Prefetch = (world_chunk_prefetch *)Data;
+	EnsureTileChunkGenerated(Prefetch->TileMap, Prefetch->TileChunk, 
+							 Prefetch->TileChunkX, Prefetch->TileChunkY, Prefetch->TileChunkZ);
+
+	CompletePreviousWritesBeforeFutureWrites;
+	Prefetch->InUse = false;
+}
+
+internal void PrefetchTileChunk(game_memory *Memory, world *World, int32 TileChunkX, int32 TileChunkY, uint32 TileChunkZ)
+{
+	tile_map *TileMap = World->TileMap;
+	tile_chunk *TileChunk = GetTileChunk(TileMap, TileChunkX, TileChunkY, TileChunkZ);
+	if(TileChunk && (TileChunk->State == TileChunkState_Ungenerated))
+	{
+		world_chunk_prefetch *Prefetch = 0;
+		for(uint32 PrefetchIndex = 0; PrefetchIndex < ArrayCount(World->Prefetches); PrefetchIndex++)
+		{
+			if(!World->Prefetches[PrefetchIndex].InUse)
+			{
+				Prefetch = World->Prefetches + PrefetchIndex;
+				break;
+			}
+		}
+
+		// NOTE: If every slot is busy the chunk just gets generated on first touch instead
+		if(Prefetch && QueueTileChunkGeneration(TileChunk))
+		{
+			Prefetch->InUse = true;
+			Prefetch->TileMap = TileMap;
+			Prefetch->TileChunk = TileChunk;
+			Prefetch->TileChunkX = TileChunkX;
+			Prefetch->TileChunkY = TileChunkY;
+			Prefetch->TileChunkZ = TileChunkZ;
+			Memory->PlatformAddEntry(Memory->LowPriorityQueue, DoChunkPrefetch, Prefetch);
+		}
+	}
+}
+
+// NOTE: Queues the band of chunks just past the edge of the rendered tile window in the
+// direction the camera is heading, so they're usually ready before they scroll into view. That
+// goes for every level drawn, LevelCount down to the camera's.
+internal void PrefetchChunksAhead(game_memory *Memory, world *World, tile_map_position CameraP, v2 Direction,
+								  int32 TileRadiusX, int32 TileRadiusY, uint32 LevelCount)
+{
+	tile_map *TileMap = World->TileMap;
+	int32 MinChunkX = ((int32)CameraP.AbsTileX - TileRadiusX) >> TILE_CHUNK_SHIFT;
+	int32 MinChunkY = ((int32)CameraP.AbsTileY - TileRadiusY) >> TILE_CHUNK_SHIFT;
+	int32 MaxChunkX = ((int32)CameraP.AbsTileX + TileRadiusX) >> TILE_CHUNK_SHIFT;
+	int32 MaxChunkY = ((int32)CameraP.AbsTileY + TileRadiusY) >> TILE_CHUNK_SHIFT;
+
+	uint32 Depth = Minimum(LevelCount, CameraP.AbsTileZ + 1) - 1;
+	for(uint32 Level = CameraP.AbsTileZ - Depth; Level <= CameraP.AbsTileZ; ++Level)
+	{
+		if(Direction.X != 0.0f)
+		{
+			int32 ChunkX = (Direction.X > 0.0f) ? (MaxChunkX + 1) : (MinChunkX - 1);
+			for(int32 ChunkY = MinChunkY - 1; ChunkY <= (MaxChunkY + 1); ChunkY++)
+			{
+				PrefetchTileChunk(Memory, World, ChunkX, ChunkY, Level);
+			}
+		}
+		if(Direction.Y != 0.0f)
+		{
+			int32 ChunkY = (Direction.Y > 0.0f) ? (MaxChunkY + 1) : (MinChunkY - 1);
+			for(int32 ChunkX = MinChunkX - 1; ChunkX <= (MaxChunkX + 1); ChunkX++)
+			{
+				PrefetchTileChunk(Memory, World, ChunkX, ChunkY, Level);
+			}
+		}
+	}
+}
+
+inline int32 FloorDivide(int32 Value, int32 Divisor)
+{
+	Assert(Divisor > 0);
+	int32 Result = Value / Divisor;
+	if((Value % Divisor) < 0)
+	{
+		--Result;
+	}
+	return Result;
+}
+
+inline int32 WrapIndex(int32 Value, int32 Count)
+{
+	int32 Result = Value % Count;
+	if(Result < 0)
+	{
+		Result += Count;
+	}
+	return Result;
+}
+
+// NOTE: The tiles with any pixel inside Width by Height world pixels from (OriginX, OriginY). Tiles
+// below 0 don't exist, the tile map would wrap their unsigned coordinates, so the rectangle stops
+// at 0 and is empty when all of it is below.
+internal tile_rect GetVisibleTileRect(int32 OriginX, int32 OriginY, int32 Width, int32 Height, int32 TileSideInPixels)
+{
+	tile_rect Result;
+
+	int32 HalfTileSide = TileSideInPixels / 2;
+	Result.MinCol = FloorDivide(OriginX + HalfTileSide, TileSideInPixels);
+	Result.MaxCol = FloorDivide(OriginX + Width - 1 + HalfTileSide, TileSideInPixels);
+	Result.MinRow = -FloorDivide(OriginY + Height - 1 + HalfTileSide, TileSideInPixels);
+	Result.MaxRow = -FloorDivide(OriginY + HalfTileSide, TileSideInPixels);
+	if(Result.MinCol < 0)
+	{
+		Result.MinCol = 0;
+	}
+	if(Result.MinRow < 0)
+	{
+		Result.MinRow = 0;
+	}
+
+	return Result;
+}
+
+// NOTE: Draws the backdrop and tiles for the world pixels from (OriginX, OriginY), the size of
+// Target. The backdrop repeats across the world rather than sitting still on the screen, so all
+// of it scrolls along with the tiles. The tiles are LevelCount levels down to AbsTileZ, deepest
+// first, as far as there are levels below it.
+internal void DrawTileLayer(game_offscreen_buffer *Target, int32 OriginX, int32 OriginY, game_state *GameState,
+							tile_map *TileMap, uint32 AbsTileZ, uint32 LevelCount, int32 TileSideInPixels)
+{
+	loaded_bitmap *Backdrop = &GameState->Backdrop;
+	if(Backdrop->Width && Backdrop->Height)
+	{
+		int32 FirstBackdropX = FloorDivide(OriginX, Backdrop->Width)*Backdrop->Width;
+		int32 FirstBackdropY = FloorDivide(OriginY, Backdrop->Height)*Backdrop->Height;
+		for(int32 BackdropY = FirstBackdropY; BackdropY < (OriginY + Target->Height); BackdropY += Backdrop->Height)
+		{
+			for(int32 BackdropX = FirstBackdropX; BackdropX < (OriginX + Target->Width); BackdropX += Backdrop->Width)
+			{
+				DrawBitmap(Target, Backdrop, (real32)(BackdropX - OriginX), (real32)(BackdropY - OriginY));
+			}
+		}
+	}
+
+	uint32 Depth = Minimum(LevelCount, AbsTileZ + 1) - 1;
+	int32 HalfTileSide = TileSideInPixels / 2;
+	tile_rect Tiles = GetVisibleTileRect(OriginX, OriginY, Target->Width, Target->Height, TileSideInPixels);
+	for(uint32 Level = AbsTileZ - Depth; Level <= AbsTileZ; ++Level)
+	{
+		real32 Alpha = 1.0f;
+		for(uint32 LevelBelow = Level; LevelBelow < AbsTileZ; ++LevelBelow)
+		{
+			Alpha *= LEVEL_FADE;
+		}
+
+		for(int32 Row = Tiles.MinRow; Row <= Tiles.MaxRow; ++Row)
+		{
+			for(int32 Col = Tiles.MinCol; Col <= Tiles.MaxCol; ++Col)
+			{
+				uint32 TileID = GetTileValue(TileMap, (uint32)Col, (uint32)Row, Level);
+				if(TileID > 1)
+				{
+					real32 Gray = 0.5f;
+					if(TileID == 2)
+					{
+						Gray = 1.0f;
+					}
+					if(TileID > 2)
+					{
+						Gray = 0.2f;
+					}
+
+					v2 Min = {(real32)(Col*TileSideInPixels - HalfTileSide - OriginX),
+							  (real32)(-Row*TileSideInPixels - HalfTileSide - OriginY)};
+					v2 Max = {Min.X + (real32)TileSideInPixels, Min.Y + (real32)TileSideInPixels};
+					RGBReal TileColor = {Gray, Gray, Gray};
+					DrawRectangle(Target, Min, Max, TileColor, Alpha);
+				}
+			}
+		}
+	}
+}
+
+internal void InitializeTileLayerCache(tile_layer_cache *Cache, memory_arena *Arena, int32 Width, int32 Height)
+{
+	*Cache = {};
+	if((Width > 0) && (Height > 0))
+	{
+		Cache->Width = Width;
+		Cache->Height = Height;
+		Cache->Pitch = Width*(int32)sizeof(uint32);
+		Cache->Pixels = PushArray(Arena, (memory_index)Width*Height, uint32);
+	}
+}
+
+// NOTE: Draws a rectangle of world pixels, at most the size of the cache, into wherever it wraps
+// around to in the cache
+internal void DrawTileLayerCacheRect(tile_layer_cache *Cache, int32 X, int32 Y, int32 Width, int32 Height, game_state *GameState,
+									 tile_map *TileMap, uint32 AbsTileZ, uint32 LevelCount, int32 TileSideInPixels)
+{
+	Assert((Width <= Cache->Width) && (Height <= Cache->Height));
+
+	int32 CacheX = WrapIndex(X, Cache->Width);
+	int32 CacheY = WrapIndex(Y, Cache->Height);
+	int32 FirstWidth = Minimum(Width, Cache->Width - CacheX);
+	int32 FirstHeight = Minimum(Height, Cache->Height - CacheY);
+
+	int32 PieceCacheX[2] = {CacheX, 0};
+	int32 PieceX[2] = {X, X + FirstWidth};
+	int32 PieceWidth[2] = {FirstWidth, Width - FirstWidth};
+	int32 PieceCacheY[2] = {CacheY, 0};
+	int32 PieceY[2] = {Y, Y + FirstHeight};
+	int32 PieceHeight[2] = {FirstHeight, Height - FirstHeight};
+	for(uint32 PieceIndexY = 0; PieceIndexY < 2; ++PieceIndexY)
+	{
+		for(uint32 PieceIndexX = 0; PieceIndexX < 2; ++PieceIndexX)
+		{
+			if((PieceWidth[PieceIndexX] > 0) && (PieceHeight[PieceIndexY] > 0))
+			{
+				game_offscreen_buffer Piece = {};
+				Piece.Memory = (uint8 *)Cache->Pixels + PieceCacheY[PieceIndexY]*Cache->Pitch + PieceCacheX[PieceIndexX]*sizeof(uint32);
+				Piece.Width = PieceWidth[PieceIndexX];
+				Piece.Height = PieceHeight[PieceIndexY];
+				Piece.Pitch = Cache->Pitch;
+				Piece.BytesPerPixel = (int32)sizeof(uint32);
+				DrawTileLayer(&Piece, PieceX[PieceIndexX], PieceY[PieceIndexY], GameState, TileMap, AbsTileZ, LevelCount,
+							  TileSideInPixels);
+
+				Cache->DrawnPixelCount += (uint64)Piece.Width*Piece.Height;
+			}
+		}
+	}
+}
+
+// NOTE: Brings the cache up to date for the screen whose top left is world pixel (OriginX,
+// OriginY), drawing only what scrolled into view since the last frame. Anything that moved by
+// a screen or more, changed level, level count or world is drawn again from scratch.
+internal void UpdateTileLayerCache(tile_layer_cache *Cache, int32 OriginX, int32 OriginY, game_state *GameState,
+								   tile_map *TileMap, uint32 AbsTileZ, uint32 LevelCount, int32 TileSideInPixels)
+{
+	int32 dX = OriginX - Cache->OriginX;
+	int32 dY = OriginY - Cache->OriginY;
+	int32 ScrollX = (dX < 0) ? -dX : dX;
+	int32 ScrollY = (dY < 0) ? -dY : dY;
+	if(!Cache->IsValid || (Cache->World != GameState->World) || (Cache->AbsTileZ != AbsTileZ) ||
+	   (Cache->LevelCount != LevelCount) || (ScrollX >= Cache->Width) || (ScrollY >= Cache->Height))
+	{
+		DrawTileLayerCacheRect(Cache, OriginX, OriginY, Cache->Width, Cache->Height,
+							   GameState, TileMap, AbsTileZ, LevelCount, TileSideInPixels);
+		++Cache->FullRedrawCount;
+	}
+	else
+	{
+		// NOTE: The columns that came into view, the whole height of the screen, then the rows
+		// that came into view short of the corner the columns already covered
+		if(dX > 0)
+		{
+			DrawTileLayerCacheRect(Cache, Cache->OriginX + Cache->Width, OriginY, ScrollX, Cache->Height,
+								   GameState, TileMap, AbsTileZ, LevelCount, TileSideInPixels);
+		}
+		else if(dX < 0)
+		{
+			DrawTileLayerCacheRect(Cache, OriginX, OriginY, ScrollX, Cache->Height,
+								   GameState, TileMap, AbsTileZ, LevelCount, TileSideInPixels);
+		}
+
+		int32 RowX = (dX > 0) ? OriginX : Cache->OriginX;
+		int32 RowWidth = Cache->Width - ScrollX;
+		if(dY > 0)
+		{
+			DrawTileLayerCacheRect(Cache, RowX, Cache->OriginY + Cache->Height, RowWidth, ScrollY,
+								   GameState, TileMap, AbsTileZ, LevelCount, TileSideInPixels);
+		}
+		else if(dY < 0)
+		{
+			DrawTileLayerCacheRect(Cache, RowX, OriginY, RowWidth, ScrollY,
+								   GameState, TileMap, AbsTileZ, LevelCount, TileSideInPixels);
+		}
+	}
+
+	Cache->IsValid = true;
+	Cache->World = GameState->World;
+	Cache->AbsTileZ = AbsTileZ;
+	Cache->LevelCount = LevelCount;
+	Cache->OriginX = OriginX;
+	Cache->OriginY = OriginY;
+}
+
+// NOTE: Unwraps the cache onto the screen, which has to be the cache's size
+internal void CopyTileLayerCache(tile_layer_cache *Cache, game_offscreen_buffer *Buffer)
+{
+	TIMED_FUNCTION();
+
+	int32 CacheX = WrapIndex(Cache->OriginX, Cache->Width);
+	int32 CacheY = WrapIndex(Cache->OriginY, Cache->Height);
+	int32 FirstWidth = Cache->Width - CacheX;
+
+	uint8 *DestRow = (uint8 *)Buffer->Memory;
+	for(int32 Y = 0; Y < Cache->Height; ++Y)
+	{
+		uint32 *Source = (uint32 *)((uint8 *)Cache->Pixels + CacheY*Cache->Pitch);
+		uint32 *Dest = (uint32 *)DestRow;
+		for(int32 X = 0; X < FirstWidth; ++X)
+		{
+			Dest[X] = Source[CacheX + X];
+		}
+		for(int32 X = 0; X < CacheX; ++X)
+		{
+			Dest[FirstWidth + X] = Source[X];
+		}
+
+		DestRow += Buffer->Pitch;
+		if(++CacheY == Cache->Height)
+		{
+			CacheY = 0;
+		}
+	}
+}
+
+// NOTE: The world comes out of WorldArena, which it carves most of what is left of into its chunk
+// arena, so it has to be the last thing pushed there that is meant to last. RoomCount only matters for
+// WorldGeneration_RoomPath, which generates everything up front using TempArena, sizes the map to
+// the rooms and only ever goes between the first two of LevelCount levels. The room grid is
+// always 128 by 128 chunks.
+internal world *InitializeWorld(game_memory *Memory, memory_arena *WorldArena, memory_arena *TempArena,
+								world_generation_mode GenerationMode, uint32 RoomCount, uint32 LevelCount)
+{
+	Assert((LevelCount >= 2) || (GenerationMode != WorldGeneration_RoomPath));
+
+	world *World = PushStruct(WorldArena, world);
+	World->TileMap = PushStruct(WorldArena, tile_map);
+
+	tile_map *TileMap = World->TileMap;
+
+	// NOTE: All but an eighth of what is left, the rest stays for whatever WorldArena still needs
+	memory_index ChunkArenaSize = WorldArena->Size - WorldArena->Used;
+	ChunkArenaSize -= ChunkArenaSize / 8;
+	SubArena(&World->ChunkArena, WorldArena, ChunkArenaSize, "Chunks");
+
+	// NOTE: The game only uses a handful of tile values, chunks that somehow hold more get repacked
+	TileMap->ChunkPaletteCapacity = 16;
+
+	TileMap->TileChunkCountX = 128;
+	TileMap->TileChunkCountY = 128;
+	TileMap->TileChunkCountZ = LevelCount;
+	if(GenerationMode != WorldGeneration_RoomPath)
+	{
+		TileMap->TileChunks = PushArrayAtomic(&World->ChunkArena, 
+											  TileMap->TileChunkCountX*TileMap->TileChunkCountY*TileMap->TileChunkCountZ, 
+											  tile_chunk);
+	}
+
+	TileMap->TileSideInMeters = 1.4f;					
+
+	World->TilesPerWidth = 17;
+	World->TilesPerHeight = 9;
+	World->GenerationMode = GenerationMode;
+	switch(World->GenerationMode)
+	{
+		case WorldGeneration_RoomPath:
+		{
+			GenerateWorld(Memory, World, TempArena, RoomCount);
+		} break;
+
+		case WorldGeneration_RoomGridEager:
+		{
+			TileMap->GenerateChunk = GenerateGridTileChunk;
+			TileMap->GeneratorContext = World;
+			GenerateAllTileChunks(TileMap);
+		} break;
+
+		case WorldGeneration_RoomGridLazy:
+		{
+			// NOTE: Nothing is generated until GetTileValue first touches a chunk
+			TileMap->GenerateChunk = GenerateGridTileChunk;
+			TileMap->GeneratorContext = World;
+		} break;
+	}
+
+	return World;
+}
+
+/*
+	NOTE: The first call in after the game code is loaded commits the state structs at the start of
+	each storage, the arenas after them commit themselves. The game and sound threads may both get
+	here first and both commit, the global is only set afterwards so neither can skip ahead of it.
+*/
+internal void BindPlatformCommitMemory(game_memory *Memory)
+{
+	platform_commit_memory *CommitMemory = Memory->PlatformCommitMemory;
+	if(GlobalPlatformCommitMemory != CommitMemory)
+	{
+		if(CommitMemory)
+		{
+			bool32 Committed = CommitMemory(Memory->PermanentStorage, sizeof(game_state));
+			Committed = Committed && CommitMemory(Memory->TransientStorage, sizeof(transient_state));
+			Assert(Committed);
+		}
+		GlobalPlatformCommitMemory = CommitMemory;
+	}
+}
+
+// NOTE: Bit N is Buttons[N]
+internal uint32 GetButtonsDownMask(game_controller_input *Controller)
+{
+	uint32 Result = 0;
+	for(uint32 ButtonIndex = 0; ButtonIndex < ArrayCount(Controller->Buttons); ++ButtonIndex)
+	{
+		if(Controller->Buttons[ButtonIndex].EndedDown)
+		{
+			Result |= (1 << ButtonIndex);
+		}
+	}
+
+	return Result;
+}
+
+internal void SetButtonsDownMask(game_controller_input *Controller, uint32 Mask)
+{
+	for(uint32 ButtonIndex = 0; ButtonIndex < ArrayCount(Controller->Buttons); ++ButtonIndex)
+	{
+		Controller->Buttons[ButtonIndex].EndedDown = ((Mask >> ButtonIndex) & 1);
+	}
+}
+
+inline bool32 IsValidInputEvent(game_input *Input, game_input_event *Event)
+{
+	bool32 Result = ((Event->ControllerIndex < ArrayCount(Input->Controllers)) &&
+					 (Event->ButtonIndex < ArrayCount(Input->Controllers[0].Buttons)));
+	return Result;
+}
+
+internal void ApplyInputEvent(game_state *GameState, game_input *Input, game_input_event *Event,
+							  uint32 ProcessedControllerMask, uint32 *ButtonsDown)
+{
+	if(IsValidInputEvent(Input, Event) && (ProcessedControllerMask & (1 << Event->ControllerIndex)))
+	{
+		uint32 ButtonBit = (1 << Event->ButtonIndex);
+		if(Event->IsDown)
+		{
+			ButtonsDown[Event->ControllerIndex] |= ButtonBit;
+			GameState->LatchedButtonsForController[Event->ControllerIndex] |= ButtonBit;
+		}
+		else
+		{
+			ButtonsDown[Event->ControllerIndex] &= ~ButtonBit;
+		}
+	}
+}
+
+internal void ReportArena(game_memory_telemetry *Telemetry, memory_arena *Arena)
+{
+	Assert(Telemetry->ArenaCount < ArrayCount(Telemetry->Arenas));
+	game_arena_telemetry *Report = Telemetry->Arenas + Telemetry->ArenaCount++;
+
+	Assert(sizeof(Report->Name) >= sizeof(Arena->Name));
+	for(uint32 NameIndex = 0; NameIndex < sizeof(Arena->Name); ++NameIndex)
+	{
+		Report->Name[NameIndex] = Arena->Name[NameIndex];
+	}
+	Report->Size = Arena->Size;
+	Report->Used = Arena->Used;
+	Report->PeakUsed = GetArenaPeakUsed(Arena);
+	Report->AllocationCount = Arena->AllocationCount;
+}
+
+internal void UpdateMemoryTelemetry(game_memory *Memory, game_state *GameState, transient_state *TranState)
+{
+	game_memory_telemetry *Telemetry = &Memory->Telemetry;
+	++Telemetry->FrameIndex;
+
+	Telemetry->ArenaCount = 0;
+	ReportArena(Telemetry, &GameState->WorldArena);
+	ReportArena(Telemetry, &GameState->World->ChunkArena);
+	ReportArena(Telemetry, &TranState->TranArena);
+
+	tile_map *TileMap = GameState->World->TileMap;
+	Telemetry->ResidentChunkCount = (uint32)TileMap->ResidentChunkCount;
+	Telemetry->ResidentChunkBytes = TileMap->ResidentChunkBytes;
+
+	Telemetry->EntityCount = GameState->EntityCount;
+}
+
+// extern "C": Prevents name mangling of compiled function
+extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
+{    
+#if HANDMADE_PROFILE
+	GlobalDebugTable = Memory->DebugTable;
+#endif
+	TIMED_FUNCTION();
+	BindPlatformCommitMemory(Memory);
+
+	// Assert that the Buttons[] and button struct in the game_controller_input are identical sizes
+	// Take the last know button, subtract the base address, and the value should be equal the the number of entries
+	Assert((&Input->Controllers[0].Start - &Input->Controllers[0].Buttons[0]) == 
+			(ArrayCount(Input->Controllers[0].Buttons) - 1));
+
+	// Assert that our game state will fit in the allocated permanent memory
+	Assert(sizeof(game_state) <= Memory->PermanentStorageSize);	
+
+	game_state *GameState = (game_state*)Memory->PermanentStorage;
+
+	Assert(sizeof(transient_state) <= Memory->TransientStorageSize);
+	transient_state *TranState = (transient_state *)Memory->TransientStorage;
+	if(!TranState->IsInitialized)
+	{
+		InitializeArena(&TranState->TranArena, Memory->TransientStorageSize - sizeof(transient_state),
+						(uint8 *)Memory->TransientStorage + sizeof(transient_state), "Transient");
+		InitializeTileLayerCache(&TranState->TileLayer, &TranState->TranArena, Buffer->Width, Buffer->Height);
+		TranState->IsInitialized = true;
+	}
+
+	if(!Memory->IsInitialized)
+	{	
+		TIMED_BLOCK("Initialize");
+
+		InitializeArena(&GameState->WorldArena, Memory->PermanentStorageSize - sizeof(game_state), 
+						(uint8 *)Memory->PermanentStorage + sizeof(game_state), "World");
+
+		GameState->Entities = PushArray(&GameState->WorldArena, MAX_ENTITY_COUNT, entity);
+
+		//NOTE:  Reserve slot 0	for null entity
+		AddEntity(GameState);
+
+		GameState->Backdrop = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_background.bmp");
+
+		hero_bitmaps *Bitmap;
+
+		Bitmap = &GameState->HeroBitmaps[0];
+		Bitmap->Head = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_right_head.bmp");
+		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_right_cape.bmp");
+		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_right_torso.bmp");
+		Bitmap->AlignX = 76;
+		Bitmap->AlignY = 182;		
+
+		Bitmap++;
+		Bitmap->Head = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_back_head.bmp");
+		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_back_cape.bmp");
+		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_back_torso.bmp");
+		Bitmap->AlignX = 71;
+		Bitmap->AlignY = 181;				
+
+		Bitmap++;
+		Bitmap->Head = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_left_head.bmp");
+		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_left_cape.bmp");
+		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_left_torso.bmp");
+		Bitmap->AlignX = 66;
+		Bitmap->AlignY = 181;					
+
+		Bitmap++;
+		Bitmap->Head = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_front_head.bmp");
+		Bitmap->Cape = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_front_cape.bmp");
+		Bitmap->Torso = DEBUGLoadBMP(Thread, Memory, &GameState->WorldArena, "test/test_hero_front_torso.bmp");
+		Bitmap->AlignX = 71;
+		Bitmap->AlignY = 181;					
+
+		InitializeAudioState(&GameState->Audio, &GameState->WorldArena, 64);
+		GameState->TestSound = DEBUGMakeTestTone(&GameState->WorldArena, 48000, 440.0f, 0.25f);
+
+		// NOTE: Optional, there is no music in the repo. Game memory only keeps the file's name, so a
+		// looped or replayed snapshot opens it again wherever it is restored.
+		GameState->Music = OpenSoundStream(Memory, &GameState->WorldArena, "test/music.wav");
+		if(GameState->Music.SampleCount)
+		{
+			StartSound(&GameState->Audio, &GameState->Music, PannedVolume(0.5f, 0.0f), true);
+		}
+
+		GameState->VisibleLevelCount = MAX_VISIBLE_LEVEL_COUNT;
+		GameState->CameraP.AbsTileX = 17/2;
+		GameState->CameraP.AbsTileY = 9/2;				
+
+		GameState->World = InitializeWorld(Memory, &GameState->WorldArena, &TranState->TranArena,
+										   WorldGeneration_RoomGridLazy, 100, 2);
+
+		Memory->IsInitialized = true;
+	}						
+
+	world *World = GameState->World;
+	tile_map *TileMap = World->TileMap;
+
+	// NOTE: Code addresses stored in game memory go stale when the game code is reloaded somewhere
+	// else, so the chunk generator is bound again every frame instead of only at init
+	if(TileMap->GenerateChunk)
+	{
+		TileMap->GenerateChunk = GenerateGridTileChunk;
+	}
+
+	int32 TileSideInPixels = 60;
+	real32 MetersToPixels = (real32)(TileSideInPixels / TileMap->TileSideInMeters);	
+	uint32 LevelCount = (uint32)Clamp((int32)GameState->VisibleLevelCount, 1, MAX_VISIBLE_LEVEL_COUNT);
+
+	// NOTE: With a fixed tick the frame's time goes into the accumulator and the simulation runs
+	// as many whole ticks as it covers, which may be none. Whatever is left over becomes the
+	// blend factor between the positions before and after the last tick.
+	BEGIN_BLOCK("Simulate");
+	uint32 TickCount = 1;
+	real32 TickdT = Input->dtForFrame;
+	real32 RenderAlpha = 1.0f;
+	// NOTE: Where the first tick starts relative to the frame's input. Time left in the accumulator
+	// came before it, so the first tick ends that much sooner into the frame.
+	real32 FirstTickStart = 0.0f;
+	if(Input->SimSecondsPerTick > 0.0f)
+	{
+		TickdT = Input->SimSecondsPerTick;
+		FirstTickStart = -GameState->SimAccumulator;
+		GameState->SimAccumulator += Input->dtForFrame;
+		TickCount = (uint32)(GameState->SimAccumulator / TickdT);
+		if(TickCount > MAX_SIM_TICKS_PER_FRAME)
+		{
+			TickCount = MAX_SIM_TICKS_PER_FRAME;
+			GameState->SimAccumulator = TickCount*TickdT;
+		}
+		GameState->SimAccumulator -= TickCount*TickdT;
+		RenderAlpha = GameState->SimAccumulator / TickdT;
+	}
+
+	// NOTE: Where each controller's buttons were when the frame's input started. A button's first
+	// event says what it was before, one with no events was where it ended up all frame, so
+	// undoing the events newest first gets there. That only holds for a complete queue, after a
+	// drop every tick just gets where the buttons ended up.
+	uint32 EventCount = 0;
+	if(!Input->EventsDropped)
+	{
+		EventCount = Minimum(Input->EventCount, (uint32)ArrayCount(Input->Events));
+	}
+	uint32 ButtonsDown[ArrayCount(Input->Controllers)];
+	uint32 ButtonsPressed[ArrayCount(Input->Controllers)] = {};
+	for(uint32 ControllerIndex = 0; ControllerIndex < ArrayCount(Input->Controllers); ++ControllerIndex)
+	{
+		ButtonsDown[ControllerIndex] = GetButtonsDownMask(GetController(Input, ControllerIndex));
+	}
+	for(uint32 EventIndex = EventCount; EventIndex > 0; --EventIndex)
+	{
+		game_input_event *Event = Input->Events + (EventIndex - 1);
+		if(IsValidInputEvent(Input, Event))
+		{
+			uint32 ButtonBit = (1 << Event->ButtonIndex);
+			if(Event->IsDown)
+			{
+				ButtonsDown[Event->ControllerIndex] &= ~ButtonBit;
+				ButtonsPressed[Event->ControllerIndex] |= ButtonBit;
+			}
+			else
+			{
+				ButtonsDown[Event->ControllerIndex] |= ButtonBit;
+			}
+		}
+	}
+
+	// NOTE: A controller with a player steps it every tick, it keeps sliding when nobody pushes.
+	// One without a player only matters if it can join, which takes Start, so one that is
+	// disconnected or hasn't had Start down this frame is never looked at. A disconnected
+	// controller's buttons are stale, its player gets no input.
+	uint32 StartBit = (1 << (uint32)(&Input->Controllers[0].Start - Input->Controllers[0].Buttons));
+	uint32 ProcessedControllerMask = 0;
+	uint32 ProcessedControllerCount = 0;
+	for(uint32 ControllerIndex = 0; ControllerIndex < ArrayCount(Input->Controllers); ++ControllerIndex)
+	{
+		game_controller_input *Controller = GetController(Input, ControllerIndex);
+		if(!Controller->IsConnected)
+		{
+			ButtonsDown[ControllerIndex] = 0;
+			ButtonsPressed[ControllerIndex] = 0;
+			GameState->LatchedButtonsForController[ControllerIndex] = 0;
+		}
+
+		uint32 StartWasDown = (ButtonsDown[ControllerIndex] | ButtonsPressed[ControllerIndex] |
+							   GameState->LatchedButtonsForController[ControllerIndex]) & StartBit;
+		if(GameState->PlayerIndexForController[ControllerIndex] || StartWasDown)
+		{
+			ProcessedControllerMask |= (1 << ControllerIndex);
+			++ProcessedControllerCount;
+		}
+	}
+
+	uint32 NextEventIndex = 0;
+	for(uint32 TickIndex = 0; TickIndex < TickCount; ++TickIndex)
+	{
+		for(uint32 EntityIndex = 0; EntityIndex < GameState->EntityCount; ++EntityIndex)
+		{
+			GameState->Entities[EntityIndex].PrevP = GameState->Entities[EntityIndex].P;
+		}
+
+		// NOTE: Events up to the end of this tick land in it, the last tick takes the rest of the
+		// frame's so nothing waits a frame for a tick that hasn't happened yet
+		real32 TickEnd = FirstTickStart + (TickIndex + 1)*TickdT;
+		for(; NextEventIndex < EventCount; ++NextEventIndex)
+		{
+			game_input_event *Event = Input->Events + NextEventIndex;
+			if((Event->tFrame > TickEnd) && (TickIndex + 1 < TickCount))
+			{
+				break;
+			}
+			ApplyInputEvent(GameState, Input, Event, ProcessedControllerMask, ButtonsDown);
+		}
+
+		for(uint32 ControllerIndex = 0; ControllerIndex < ArrayCount(Input->Controllers); ++ControllerIndex)
+		{	
+			if(!(ProcessedControllerMask & (1 << ControllerIndex)))
+			{
+				continue;
+			}
+
+			// NOTE: The controller as this tick sees it, with a button down if it was down at any
+			// point during the tick
+			game_controller_input TickController = *GetController(Input, ControllerIndex);
+			SetButtonsDownMask(&TickController, ButtonsDown[ControllerIndex] | GameState->LatchedButtonsForController[ControllerIndex]);
+			GameState->LatchedButtonsForController[ControllerIndex] = 0;
+			if(!TickController.IsConnected)
+			{
+				TickController.IsAnalog = false;
+			}
+			game_controller_input *Controller = &TickController;
+
+			entity *ControllingEntity = GetEntity(GameState, GameState->PlayerIndexForController[ControllerIndex]);
+			if(ControllingEntity)	
+			{
+				v2 ddP = {};
+				bool32 didInputMovement = false;
+				if(Controller->IsAnalog)
+				{	
+					// NOTE: analog movement tuning
+					ddP = V2(Controller->StickAverageX, Controller->StickAverageY);
+				}
+				else
+				{								
+				
+					if(Controller->MoveUp.EndedDown)
+					{
+						ddP.Y = 1.0f;		
+						didInputMovement = true;		
+					}
+					if(Controller->MoveDown.EndedDown)
+					{
+						ddP.Y = -1.0f;
+						didInputMovement = true;
+					}
+					if(Controller->MoveLeft.EndedDown)
+					{
+						ddP.X = -1.0f;
+						didInputMovement = true;
+					}
+					if(Controller->MoveRight.EndedDown)
+					{
+						ddP.X = 1.0f;
+						didInputMovement = true;
+					}							
+				}
+
+				if(didInputMovement){
+					MovePlayer(GameState, ControllingEntity, TickdT, ddP);
+				}			
+				else
+				{
+					MovePlayer(GameState, ControllingEntity, TickdT, ddP);
+				}
+			}		
+			else
+			{
+				if(Controller->Start.EndedDown)
+				{
+					uint32 EntityIndex = AddEntity(GameState);				
+					InitializePlayer(GameState, EntityIndex);
+					GameState->PlayerIndexForController[ControllerIndex] = EntityIndex;
+					// NOTE: A whole tone higher per controller, so you can hear who joined
+					sound_handle Chime = StartSound(&GameState->Audio, &GameState->TestSound, PannedVolume(1.0f, 0.0f), false);
+					ChangePitch(&GameState->Audio, Chime, powf(1.122462f, (real32)ControllerIndex));
+				}		
+			}
+		}	
+
+		// NOTE: Stand-in until there is any AI. The heading is a hash of the entity and the tick, so
+		// it needs no state and replays the same.
+		uint32 WanderStep = (uint32)(GameState->SimTickCount / WANDER_TICKS);
+		for(uint32 EntityIndex = 1; EntityIndex < GameState->EntityCount; ++EntityIndex)
+		{
+			entity *Entity = GameState->Entities + EntityIndex;
+			if(Entity->Exists && Entity->Wanders)
+			{
+				random_series Series = RandomSeed(EntityIndex);
+				RandomSeek(&Series, 2*WanderStep);
+				v2 ddP;
+				ddP.X = 0.5f*RandomBilateral(&Series);
+				ddP.Y = 0.5f*RandomBilateral(&Series);
+				MovePlayer(GameState, Entity, TickdT, ddP);
+			}
+		}
+
+		++GameState->SimTickCount;
+	}
+
+	// NOTE: Only left over when no tick ran, their presses wait in the latch for the next one
+	for(; NextEventIndex < EventCount; ++NextEventIndex)
+	{
+		ApplyInputEvent(GameState, Input, Input->Events + NextEventIndex, ProcessedControllerMask, ButtonsDown);
+	}
+	END_BLOCK();
+
+	Memory->Telemetry.InputEventCount = EventCount;
+	Memory->Telemetry.ProcessedControllerCount = ProcessedControllerCount;
+	Memory->Telemetry.TickCount = TickCount;
+
+	BEGIN_BLOCK("Camera");
+	entity *CameraFollowingEntity = GetEntity(GameState, GameState->CameraFollowingEntityIndex);
+	if(CameraFollowingEntity)
+	{		
+		GameState->CameraP.AbsTileZ = CameraFollowingEntity->P.AbsTileZ;	
+
+		// NOTE: Follows where the entity is drawn rather than where it is, or the camera would
+		// step with the sim ticks while the entity glides between them
+		tile_map_difference Diff = Subtract(TileMap, &CameraFollowingEntity->P, &GameState->CameraP);
+		if(CameraFollowingEntity->PrevP.AbsTileZ == CameraFollowingEntity->P.AbsTileZ)
+		{
+			tile_map_difference TickDelta = Subtract(TileMap, &CameraFollowingEntity->P, &CameraFollowingEntity->PrevP);
+			Diff.dXY = Diff.dXY - (1.0f - RenderAlpha)*TickDelta.dXY;
+		}
+		real32 FollowFraction = 1.0f - Exp(-CAMERA_FOLLOW_RATE*Input->dtForFrame);
+		GameState->CameraP = Offset(TileMap, GameState->CameraP, FollowFraction*Diff.dXY);
+
+		// NOTE: Half a screen of tiles each way, plus the one the camera's offset can push into view
+		if((World->GenerationMode == WorldGeneration_RoomGridLazy) && Memory->PlatformAddEntry)
+		{
+			int32 TileRadiusX = (Buffer->Width/2)/TileSideInPixels + 1;
+			int32 TileRadiusY = (Buffer->Height/2)/TileSideInPixels + 1;
+			PrefetchChunksAhead(Memory, World, GameState->CameraP, CameraFollowingEntity->dP, TileRadiusX, TileRadiusY,
+								LevelCount);
+		}
+	}	
+	END_BLOCK();
+
+	// NOTE: Render
+	// NOTE: The tile layer only scrolls by whole pixels, so the camera is rounded to one for it and
+	// whatever was rounded off moves the screen centre instead, keeping entities where they stand
+	tile_map_position CameraP = GameState->CameraP;
+	real32 CameraPixelX = MetersToPixels*CameraP.Offset_.X;
+	real32 CameraPixelY = MetersToPixels*CameraP.Offset_.Y;
+	int32 CameraRoundedX = RoundReal32ToInt32(CameraPixelX);
+	int32 CameraRoundedY = RoundReal32ToInt32(CameraPixelY);
+	int32 OriginX = (int32)CameraP.AbsTileX*TileSideInPixels + CameraRoundedX - Buffer->Width/2;
+	int32 OriginY = -((int32)CameraP.AbsTileY*TileSideInPixels + CameraRoundedY) - Buffer->Height/2;
+
+	real32 ScreenCenterX = (real32)(Buffer->Width/2) + (CameraPixelX - (real32)CameraRoundedX);
+	real32 ScreenCenterY = (real32)(Buffer->Height/2) - (CameraPixelY - (real32)CameraRoundedY);
+
+	BEGIN_BLOCK("Tiles");
+	tile_layer_cache *TileLayer = &TranState->TileLayer;
+	if(TileLayer->Pixels && (TileLayer->Width == Buffer->Width) && (TileLayer->Height == Buffer->Height) &&
+	   (Buffer->BytesPerPixel == (int32)sizeof(uint32)))
+	{
+		UpdateTileLayerCache(TileLayer, OriginX, OriginY, GameState, TileMap, CameraP.AbsTileZ, LevelCount, TileSideInPixels);
+		CopyTileLayerCache(TileLayer, Buffer);
+	}
+	else
+	{
+		DrawTileLayer(Buffer, OriginX, OriginY, GameState, TileMap, CameraP.AbsTileZ, LevelCount, TileSideInPixels);
+	}
+	END_BLOCK();
+
+	// NOTE: Entities on another level than the camera's are never drawn, the rest only once
+	// something they draw, the rectangle or a sprite, reaches the screen
+	BEGIN_BLOCK("Entities");
+	uint32 DrawnEntityCount = 0;
+	uint32 OffScreenEntityCount = 0;
+	uint32 OtherLevelEntityCount = 0;
+	entity *Entity = GameState->Entities;
+	for(uint32 EntityIndex = 0; EntityIndex < GameState->EntityCount; EntityIndex++, ++Entity)
 	{		
-		// TODO Culling of entities based on Z camera view
-		if(Entity->Exists)
+		if(Entity->Exists && (Entity->P.AbsTileZ != CameraP.AbsTileZ))
+		{
+			++OtherLevelEntityCount;
+		}
+		else if(Entity->Exists)
 		{
 			tile_map_difference Diff = Subtract(TileMap, &Entity->P, &GameState->CameraP);
+			if(Entity->PrevP.AbsTileZ == Entity->P.AbsTileZ)
+			{
+				// NOTE: Draw the entity part way back along its last tick
+				tile_map_difference TickDelta = Subtract(TileMap, &Entity->P, &Entity->PrevP);
+				Diff.dXY = Diff.dXY - (1.0f - RenderAlpha)*TickDelta.dXY;
+			}
 
-			RGBReal EntityColor = {0.8f, 0.8f, 0.0f};
 			real32 EntityGroundX = ScreenCenterX + MetersToPixels*Diff.dXY.X;
 			real32 EntityGroundY = ScreenCenterY - MetersToPixels*Diff.dXY.Y;
 			v2 EntityLeftTop =	{EntityGroundX - MetersToPixels*0.5f*Entity->Width,
 								EntityGroundY - MetersToPixels*Entity->Height};
 			v2 EntityWidthHeight = {Entity->Width, Entity->Height};
-			DrawRectangle(Buffer, 
-						EntityLeftTop,
-						EntityLeftTop + MetersToPixels*EntityWidthHeight,
-						EntityColor);
-					
-			hero_bitmaps *HeroBitmaps = &GameState->HeroBitmaps[Entity->FacingDirection];			
+			v2 EntityRightBottom = EntityLeftTop + MetersToPixels*EntityWidthHeight;
 
-			DrawBitmap(Buffer, &HeroBitmaps->Torso, EntityGroundX, EntityGroundY, 
-						HeroBitmaps->AlignX, HeroBitmaps->AlignY);
-			DrawBitmap(Buffer, &HeroBitmaps->Cape, EntityGroundX, EntityGroundY, 
-						HeroBitmaps->AlignX, HeroBitmaps->AlignY);	
-			DrawBitmap(Buffer, &HeroBitmaps->Head, EntityGroundX, EntityGroundY, 
-						HeroBitmaps->AlignX, HeroBitmaps->AlignY);		
+			hero_bitmaps *HeroBitmaps = &GameState->HeroBitmaps[Entity->FacingDirection];			
+			int32 SpriteWidth = Maximum(HeroBitmaps->Torso.Width, Maximum(HeroBitmaps->Cape.Width, HeroBitmaps->Head.Width));
+			int32 SpriteHeight = Maximum(HeroBitmaps->Torso.Height, Maximum(HeroBitmaps->Cape.Height, HeroBitmaps->Head.Height));
+			real32 SpriteMinX = EntityGroundX - (real32)HeroBitmaps->AlignX;
+			real32 SpriteMinY = EntityGroundY - (real32)HeroBitmaps->AlignY;
+			real32 MinX = Minimum(EntityLeftTop.X, SpriteMinX);
+			real32 MinY = Minimum(EntityLeftTop.Y, SpriteMinY);
+			real32 MaxX = Maximum(EntityRightBottom.X, SpriteMinX + (real32)SpriteWidth);
+			real32 MaxY = Maximum(EntityRightBottom.Y, SpriteMinY + (real32)SpriteHeight);
+
+			if((MaxX <= 0.0f) || (MaxY <= 0.0f) || (MinX >= (real32)Buffer->Width) || (MinY >= (real32)Buffer->Height))
+			{
+				++OffScreenEntityCount;
+			}
+			else
+			{
+				RGBReal EntityColor = {0.8f, 0.8f, 0.0f};
+				DrawRectangle(Buffer, EntityLeftTop, EntityRightBottom, EntityColor);
+
+				DrawBitmap(Buffer, &HeroBitmaps->Torso, EntityGroundX, EntityGroundY, 
+							HeroBitmaps->AlignX, HeroBitmaps->AlignY);
+				DrawBitmap(Buffer, &HeroBitmaps->Cape, EntityGroundX, EntityGroundY, 
+							HeroBitmaps->AlignX, HeroBitmaps->AlignY);	
+				DrawBitmap(Buffer, &HeroBitmaps->Head, EntityGroundX, EntityGroundY, 
+							HeroBitmaps->AlignX, HeroBitmaps->AlignY);		
+				++DrawnEntityCount;
+			}
 		}
 	}
+	END_BLOCK();
+
+	game_memory_telemetry *Telemetry = &Memory->Telemetry;
+	Telemetry->DrawnEntityCount = DrawnEntityCount;
+	Telemetry->OffScreenEntityCount = OffScreenEntityCount;
+	Telemetry->OtherLevelEntityCount = OtherLevelEntityCount;
 
-	  
+	UpdateMemoryTelemetry(Memory, GameState, TranState);
 }
 
 extern "C" GAME_GET_SOUND_SAMPLES(GameGetSoundSamples)
 {
+#if HANDMADE_PROFILE
+	GlobalDebugTable = Memory->DebugTable;
+#endif
+	TIMED_FUNCTION();
+	BindPlatformCommitMemory(Memory);
+
 	// TODO : may not want continuous samples, could require earlier or later samples	
 	game_state *GameState = (game_state*)Memory->PermanentStorage;
-	GameOutputSound(SoundBuffer, GameState);
+	transient_state *TranState = (transient_state *)Memory->TransientStorage;
+	if(Memory->IsInitialized && TranState->IsInitialized)
+	{
+		BindAudioPlatform(&GameState->Audio, Memory);
+		OutputPlayingSounds(&GameState->Audio, SoundBuffer, &TranState->TranArena);
+	}
+	else
+	{
+		int16 *SampleOut = SoundBuffer->Samples;
+		for(int SampleIndex = 0; SampleIndex < SoundBuffer->SampleCount; SampleIndex++)
+		{
+			*SampleOut++ = 0;
+			*SampleOut++ = 0;
+		}
+	}
 }
 
 /*
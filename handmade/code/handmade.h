@@ -7,7 +7,9 @@
 #include "handmade_random.h"
 #include "handmade_math.h"
 #include "handmade_intrinsics.h"
+#include "handmade_debug.h"
 #include "handmade_tile.h"
+#include "handmade_audio.h"
 
 #define PI 3.1415926535f
 
@@ -19,6 +21,10 @@
 	HANDMADE_SLOW:
 		0 - No slow code allowed!
 		1 - Slow code allowed
+
+	HANDMADE_PROFILE:
+		0 - Timed blocks compile to nothing
+		1 - Timed blocks record into the platform's debug table, when it hands one over
 */
 
 // MACROS
@@ -51,16 +57,151 @@ inline game_controller_input *GetController(game_input *Input, int ControllerInd
 	return Result;
 }
 
+// NOTE: For the platform, after it has updated the button state itself. Returns false if the
+// queue was full and the event was dropped, which flags the frame's input as EventsDropped.
+inline bool32 PushInputEvent(game_input *Input, uint32 ControllerIndex, uint32 ButtonIndex, bool32 IsDown, real32 tFrame)
+{
+	bool32 Result = false;
+	if(Input->EventCount < ArrayCount(Input->Events))
+	{
+		game_input_event *Event = Input->Events + Input->EventCount++;
+		Event->tFrame = tFrame;
+		Event->ControllerIndex = ControllerIndex;
+		Event->ButtonIndex = ButtonIndex;
+		Event->IsDown = IsDown;
+		Result = true;
+	}
+	else
+	{
+		Input->EventsDropped = true;
+	}
+
+	return Result;
+}
+
+// NOTE: The name is copied in rather than pointed at, arenas live in game memory and outlast
+// the game code's string literals across a reload
+#define MEMORY_ARENA_NAME_LENGTH 16
+
 struct memory_arena
 {
 	memory_index Size;
 	uint8 *Base;
 	memory_index Used;
+
+	// NOTE: Used only ever shrinks in EndTemporaryMemory, so that is the one place the peak has
+	// to be caught, the live high water mark is Maximum(PeakUsed, Used)
+	memory_index PeakUsed;
+	uint64 AllocationCount;
+	char Name[MEMORY_ARENA_NAME_LENGTH];
+
+	// NOTE: How far from Base the platform has committed, all of Size unless game memory is only
+	// reserved (game_memory.PlatformCommitMemory)
+	memory_index CommitSize;
+};
+
+struct temporary_memory
+{
+	memory_arena *Arena;
+	memory_index Used;
+};
+
+enum world_generation_mode
+{
+	// NOTE: One winding path of rooms, planned and filled entirely at startup
+	WorldGeneration_RoomPath,
+
+	// NOTE: Every screen is a room whose doors are derived from its coordinates, so any chunk
+	// can be generated on its own. Eager fills the whole map at startup, lazy on first touch.
+	WorldGeneration_RoomGridEager,
+	WorldGeneration_RoomGridLazy,
+};
+
+struct world_chunk_prefetch
+{
+	bool32 volatile InUse;
+	tile_map *TileMap;
+	tile_chunk *TileChunk;
+	uint32 TileChunkX;
+	uint32 TileChunkY;
+	uint32 TileChunkZ;
 };
 
 struct world
 {
 	tile_map *TileMap;
+
+	world_generation_mode GenerationMode;
+	// NOTE: The chunk table and chunk storage. Worker threads push onto it while the main thread
+	// does too, so every push onto it has to be PushArrayAtomic.
+	memory_arena ChunkArena;
+	uint32 TilesPerWidth;
+	uint32 TilesPerHeight;
+
+	// NOTE: Rooms of the path that fell partly or wholly outside the tile map, see GenerateWorld
+	uint32 DroppedRoomCount;
+
+	world_chunk_prefetch Prefetches[32];
+};
+
+// NOTE: One screen of the generated world, decided by the serial planning pass
+struct world_room
+{
+	uint32 ScreenX;
+	uint32 ScreenY;
+	uint32 AbsTileZ;
+
+	bool32 DoorLeft;
+	bool32 DoorRight;
+	bool32 DoorTop;
+	bool32 DoorBottom;
+	bool32 DoorUp;
+	bool32 DoorDown;
+};
+
+struct world_gen_room_link
+{
+	uint32 RoomIndex;
+	world_gen_room_link *Next;
+};
+
+// NOTE: A chunk the fill pass owns exclusively, along with every room that overlaps it
+struct world_gen_chunk
+{
+	tile_chunk *TileChunk;
+	uint32 AbsTileMinX;
+	uint32 AbsTileMinY;
+	world_gen_room_link *FirstRoom;
+};
+
+// NOTE: Open addressed, a zero TileChunkIndexPlusOne is an empty slot
+struct world_gen_chunk_slot
+{
+	uint32 TileChunkIndexPlusOne;
+	uint32 GenChunkIndex;
+};
+
+struct world_gen
+{
+	world *World;
+	tile_map *TileMap;
+
+	uint32 RoomCount;
+	world_room *Rooms;
+
+	uint32 ChunkCapacity;
+	uint32 ChunkCount;
+	world_gen_chunk *Chunks;
+
+	uint32 ChunkSlotMask;
+	world_gen_chunk_slot *ChunkSlots;
+};
+
+struct world_gen_work
+{
+	world_gen *Gen;
+	uint32 FirstChunk;
+	uint32 OnePastLastChunk;
 };
 
 struct loaded_bitmap
@@ -79,10 +220,22 @@ struct hero_bitmaps
 	loaded_bitmap Torso;
 };
 
+// NOTE: Beyond this many ticks in one frame the leftover time is dropped, so a long hitch
+// slows the game down instead of every later frame trying to catch up
+#define MAX_SIM_TICKS_PER_FRAME 8
+
+#define MAX_ENTITY_COUNT 16384
+// NOTE: Wandering entities pick a new heading this often
+#define WANDER_TICKS 32
+
 struct entity
 {
 	bool32 Exists;
+	// NOTE: Moves on its own when nobody is controlling it
+	bool32 Wanders;
 	tile_map_position P;
+	// NOTE: Where the last sim tick started, rendering blends from here to P
+	tile_map_position PrevP;
 	v2 dP;
 	uint32 FacingDirection;
 
@@ -90,6 +243,65 @@ struct entity
 	real32 Height;
 };
 
+// NOTE: Levels drawn at once, the camera's and the ones below it. Each level down has its walls
+// blended over the ones beneath at LEVEL_FADE times the opacity of the level above.
+#define MAX_VISIBLE_LEVEL_COUNT 4
+#define LEVEL_FADE 0.5f
+
+// NOTE: How quickly the camera closes on the entity it follows, per second. The gap shrinks by
+// a factor of e every 1/CAMERA_FOLLOW_RATE seconds whatever the frame rate.
+#define CAMERA_FOLLOW_RATE 6.0f
+
+// NOTE: Inclusive, in tile map coordinates
+struct tile_rect
+{
+	int32 MinCol;
+	int32 MaxCol;
+	int32 MinRow;
+	int32 MaxRow;
+};
+
+/*
+	NOTE: The backdrop and tiles, drawn once and kept across frames in a buffer the size of the
+	screen that wraps around both ways. World pixel (X, Y) lives at (X mod Width, Y mod Height), so
+	when the camera moves by a few pixels everything still on screen is already in the buffer in
+	the right place, and only the strips that scrolled into view get drawn. The frame is then one
+	copy out of the buffer, in at most four pieces where it wraps.
+
+	World pixels run right and down, tile (Col, Row) is centred on (Col*TileSide, -Row*TileSide).
+
+	The levels below the camera's are drawn into the same buffer, under it and faded by depth.
+	Tiles never change once generated, so each level is only drawn in the strips that scroll into
+	view like the rest, and a level costs nothing on a frame the camera holds still. Keeping a
+	buffer per level instead would mean blending all of them onto the screen every frame.
+
+	The cache is a couple of megabytes rewritten as the camera moves, so it lives in transient
+	storage rather than dirtying the permanent pages snapshots care about. It only trusts its own
+	record of what it last drew, so it comes out right after a restore whether or not transient
+	storage was restored along with the game state, and it is rebuilt from scratch whenever
+	transient storage starts over.
+*/
+struct tile_layer_cache
+{
+	int32 Width;
+	int32 Height;
+	int32 Pitch;
+	// NOTE: Null when there was no buffer to size it by, the layer is drawn straight to the screen
+	uint32 *Pixels;
+
+	// NOTE: What the pixels were last drawn for, the world pixel at the top left of the screen
+	bool32 IsValid;
+	world *World;
+	uint32 AbsTileZ;
+	uint32 LevelCount;
+	int32 OriginX;
+	int32 OriginY;
+
+	// NOTE: Running totals, for the bench
+	uint64 DrawnPixelCount;
+	uint32 FullRedrawCount;
+};
+
 struct game_state
 {
 	memory_arena WorldArena;
@@ -101,12 +313,34 @@ struct game_state
 	
 	// Number of players matches number of controllers
 	uint32 PlayerIndexForController[ArrayCount(((game_input *)0)->Controllers)];
+	// NOTE: Buttons pressed since the last sim tick, bit N is Buttons[N]. A press counts for the
+	// tick it lands in even if it was let go again before the tick ended, and a frame that runs
+	// no ticks hands its presses on to the next.
+	uint32 LatchedButtonsForController[ArrayCount(((game_input *)0)->Controllers)];
 	uint32 EntityCount;
-	entity Entities[256];
+	// NOTE: MAX_ENTITY_COUNT of them, from the world arena
+	entity *Entities;
 
 	loaded_bitmap Backdrop;
 	hero_bitmaps HeroBitmaps[4];
-	
+	// NOTE: Up to MAX_VISIBLE_LEVEL_COUNT, 1 draws only the camera's level
+	uint32 VisibleLevelCount;
+
+	audio_state Audio;
+	loaded_sound TestSound;
+	loaded_sound Music;
+
+	// NOTE: Frame time not yet consumed by a fixed sim tick
+	real32 SimAccumulator;
+	uint64 SimTickCount;
+};
+
+struct transient_state
+{
+	bool32 IsInitialized;
+	memory_arena TranArena;
+
+	tile_layer_cache TileLayer;
 };
 
 union RGBReal
@@ -121,11 +355,46 @@ union RGBReal
 };
 
 
-internal void InitializeArena(memory_arena *Arena, memory_index Size, uint8 *Base)
+// NOTE: One per module like GlobalDebugTable, set from game_memory on every call in. Arenas commit
+// as they grow through it, in steps of ARENA_COMMIT_GRANULARITY so a push isn't a system call.
+global_variable platform_commit_memory *GlobalPlatformCommitMemory;
+#define ARENA_COMMIT_GRANULARITY Kilobytes(64)
+
+internal void InitializeArena(memory_arena *Arena, memory_index Size, uint8 *Base, char *Name)
 {
 	Arena->Size = Size;
 	Arena->Base = Base;
 	Arena->Used = 0;
+	Arena->PeakUsed = 0;
+	Arena->AllocationCount = 0;
+	Arena->CommitSize = GlobalPlatformCommitMemory ? 0 : Size;
+
+	uint32 NameIndex = 0;
+	for(; Name[NameIndex] && (NameIndex < (MEMORY_ARENA_NAME_LENGTH - 1)); ++NameIndex)
+	{
+		Arena->Name[NameIndex] = Name[NameIndex];
+	}
+	Arena->Name[NameIndex] = 0;
+}
+
+/*
+	NOTE: Commits the arena out to at least NewUsed. Threads pushing atomically can race through
+	here and commit overlapping ranges, or store a CommitSize smaller than another thread's, which
+	only ever costs a redundant commit later since committing twice is harmless. Game memory that
+	was restored from a snapshot keeps its CommitSize, so a host that restores snapshots has to
+	have committed whatever they cover.
+*/
+internal void CommitArena(memory_arena *Arena, memory_index NewUsed)
+{
+	memory_index CommitSize = Arena->CommitSize;
+	memory_index NewCommitSize = (NewUsed + ARENA_COMMIT_GRANULARITY - 1) & ~(memory_index)(ARENA_COMMIT_GRANULARITY - 1);
+	NewCommitSize = Minimum(NewCommitSize, Arena->Size);
+	if(GlobalPlatformCommitMemory && (NewCommitSize > CommitSize))
+	{
+		bool32 Committed = GlobalPlatformCommitMemory(Arena->Base + CommitSize, NewCommitSize - CommitSize);
+		Assert(Committed);
+	}
+	Arena->CommitSize = NewCommitSize;
 }
 
 #define PushStruct(Arena, type) (type *)PushSize_(Arena, sizeof(type))
@@ -133,10 +402,73 @@ internal void InitializeArena(memory_arena *Arena, memory_index Size, uint8 *Bas
 internal void *PushSize_(memory_arena *Arena, memory_index Size)
 {
 	Assert((Arena->Used + Size) <= Arena->Size)
+	if((Arena->Used + Size) > Arena->CommitSize)
+	{
+		CommitArena(Arena, Arena->Used + Size);
+	}
 	void *Result = Arena->Base + Arena->Used;
 	Arena->Used += Size;
+	++Arena->AllocationCount;
+
+	return Result;
+}
+
+// NOTE: For arenas that more than one thread pushes onto (lazy chunk generation). Every push
+// that can overlap with another thread has to go through here, not PushSize_.
+#define PushArrayAtomic(Arena, Count, type) (type *)PushSizeAtomic_(Arena, (sizeof(type)*(Count)))
+internal void *PushSizeAtomic_(memory_arena *Arena, memory_index Size)
+{
+	memory_index OldUsed = (memory_index)AtomicAddU64((uint64 volatile *)&Arena->Used, Size);
+	Assert((OldUsed + Size) <= Arena->Size);
+	if((OldUsed + Size) > Arena->CommitSize)
+	{
+		CommitArena(Arena, OldUsed + Size);
+	}
+	AtomicAddU64((uint64 volatile *)&Arena->AllocationCount, 1);
+	void *Result = Arena->Base + OldUsed;
+
+	return Result;
+}
+
+/*
+	NOTE: Carves Size bytes off Arena as an arena of its own. The parent never commits the carved
+	range, the child commits what it grows into itself, so a big mostly empty sub-arena costs
+	nothing until it is used.
+*/
+internal void SubArena(memory_arena *Result, memory_arena *Arena, memory_index Size, char *Name)
+{
+	Assert((Arena->Used + Size) <= Arena->Size);
+	InitializeArena(Result, Size, Arena->Base + Arena->Used, Name);
+	Arena->Used += Size;
+	++Arena->AllocationCount;
+	Arena->CommitSize = Maximum(Arena->CommitSize, Arena->Used);
+}
+
+inline temporary_memory BeginTemporaryMemory(memory_arena *Arena)
+{
+	temporary_memory Result;
+	Result.Arena = Arena;
+	Result.Used = Arena->Used;
+
+	return Result;
+}
+
+inline memory_index GetArenaPeakUsed(memory_arena *Arena)
+{
+	memory_index Result = Maximum(Arena->PeakUsed, Arena->Used);
 
 	return Result;
 }
 
+inline void EndTemporaryMemory(temporary_memory TempMem)
+{
+	memory_arena *Arena = TempMem.Arena;
+	Assert(Arena->Used >= TempMem.Used);
+	if(Arena->Used > Arena->PeakUsed)
+	{
+		Arena->PeakUsed = Arena->Used;
+	}
+	Arena->Used = TempMem.Used;
+}
+
 #endif
\ No newline at end of file
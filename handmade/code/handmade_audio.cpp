@@ -0,0 +1,995 @@
+#include "handmade_audio.h"
+#include "handmade.h"
+
+// AUDIO IMPLEMENTATION
+#pragma pack(push, 1)
+struct wave_header
+{
+	uint32 RIFFID;
+	uint32 Size;
+	uint32 WAVEID;
+};
+
+struct wave_chunk
+{
+	uint32 ID;
+	uint32 Size;
+};
+
+struct wave_fmt
+{
+	uint16 wFormatTag;
+	uint16 nChannels;
+	uint32 nSamplesPerSec;
+	uint32 nAvgBytesPerSec;
+	uint16 nBlockAlign;
+	uint16 wBitsPerSample;
+};
+#pragma pack(pop)
+
+#define RIFF_CODE(a, b, c, d) (((uint32)(a) << 0) | ((uint32)(b) << 8) | ((uint32)(c) << 16) | ((uint32)(d) << 24))
+enum
+{
+	WAVE_ChunkID_fmt = RIFF_CODE('f', 'm', 't', ' '),
+	WAVE_ChunkID_data = RIFF_CODE('d', 'a', 't', 'a'),
+	WAVE_ChunkID_RIFF = RIFF_CODE('R', 'I', 'F', 'F'),
+	WAVE_ChunkID_WAVE = RIFF_CODE('W', 'A', 'V', 'E'),
+};
+
+struct wav_info
+{
+	bool32 Valid;
+	uint32 ChannelCount;
+	uint32 SamplesPerSecond;
+	uint32 SampleCount;
+	uint64 DataOffset;
+};
+
+/*
+	NOTE: Walks the RIFF chunks up to the start of the sample data. The data itself doesn't have to
+	be in Contents, so a stream can parse just the front of the file. Only 16 bit PCM, mono or
+	stereo, is accepted.
+*/
+internal wav_info ParseWAV(void *Contents, uint64 ContentsSize)
+{
+	wav_info Result = {};
+
+	uint8 *Base = (uint8 *)Contents;
+	wave_header *Header = (wave_header *)Base;
+	if((ContentsSize >= sizeof(wave_header)) &&
+	   (Header->RIFFID == WAVE_ChunkID_RIFF) && (Header->WAVEID == WAVE_ChunkID_WAVE))
+	{
+		bool32 FoundFormat = false;
+		uint64 At = sizeof(wave_header);
+		while((At + sizeof(wave_chunk)) <= ContentsSize)
+		{
+			wave_chunk *Chunk = (wave_chunk *)(Base + At);
+			uint64 ChunkDataOffset = At + sizeof(wave_chunk);
+			if(Chunk->ID == WAVE_ChunkID_fmt)
+			{
+				if((ChunkDataOffset + sizeof(wave_fmt)) <= ContentsSize)
+				{
+					wave_fmt *Format = (wave_fmt *)(Base + ChunkDataOffset);
+					FoundFormat = ((Format->wFormatTag == 1) && (Format->wBitsPerSample == 16) &&
+								   (Format->nChannels >= 1) && (Format->nChannels <= 2));
+					Result.ChannelCount = Format->nChannels;
+					Result.SamplesPerSecond = Format->nSamplesPerSec;
+				}
+			}
+			else if(Chunk->ID == WAVE_ChunkID_data)
+			{
+				Result.Valid = FoundFormat;
+				Result.DataOffset = ChunkDataOffset;
+				if(FoundFormat)
+				{
+					Result.SampleCount = Chunk->Size / (Result.ChannelCount*(uint32)sizeof(int16));
+				}
+				break;
+			}
+
+			// NOTE: Chunks are padded to an even size
+			At = ChunkDataOffset + ((Chunk->Size + 1) & ~1);
+		}
+	}
+
+	return Result;
+}
+
+internal loaded_sound DEBUGLoadWAV(thread_context *Thread, game_memory *Memory, memory_arena *Arena, char *Filename)
+{
+	loaded_sound Result = {};
+
+	debug_read_file_result ReadResult = Memory->DEBUGPlatformReadEntireFile(Thread, Filename);
+	if(ReadResult.ContentsSize != 0)
+	{
+		wav_info Info = ParseWAV(ReadResult.Contents, ReadResult.ContentsSize);
+		if(Info.Valid)
+		{
+			// NOTE: A truncated file plays what it has
+			uint32 FrameSize = Info.ChannelCount*(uint32)sizeof(int16);
+			uint32 SamplesInFile = (uint32)((ReadResult.ContentsSize - Info.DataOffset) / FrameSize);
+			Result.SampleCount = Minimum(Info.SampleCount, SamplesInFile);
+			Result.ChannelCount = Info.ChannelCount;
+			Result.SamplesPerSecond = Info.SamplesPerSecond;
+
+			int16 *Source = (int16 *)((uint8 *)ReadResult.Contents + Info.DataOffset);
+			for(uint32 ChannelIndex = 0; ChannelIndex < Result.ChannelCount; ++ChannelIndex)
+			{
+				Result.Samples[ChannelIndex] = PushArray(Arena, Result.SampleCount, int16);
+			}
+			for(uint32 SampleIndex = 0; SampleIndex < Result.SampleCount; ++SampleIndex)
+			{
+				for(uint32 ChannelIndex = 0; ChannelIndex < Result.ChannelCount; ++ChannelIndex)
+				{
+					Result.Samples[ChannelIndex][SampleIndex] = *Source++;
+				}
+			}
+		}
+
+		Memory->DEBUGPlatformFreeFileMemory(Thread, ReadResult.Contents);
+	}
+
+	return Result;
+}
+
+internal platform_stream_file *FindStreamFile(platform_stream_file *Files, char *Filename)
+{
+	platform_stream_file *Result = 0;
+	for(uint32 FileIndex = 0; FileIndex < PLATFORM_STREAM_FILE_COUNT; ++FileIndex)
+	{
+		platform_stream_file *File = Files + FileIndex;
+		uint32 CharIndex = 0;
+		while(File->Filename[CharIndex] && (File->Filename[CharIndex] == Filename[CharIndex]))
+		{
+			++CharIndex;
+		}
+		if(File->Filename[0] && (File->Filename[CharIndex] == Filename[CharIndex]))
+		{
+			Result = File;
+			break;
+		}
+	}
+
+	return Result;
+}
+
+/*
+	NOTE: Returns the open handle for Filename, opening it into a free slot if no slot has it yet,
+	which is what happens on the first read after game memory was restored in another process.
+	Returns 0 if every slot is taken or the platform can't open files. A file that didn't open keeps
+	its slot with NoErrors false, so a missing file isn't tried again on every read.
+*/
+internal platform_file_handle *GetStreamFile(platform_stream_file *Files, platform_open_file *PlatformOpenFile, char *Filename)
+{
+	platform_file_handle *Result = 0;
+	platform_stream_file *File = FindStreamFile(Files, Filename);
+	if(File)
+	{
+		Result = &File->Handle;
+	}
+	else if(PlatformOpenFile)
+	{
+		for(uint32 FileIndex = 0; FileIndex < PLATFORM_STREAM_FILE_COUNT; ++FileIndex)
+		{
+			File = Files + FileIndex;
+			if(!File->Filename[0])
+			{
+				uint32 CharIndex = 0;
+				for(; Filename[CharIndex] && (CharIndex < (PLATFORM_STREAM_FILENAME_LENGTH - 1)); ++CharIndex)
+				{
+					File->Filename[CharIndex] = Filename[CharIndex];
+				}
+				File->Filename[CharIndex] = 0;
+				File->Handle = PlatformOpenFile(Filename);
+				Result = &File->Handle;
+				break;
+			}
+		}
+	}
+
+	return Result;
+}
+
+internal void CloseStreamFile(game_memory *Memory, char *Filename)
+{
+	platform_stream_file *File = FindStreamFile(Memory->StreamFiles, Filename);
+	if(File)
+	{
+		if(Memory->PlatformCloseFile)
+		{
+			Memory->PlatformCloseFile(&File->Handle);
+		}
+		*File = {};
+	}
+}
+
+inline void BindAudioPlatform(audio_state *Audio, game_memory *Memory)
+{
+	Audio->PlatformOpenFile = Memory->PlatformOpenFile;
+	Audio->PlatformReadDataFromFile = Memory->PlatformReadDataFromFile;
+	Audio->StreamFiles = Memory->StreamFiles;
+	Audio->StreamStaging = Memory->StreamStaging;
+}
+
+// NOTE: Returns a sound with SampleCount 0 if the file can't be opened or isn't a WAV we can play.
+// The filename has to fit a stream file slot, since that's how the file is found again.
+internal loaded_sound OpenSoundStream(game_memory *Memory, memory_arena *Arena, char *Filename)
+{
+	loaded_sound Result = {};
+
+	uint32 FilenameLength = 0;
+	while(Filename[FilenameLength])
+	{
+		++FilenameLength;
+	}
+
+	platform_file_handle *File = 0;
+	if(FilenameLength < PLATFORM_STREAM_FILENAME_LENGTH)
+	{
+		File = GetStreamFile(Memory->StreamFiles, Memory->PlatformOpenFile, Filename);
+	}
+	if(File)
+	{
+		// NOTE: The data chunk has to start within this much of the front of the file
+		uint8 HeaderBytes[4096];
+		uint64 HeaderSize = Memory->PlatformReadDataFromFile(File, 0, sizeof(HeaderBytes), HeaderBytes);
+		wav_info Info = ParseWAV(HeaderBytes, HeaderSize);
+		if(Info.Valid && (Info.SampleCount > 0))
+		{
+			sound_stream *Stream = PushStruct(Arena, sound_stream);
+			*Stream = {};
+			for(uint32 CharIndex = 0; CharIndex <= FilenameLength; ++CharIndex)
+			{
+				Stream->Filename[CharIndex] = Filename[CharIndex];
+			}
+			Stream->DataOffset = Info.DataOffset;
+			for(uint32 ChunkIndex = 0; ChunkIndex < SOUND_STREAM_CHUNK_COUNT; ++ChunkIndex)
+			{
+				sound_stream_chunk *Chunk = Stream->Chunks + ChunkIndex;
+				for(uint32 ChannelIndex = 0; ChannelIndex < Info.ChannelCount; ++ChannelIndex)
+				{
+					Chunk->Samples[ChannelIndex] = PushArray(Arena, SOUND_STREAM_CHUNK_SAMPLES, int16);
+				}
+			}
+
+			Result.SampleCount = Info.SampleCount;
+			Result.ChannelCount = Info.ChannelCount;
+			Result.SamplesPerSecond = Info.SamplesPerSecond;
+			Result.Stream = Stream;
+		}
+		else
+		{
+			CloseStreamFile(Memory, Filename);
+		}
+	}
+
+	return Result;
+}
+
+// NOTE: Returns the chunk holding SampleIndex, reading it over the least recently used one if needed.
+// A read that comes up short leaves silence in the rest of the chunk rather than stopping the sound.
+internal sound_stream_chunk *FetchSoundStreamChunk(audio_state *Audio, loaded_sound *Sound, uint32 SampleIndex)
+{
+	sound_stream *Stream = Sound->Stream;
+	uint32 FirstSample = SampleIndex - (SampleIndex % SOUND_STREAM_CHUNK_SAMPLES);
+	uint32 UseCounter = ++Stream->UseCounter;
+
+	sound_stream_chunk *Result = 0;
+	sound_stream_chunk *Oldest = Stream->Chunks;
+	for(uint32 ChunkIndex = 0; ChunkIndex < SOUND_STREAM_CHUNK_COUNT; ++ChunkIndex)
+	{
+		sound_stream_chunk *Chunk = Stream->Chunks + ChunkIndex;
+		if(Chunk->SampleCount && (Chunk->FirstSample == FirstSample))
+		{
+			Result = Chunk;
+			break;
+		}
+		if(Chunk->LastUsed < Oldest->LastUsed)
+		{
+			Oldest = Chunk;
+		}
+	}
+
+	if(!Result)
+	{
+		TIMED_BLOCK("Stream read");
+
+		Result = Oldest;
+		Result->FirstSample = FirstSample;
+		Result->SampleCount = Minimum(SOUND_STREAM_CHUNK_SAMPLES, Sound->SampleCount - FirstSample);
+
+		uint32 ChannelCount = Sound->ChannelCount;
+		uint32 FrameSize = ChannelCount*(uint32)sizeof(int16);
+		platform_file_handle *File = 0;
+		if(Audio->PlatformReadDataFromFile && Audio->StreamFiles)
+		{
+			File = GetStreamFile(Audio->StreamFiles, Audio->PlatformOpenFile, Stream->Filename);
+		}
+
+		// NOTE: Read through the platform's staging a piece at a time, each split into the chunk's planes
+		uint64 BytesRead = 0;
+		uint32 SamplesRead = 0;
+		uint32 StagingSampleCount = PLATFORM_STREAM_STAGING_SIZE / FrameSize;
+		while(File && (SamplesRead < Result->SampleCount))
+		{
+			uint32 PieceSampleCount = Minimum(StagingSampleCount, Result->SampleCount - SamplesRead);
+			uint64 PieceBytesRead = Audio->PlatformReadDataFromFile(File, Stream->DataOffset + (uint64)(FirstSample + SamplesRead)*FrameSize,
+																	PieceSampleCount*FrameSize, Audio->StreamStaging);
+			uint32 PieceSamplesRead = (uint32)(PieceBytesRead / FrameSize);
+			BytesRead += PieceBytesRead;
+
+			int16 *Source = (int16 *)Audio->StreamStaging;
+			if(ChannelCount == 2)
+			{
+				int16 *Dest0 = Result->Samples[0] + SamplesRead;
+				int16 *Dest1 = Result->Samples[1] + SamplesRead;
+				for(uint32 Index = 0; Index < PieceSamplesRead; ++Index)
+				{
+					*Dest0++ = *Source++;
+					*Dest1++ = *Source++;
+				}
+			}
+			else
+			{
+				for(uint32 Index = 0; Index < PieceSamplesRead; ++Index)
+				{
+					Result->Samples[0][SamplesRead + Index] = Source[Index];
+				}
+			}
+			SamplesRead += PieceSamplesRead;
+
+			if(PieceSamplesRead < PieceSampleCount)
+			{
+				break;
+			}
+		}
+
+		if(SamplesRead < Result->SampleCount)
+		{
+			++Stream->ShortReadCount;
+		}
+		++Stream->FetchCount;
+		Stream->BytesRead += BytesRead;
+
+		for(uint32 ChannelIndex = 0; ChannelIndex < ChannelCount; ++ChannelIndex)
+		{
+			for(uint32 Index = SamplesRead; Index < Result->SampleCount; ++Index)
+			{
+				Result->Samples[ChannelIndex][Index] = 0;
+			}
+		}
+	}
+	Result->LastUsed = UseCounter;
+
+	return Result;
+}
+
+internal void CloseSoundStream(game_memory *Memory, loaded_sound *Sound)
+{
+	if(Sound->Stream)
+	{
+		CloseStreamFile(Memory, Sound->Stream->Filename);
+	}
+}
+
+// NOTE: Zeroth order modified Bessel function of the first kind, for the Kaiser window. The series
+// converges quickly for the betas a filter ever uses.
+internal real32 BesselI0(real32 X)
+{
+	real32 Result = 1.0f;
+	real32 Term = 1.0f;
+	real32 HalfXSquared = 0.25f*X*X;
+	for(uint32 K = 1; K < 32; ++K)
+	{
+		Term *= HalfXSquared / (real32)(K*K);
+		Result += Term;
+	}
+	return Result;
+}
+
+// NOTE: Row Phase holds the taps for an output landing Phase/AUDIO_SINC_PHASE_COUNT of the way past
+// source sample i, and tap 0 lines up with sample i - (AUDIO_SINC_TAPS/2 - 1). The cutoff sits a
+// little under the source's Nyquist so the short filter still has room to roll off before its images.
+// Each row is normalized so a constant signal comes out unchanged.
+// TODO: Stepping faster than 1:1 needs the cutoff to drop with the step or the top end aliases,
+// which would mean a table per step range. Nothing plays downward conversions yet.
+internal void BuildSincTable(real32 *Table)
+{
+	real32 Cutoff = 0.9f;
+	real32 Beta = 8.0f;
+	real32 HalfWidth = (real32)(AUDIO_SINC_TAPS / 2);
+	real32 OneOverI0Beta = 1.0f / BesselI0(Beta);
+	for(uint32 Phase = 0; Phase <= AUDIO_SINC_PHASE_COUNT; ++Phase)
+	{
+		real32 *Row = Table + Phase*AUDIO_SINC_TAPS;
+		real32 Fraction = (real32)Phase / (real32)AUDIO_SINC_PHASE_COUNT;
+		real32 Sum = 0.0f;
+		for(uint32 Tap = 0; Tap < AUDIO_SINC_TAPS; ++Tap)
+		{
+			real32 X = (real32)((int32)Tap - (AUDIO_SINC_TAPS/2 - 1)) - Fraction;
+			real32 Sinc = Cutoff;
+			if(X != 0.0f)
+			{
+				Sinc = Sin(PI*Cutoff*X) / (PI*X);
+			}
+			real32 T = X / HalfWidth;
+			real32 Window = 0.0f;
+			if(T*T < 1.0f)
+			{
+				Window = BesselI0(Beta*SquareRoot(1.0f - T*T))*OneOverI0Beta;
+			}
+			Row[Tap] = Sinc*Window;
+			Sum += Row[Tap];
+		}
+		for(uint32 Tap = 0; Tap < AUDIO_SINC_TAPS; ++Tap)
+		{
+			Row[Tap] /= Sum;
+		}
+	}
+}
+
+internal void InitializeAudioState(audio_state *Audio, memory_arena *Arena, uint32 VoiceCapacity)
+{
+	*Audio = {};
+	Audio->VoiceCapacity = VoiceCapacity;
+	Audio->Voices = PushArray(Arena, VoiceCapacity, playing_sound);
+	Audio->SincTable = PushArray(Arena, (AUDIO_SINC_PHASE_COUNT + 1)*AUDIO_SINC_TAPS, real32);
+	BuildSincTable(Audio->SincTable);
+
+	// NOTE: Generations start at 1 so a zeroed sound_handle never matches a voice
+	for(uint32 VoiceIndex = VoiceCapacity; VoiceIndex > 0; --VoiceIndex)
+	{
+		playing_sound *Voice = Audio->Voices + VoiceIndex - 1;
+		*Voice = {};
+		Voice->Generation = 1;
+		Voice->Next = Audio->FirstFreePlayingSound;
+		Audio->FirstFreePlayingSound = Voice;
+	}
+}
+
+// NOTE: Equal power pan, -1 is hard left and 1 hard right, centered plays each side at ~0.707
+inline v2 PannedVolume(real32 Volume, real32 Pan)
+{
+	real32 Angle = 0.25f*PI*(fClamp(Pan, -1.0f, 1.0f) + 1.0f);
+	v2 Result = {Volume*Cos(Angle), Volume*Sin(Angle)};
+	return Result;
+}
+
+inline playing_sound *GetPlayingSound(audio_state *Audio, sound_handle Handle)
+{
+	playing_sound *Result = 0;
+	if(Handle.Index < Audio->VoiceCapacity)
+	{
+		playing_sound *Voice = Audio->Voices + Handle.Index;
+		if(Voice->Sound && (Voice->Generation == Handle.Generation))
+		{
+			Result = Voice;
+		}
+	}
+
+	return Result;
+}
+
+// NOTE: Returns a null handle when every voice is busy, which is safe to pass to the other calls
+internal sound_handle StartSound(audio_state *Audio, loaded_sound *Sound, v2 Volume, bool32 Looping)
+{
+	sound_handle Result = {};
+
+	Assert(Sound->SampleCount > 0);
+	playing_sound *Voice = Audio->FirstFreePlayingSound;
+	if(Voice)
+	{
+		Audio->FirstFreePlayingSound = Voice->Next;
+
+		uint32 Generation = Voice->Generation;
+		*Voice = {};
+		Voice->Sound = Sound;
+		Voice->Looping = Looping;
+		Voice->Pitch = 1.0f;
+		Voice->CurrentVolume = Voice->TargetVolume = Volume;
+		Voice->Generation = Generation;
+
+		Voice->Next = Audio->FirstPlayingSound;
+		Audio->FirstPlayingSound = Voice;
+		++Audio->PlayingCount;
+
+		Result.Index = (uint32)(Voice - Audio->Voices);
+		Result.Generation = Generation;
+	}
+
+	return Result;
+}
+
+internal void ChangeVolume(audio_state *Audio, sound_handle Handle, real32 FadeDurationInSeconds, v2 Volume)
+{
+	playing_sound *Voice = GetPlayingSound(Audio, Handle);
+	if(Voice)
+	{
+		Voice->TargetVolume = Volume;
+		if(FadeDurationInSeconds <= 0.0f)
+		{
+			Voice->CurrentVolume = Volume;
+			Voice->dCurrentVolume = V2(0, 0);
+		}
+		else
+		{
+			real32 OneOverFade = 1.0f / FadeDurationInSeconds;
+			Voice->dCurrentVolume = OneOverFade*(Volume - Voice->CurrentVolume);
+		}
+	}
+}
+
+internal void StopSound(audio_state *Audio, sound_handle Handle, real32 FadeDurationInSeconds)
+{
+	playing_sound *Voice = GetPlayingSound(Audio, Handle);
+	if(Voice)
+	{
+		ChangeVolume(Audio, Handle, FadeDurationInSeconds, V2(0, 0));
+		Voice->StopWhenSilent = true;
+	}
+}
+
+internal void ChangePitch(audio_state *Audio, sound_handle Handle, real32 Pitch)
+{
+	playing_sound *Voice = GetPlayingSound(Audio, Handle);
+	if(Voice)
+	{
+		Voice->Pitch = Pitch;
+	}
+}
+
+// NOTE: Adds Count samples of one voice into the accumulators, with the volume stepping by
+// dVolume every sample. Nothing here needs alignment, spans start wherever a loop or a fade ends.
+internal void MixSoundSpan(real32 *Dest0, real32 *Dest1, int16 *Source0, int16 *Source1,
+						   uint32 Count, v2 Volume, v2 dVolume)
+{
+	__m128 Volume0 = _mm_setr_ps(Volume.E[0], Volume.E[0] + dVolume.E[0],
+								 Volume.E[0] + 2.0f*dVolume.E[0], Volume.E[0] + 3.0f*dVolume.E[0]);
+	__m128 Volume1 = _mm_setr_ps(Volume.E[1], Volume.E[1] + dVolume.E[1],
+								 Volume.E[1] + 2.0f*dVolume.E[1], Volume.E[1] + 3.0f*dVolume.E[1]);
+	__m128 dVolume0 = _mm_set1_ps(4.0f*dVolume.E[0]);
+	__m128 dVolume1 = _mm_set1_ps(4.0f*dVolume.E[1]);
+
+	uint32 ChunkCount = Count / 4;
+	for(uint32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+	{
+		// NOTE: Sign extend four int16s to int32 by pairing each with itself and shifting back down
+		__m128i Raw0 = _mm_loadl_epi64((__m128i *)Source0);
+		__m128i Raw1 = _mm_loadl_epi64((__m128i *)Source1);
+		__m128 Sample0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Raw0, Raw0), 16));
+		__m128 Sample1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Raw1, Raw1), 16));
+
+		__m128 D0 = _mm_loadu_ps(Dest0);
+		__m128 D1 = _mm_loadu_ps(Dest1);
+		D0 = _mm_add_ps(D0, _mm_mul_ps(Sample0, Volume0));
+		D1 = _mm_add_ps(D1, _mm_mul_ps(Sample1, Volume1));
+		_mm_storeu_ps(Dest0, D0);
+		_mm_storeu_ps(Dest1, D1);
+
+		Volume0 = _mm_add_ps(Volume0, dVolume0);
+		Volume1 = _mm_add_ps(Volume1, dVolume1);
+		Source0 += 4;
+		Source1 += 4;
+		Dest0 += 4;
+		Dest1 += 4;
+	}
+
+	for(uint32 SampleIndex = 4*ChunkCount; SampleIndex < Count; ++SampleIndex)
+	{
+		real32 SampleVolume0 = Volume.E[0] + (real32)SampleIndex*dVolume.E[0];
+		real32 SampleVolume1 = Volume.E[1] + (real32)SampleIndex*dVolume.E[1];
+		*Dest0++ += SampleVolume0*(real32)(*Source0++);
+		*Dest1++ += SampleVolume1*(real32)(*Source1++);
+	}
+}
+
+// NOTE: Float sources, for voices that came through the resampler. Otherwise the same as MixSoundSpan.
+internal void MixRealSpan(real32 *Dest0, real32 *Dest1, real32 *Source0, real32 *Source1,
+						  uint32 Count, v2 Volume, v2 dVolume)
+{
+	__m128 Volume0 = _mm_setr_ps(Volume.E[0], Volume.E[0] + dVolume.E[0],
+								 Volume.E[0] + 2.0f*dVolume.E[0], Volume.E[0] + 3.0f*dVolume.E[0]);
+	__m128 Volume1 = _mm_setr_ps(Volume.E[1], Volume.E[1] + dVolume.E[1],
+								 Volume.E[1] + 2.0f*dVolume.E[1], Volume.E[1] + 3.0f*dVolume.E[1]);
+	__m128 dVolume0 = _mm_set1_ps(4.0f*dVolume.E[0]);
+	__m128 dVolume1 = _mm_set1_ps(4.0f*dVolume.E[1]);
+
+	uint32 ChunkCount = Count / 4;
+	for(uint32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+	{
+		__m128 D0 = _mm_loadu_ps(Dest0);
+		__m128 D1 = _mm_loadu_ps(Dest1);
+		D0 = _mm_add_ps(D0, _mm_mul_ps(_mm_loadu_ps(Source0), Volume0));
+		D1 = _mm_add_ps(D1, _mm_mul_ps(_mm_loadu_ps(Source1), Volume1));
+		_mm_storeu_ps(Dest0, D0);
+		_mm_storeu_ps(Dest1, D1);
+
+		Volume0 = _mm_add_ps(Volume0, dVolume0);
+		Volume1 = _mm_add_ps(Volume1, dVolume1);
+		Source0 += 4;
+		Source1 += 4;
+		Dest0 += 4;
+		Dest1 += 4;
+	}
+
+	for(uint32 SampleIndex = 4*ChunkCount; SampleIndex < Count; ++SampleIndex)
+	{
+		real32 SampleVolume0 = Volume.E[0] + (real32)SampleIndex*dVolume.E[0];
+		real32 SampleVolume1 = Volume.E[1] + (real32)SampleIndex*dVolume.E[1];
+		*Dest0++ += SampleVolume0*(*Source0++);
+		*Dest1++ += SampleVolume1*(*Source1++);
+	}
+}
+
+// NOTE: Points Source at SampleIndex and returns how many samples follow it contiguously, which for a
+// streamed sound is only as far as the end of the chunk holding it
+internal uint32 GetSoundSamples(audio_state *Audio, loaded_sound *Sound, uint32 SampleIndex,
+								int16 **Source0, int16 **Source1)
+{
+	uint32 Result;
+	if(Sound->Stream)
+	{
+		sound_stream_chunk *Chunk = FetchSoundStreamChunk(Audio, Sound, SampleIndex);
+		uint32 ChunkOffset = SampleIndex - Chunk->FirstSample;
+		*Source0 = Chunk->Samples[0] + ChunkOffset;
+		*Source1 = (Sound->ChannelCount > 1) ? (Chunk->Samples[1] + ChunkOffset) : *Source0;
+		Result = Chunk->SampleCount - ChunkOffset;
+	}
+	else
+	{
+		*Source0 = Sound->Samples[0] + SampleIndex;
+		*Source1 = (Sound->ChannelCount > 1) ? (Sound->Samples[1] + SampleIndex) : *Source0;
+		Result = Sound->SampleCount - SampleIndex;
+	}
+
+	return Result;
+}
+
+// NOTE: Copies Count samples starting at FirstSample out as floats. Looping sounds wrap around in
+// both directions, so the filter taps either side of the loop point see the other end of the sound.
+// One shots read silence before their start and past their end.
+internal void GatherSoundSamples(audio_state *Audio, loaded_sound *Sound, bool32 Looping,
+								 int64 FirstSample, uint32 Count, real32 *Dest0, real32 *Dest1)
+{
+	int64 SampleCount = Sound->SampleCount;
+	uint32 Gathered = 0;
+	while(Gathered < Count)
+	{
+		int64 SampleIndex = FirstSample + Gathered;
+		if(Looping)
+		{
+			SampleIndex %= SampleCount;
+			if(SampleIndex < 0)
+			{
+				SampleIndex += SampleCount;
+			}
+		}
+
+		uint32 RunCount = Count - Gathered;
+		if((SampleIndex < 0) || (SampleIndex >= SampleCount))
+		{
+			if(SampleIndex < 0)
+			{
+				RunCount = (uint32)Minimum((int64)RunCount, -SampleIndex);
+			}
+			for(uint32 Index = 0; Index < RunCount; ++Index)
+			{
+				Dest0[Gathered + Index] = 0.0f;
+				Dest1[Gathered + Index] = 0.0f;
+			}
+		}
+		else
+		{
+			int16 *Source0;
+			int16 *Source1;
+			uint32 SamplesAvailable = GetSoundSamples(Audio, Sound, (uint32)SampleIndex, &Source0, &Source1);
+			RunCount = Minimum(RunCount, SamplesAvailable);
+			for(uint32 Index = 0; Index < RunCount; ++Index)
+			{
+				Dest0[Gathered + Index] = (real32)Source0[Index];
+				Dest1[Gathered + Index] = (real32)Source1[Index];
+			}
+		}
+
+		Gathered += RunCount;
+	}
+}
+
+// NOTE: Source starts AUDIO_SINC_TAPS/2 - 1 samples before the one the first output follows, and
+// Position is 32.32 relative to that one. Each output is 16 taps, four SSE multiplies a channel,
+// with both channels' horizontal sums done together at the end. The bits of the fraction below the
+// phase blend between neighbouring rows, snapping to the nearest row instead costs ~25dB at 10kHz.
+internal void ResampleSinc(real32 *Dest0, real32 *Dest1, real32 *Source0, real32 *Source1,
+						   uint64 Position, uint64 Step, uint32 Count, real32 *SincTable)
+{
+	real32 OneOverFractionScale = 1.0f / (real32)(1 << 24);
+	for(uint32 SampleIndex = 0; SampleIndex < Count; ++SampleIndex)
+	{
+		uint32 Index = (uint32)(Position >> 32);
+		uint32 Phase = (uint32)Position >> (32 - AUDIO_SINC_PHASE_BITS);
+		uint32 PhaseFraction = ((uint32)Position << AUDIO_SINC_PHASE_BITS) >> 8;
+		__m128 t = _mm_set1_ps((real32)PhaseFraction*OneOverFractionScale);
+		real32 *Coefficients = SincTable + Phase*AUDIO_SINC_TAPS;
+		real32 *Taps0 = Source0 + Index;
+		real32 *Taps1 = Source1 + Index;
+
+		__m128 Sum0 = _mm_setzero_ps();
+		__m128 Sum1 = _mm_setzero_ps();
+		for(uint32 Tap = 0; Tap < AUDIO_SINC_TAPS; Tap += 4)
+		{
+			__m128 A = _mm_loadu_ps(Coefficients + Tap);
+			__m128 B = _mm_loadu_ps(Coefficients + AUDIO_SINC_TAPS + Tap);
+			__m128 C = _mm_add_ps(A, _mm_mul_ps(t, _mm_sub_ps(B, A)));
+			Sum0 = _mm_add_ps(Sum0, _mm_mul_ps(C, _mm_loadu_ps(Taps0 + Tap)));
+			Sum1 = _mm_add_ps(Sum1, _mm_mul_ps(C, _mm_loadu_ps(Taps1 + Tap)));
+		}
+
+		// NOTE: a0+a2 b0+b2 a1+a3 b1+b3, then the high half folded onto the low
+		__m128 Pairs = _mm_add_ps(_mm_unpacklo_ps(Sum0, Sum1), _mm_unpackhi_ps(Sum0, Sum1));
+		__m128 Sums = _mm_add_ps(Pairs, _mm_movehl_ps(Pairs, Pairs));
+		Dest0[SampleIndex] = _mm_cvtss_f32(Sums);
+		Dest1[SampleIndex] = _mm_cvtss_f32(_mm_shuffle_ps(Sums, Sums, 1));
+
+		Position += Step;
+	}
+}
+
+// NOTE: Source starts at the sample the first output follows. Four outputs at a time, the sample
+// pairs have to be picked up one by one but the blend is vectorized.
+internal void ResampleLinear(real32 *Dest0, real32 *Dest1, real32 *Source0, real32 *Source1,
+							 uint64 Position, uint64 Step, uint32 Count)
+{
+	real32 OneOverFractionScale = 1.0f / (real32)(1 << 24);
+	uint32 ChunkCount = Count / 4;
+	for(uint32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+	{
+		uint32 Index[4];
+		real32 t[4];
+		for(uint32 Lane = 0; Lane < 4; ++Lane)
+		{
+			Index[Lane] = (uint32)(Position >> 32);
+			t[Lane] = (real32)((uint32)Position >> 8)*OneOverFractionScale;
+			Position += Step;
+		}
+
+		__m128 T = _mm_loadu_ps(t);
+		__m128 A0 = _mm_setr_ps(Source0[Index[0]], Source0[Index[1]], Source0[Index[2]], Source0[Index[3]]);
+		__m128 B0 = _mm_setr_ps(Source0[Index[0] + 1], Source0[Index[1] + 1], Source0[Index[2] + 1], Source0[Index[3] + 1]);
+		__m128 A1 = _mm_setr_ps(Source1[Index[0]], Source1[Index[1]], Source1[Index[2]], Source1[Index[3]]);
+		__m128 B1 = _mm_setr_ps(Source1[Index[0] + 1], Source1[Index[1] + 1], Source1[Index[2] + 1], Source1[Index[3] + 1]);
+		_mm_storeu_ps(Dest0 + 4*ChunkIndex, _mm_add_ps(A0, _mm_mul_ps(T, _mm_sub_ps(B0, A0))));
+		_mm_storeu_ps(Dest1 + 4*ChunkIndex, _mm_add_ps(A1, _mm_mul_ps(T, _mm_sub_ps(B1, A1))));
+	}
+
+	for(uint32 SampleIndex = 4*ChunkCount; SampleIndex < Count; ++SampleIndex)
+	{
+		uint32 Index = (uint32)(Position >> 32);
+		real32 t = (real32)((uint32)Position >> 8)*OneOverFractionScale;
+		Dest0[SampleIndex] = Source0[Index] + t*(Source0[Index + 1] - Source0[Index]);
+		Dest1[SampleIndex] = Source1[Index] + t*(Source1[Index + 1] - Source1[Index]);
+		Position += Step;
+	}
+}
+
+// NOTE: Source samples per output sample in 32.32, from the voice's pitch and the two rates
+inline uint64 GetSampleStep(playing_sound *PlayingSound, uint32 OutputSamplesPerSecond)
+{
+	real64 Ratio = (real64)PlayingSound->Pitch;
+	uint32 SoundSamplesPerSecond = PlayingSound->Sound->SamplesPerSecond;
+	if(SoundSamplesPerSecond && (SoundSamplesPerSecond != OutputSamplesPerSecond))
+	{
+		Ratio *= (real64)SoundSamplesPerSecond / (real64)OutputSamplesPerSecond;
+	}
+	if(Ratio < 1.0 / 64.0)
+	{
+		Ratio = 1.0 / 64.0;
+	}
+	if(Ratio > (real64)AUDIO_MAX_SAMPLE_STEP)
+	{
+		Ratio = (real64)AUDIO_MAX_SAMPLE_STEP;
+	}
+
+	uint64 Result = (uint64)(Ratio*4294967296.0 + 0.5);
+	return Result;
+}
+
+internal void OutputPlayingSounds(audio_state *Audio, game_sound_output_buffer *SoundBuffer, memory_arena *TempArena)
+{
+	TIMED_FUNCTION();
+
+	temporary_memory MixerMemory = BeginTemporaryMemory(TempArena);
+
+	// NOTE: Rounded up so the zeroing and the conversion can run whole chunks of four
+	uint32 SampleCount = (uint32)SoundBuffer->SampleCount;
+	uint32 ChunkCount = (SampleCount + 3) / 4;
+	real32 *RealChannel0 = PushArray(TempArena, 4*ChunkCount, real32);
+	real32 *RealChannel1 = PushArray(TempArena, 4*ChunkCount, real32);
+
+	__m128 Zero = _mm_setzero_ps();
+	for(uint32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+	{
+		_mm_storeu_ps(RealChannel0 + 4*ChunkIndex, Zero);
+		_mm_storeu_ps(RealChannel1 + 4*ChunkIndex, Zero);
+	}
+
+	// NOTE: Resampler scratch, the gathered source for one block and the block's converted output
+	uint32 GatherCapacity = AUDIO_RESAMPLE_BLOCK*AUDIO_MAX_SAMPLE_STEP + AUDIO_SINC_TAPS + 1;
+	real32 *Gathered0 = PushArray(TempArena, GatherCapacity, real32);
+	real32 *Gathered1 = PushArray(TempArena, GatherCapacity, real32);
+	real32 *Resampled0 = PushArray(TempArena, AUDIO_RESAMPLE_BLOCK, real32);
+	real32 *Resampled1 = PushArray(TempArena, AUDIO_RESAMPLE_BLOCK, real32);
+
+	uint32 OutputSamplesPerSecond = (uint32)SoundBuffer->SamplesPerSecond;
+	real32 SecondsPerSample = 1.0f / (real32)SoundBuffer->SamplesPerSecond;
+	for(playing_sound **PlayingSoundPtr = &Audio->FirstPlayingSound; *PlayingSoundPtr;)
+	{
+		playing_sound *PlayingSound = *PlayingSoundPtr;
+		loaded_sound *Sound = PlayingSound->Sound;
+
+		real32 *Dest0 = RealChannel0;
+		real32 *Dest1 = RealChannel1;
+		uint32 TotalSamplesToMix = SampleCount;
+		bool32 SoundFinished = false;
+		uint64 Step = GetSampleStep(PlayingSound, OutputSamplesPerSecond);
+		while(TotalSamplesToMix && !SoundFinished)
+		{
+			uint32 SamplesToMix = TotalSamplesToMix;
+
+			// NOTE: A span stops where a fade ends, so the ramp lands exactly on its target
+			v2 dVolume = SecondsPerSample*PlayingSound->dCurrentVolume;
+			uint32 VolumeSampleCount[2] = {};
+			for(uint32 ChannelIndex = 0; ChannelIndex < 2; ++ChannelIndex)
+			{
+				if(dVolume.E[ChannelIndex] != 0.0f)
+				{
+					real32 DeltaVolume = PlayingSound->TargetVolume.E[ChannelIndex] - PlayingSound->CurrentVolume.E[ChannelIndex];
+					VolumeSampleCount[ChannelIndex] = (uint32)((DeltaVolume / dVolume.E[ChannelIndex]) + 0.5f);
+					SamplesToMix = Minimum(SamplesToMix, VolumeSampleCount[ChannelIndex]);
+				}
+			}
+
+			bool32 ReachedEnd = false;
+			if((Step == ((uint64)1 << 32)) && (PlayingSound->SampleFraction == 0))
+			{
+				// NOTE: 1:1, mixed straight from the sound. A streamed sound can only be mixed up
+				// to the end of the chunk that's resident.
+				int16 *Source0;
+				int16 *Source1;
+				uint32 SamplesAvailable = GetSoundSamples(Audio, Sound, PlayingSound->SamplesPlayed, &Source0, &Source1);
+				SamplesToMix = Minimum(SamplesToMix, SamplesAvailable);
+
+				MixSoundSpan(Dest0, Dest1, Source0, Source1, SamplesToMix, PlayingSound->CurrentVolume, dVolume);
+
+				PlayingSound->SamplesPlayed += SamplesToMix;
+				if(PlayingSound->SamplesPlayed == Sound->SampleCount)
+				{
+					PlayingSound->SamplesPlayed = 0;
+					ReachedEnd = true;
+				}
+			}
+			else
+			{
+				uint64 Position = ((uint64)PlayingSound->SamplesPlayed << 32) | PlayingSound->SampleFraction;
+				uint64 End = (uint64)Sound->SampleCount << 32;
+				SamplesToMix = Minimum(SamplesToMix, AUDIO_RESAMPLE_BLOCK);
+				if(!PlayingSound->Looping)
+				{
+					// NOTE: Only as many outputs as still land inside the sound
+					uint64 OutputsLeft = (End - Position + Step - 1) / Step;
+					SamplesToMix = (uint32)Minimum((uint64)SamplesToMix, OutputsLeft);
+				}
+
+				if(SamplesToMix)
+				{
+					uint64 BlockPosition = Position & 0xFFFFFFFF;
+					uint32 LastIndex = (uint32)((BlockPosition + (uint64)(SamplesToMix - 1)*Step) >> 32);
+					uint32 TapsBefore = 0;
+					uint32 TapsAfter = 1;
+					if(Audio->ResampleMode == ResampleMode_Sinc)
+					{
+						TapsBefore = AUDIO_SINC_TAPS/2 - 1;
+						TapsAfter = AUDIO_SINC_TAPS/2;
+					}
+
+					GatherSoundSamples(Audio, Sound, PlayingSound->Looping,
+									   (int64)PlayingSound->SamplesPlayed - (int64)TapsBefore,
+									   TapsBefore + LastIndex + TapsAfter + 1, Gathered0, Gathered1);
+					if(Audio->ResampleMode == ResampleMode_Sinc)
+					{
+						ResampleSinc(Resampled0, Resampled1, Gathered0, Gathered1,
+									 BlockPosition, Step, SamplesToMix, Audio->SincTable);
+					}
+					else
+					{
+						ResampleLinear(Resampled0, Resampled1, Gathered0, Gathered1,
+									   BlockPosition, Step, SamplesToMix);
+					}
+					MixRealSpan(Dest0, Dest1, Resampled0, Resampled1, SamplesToMix, PlayingSound->CurrentVolume, dVolume);
+				}
+
+				Position += (uint64)SamplesToMix*Step;
+				if(Position >= End)
+				{
+					Position %= End;
+					ReachedEnd = true;
+				}
+				PlayingSound->SamplesPlayed = (uint32)(Position >> 32);
+				PlayingSound->SampleFraction = (uint32)Position;
+			}
+
+			bool32 VolumeEnded[2] = {};
+			for(uint32 ChannelIndex = 0; ChannelIndex < 2; ++ChannelIndex)
+			{
+				VolumeEnded[ChannelIndex] = ((dVolume.E[ChannelIndex] != 0.0f) &&
+											 (VolumeSampleCount[ChannelIndex] <= SamplesToMix));
+			}
+
+			Dest0 += SamplesToMix;
+			Dest1 += SamplesToMix;
+			TotalSamplesToMix -= SamplesToMix;
+
+			PlayingSound->CurrentVolume += (real32)SamplesToMix*dVolume;
+			for(uint32 ChannelIndex = 0; ChannelIndex < 2; ++ChannelIndex)
+			{
+				if(VolumeEnded[ChannelIndex])
+				{
+					PlayingSound->CurrentVolume.E[ChannelIndex] = PlayingSound->TargetVolume.E[ChannelIndex];
+					PlayingSound->dCurrentVolume.E[ChannelIndex] = 0.0f;
+				}
+			}
+
+			if(PlayingSound->StopWhenSilent &&
+			   (PlayingSound->dCurrentVolume.E[0] == 0.0f) && (PlayingSound->dCurrentVolume.E[1] == 0.0f))
+			{
+				SoundFinished = true;
+			}
+			else if(ReachedEnd && !PlayingSound->Looping)
+			{
+				SoundFinished = true;
+			}
+		}
+
+		if(SoundFinished)
+		{
+			*PlayingSoundPtr = PlayingSound->Next;
+			--Audio->PlayingCount;
+
+			++PlayingSound->Generation;
+			PlayingSound->Sound = 0;
+			PlayingSound->Next = Audio->FirstFreePlayingSound;
+			Audio->FirstFreePlayingSound = PlayingSound;
+		}
+		else
+		{
+			PlayingSoundPtr = &PlayingSound->Next;
+		}
+	}
+
+	// NOTE: Clamp before converting, out of range floats convert to 0x80000000 which packs to
+	// -32768 no matter which way they overflowed
+	__m128 MaxSample = _mm_set1_ps(32767.0f);
+	__m128 MinSample = _mm_set1_ps(-32768.0f);
+	uint32 WholeChunkCount = SampleCount / 4;
+	int16 *SampleOut = SoundBuffer->Samples;
+	for(uint32 ChunkIndex = 0; ChunkIndex < WholeChunkCount; ++ChunkIndex)
+	{
+		__m128 S0 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(RealChannel0 + 4*ChunkIndex), MinSample), MaxSample);
+		__m128 S1 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(RealChannel1 + 4*ChunkIndex), MinSample), MaxSample);
+		__m128i L = _mm_cvtps_epi32(S0);
+		__m128i R = _mm_cvtps_epi32(S1);
+
+		// NOTE: L0 R0 L1 R1 and L2 R2 L3 R3 as int32, then saturated down to eight interleaved int16s
+		__m128i LR0 = _mm_unpacklo_epi32(L, R);
+		__m128i LR1 = _mm_unpackhi_epi32(L, R);
+		_mm_storeu_si128((__m128i *)SampleOut, _mm_packs_epi32(LR0, LR1));
+		SampleOut += 8;
+	}
+
+	for(uint32 SampleIndex = 4*WholeChunkCount; SampleIndex < SampleCount; ++SampleIndex)
+	{
+		*SampleOut++ = (int16)RoundReal32ToInt32(fClamp(RealChannel0[SampleIndex], -32768.0f, 32767.0f));
+		*SampleOut++ = (int16)RoundReal32ToInt32(fClamp(RealChannel1[SampleIndex], -32768.0f, 32767.0f));
+	}
+
+	EndTemporaryMemory(MixerMemory);
+}
@@ -0,0 +1,138 @@
+#ifndef HANDMADE_AUDIO_H
+#define HANDMADE_AUDIO_H
+
+/*
+	NOTE: Software mixer
+
+	Every playing sound is a voice out of a fixed pool. Voices are mixed into float accumulation
+	buffers, one per output channel, four samples per SSE instruction, and only the final sum is
+	converted down to interleaved int16 with saturation, so loud voices clip once at the end instead
+	of wrapping along the way.
+
+	Volume is a gain per channel, 1.0 plays the sound as recorded. Changes ramp linearly over the
+	requested fade time, sample by sample, so volume and pan moves don't click.
+
+	Callers hold sound_handles rather than pointers. A voice that has finished goes back on the free
+	list with its generation bumped, which makes any handle still pointing at it go stale instead of
+	silently steering whatever sound reuses the slot.
+
+	Long sounds can be streamed instead of loaded. A streamed sound keeps its file open and only a
+	handful of fixed size chunks resident, and the mixer pulls the chunk covering the samples it
+	is about to mix, reading it from the file if it isn't there already. The open file itself is
+	kept with the platform by name, since game memory gets restored where the handle means nothing.
+
+	A voice whose sound was recorded at another rate, or that has been given a pitch, is resampled
+	on the way into the mix. Its position is kept in 32.32 fixed point so it never drifts, and each
+	block of output first copies the source samples it will touch, loop wraps and stream chunks
+	included, into a float scratch buffer, so the filters never have to worry about where they are
+	reading from and carry no state of their own. Voices playing at exactly 1:1 skip all of this.
+*/
+
+// NOTE: 16384 samples is about a third of a second at 48kHz, 64KB per stereo chunk
+#define SOUND_STREAM_CHUNK_SAMPLES 16384
+#define SOUND_STREAM_CHUNK_COUNT 4
+
+// NOTE: Sinc is a 16 tap Kaiser windowed sinc tabulated at 256 fractional phases. Each output sample
+// blends the two rows either side of its phase and dots that with the samples around it. Linear
+// interpolation costs about a third as much and is fine for effects, but lets images of the source
+// through.
+enum resample_mode
+{
+	ResampleMode_Sinc,
+	ResampleMode_Linear,
+};
+
+#define AUDIO_SINC_TAPS 16
+#define AUDIO_SINC_PHASE_BITS 8
+#define AUDIO_SINC_PHASE_COUNT (1 << AUDIO_SINC_PHASE_BITS)
+
+// NOTE: Output samples per resampled block, and the furthest a voice may step through its source per
+// output sample. Together they bound the scratch the mixer needs per block.
+#define AUDIO_RESAMPLE_BLOCK 256
+#define AUDIO_MAX_SAMPLE_STEP 8
+
+struct sound_stream_chunk
+{
+	// NOTE: SampleCount is 0 while the chunk holds nothing
+	uint32 FirstSample;
+	uint32 SampleCount;
+	uint32 LastUsed;
+	int16 *Samples[2];
+};
+
+struct sound_stream
+{
+	// NOTE: Looks up the open file in the platform's stream files, see platform_stream_file
+	char Filename[PLATFORM_STREAM_FILENAME_LENGTH];
+	uint64 DataOffset;
+
+	uint32 UseCounter;
+	sound_stream_chunk Chunks[SOUND_STREAM_CHUNK_COUNT];
+
+	uint32 FetchCount;
+	uint32 ShortReadCount;
+	uint64 BytesRead;
+};
+
+// NOTE: Sample data is planar, one array per channel. Mono sounds play the same samples on both sides.
+// Streamed sounds leave Samples empty and go through Stream instead.
+struct loaded_sound
+{
+	uint32 SampleCount;
+	uint32 ChannelCount;
+	uint32 SamplesPerSecond;
+	int16 *Samples[2];
+
+	sound_stream *Stream;
+};
+
+struct sound_handle
+{
+	uint32 Index;
+	uint32 Generation;
+};
+
+struct playing_sound
+{
+	loaded_sound *Sound;
+	uint32 SamplesPlayed;
+	// NOTE: In 1/2^32ths of a sample, only ever nonzero for a resampled voice
+	uint32 SampleFraction;
+	// NOTE: 1.0 plays at the sound's own rate, 2.0 an octave up
+	real32 Pitch;
+	bool32 Looping;
+	// NOTE: Set by StopSound, the voice is freed once its fade out reaches silence
+	bool32 StopWhenSilent;
+
+	v2 CurrentVolume;
+	// NOTE: Per second, the mixer converts to per sample once it knows the output rate
+	v2 dCurrentVolume;
+	v2 TargetVolume;
+
+	uint32 Generation;
+	playing_sound *Next;
+};
+
+struct audio_state
+{
+	uint32 VoiceCapacity;
+	playing_sound *Voices;
+
+	playing_sound *FirstPlayingSound;
+	playing_sound *FirstFreePlayingSound;
+	uint32 PlayingCount;
+
+	resample_mode ResampleMode;
+	// NOTE: AUDIO_SINC_PHASE_COUNT + 1 rows of AUDIO_SINC_TAPS coefficients, the last one being a
+	// whole sample along so the blend never has to wrap
+	real32 *SincTable;
+
+	// NOTE: Bound again on every call into the mixer by BindAudioPlatform, like any other code address
+	// kept in game memory. The stream files and staging belong to the platform's game_memory.
+	platform_open_file *PlatformOpenFile;
+	platform_read_data_from_file *PlatformReadDataFromFile;
+	platform_stream_file *StreamFiles;
+	uint8 *StreamStaging;
+};
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef HANDMADE_DEBUG_H
+#define HANDMADE_DEBUG_H
+
+/*
+	NOTE: Timed blocks
+
+	TIMED_FUNCTION() or TIMED_BLOCK("Name") at the top of a scope, or BEGIN_BLOCK("Name") and
+	END_BLOCK() around a stretch of code that isn't one, read the cycle counter on the way in and on
+	the way out. Nothing gets added up here. Every begin and end goes into the recording thread's own
+	log as an event, and once a frame the platform drains the logs and builds the call tree out of
+	them (handmade_profiler.h).
+
+	Each log is a single producer, single consumer ring like the sound ring. Only its thread writes
+	events and only the platform's collation reads them, so recording is a handful of stores with no
+	locked instructions. A thread claims a log the first time it records anything, by compare
+	exchanging its ID into a free slot. A full log drops the event and counts it rather than wait.
+
+	A block is identified by a string with static storage, file and line and name pasted together by
+	the preprocessor, so events only carry a pointer. The string lives in whichever module recorded
+	it, and the collation copies it before the game code can be reloaded out from under it.
+
+	The table itself is allocated by the platform and handed over in game_memory, so the game and
+	the platform record into the same logs. Null means nobody is listening and blocks cost a branch.
+	HANDMADE_PROFILE 0 compiles all of it out.
+*/
+
+// NOTE: Both powers of two. A frame of the 10k entity bench scene records ~100k events on the
+// game thread, the pages of logs nobody writes to are never touched.
+#define DEBUG_MAX_THREAD_COUNT 16
+#define DEBUG_THREAD_EVENT_COUNT (1 << 17)
+
+enum debug_event_type
+{
+	DebugEvent_BeginBlock,
+	DebugEvent_EndBlock,
+};
+
+struct debug_event
+{
+	uint64 Clock;
+	// NOTE: Null on an EndBlock, ends pair with the innermost open begin on their thread
+	char *GUID;
+	uint32 Type;
+};
+
+struct debug_thread_log
+{
+	// NOTE: 0 while the slot is unclaimed
+	uint32 volatile ThreadID;
+
+	// NOTE: Only the owning thread writes these
+	uint64 volatile WriteIndex;
+	uint32 volatile DroppedCount;
+
+	// NOTE: Only the collation writes this
+	uint64 volatile ReadIndex;
+
+	debug_event Events[DEBUG_THREAD_EVENT_COUNT];
+};
+
+struct debug_table
+{
+	// NOTE: Set once any thread has found every log taken, its events go nowhere
+	bool32 volatile OutOfLogs;
+	debug_thread_log Logs[DEBUG_MAX_THREAD_COUNT];
+};
+
+#if HANDMADE_PROFILE
+
+// NOTE: One per module, the game sets its copy from game_memory on every call in
+global_variable debug_table *GlobalDebugTable;
+
+inline debug_thread_log *GetDebugThreadLog(debug_table *Table)
+{
+	debug_thread_log *Result = 0;
+
+	uint32 ThreadID = GetThreadID();
+	// NOTE: IDs tend to be multiples of 4 or of the stack size, so spread them before masking
+	uint32 Slot = (ThreadID*2654435761u) >> 16;
+	for(uint32 Probe = 0; Probe < DEBUG_MAX_THREAD_COUNT; ++Probe)
+	{
+		debug_thread_log *Log = Table->Logs + ((Slot + Probe) & (DEBUG_MAX_THREAD_COUNT - 1));
+		uint32 LogThreadID = Log->ThreadID;
+		if(LogThreadID == ThreadID)
+		{
+			Result = Log;
+			break;
+		}
+		if((LogThreadID == 0) && (AtomicCompareExchangeUInt32(&Log->ThreadID, ThreadID, 0) == 0))
+		{
+			Result = Log;
+			break;
+		}
+	}
+
+	if(!Result)
+	{
+		Table->OutOfLogs = true;
+	}
+
+	return Result;
+}
+
+inline void RecordDebugEvent(uint32 Type, char *GUID)
+{
+	debug_table *Table = GlobalDebugTable;
+	if(Table)
+	{
+		debug_thread_log *Log = GetDebugThreadLog(Table);
+		if(Log)
+		{
+			uint64 WriteIndex = Log->WriteIndex;
+			if((WriteIndex - Log->ReadIndex) < DEBUG_THREAD_EVENT_COUNT)
+			{
+				debug_event *Event = Log->Events + (WriteIndex & (DEBUG_THREAD_EVENT_COUNT - 1));
+				Event->Clock = __rdtsc();
+				Event->GUID = GUID;
+				Event->Type = Type;
+
+				CompletePreviousWritesBeforeFutureWrites;
+				Log->WriteIndex = WriteIndex + 1;
+			}
+			else
+			{
+				++Log->DroppedCount;
+			}
+		}
+	}
+}
+
+struct timed_block
+{
+	timed_block(char *GUID)
+	{
+		RecordDebugEvent(DebugEvent_BeginBlock, GUID);
+	}
+
+	~timed_block()
+	{
+		RecordDebugEvent(DebugEvent_EndBlock, 0);
+	}
+};
+
+#define DEBUG_NAME__(File, Line, Name) File "(" #Line ") " Name
+#define DEBUG_NAME_(File, Line, Name) DEBUG_NAME__(File, Line, Name)
+#define DEBUG_NAME(Name) DEBUG_NAME_(__FILE__, __LINE__, Name)
+
+#define TIMED_BLOCK__(GUID, Number) timed_block TimedBlock_##Number(GUID)
+#define TIMED_BLOCK_(GUID, Number) TIMED_BLOCK__(GUID, Number)
+#define TIMED_BLOCK(Name) TIMED_BLOCK_(DEBUG_NAME(Name), __LINE__)
+// NOTE: __FUNCTION__ isn't a literal so it can't be pasted onto the file and line, but it is
+// already one static string per function
+#define TIMED_FUNCTION() TIMED_BLOCK_((char *)__FUNCTION__, __LINE__)
+
+#define BEGIN_BLOCK(Name) RecordDebugEvent(DebugEvent_BeginBlock, DEBUG_NAME(Name))
+#define END_BLOCK() RecordDebugEvent(DebugEvent_EndBlock, 0)
+
+#else
+
+#define TIMED_BLOCK(Name)
+#define TIMED_FUNCTION()
+#define BEGIN_BLOCK(Name)
+#define END_BLOCK()
+
+#endif
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef HANDMADE_DIRTY_PAGES_H
+#define HANDMADE_DIRTY_PAGES_H
+
+/*
+	NOTE: Tracks which pages of a block have been written, so copies between it and a snapshot of
+	it only have to move what changed. Shared by the platform layers.
+
+	Windows has write watch for this, the block has to be allocated with MEM_WRITE_WATCH. Linux
+	has soft-dirty bits in /proc/self/pagemap, but only with CONFIG_MEM_SOFT_DIRTY, which plenty of
+	kernels leave out, so here the block is mprotected read-only instead and the first write to each
+	page faults into a SIGSEGV handler that notes the page and makes it writable again. A page costs
+	one fault per collection it is written in, and the 4KB protections split any transparent huge
+	pages the block was on. Only one block per process can be tracked on Linux, and the kernel's
+	own writes into it (a read() straight into game memory) fail with EFAULT instead of faulting,
+	so the platform's file reads bounce through a buffer of their own.
+
+	Each page has a byte of view bits, one per consumer that wants to know what changed since it
+	last looked (a replay buffer, a recording's keyframe shadow). CollectDirtyPages takes what the
+	OS has seen written since the last collection, sets every view's bit for those pages, and starts
+	watching afresh; on Windows the query and the reset are one atomic call. A view clears its own
+	bits as it copies them or by ClearDirtyPages. Collect with no other thread writing the block:
+	the OS side never loses a write, but one that lands while the collection runs can be counted in
+	this collection when the caller is about to copy the page out from under it.
+*/
+
+#define DIRTY_PAGE_VIEW_COUNT 8
+
+struct dirty_page_tracker
+{
+	uint8 *Base;
+	uint64 Size;
+	uint64 PageSize;
+	uint64 PageCount;
+
+	// NOTE: A byte per page, bit N set while view N hasn't caught up with the page's last write
+	uint8 *Views;
+
+#if _WIN32
+	ULONG_PTR AddressCapacity;
+	void **Addresses;
+#else
+	// NOTE: A byte per page, set by the fault handler and taken by CollectDirtyPages
+	uint8 volatile *Written;
+	// NOTE: Set when a page couldn't be made writable on its own, see DirtyPageFaultHandler
+	bool32 volatile Overflowed;
+#endif
+};
+
+#if _WIN32
+internal bool32 BeginDirtyPageTracking(dirty_page_tracker *Tracker, void *Base, uint64 Size)
+{
+	SYSTEM_INFO SystemInfo;
+	GetSystemInfo(&SystemInfo);
+
+	Tracker->Base = (uint8 *)Base;
+	Tracker->Size = Size;
+	Tracker->PageSize = SystemInfo.dwPageSize;
+	Tracker->PageCount = (Size + Tracker->PageSize - 1) / Tracker->PageSize;
+	// NOTE: 64k page addresses per GetWriteWatch call covers 256MB of 4k pages at a time
+	Tracker->AddressCapacity = 65536;
+	Tracker->Views = (uint8 *)VirtualAlloc(0, (SIZE_T)Tracker->PageCount, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	Tracker->Addresses = (void **)VirtualAlloc(0, Tracker->AddressCapacity*sizeof(void *),
+											   MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+	bool32 Result = (Tracker->Views && Tracker->Addresses && (ResetWriteWatch(Base, (SIZE_T)Size) == 0));
+	if(!Result)
+	{
+		Tracker->Views = 0;
+	}
+
+	return Result;
+}
+
+internal void CollectDirtyPages(dirty_page_tracker *Tracker)
+{
+	// NOTE: Walk the block in windows no bigger than the address array, so GetWriteWatch never
+	// runs out of room
+	uint64 WindowSize = (uint64)Tracker->AddressCapacity*Tracker->PageSize;
+	for(uint64 WindowOffset = 0; WindowOffset < Tracker->Size; WindowOffset += WindowSize)
+	{
+		uint8 *Window = Tracker->Base + WindowOffset;
+		SIZE_T ThisWindowSize = (SIZE_T)Minimum(WindowSize, Tracker->Size - WindowOffset);
+
+		ULONG_PTR AddressCount = Tracker->AddressCapacity;
+		ULONG PageSize;
+		if(GetWriteWatch(WRITE_WATCH_FLAG_RESET, Window, ThisWindowSize, Tracker->Addresses,
+						 &AddressCount, &PageSize) == 0)
+		{
+			for(ULONG_PTR AddressIndex = 0; AddressIndex < AddressCount; ++AddressIndex)
+			{
+				uint64 PageIndex = ((uint8 *)Tracker->Addresses[AddressIndex] - Tracker->Base) / Tracker->PageSize;
+				Tracker->Views[PageIndex] = 0xFF;
+			}
+		}
+		else
+		{
+			// TODO diagnostic, write watch should never fail on our own block
+			Assert(!"GetWriteWatch failed");
+		}
+	}
+}
+
+internal void EndDirtyPageTracking(dirty_page_tracker *Tracker)
+{
+	if(Tracker->Views)
+	{
+		VirtualFree(Tracker->Views, 0, MEM_RELEASE);
+		VirtualFree(Tracker->Addresses, 0, MEM_RELEASE);
+		Tracker->Views = 0;
+	}
+}
+#else
+global_variable dirty_page_tracker *GlobalDirtyPageTracker;
+global_variable struct sigaction GlobalDirtyPagePreviousAction;
+
+/*
+	NOTE: Makes the pages writable before noting them, so a collection that runs in between at
+	worst protects them again and the write faults a second time. The other order could leave a
+	writable page that no collection knows about.
+
+	Every run of pages with a protection of its own splits the block's mapping, and the kernel only
+	allows vm.max_map_count of them. When a run can't be split off the whole block is made
+	writable, which merges it back into one mapping, and the next collection counts every page as
+	written.
+*/
+internal void MarkDirtyPagesWritten(dirty_page_tracker *Tracker, uint64 FirstPageIndex, uint64 OnePastLastPageIndex)
+{
+	if(mprotect(Tracker->Base + FirstPageIndex*Tracker->PageSize,
+				(OnePastLastPageIndex - FirstPageIndex)*Tracker->PageSize, PROT_READ | PROT_WRITE) == 0)
+	{
+		for(uint64 PageIndex = FirstPageIndex; PageIndex < OnePastLastPageIndex; ++PageIndex)
+		{
+			Tracker->Written[PageIndex] = 1;
+		}
+	}
+	else
+	{
+		mprotect(Tracker->Base, Tracker->Size, PROT_READ | PROT_WRITE);
+		Tracker->Overflowed = true;
+	}
+}
+
+internal void DirtyPageFaultHandler(int Signal, siginfo_t *Info, void *Context)
+{
+	dirty_page_tracker *Tracker = GlobalDirtyPageTracker;
+	uint8 *Address = (uint8 *)Info->si_addr;
+	if(Tracker && (Address >= Tracker->Base) && (Address < (Tracker->Base + Tracker->Size)))
+	{
+		uint64 PageIndex = (uint64)(Address - Tracker->Base) / Tracker->PageSize;
+		MarkDirtyPagesWritten(Tracker, PageIndex, PageIndex + 1);
+	}
+	else
+	{
+		// NOTE: Not ours, put back whatever handled it before and let the access fault again
+		sigaction(SIGSEGV, &GlobalDirtyPagePreviousAction, 0);
+	}
+}
+
+internal bool32 BeginDirtyPageTracking(dirty_page_tracker *Tracker, void *Base, uint64 Size)
+{
+	Assert(!GlobalDirtyPageTracker);
+
+	Tracker->Base = (uint8 *)Base;
+	Tracker->Size = Size;
+	Tracker->PageSize = (uint64)sysconf(_SC_PAGESIZE);
+	Tracker->PageCount = (Size + Tracker->PageSize - 1) / Tracker->PageSize;
+	Tracker->Views = (uint8 *)mmap(0, 2*Tracker->PageCount, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	bool32 Result = false;
+	if(Tracker->Views != MAP_FAILED)
+	{
+		Tracker->Written = Tracker->Views + Tracker->PageCount;
+		GlobalDirtyPageTracker = Tracker;
+
+		struct sigaction Action = {};
+		Action.sa_sigaction = DirtyPageFaultHandler;
+		Action.sa_flags = SA_SIGINFO;
+		sigemptyset(&Action.sa_mask);
+		Result = ((sigaction(SIGSEGV, &Action, &GlobalDirtyPagePreviousAction) == 0) &&
+				  (mprotect(Base, Size, PROT_READ) == 0));
+	}
+	if(!Result)
+	{
+		GlobalDirtyPageTracker = 0;
+		Tracker->Views = 0;
+	}
+
+	return Result;
+}
+
+internal void CollectDirtyPages(dirty_page_tracker *Tracker)
+{
+	if(Tracker->Overflowed)
+	{
+		Tracker->Overflowed = false;
+		CompletePreviousWritesBeforeFutureWrites;
+		mprotect(Tracker->Base, Tracker->Size, PROT_READ);
+		memset((void *)Tracker->Written, 0, Tracker->PageCount);
+		memset(Tracker->Views, 0xFF, Tracker->PageCount);
+	}
+
+	uint64 PageIndex = 0;
+	while(PageIndex < Tracker->PageCount)
+	{
+		if(Tracker->Written[PageIndex])
+		{
+			// NOTE: Note and clear a whole run before protecting it again, so a write that
+			// lands in between is either part of this collection or faults into the next one
+			uint64 FirstPageIndex = PageIndex;
+			while((PageIndex < Tracker->PageCount) && Tracker->Written[PageIndex])
+			{
+				Tracker->Written[PageIndex] = 0;
+				Tracker->Views[PageIndex] = 0xFF;
+				++PageIndex;
+			}
+			CompletePreviousWritesBeforeFutureWrites;
+			mprotect(Tracker->Base + FirstPageIndex*Tracker->PageSize,
+					 (PageIndex - FirstPageIndex)*Tracker->PageSize, PROT_READ);
+		}
+		else
+		{
+			++PageIndex;
+		}
+	}
+}
+
+internal void EndDirtyPageTracking(dirty_page_tracker *Tracker)
+{
+	if(Tracker->Views)
+	{
+		mprotect(Tracker->Base, Tracker->Size, PROT_READ | PROT_WRITE);
+		sigaction(SIGSEGV, &GlobalDirtyPagePreviousAction, 0);
+		GlobalDirtyPageTracker = 0;
+		munmap(Tracker->Views, 2*Tracker->PageCount);
+		Tracker->Views = 0;
+	}
+}
+#endif
+
+inline void ClearDirtyPages(dirty_page_tracker *Tracker, uint32 View)
+{
+	uint8 KeepMask = (uint8)~(1 << View);
+	for(uint64 PageIndex = 0; PageIndex < Tracker->PageCount; ++PageIndex)
+	{
+		Tracker->Views[PageIndex] &= KeepMask;
+	}
+}
+
+/*
+	NOTE: Copies the pages View hasn't seen from Source to Dest, both laid out like the tracked
+	block, and clears them in View. Runs of dirty pages go in one copy. Returns how many pages
+	were copied. On Linux a copy into the tracked block makes each run writable up front, rather
+	than taking a fault on every page of it.
+*/
+internal uint64 CopyDirtyPages(dirty_page_tracker *Tracker, uint32 View, uint8 *Dest, uint8 *Source)
+{
+	uint64 Result = 0;
+
+	uint8 ViewMask = (uint8)(1 << View);
+	uint8 KeepMask = (uint8)~ViewMask;
+	uint64 PageIndex = 0;
+	while(PageIndex < Tracker->PageCount)
+	{
+		if(Tracker->Views[PageIndex] & ViewMask)
+		{
+			uint64 FirstPageIndex = PageIndex;
+			while((PageIndex < Tracker->PageCount) && (Tracker->Views[PageIndex] & ViewMask))
+			{
+				Tracker->Views[PageIndex] &= KeepMask;
+				++PageIndex;
+			}
+
+			uint64 Offset = FirstPageIndex*Tracker->PageSize;
+			uint64 Size = Minimum((PageIndex - FirstPageIndex)*Tracker->PageSize, Tracker->Size - Offset);
+#if !_WIN32
+			if((Dest == Tracker->Base) && !Tracker->Overflowed)
+			{
+				MarkDirtyPagesWritten(Tracker, FirstPageIndex, PageIndex);
+			}
+#endif
+			memcpy(Dest + Offset, Source + Offset, Size);
+			Result += PageIndex - FirstPageIndex;
+		}
+		else
+		{
+			++PageIndex;
+		}
+	}
+
+	return Result;
+}
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef HANDMADE_FRAME_PACER_H
+#define HANDMADE_FRAME_PACER_H
+
+/*
+	NOTE: Frame pacer shared by the platform layers.
+
+	Frames are paced to absolute deadlines, so time lost to one late wake does not push every
+	later frame back. The pacer sleeps until SleepMargin before the deadline and spins the rest.
+	The margin follows the oversleep it actually sees: it jumps up as soon as the OS wakes us later
+	than planned and only creeps back down, so it settles just above the scheduler's real
+	granularity (well under a millisecond for clock_nanosleep, around one for Sleep with
+	timeBeginPeriod(1)).
+
+	Frames whose work already ran past the deadline are counted as missed and the deadlines resync
+	from there instead of trying to catch up. Each frame goes into three histograms: the lateness of
+	the frames that made their deadline (the pacer's own jitter), how far past it the missed ones
+	ran (the game's overruns, kept apart so they don't swamp the jitter percentiles), and the time
+	between one wait returning and the next (what the player actually sees).
+*/
+
+#define FRAME_PACER_MIN_MARGIN 50000ull
+#define FRAME_PACER_MAX_MARGIN 4000000ull
+
+/*
+	NOTE: Log-scaled, in microseconds. The first FRAME_PACER_SUB_BUCKET_COUNT buckets are a
+	microsecond wide, after that every power of two is split into that many buckets, so a bucket is
+	never more than 1/64th of its value wide, close enough to tell a 33.3ms frame from a 33.8ms
+	one. The buckets reach 2^24us, about 17 seconds, far past any frame; the last one also holds
+	anything later.
+*/
+#define FRAME_PACER_SUB_BUCKET_BITS 6
+#define FRAME_PACER_SUB_BUCKET_COUNT (1 << FRAME_PACER_SUB_BUCKET_BITS)
+#define FRAME_PACER_BUCKET_COUNT ((25 - FRAME_PACER_SUB_BUCKET_BITS) << FRAME_PACER_SUB_BUCKET_BITS)
+
+struct frame_pacer_histogram
+{
+	uint32 Count;
+	uint64 Max;
+	uint32 Buckets[FRAME_PACER_BUCKET_COUNT];
+};
+
+struct frame_pacer
+{
+	uint64 TargetNanoseconds;
+	uint64 Deadline;
+	uint64 SleepMargin;
+	uint64 LastWake;
+
+	uint32 FrameCount;
+	uint32 MissedCount;
+	uint32 OversleptCount;
+
+	frame_pacer_histogram Lateness;
+	frame_pacer_histogram MissedLateness;
+	frame_pacer_histogram FrameTime;
+};
+
+//
+// NOTE: Platform clock and sleep
+//
+
+#if _WIN32
+// NOTE: Fixed at boot, so it's asked for once rather than on every clock read
+global_variable uint64 GlobalFramePacerFrequency;
+
+inline uint64 FramePacerGetClock(void)
+{
+	if(!GlobalFramePacerFrequency)
+	{
+		LARGE_INTEGER Frequency;
+		QueryPerformanceFrequency(&Frequency);
+		GlobalFramePacerFrequency = (uint64)Frequency.QuadPart;
+	}
+
+	LARGE_INTEGER Counter;
+	QueryPerformanceCounter(&Counter);
+
+	// NOTE: Split so Counter*1e9 can't overflow
+	uint64 Seconds = (uint64)Counter.QuadPart / GlobalFramePacerFrequency;
+	uint64 Remainder = (uint64)Counter.QuadPart % GlobalFramePacerFrequency;
+	uint64 Result = Seconds*1000000000ull + (Remainder*1000000000ull) / GlobalFramePacerFrequency;
+	return Result;
+}
+
+// NOTE: Sleep only takes whole milliseconds, the margin soaks up the rounding
+inline void FramePacerSleepUntil(uint64 WakeTime)
+{
+	uint64 Now = FramePacerGetClock();
+	if(WakeTime > Now)
+	{
+		DWORD SleepMS = (DWORD)((WakeTime - Now) / 1000000ull);
+		if(SleepMS > 0)
+		{
+			Sleep(SleepMS);
+		}
+	}
+}
+#else
+inline uint64 FramePacerGetClock(void)
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	uint64 Result = (uint64)Time.tv_sec*1000000000ull + (uint64)Time.tv_nsec;
+	return Result;
+}
+
+inline void FramePacerSleepUntil(uint64 WakeTime)
+{
+	struct timespec Deadline;
+	Deadline.tv_sec = (time_t)(WakeTime / 1000000000ull);
+	Deadline.tv_nsec = (long)(WakeTime % 1000000000ull);
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, 0) == EINTR)
+	{
+	}
+}
+#endif
+
+//
+// NOTE: Histograms
+//
+
+inline uint32 FramePacerBucketIndex(uint64 Nanoseconds)
+{
+	uint64 Microseconds = Nanoseconds / 1000;
+
+	uint32 Result;
+	if(Microseconds < FRAME_PACER_SUB_BUCKET_COUNT)
+	{
+		Result = (uint32)Microseconds;
+	}
+	else
+	{
+		uint32 Shift = 0;
+		while((Microseconds >> Shift) >= 2*FRAME_PACER_SUB_BUCKET_COUNT)
+		{
+			++Shift;
+		}
+		Result = (Shift + 1)*FRAME_PACER_SUB_BUCKET_COUNT +
+			(uint32)(Microseconds >> Shift) - FRAME_PACER_SUB_BUCKET_COUNT;
+		Result = Minimum(Result, FRAME_PACER_BUCKET_COUNT - 1);
+	}
+
+	return Result;
+}
+
+// NOTE: The first microsecond past the bucket
+inline uint64 FramePacerBucketEdge(uint32 Bucket)
+{
+	uint64 Result;
+	if(Bucket < FRAME_PACER_SUB_BUCKET_COUNT)
+	{
+		Result = Bucket + 1;
+	}
+	else
+	{
+		uint32 Shift = Bucket/FRAME_PACER_SUB_BUCKET_COUNT - 1;
+		uint64 SubBucket = Bucket % FRAME_PACER_SUB_BUCKET_COUNT + FRAME_PACER_SUB_BUCKET_COUNT;
+		Result = (SubBucket + 1) << Shift;
+	}
+
+	return Result;
+}
+
+inline void FramePacerRecord(frame_pacer_histogram *Histogram, uint64 Nanoseconds)
+{
+	++Histogram->Buckets[FramePacerBucketIndex(Nanoseconds)];
+	++Histogram->Count;
+	Histogram->Max = Maximum(Histogram->Max, Nanoseconds);
+}
+
+// NOTE: Upper edge of the bucket holding the given fraction of the histogram, in microseconds,
+// never past the largest value actually recorded
+internal uint32 FramePacerPercentile(frame_pacer_histogram *Histogram, real32 Fraction)
+{
+	uint64 Result = 0;
+	if(Histogram->Count)
+	{
+		uint32 Wanted = (uint32)(Fraction*(real32)Histogram->Count);
+		uint32 Seen = 0;
+		for(uint32 Bucket = 0; Bucket < FRAME_PACER_BUCKET_COUNT; Bucket++)
+		{
+			Seen += Histogram->Buckets[Bucket];
+			Result = FramePacerBucketEdge(Bucket);
+			if(Seen >= Wanted)
+			{
+				break;
+			}
+		}
+		Result = Minimum(Result, Histogram->Max / 1000);
+	}
+
+	return (uint32)Result;
+}
+
+//
+// NOTE: Pacing
+//
+
+internal void BeginFramePacer(frame_pacer *Pacer, real32 TargetSecondsPerFrame)
+{
+	*Pacer = {};
+	Pacer->TargetNanoseconds = (uint64)(1000000000.0f*TargetSecondsPerFrame);
+	Pacer->SleepMargin = 2*FRAME_PACER_MIN_MARGIN;
+	Pacer->LastWake = FramePacerGetClock();
+	Pacer->Deadline = Pacer->LastWake + Pacer->TargetNanoseconds;
+}
+
+// NOTE: Returns true if this frame's work had already run past its deadline
+internal bool32 FramePacerWait(frame_pacer *Pacer)
+{
+	bool32 Missed = false;
+	uint64 Deadline = Pacer->Deadline;
+	uint64 Now = FramePacerGetClock();
+	if(Now < Deadline)
+	{
+		if((Deadline - Now) > Pacer->SleepMargin)
+		{
+			uint64 WakeTime = Deadline - Pacer->SleepMargin;
+			FramePacerSleepUntil(WakeTime);
+			Now = FramePacerGetClock();
+
+			uint64 Oversleep = (Now > WakeTime) ? (Now - WakeTime) : 0;
+			if(Oversleep > Pacer->SleepMargin)
+			{
+				++Pacer->OversleptCount;
+			}
+
+			// NOTE: Up fast, down slow, so one bad wake costs a little spinning for a while
+			// instead of a late frame every time the scheduler has a hiccup
+			uint64 WantedMargin = Oversleep + Oversleep/4 + FRAME_PACER_MIN_MARGIN;
+			if(WantedMargin > Pacer->SleepMargin)
+			{
+				Pacer->SleepMargin = WantedMargin;
+			}
+			else
+			{
+				Pacer->SleepMargin -= (Pacer->SleepMargin - WantedMargin) / 32;
+			}
+			Pacer->SleepMargin = Maximum(Pacer->SleepMargin, FRAME_PACER_MIN_MARGIN);
+			Pacer->SleepMargin = Minimum(Pacer->SleepMargin, FRAME_PACER_MAX_MARGIN);
+		}
+
+		while(Now < Deadline)
+		{
+			_mm_pause();
+			Now = FramePacerGetClock();
+		}
+		Pacer->Deadline = Deadline + Pacer->TargetNanoseconds;
+	}
+	else
+	{
+		Missed = true;
+		++Pacer->MissedCount;
+		Pacer->Deadline = Now + Pacer->TargetNanoseconds;
+	}
+
+	FramePacerRecord(Missed ? &Pacer->MissedLateness : &Pacer->Lateness, Now - Deadline);
+	FramePacerRecord(&Pacer->FrameTime, Now - Pacer->LastWake);
+	Pacer->LastWake = Now;
+	++Pacer->FrameCount;
+
+	return Missed;
+}
+
+#endif
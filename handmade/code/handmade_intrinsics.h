@@ -5,6 +5,54 @@
 
 //TODO convert all of these to platform-efficient versions and remove math.h
 
+#if COMPILER_MSVC
+#define CompletePreviousReadsBeforeFutureReads _ReadBarrier()
+#define CompletePreviousWritesBeforeFutureWrites _WriteBarrier()
+#define CompletePreviousReadsBeforeFutureWrites _ReadWriteBarrier()
+inline uint32 AtomicCompareExchangeUInt32(uint32 volatile *Value, uint32 New, uint32 Expected)
+{
+	uint32 Result = _InterlockedCompareExchange((long volatile *)Value, New, Expected);
+	return Result;
+}
+// NOTE: Returns the value from before the add
+inline uint64 AtomicAddU64(uint64 volatile *Value, uint64 Addend)
+{
+	uint64 Result = _InterlockedExchangeAdd64((__int64 volatile *)Value, Addend);
+	return Result;
+}
+#elif COMPILER_LLVM
+#define CompletePreviousReadsBeforeFutureReads asm volatile("" ::: "memory")
+#define CompletePreviousWritesBeforeFutureWrites asm volatile("" ::: "memory")
+#define CompletePreviousReadsBeforeFutureWrites asm volatile("" ::: "memory")
+inline uint32 AtomicCompareExchangeUInt32(uint32 volatile *Value, uint32 New, uint32 Expected)
+{
+	uint32 Result = __sync_val_compare_and_swap(Value, Expected, New);
+	return Result;
+}
+// NOTE: Returns the value from before the add
+inline uint64 AtomicAddU64(uint64 volatile *Value, uint64 Addend)
+{
+	uint64 Result = __sync_fetch_and_add(Value, Addend);
+	return Result;
+}
+#endif
+
+// NOTE: Identifies the calling thread without a system call, from the thread's own block that the
+// OS keeps a segment register pointed at. Windows has the real thread ID in there, on Linux the
+// block's address is as unique and is what gets used.
+inline uint32 GetThreadID(void)
+{
+#if COMPILER_MSVC
+	uint8 *ThreadLocalStorage = (uint8 *)__readgsqword(0x30);
+	uint32 Result = *(uint32 *)(ThreadLocalStorage + 0x48);
+#elif COMPILER_LLVM
+	uint64 ThreadPointer;
+	asm("mov %%fs:0x10, %0" : "=r"(ThreadPointer));
+	uint32 Result = (uint32)ThreadPointer;
+#endif
+	return Result;
+}
+
 inline int32 SignOf(int32 Value)
 {
 	//int32 Result = (Value >> 31);
@@ -118,6 +166,12 @@ inline real32 ATan2(real32 Y, real32 X)
     return Result;
 }
 
+inline real32 Exp(real32 Power)
+{
+    real32 Result = expf(Power);
+    return Result;
+}
+
 inline real32 Square(real32 A)
 {
 	real32 Result = A * A;
@@ -0,0 +1,162 @@
+#ifndef HANDMADE_LARGE_PAGES_H
+#define HANDMADE_LARGE_PAGES_H
+
+/*
+	NOTE: Large page allocations shared by the platform layers, for memory that gets walked all over
+	every frame. A frame reads tile chunks and bitmaps from across the world arena and writes every
+	row of the framebuffer, and with 4KB pages that is a TLB miss every 4KB; one 2MB entry covers
+	the whole 960x540 framebuffer.
+
+	AllocateLargePages tries explicit large pages first: MAP_HUGETLB from the kernel's reserved pool
+	on Linux, MEM_LARGE_PAGES on Windows, which needs the account to hold Lock pages in memory. Both
+	are backed in full up front and fail cleanly when the pool is empty or the privilege missing.
+	On Linux it then falls back to an ordinary mapping aligned to 2MB and marked MADV_HUGEPAGE, so
+	the kernel backs it with transparent huge pages as it is touched, as long as
+	/sys/kernel/mm/transparent_hugepage/enabled isn't never. Failing that it is an ordinary
+	allocation. Backing says which one it got.
+
+	AdviseLargePages only does the transparent part, for memory that is already mapped and
+	shouldn't be backed up front, like game memory the game commits as it goes.
+*/
+
+#define LARGE_PAGE_SIZE Megabytes(2)
+
+enum large_page_backing
+{
+	LargePages_None,
+	LargePages_Transparent,
+	LargePages_Explicit,
+};
+
+global_variable char *LargePageBackingNames[] = {"4KB pages", "transparent huge pages", "explicit huge pages"};
+
+#if _WIN32
+internal void *AllocateLargePages(uint64 Size, large_page_backing *Backing)
+{
+	local_persist bool32 PrivilegeEnabled = false;
+	if(!PrivilegeEnabled)
+	{
+		HANDLE Token;
+		if(OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &Token))
+		{
+			TOKEN_PRIVILEGES Privileges = {};
+			Privileges.PrivilegeCount = 1;
+			Privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+			if(LookupPrivilegeValueA(0, "SeLockMemoryPrivilege", &Privileges.Privileges[0].Luid))
+			{
+				AdjustTokenPrivileges(Token, FALSE, &Privileges, 0, 0, 0);
+			}
+			CloseHandle(Token);
+		}
+		PrivilegeEnabled = true;
+	}
+
+	*Backing = LargePages_None;
+	void *Result = 0;
+	uint64 LargePageSize = (uint64)GetLargePageMinimum();
+	if(LargePageSize)
+	{
+		uint64 LargeSize = (Size + LargePageSize - 1) & ~(LargePageSize - 1);
+		Result = VirtualAlloc(0, (SIZE_T)LargeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if(Result)
+		{
+			*Backing = LargePages_Explicit;
+		}
+	}
+	if(!Result)
+	{
+		Result = VirtualAlloc(0, (SIZE_T)Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	}
+
+	return Result;
+}
+
+internal void FreeLargePages(void *Memory, uint64 Size)
+{
+	VirtualFree(Memory, 0, MEM_RELEASE);
+}
+
+// NOTE: Windows has no transparent large pages
+internal bool32 AdviseLargePages(void *Base, uint64 Size)
+{
+	return false;
+}
+
+internal uint64 GetLargePageResidentBytes(void)
+{
+	return 0;
+}
+#else
+internal bool32 AdviseLargePages(void *Base, uint64 Size)
+{
+	bool32 Result = (madvise(Base, Size, MADV_HUGEPAGE) == 0);
+	return Result;
+}
+
+internal void *AllocateLargePages(uint64 Size, large_page_backing *Backing)
+{
+	uint64 LargeSize = (Size + LARGE_PAGE_SIZE - 1) & ~(uint64)(LARGE_PAGE_SIZE - 1);
+
+	*Backing = LargePages_Explicit;
+	void *Result = mmap(0, LargeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if(Result == MAP_FAILED)
+	{
+		// NOTE: Map a large page's worth extra and trim it off, so the start is large page aligned
+		// and no huge page straddles the ends
+		*Backing = LargePages_None;
+		Result = 0;
+		uint8 *Mapping = (uint8 *)mmap(0, LargeSize + LARGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+									   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if(Mapping != MAP_FAILED)
+		{
+			uint8 *Aligned = (uint8 *)(((uint64)Mapping + LARGE_PAGE_SIZE - 1) & ~(uint64)(LARGE_PAGE_SIZE - 1));
+			if(Aligned > Mapping)
+			{
+				munmap(Mapping, (size_t)(Aligned - Mapping));
+			}
+			munmap(Aligned + LargeSize, (size_t)((Mapping + LargeSize + LARGE_PAGE_SIZE) - (Aligned + LargeSize)));
+
+			Result = Aligned;
+			if(AdviseLargePages(Result, LargeSize))
+			{
+				*Backing = LargePages_Transparent;
+			}
+		}
+	}
+
+	return Result;
+}
+
+internal void FreeLargePages(void *Memory, uint64 Size)
+{
+	uint64 LargeSize = (Size + LARGE_PAGE_SIZE - 1) & ~(uint64)(LARGE_PAGE_SIZE - 1);
+	munmap(Memory, LargeSize);
+}
+
+// NOTE: How much of the process is actually on transparent huge pages right now, AnonHugePages in
+// /proc/self/smaps_rollup. Explicit huge pages don't show up here.
+internal uint64 GetLargePageResidentBytes(void)
+{
+	uint64 Result = 0;
+
+	FILE *Rollup = fopen("/proc/self/smaps_rollup", "r");
+	if(Rollup)
+	{
+		char Line[256];
+		while(fgets(Line, sizeof(Line), Rollup))
+		{
+			unsigned long long KilobyteCount;
+			if(sscanf(Line, "AnonHugePages: %llu kB", &KilobyteCount) == 1)
+			{
+				Result = (uint64)KilobyteCount*1024;
+				break;
+			}
+		}
+		fclose(Rollup);
+	}
+
+	return Result;
+}
+#endif
+
+#endif
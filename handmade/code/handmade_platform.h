@@ -32,6 +32,8 @@ extern "C" {
 
 #if COMPILER_MSVC
 #include <intrin.h>
+#elif COMPILER_LLVM
+#include <x86intrin.h>
 #endif
 
 #define internal static
@@ -87,6 +89,70 @@ typedef DEBUG_PLATFORM_WRITE_ENTIRE_FILE(debug_platform_write_entire_file);
 #endif
 
 
+/*
+	NOTE: Work queue for spreading game work across the platform's worker threads.
+	Entries are run in any order on any thread, CompleteAllWork returns once every
+	added entry has finished (the calling thread helps out while it waits).
+*/
+typedef struct platform_work_queue platform_work_queue;
+
+// NOTE: Profiler event logs, see handmade_debug.h
+typedef struct debug_table debug_table;
+
+#define PLATFORM_WORK_QUEUE_CALLBACK(name) void name(platform_work_queue *Queue, void *Data)
+typedef PLATFORM_WORK_QUEUE_CALLBACK(platform_work_queue_callback);
+
+typedef void platform_add_entry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data);
+typedef void platform_complete_all_work(platform_work_queue *Queue);
+
+/*
+	NOTE: Ranged reads for assets that are streamed in pieces instead of loaded whole. Reads block
+	and can come from whichever thread is mixing sound. A read returns how many bytes it got, which
+	is short at the end of the file and 0 once the handle has hit an error.
+*/
+typedef struct platform_file_handle
+{
+	bool32 NoErrors;
+	void *Platform;
+} platform_file_handle;
+
+#define PLATFORM_OPEN_FILE(name) platform_file_handle name(char *Filename)
+typedef PLATFORM_OPEN_FILE(platform_open_file);
+
+#define PLATFORM_READ_DATA_FROM_FILE(name) uint64 name(platform_file_handle *Handle, uint64 Offset, uint64 Size, void *Dest)
+typedef PLATFORM_READ_DATA_FROM_FILE(platform_read_data_from_file);
+
+#define PLATFORM_CLOSE_FILE(name) void name(platform_file_handle *Handle)
+typedef PLATFORM_CLOSE_FILE(platform_close_file);
+
+/*
+	NOTE: The files the game streams from stay open in game_memory rather than in game storage,
+	which gets snapshotted and restored later or in another process where a handle would be stale
+	or somebody else's. The game keeps a file's name in its own storage and looks the handle up by
+	it on every read, opening it again if it isn't there. Reads land in StreamStaging, so reading
+	only writes game storage where the samples end up. The platform just has to zero the slots
+	before the first call into the game and leave them alone after.
+*/
+#define PLATFORM_STREAM_FILE_COUNT 4
+#define PLATFORM_STREAM_FILENAME_LENGTH 64
+#define PLATFORM_STREAM_STAGING_SIZE (16*1024)
+
+typedef struct platform_stream_file
+{
+	// NOTE: Empty while the slot is free
+	char Filename[PLATFORM_STREAM_FILENAME_LENGTH];
+	platform_file_handle Handle;
+} platform_stream_file;
+
+/*
+	NOTE: Game memory that is only reserved. The game commits a range before it first touches it,
+	which makes it readable and writable and zeroed. Ranges are rounded out to whole pages, so they
+	can start and end anywhere and overlap what is already committed, and committing twice is
+	harmless. Any thread may commit. Returns false if the OS is out of memory.
+*/
+#define PLATFORM_COMMIT_MEMORY(name) bool32 name(void *Base, memory_index Size)
+typedef PLATFORM_COMMIT_MEMORY(platform_commit_memory);
+
 // Structures for game generics
 typedef struct
 {	
@@ -145,15 +211,90 @@ typedef struct
 	};
 } game_controller_input;
 
+/*
+	NOTE: Input events, every controller button transition the platform saw during the frame, oldest
+	first. The controllers' button states only say where each button ended up, the events say when
+	in the frame it got there, so the game can land a press in the sim tick it happened during and
+	still see a tap that was pressed and let go within one frame.
+
+	Events only cover controller buttons, not the mouse or the sticks. When more happen in a frame
+	than the queue holds the rest are dropped and EventsDropped is set. The queue then no longer
+	adds up to the button states, so the game ignores it for that frame and runs every tick on where
+	the buttons ended up: their timing is lost, and so is any tap that was let go again.
+*/
+#define GAME_MAX_INPUT_EVENT_COUNT 64
+
+typedef struct
+{
+	// NOTE: Seconds into the frame's input, from 0 where the last frame's input was taken up to
+	// dtForFrame for now
+	real32 tFrame;
+	uint32 ControllerIndex;
+	// NOTE: Index into the controller's Buttons
+	uint32 ButtonIndex;
+	bool32 IsDown;
+} game_input_event;
+
 typedef struct 
 {
 	game_button_state MouseButtons[5];
 	int32 MouseX, MouseY, MouseZ;
 
 	real32 dtForFrame;
+	// NOTE: Zero steps the simulation once per frame by dtForFrame, otherwise it runs in fixed
+	// ticks of this length and rendering interpolates between the last two
+	real32 SimSecondsPerTick;
 	game_controller_input Controllers[5];
+
+	uint32 EventCount;
+	bool32 EventsDropped;
+	game_input_event Events[GAME_MAX_INPUT_EVENT_COUNT];
 } game_input;
 
+/*
+	NOTE: Memory telemetry, rewritten by the game at the end of every GameUpdateAndRender for the
+	platform to log or draw. Everything is copied out of the game's own structures so it stays
+	readable while the game code is being reloaded.
+*/
+#define GAME_MAX_TELEMETRY_ARENA_COUNT 4
+#define GAME_TELEMETRY_NAME_LENGTH 16
+
+typedef struct
+{
+	char Name[GAME_TELEMETRY_NAME_LENGTH];
+	// NOTE: Size is what the arena was given, PeakUsed the most it has ever had pushed on at once
+	uint64 Size;
+	uint64 Used;
+	uint64 PeakUsed;
+	uint64 AllocationCount;
+} game_arena_telemetry;
+
+typedef struct
+{
+	// NOTE: Calls to GameUpdateAndRender on this game_memory, the game only ever adds one to it
+	uint64 FrameIndex;
+
+	uint32 ArenaCount;
+	game_arena_telemetry Arenas[GAME_MAX_TELEMETRY_ARENA_COUNT];
+
+	// NOTE: Chunks holding per tile storage, chunks of one uniform value cost nothing
+	uint32 ResidentChunkCount;
+	uint64 ResidentChunkBytes;
+
+	uint32 EntityCount;
+	// NOTE: Of those, how many the last frame drew and how many it culled, for being off screen or
+	// on another level than the camera
+	uint32 DrawnEntityCount;
+	uint32 OffScreenEntityCount;
+	uint32 OtherLevelEntityCount;
+
+	// NOTE: The last frame's input events, the controllers it had to look at, and the sim ticks it
+	// ran. A frame that runs no ticks leaves its input for the next one that does.
+	uint32 InputEventCount;
+	uint32 ProcessedControllerCount;
+	uint32 TickCount;
+} game_memory_telemetry;
+
 typedef struct
 {
 	bool32 IsInitialized;
@@ -164,6 +305,28 @@ typedef struct
 	uint64 TransientStorageSize;
 	void *TransientStorage;
 
+	// NOTE: The queue functions may be null if the platform runs the game single threaded
+	platform_work_queue *HighPriorityQueue;
+	platform_work_queue *LowPriorityQueue;
+	platform_add_entry *PlatformAddEntry;
+	platform_complete_all_work *PlatformCompleteAllWork;
+
+	// NOTE: May be null on platforms that can't stream, the game has to check
+	platform_open_file *PlatformOpenFile;
+	platform_read_data_from_file *PlatformReadDataFromFile;
+	platform_close_file *PlatformCloseFile;
+	platform_stream_file StreamFiles[PLATFORM_STREAM_FILE_COUNT];
+	uint8 StreamStaging[PLATFORM_STREAM_STAGING_SIZE];
+
+	// NOTE: Null when all of game memory is committed up front. Otherwise nothing in either storage
+	// is usable until the game has committed it.
+	platform_commit_memory *PlatformCommitMemory;
+
+	// NOTE: Null unless the platform is collecting timed blocks
+	debug_table *DebugTable;
+
+	game_memory_telemetry Telemetry;
+
 	debug_platform_free_file_memory* DEBUGPlatformFreeFileMemory;
 	debug_platform_read_entire_file* DEBUGPlatformReadEntireFile;	
 	debug_platform_write_entire_file* DEBUGPlatformWriteEntireFile;
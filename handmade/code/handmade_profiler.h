@@ -0,0 +1,672 @@
+#ifndef HANDMADE_PROFILER_H
+#define HANDMADE_PROFILER_H
+
+#include "handmade.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+	NOTE: Frame profile, built by the platform out of the timed block logs (handmade_debug.h)
+
+	CollateDebugFrame runs once a frame. It drains every thread's log and replays the events
+	against a stack per thread, and each block that closes adds its cycles and a hit to its node in
+	the call tree. Nodes are keyed by parent and block, so a function called from two places shows
+	up twice, once under each caller, and every thread gets a tree of its own. A block still open
+	when its frame is collated stays on the stack and counts in whichever frame it closes in.
+
+	Each frame's counts are folded into running totals and a per frame maximum, which is what the
+	report shows, until ResetProfile starts them over. Cycles are the TSC, so they only convert to
+	time at the CPU's nominal rate.
+
+	Every block that closes also goes into a trace ring, start and end clock, node and thread, along
+	with one block per frame. BeginTraceDump marks what is in the ring at that moment and
+	FormatTraceDump turns it into Chrome trace JSON (chrome://tracing, Perfetto) a buffer at a time,
+	so a platform thread can write the file while collation keeps filling the ring. The dump checks
+	each block against the write index after copying it, and anything overwritten before the
+	dump got to it is skipped and counted instead of waited for.
+
+	Everything here only touches memory. Printing the report and writing the file are up to the
+	platform.
+*/
+
+#define PROFILE_NODE_CAPACITY 1024
+#define PROFILE_MAX_DEPTH 64
+#define PROFILE_GUID_LENGTH 128
+// NOTE: Power of two, a bit under 1000 frames of the game's blocks at the moment
+#define PROFILE_TRACE_BLOCK_COUNT (1 << 17)
+// NOTE: How far behind the write index a dump starts, headroom for collation to keep going
+#define PROFILE_TRACE_DUMP_SLACK 4096
+
+struct profile_node
+{
+	// NOTE: Pointer compare first, the copy decides when the pointer has moved with a code reload
+	char *LastGUID;
+	char GUID[PROFILE_GUID_LENGTH];
+	char *Name;
+
+	profile_node *Parent;
+	profile_node *FirstChild;
+	profile_node *NextSibling;
+
+	uint32 FrameHitCount;
+	uint64 FrameCycles;
+
+	uint64 HitCount;
+	uint64 Cycles;
+	uint64 MaxFrameCycles;
+};
+
+struct profile_thread
+{
+	uint32 ThreadID;
+	profile_node *Root;
+	uint32 DroppedCount;
+
+	uint32 OpenCount;
+	// NOTE: Begins past PROFILE_MAX_DEPTH are only counted, so their ends can be skipped
+	uint32 OverflowDepth;
+	profile_node *OpenNodes[PROFILE_MAX_DEPTH];
+	uint64 OpenClocks[PROFILE_MAX_DEPTH];
+};
+
+struct trace_block
+{
+	uint64 StartClock;
+	uint64 EndClock;
+	// NOTE: Null for the frame blocks, which go on a track of their own
+	profile_node *Node;
+	uint32 ThreadID;
+};
+
+struct debug_profile
+{
+	debug_table *Table;
+	profile_thread Threads[DEBUG_MAX_THREAD_COUNT];
+
+	uint32 NodeCount;
+	profile_node Nodes[PROFILE_NODE_CAPACITY];
+
+	uint64 LastFrameClock;
+	uint32 FrameCount;
+	uint64 FrameCycles;
+	uint64 MaxFrameCycles;
+
+	uint64 EventCount;
+	uint32 DroppedCount;
+	uint32 LostBlockCount;
+	uint64 CollationCycles;
+
+	// NOTE: Measured once by MeasureTimedBlockOverhead, 0 until then
+	real64 CyclesPerBlock;
+
+	// NOTE: From UpdateProfileClockRate, 0 until the platform has called it twice
+	uint64 CalibrationClock;
+	uint64 CalibrationNanoseconds;
+	real64 CyclesPerMicrosecond;
+
+	// NOTE: Only collation writes the ring, TraceWriteIndex is published after each block
+	uint64 volatile TraceWriteIndex;
+	trace_block Trace[PROFILE_TRACE_BLOCK_COUNT];
+};
+
+internal void InitializeProfile(debug_profile *Profile, debug_table *Table)
+{
+	// NOTE: Both come zeroed from the platform's page allocator
+	Profile->Table = Table;
+	Profile->LastFrameClock = __rdtsc();
+}
+
+// NOTE: The platform passes its nanosecond clock, rdtsc only converts to time against another clock
+internal void UpdateProfileClockRate(debug_profile *Profile, uint64 Nanoseconds)
+{
+	uint64 Clock = __rdtsc();
+	if(!Profile->CalibrationNanoseconds)
+	{
+		Profile->CalibrationClock = Clock;
+		Profile->CalibrationNanoseconds = Nanoseconds;
+	}
+	else if(Nanoseconds > Profile->CalibrationNanoseconds)
+	{
+		Profile->CyclesPerMicrosecond = 1000.0*(real64)(Clock - Profile->CalibrationClock) /
+			(real64)(Nanoseconds - Profile->CalibrationNanoseconds);
+	}
+}
+
+inline void AddTraceBlock(debug_profile *Profile, uint64 StartClock, uint64 EndClock, profile_node *Node, uint32 ThreadID)
+{
+	uint64 WriteIndex = Profile->TraceWriteIndex;
+	trace_block *Block = Profile->Trace + (WriteIndex & (PROFILE_TRACE_BLOCK_COUNT - 1));
+	Block->StartClock = StartClock;
+	Block->EndClock = EndClock;
+	Block->Node = Node;
+	Block->ThreadID = ThreadID;
+
+	CompletePreviousWritesBeforeFutureWrites;
+	Profile->TraceWriteIndex = WriteIndex + 1;
+}
+
+internal profile_node *AddProfileNode(debug_profile *Profile, profile_node *Parent, char *GUID)
+{
+	profile_node *Result = 0;
+	if(Profile->NodeCount < PROFILE_NODE_CAPACITY)
+	{
+		Result = Profile->Nodes + Profile->NodeCount++;
+		Result->LastGUID = GUID;
+		// NOTE: Copied by hand, MSVC flags strncpy at -W4
+		for(uint32 CharIndex = 0; (CharIndex < PROFILE_GUID_LENGTH - 1) && GUID[CharIndex]; ++CharIndex)
+		{
+			Result->GUID[CharIndex] = GUID[CharIndex];
+		}
+
+		// NOTE: Blocks named in the source read "file(line) Name", only the name is shown
+		Result->Name = Result->GUID;
+		char *NameStart = strstr(Result->GUID, ") ");
+		if(NameStart)
+		{
+			Result->Name = NameStart + 2;
+		}
+
+		// NOTE: Appended, so children list in the order they first ran
+		Result->Parent = Parent;
+		if(Parent)
+		{
+			profile_node **Link = &Parent->FirstChild;
+			while(*Link)
+			{
+				Link = &(*Link)->NextSibling;
+			}
+			*Link = Result;
+		}
+	}
+	else
+	{
+		++Profile->LostBlockCount;
+	}
+
+	return Result;
+}
+
+internal profile_node *GetProfileChild(debug_profile *Profile, profile_node *Parent, char *GUID)
+{
+	profile_node *Result = 0;
+	if(Parent)
+	{
+		for(profile_node *Child = Parent->FirstChild; Child; Child = Child->NextSibling)
+		{
+			if(Child->LastGUID == GUID)
+			{
+				Result = Child;
+				break;
+			}
+		}
+		if(!Result)
+		{
+			for(profile_node *Child = Parent->FirstChild; Child; Child = Child->NextSibling)
+			{
+				if(strncmp(Child->GUID, GUID, PROFILE_GUID_LENGTH - 1) == 0)
+				{
+					Child->LastGUID = GUID;
+					Result = Child;
+					break;
+				}
+			}
+		}
+		if(!Result)
+		{
+			Result = AddProfileNode(Profile, Parent, GUID);
+		}
+	}
+
+	return Result;
+}
+
+// NOTE: Reads every thread's events so far into the tree, without closing the frame
+internal void CollateDebugEvents(debug_profile *Profile)
+{
+	uint64 CollationStart = __rdtsc();
+	debug_table *Table = Profile->Table;
+
+	for(uint32 LogIndex = 0; LogIndex < DEBUG_MAX_THREAD_COUNT; ++LogIndex)
+	{
+		debug_thread_log *Log = Table->Logs + LogIndex;
+		uint32 ThreadID = Log->ThreadID;
+		if(!ThreadID)
+		{
+			continue;
+		}
+
+		profile_thread *Thread = Profile->Threads + LogIndex;
+		if(!Thread->Root)
+		{
+			char RootName[32];
+			snprintf(RootName, sizeof(RootName), "Thread %08x", ThreadID);
+			Thread->Root = AddProfileNode(Profile, 0, RootName);
+			Thread->ThreadID = ThreadID;
+		}
+
+		uint64 WriteIndex = Log->WriteIndex;
+		uint64 ReadIndex = Log->ReadIndex;
+		CompletePreviousReadsBeforeFutureReads;
+
+		for(uint64 EventIndex = ReadIndex; EventIndex < WriteIndex; ++EventIndex)
+		{
+			debug_event *Event = Log->Events + (EventIndex & (DEBUG_THREAD_EVENT_COUNT - 1));
+			if(Event->Type == DebugEvent_BeginBlock)
+			{
+				if(Thread->OpenCount < PROFILE_MAX_DEPTH)
+				{
+					profile_node *Parent = Thread->OpenCount ? Thread->OpenNodes[Thread->OpenCount - 1] : Thread->Root;
+					Thread->OpenNodes[Thread->OpenCount] = GetProfileChild(Profile, Parent, Event->GUID);
+					Thread->OpenClocks[Thread->OpenCount] = Event->Clock;
+					++Thread->OpenCount;
+				}
+				else
+				{
+					++Thread->OverflowDepth;
+				}
+			}
+			else if(Thread->OverflowDepth)
+			{
+				--Thread->OverflowDepth;
+			}
+			else if(Thread->OpenCount)
+			{
+				--Thread->OpenCount;
+				profile_node *Node = Thread->OpenNodes[Thread->OpenCount];
+				if(Node)
+				{
+					uint64 StartClock = Thread->OpenClocks[Thread->OpenCount];
+					++Node->FrameHitCount;
+					Node->FrameCycles += Event->Clock - StartClock;
+					AddTraceBlock(Profile, StartClock, Event->Clock, Node, ThreadID);
+				}
+			}
+		}
+		Profile->EventCount += WriteIndex - ReadIndex;
+
+		CompletePreviousReadsBeforeFutureWrites;
+		Log->ReadIndex = WriteIndex;
+
+		// NOTE: There's no telling which begins lost their ends, so the stack starts over
+		uint32 DroppedCount = Log->DroppedCount;
+		if(DroppedCount != Thread->DroppedCount)
+		{
+			Profile->DroppedCount += DroppedCount - Thread->DroppedCount;
+			Thread->DroppedCount = DroppedCount;
+			Thread->OpenCount = 0;
+			Thread->OverflowDepth = 0;
+		}
+	}
+
+	Profile->CollationCycles += __rdtsc() - CollationStart;
+}
+
+/*
+	NOTE: Event GUIDs point into the string literals of the module that logged them. Before the
+	platform unloads the game code it collates what has been logged so far, while the strings are
+	still there, and the cached GUID pointers are dropped since the next library can put different
+	strings at the same addresses.
+*/
+internal void CollateDebugEventsBeforeUnload(debug_profile *Profile)
+{
+	CollateDebugEvents(Profile);
+	for(uint32 NodeIndex = 0; NodeIndex < Profile->NodeCount; ++NodeIndex)
+	{
+		Profile->Nodes[NodeIndex].LastGUID = 0;
+	}
+}
+
+internal void CollateDebugFrame(debug_profile *Profile)
+{
+	CollateDebugEvents(Profile);
+
+	uint64 CollationStart = __rdtsc();
+	for(uint32 NodeIndex = 0; NodeIndex < Profile->NodeCount; ++NodeIndex)
+	{
+		profile_node *Node = Profile->Nodes + NodeIndex;
+		Node->HitCount += Node->FrameHitCount;
+		Node->Cycles += Node->FrameCycles;
+		Node->MaxFrameCycles = Maximum(Node->MaxFrameCycles, Node->FrameCycles);
+		Node->FrameHitCount = 0;
+		Node->FrameCycles = 0;
+	}
+
+	uint64 FrameClock = __rdtsc();
+	uint64 FrameCycles = FrameClock - Profile->LastFrameClock;
+	AddTraceBlock(Profile, Profile->LastFrameClock, FrameClock, 0, 0);
+	Profile->LastFrameClock = FrameClock;
+	++Profile->FrameCount;
+	Profile->FrameCycles += FrameCycles;
+	Profile->MaxFrameCycles = Maximum(Profile->MaxFrameCycles, FrameCycles);
+	Profile->CollationCycles += FrameClock - CollationStart;
+}
+
+// NOTE: Starts the totals over, the tree and any blocks still open are kept
+internal void ResetProfile(debug_profile *Profile)
+{
+	for(uint32 NodeIndex = 0; NodeIndex < Profile->NodeCount; ++NodeIndex)
+	{
+		profile_node *Node = Profile->Nodes + NodeIndex;
+		Node->HitCount = 0;
+		Node->Cycles = 0;
+		Node->MaxFrameCycles = 0;
+	}
+
+	Profile->LastFrameClock = __rdtsc();
+	Profile->FrameCount = 0;
+	Profile->FrameCycles = 0;
+	Profile->MaxFrameCycles = 0;
+	Profile->EventCount = 0;
+	Profile->DroppedCount = 0;
+	Profile->LostBlockCount = 0;
+	Profile->CollationCycles = 0;
+}
+
+#if HANDMADE_PROFILE
+// NOTE: Best of a few runs of back to back empty blocks on the calling thread, which leaves the
+// cost of the two events and the log lookup. Needs GlobalDebugTable pointing at Profile->Table, and
+// resets the profile afterwards.
+internal void MeasureTimedBlockOverhead(debug_profile *Profile)
+{
+	uint32 BlockCount = 1024;
+	uint64 BestCycles = 0xFFFFFFFFFFFFFFFFull;
+	for(uint32 RunIndex = 0; RunIndex < 64; ++RunIndex)
+	{
+		uint64 Start = __rdtsc();
+		for(uint32 BlockIndex = 0; BlockIndex < BlockCount; ++BlockIndex)
+		{
+			TIMED_BLOCK("Timed block overhead");
+		}
+		uint64 Cycles = __rdtsc() - Start;
+		BestCycles = Minimum(BestCycles, Cycles);
+
+		CollateDebugFrame(Profile);
+	}
+
+	Profile->CyclesPerBlock = (real64)BestCycles / (real64)BlockCount;
+	ResetProfile(Profile);
+
+	// NOTE: No dump can be running yet, and nobody wants a trace of the measurement
+	Profile->TraceWriteIndex = 0;
+}
+#endif
+
+struct profile_report
+{
+	char *At;
+	char *End;
+};
+
+internal void ReportPrint(profile_report *Report, char *Format, ...)
+{
+	if(Report->At < Report->End)
+	{
+		va_list ArgList;
+		va_start(ArgList, Format);
+		int Written = vsnprintf(Report->At, (size_t)(Report->End - Report->At), Format, ArgList);
+		va_end(ArgList);
+		if(Written > 0)
+		{
+			Report->At = Minimum(Report->At + Written, Report->End - 1);
+		}
+	}
+}
+
+internal void ReportProfileNode(profile_report *Report, debug_profile *Profile, profile_node *Node, uint32 Depth)
+{
+	if(Node->HitCount)
+	{
+		uint64 ChildCycles = 0;
+		for(profile_node *Child = Node->FirstChild; Child; Child = Child->NextSibling)
+		{
+			ChildCycles += Child->Cycles;
+		}
+
+		real64 Frames = (real64)Maximum(Profile->FrameCount, 1);
+		real64 FrameCycles = (real64)Maximum(Profile->FrameCycles, 1);
+		// NOTE: Exclusive can come out slightly negative when a child was still open at a frame edge
+		int Indent = (int)(2*Depth);
+		ReportPrint(Report, "%*s%-*.*s %9.1f %11.1f %11.1f %7.1f%% %11.1f\n",
+					Indent, "", 40 - Indent, 40 - Indent, Node->Name,
+					(real64)Node->HitCount / Frames,
+					(real64)Node->Cycles / (1000.0*Frames),
+					((real64)Node->Cycles - (real64)ChildCycles) / (1000.0*Frames),
+					100.0*(real64)Node->Cycles / FrameCycles,
+					(real64)Node->MaxFrameCycles / 1000.0);
+	}
+
+	for(profile_node *Child = Node->FirstChild; Child; Child = Child->NextSibling)
+	{
+		ReportProfileNode(Report, Profile, Child, Depth + 1);
+	}
+}
+
+// NOTE: Returns the length written, Dest always ends up terminated
+internal uint32 FormatProfileReport(debug_profile *Profile, char *Dest, uint32 DestSize)
+{
+	profile_report Report = {Dest, Dest + DestSize};
+	Dest[0] = 0;
+
+	real64 Frames = (real64)Maximum(Profile->FrameCount, 1);
+	real64 BlocksPerFrame = 0.5*(real64)Profile->EventCount / Frames;
+	real64 CyclesPerFrame = (real64)Profile->FrameCycles / Frames;
+	ReportPrint(&Report, "Profile over %u frames: %.2f Mcycles per frame, max %.2f. %.0f blocks per frame",
+				Profile->FrameCount, CyclesPerFrame / 1000000.0, (real64)Profile->MaxFrameCycles / 1000000.0,
+				BlocksPerFrame);
+	if(Profile->CyclesPerBlock > 0.0)
+	{
+		ReportPrint(&Report, " at ~%.0f cycles each (%.2f%% of the frame)", Profile->CyclesPerBlock,
+					100.0*BlocksPerFrame*Profile->CyclesPerBlock / CyclesPerFrame);
+	}
+	ReportPrint(&Report, ", collation %.1f kcycles per frame.\n", (real64)Profile->CollationCycles / (1000.0*Frames));
+	if(Profile->DroppedCount || Profile->LostBlockCount || Profile->Table->OutOfLogs)
+	{
+		ReportPrint(&Report, "Incomplete: %u events dropped on full logs, %u blocks past the node capacity%s.\n",
+					Profile->DroppedCount, Profile->LostBlockCount,
+					Profile->Table->OutOfLogs ? ", some threads found no free log" : "");
+	}
+
+	ReportPrint(&Report, "%-40s %9s %11s %11s %8s %11s\n", "", "calls/f", "incl kc/f", "excl kc/f", "frame", "max kc");
+	for(uint32 ThreadIndex = 0; ThreadIndex < DEBUG_MAX_THREAD_COUNT; ++ThreadIndex)
+	{
+		profile_node *Root = Profile->Threads[ThreadIndex].Root;
+		if(Root)
+		{
+			bool32 ThreadRan = false;
+			for(profile_node *Child = Root->FirstChild; Child; Child = Child->NextSibling)
+			{
+				ThreadRan |= (Child->HitCount != 0);
+			}
+			if(ThreadRan)
+			{
+				ReportPrint(&Report, "%s\n", Root->Name);
+				for(profile_node *Child = Root->FirstChild; Child; Child = Child->NextSibling)
+				{
+					ReportProfileNode(&Report, Profile, Child, 1);
+				}
+			}
+		}
+	}
+
+	uint32 Result = (uint32)(Report.At - Dest);
+	return Result;
+}
+
+//
+// NOTE: Chrome trace export
+//
+
+enum trace_dump_stage
+{
+	TraceDump_Header,
+	TraceDump_Threads,
+	TraceDump_Blocks,
+	TraceDump_Footer,
+	TraceDump_Done,
+};
+
+struct trace_dump
+{
+	debug_profile *Profile;
+	uint32 Stage;
+
+	uint64 ReadIndex;
+	uint64 EndIndex;
+	uint64 BaseClock;
+	real64 MicrosecondsPerCycle;
+
+	uint32 ThreadCount;
+	uint32 ThreadIndex;
+	uint32 ThreadIDs[DEBUG_MAX_THREAD_COUNT];
+	char *ThreadNames[DEBUG_MAX_THREAD_COUNT];
+
+	uint32 BlockCount;
+	uint32 LostCount;
+};
+
+// NOTE: On the collating thread between frames. The dump covers what is in the ring right now.
+internal void BeginTraceDump(trace_dump *Dump, debug_profile *Profile)
+{
+	*Dump = {};
+	Dump->Profile = Profile;
+
+	Dump->EndIndex = Profile->TraceWriteIndex;
+	uint64 Reach = PROFILE_TRACE_BLOCK_COUNT - PROFILE_TRACE_DUMP_SLACK;
+	Dump->ReadIndex = (Dump->EndIndex > Reach) ? (Dump->EndIndex - Reach) : 0;
+
+	// NOTE: Timestamps count from the first calibration, which is before any block. Without a
+	// rate yet they come out as kilocycles.
+	Dump->BaseClock = Profile->CalibrationClock;
+	Dump->MicrosecondsPerCycle = (Profile->CyclesPerMicrosecond > 0.0) ? (1.0 / Profile->CyclesPerMicrosecond) : 0.001;
+
+	for(uint32 ThreadIndex = 0; ThreadIndex < DEBUG_MAX_THREAD_COUNT; ++ThreadIndex)
+	{
+		profile_thread *Thread = Profile->Threads + ThreadIndex;
+		if(Thread->Root)
+		{
+			Dump->ThreadIDs[Dump->ThreadCount] = Thread->ThreadID;
+			Dump->ThreadNames[Dump->ThreadCount] = Thread->Root->Name;
+			++Dump->ThreadCount;
+		}
+	}
+}
+
+internal void CopyTraceName(char *Dest, uint32 DestSize, char *Source)
+{
+	char *End = Dest + DestSize - 2;
+	while(*Source && (Dest < End))
+	{
+		if((*Source == '"') || (*Source == '\\'))
+		{
+			*Dest++ = '\\';
+		}
+		*Dest++ = *Source++;
+	}
+	*Dest = 0;
+}
+
+// NOTE: Fills Dest with as much of the dump as fits and returns how much that was, 0 once it's all
+// out. Safe on any thread while collation carries on.
+internal uint32 FormatTraceDump(trace_dump *Dump, char *Dest, uint32 DestSize)
+{
+	debug_profile *Profile = Dump->Profile;
+	char *At = Dest;
+	char *End = Dest + DestSize;
+
+	char Name[2*PROFILE_GUID_LENGTH];
+	char Line[3*PROFILE_GUID_LENGTH];
+	Assert(DestSize >= sizeof(Line));
+	while(Dump->Stage != TraceDump_Done)
+	{
+		// NOTE: Nothing moves on until the line is known to fit, otherwise it goes out next call
+		int LineLength = 0;
+		uint32 NextStage = Dump->Stage;
+		uint32 NextThreadIndex = Dump->ThreadIndex;
+		uint64 NextReadIndex = Dump->ReadIndex;
+		bool32 Lost = false;
+		switch(Dump->Stage)
+		{
+			case TraceDump_Header:
+			{
+				LineLength = snprintf(Line, sizeof(Line), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+									  "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}}");
+				NextStage = TraceDump_Threads;
+			} break;
+
+			case TraceDump_Threads:
+			{
+				if(Dump->ThreadIndex < Dump->ThreadCount)
+				{
+					CopyTraceName(Name, sizeof(Name), Dump->ThreadNames[Dump->ThreadIndex]);
+					LineLength = snprintf(Line, sizeof(Line), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+										  Dump->ThreadIDs[Dump->ThreadIndex], Name);
+					++NextThreadIndex;
+				}
+				else
+				{
+					NextStage = TraceDump_Blocks;
+				}
+			} break;
+
+			case TraceDump_Blocks:
+			{
+				if(Dump->ReadIndex < Dump->EndIndex)
+				{
+					trace_block Block = Profile->Trace[Dump->ReadIndex & (PROFILE_TRACE_BLOCK_COUNT - 1)];
+					CompletePreviousReadsBeforeFutureReads;
+					uint64 WriteIndex = Profile->TraceWriteIndex;
+					if((WriteIndex - Dump->ReadIndex) < PROFILE_TRACE_BLOCK_COUNT)
+					{
+						CopyTraceName(Name, sizeof(Name), Block.Node ? Block.Node->Name : (char *)"Frame");
+						uint64 StartClock = Maximum(Block.StartClock, Dump->BaseClock);
+						LineLength = snprintf(Line, sizeof(Line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+											  Name, Block.ThreadID,
+											  (real64)(StartClock - Dump->BaseClock)*Dump->MicrosecondsPerCycle,
+											  (real64)(Block.EndClock - StartClock)*Dump->MicrosecondsPerCycle);
+					}
+					else
+					{
+						Lost = true;
+					}
+					++NextReadIndex;
+				}
+				else
+				{
+					NextStage = TraceDump_Footer;
+				}
+			} break;
+
+			case TraceDump_Footer:
+			{
+				LineLength = snprintf(Line, sizeof(Line), "\n]}\n");
+				NextStage = TraceDump_Done;
+			} break;
+		}
+
+		LineLength = Minimum(Maximum(LineLength, 0), (int)sizeof(Line) - 1);
+		if(At + LineLength > End)
+		{
+			break;
+		}
+		memcpy(At, Line, LineLength);
+		At += LineLength;
+
+		if(Lost)
+		{
+			++Dump->LostCount;
+		}
+		else if(NextReadIndex != Dump->ReadIndex)
+		{
+			++Dump->BlockCount;
+		}
+		Dump->Stage = NextStage;
+		Dump->ThreadIndex = NextThreadIndex;
+		Dump->ReadIndex = NextReadIndex;
+	}
+
+	uint32 Result = (uint32)(At - Dest);
+	return Result;
+}
+
+#endif
@@ -3,520 +3,200 @@
 
 #include "handmade.h"
 
-global_variable uint32 RandomNumberTable[] =
+/*
+	NOTE: Counter-based random numbers. Each number is a keyed hash of its position in the
+	stream, so a series is just a key and a counter: seeding is free, and any series can jump
+	straight to any position with RandomSeek. The counter is 32 bits, so a series is 2^32
+	numbers long and starts over from its beginning once it has drawn that many. Short of that,
+	series with different seeds are separate streams rather than windows onto one shared stream,
+	so no amount of drawing from one runs into the start of another.
+
+	The hash is two rounds of a 32 bit integer bijection (lowbias32 from Chris Wellons'
+	hash prospector) with the key mixed in between rounds, which only needs 32 bit multiplies
+	and shifts, so four lanes at a time fit in SSE2.
+*/
+struct random_series
 {
-	0x2185398f, 0x27540bd9, 0x38571bc9, 0x1be40ccc, 0x27646200, 0x31afb39e, 0x1d2f2cfa, 0x178cd2be, 0x2a760241, 
-	0x7209808, 0x1f9fd3f9, 0x385ea3eb, 0x2aaf75b6, 0x321e1c82, 0x1163b1b5, 0x2e5b039, 0x8804ff1, 
-	0x36eea3c, 0x154b6a1f, 0x117bd044, 0x82d43ff, 0x5b70f8d, 0x4a019a7, 0x2cbde749, 0x313828bc, 
-	0x248c035f, 0x18e1112c, 0xffe6e41, 0x1fdb5215, 0x1688cecb, 0x3077ec05, 0x311a2e9e, 0x1098c6e1, 
-	0x3970cc33, 0x18f1774a, 0x399aad0e, 0x341792b9, 0x9df1cc, 0x25ae3df5, 0x101320dc, 0x22e3323a, 
-	0x1c3866fd, 0xf700da, 0x1bc7532d, 0x24818bb4, 0x3a563334, 0xd11990f, 0x127a1bdb, 0x211cb298, 
-	0x1d8bbfdd, 0x82b70f5, 0x364ff42b, 0x1216f585, 0x37c1e99b, 0x821aa63, 0x3b050039, 0xb855a5f, 
-	0x3aec4405, 0x1aff7af2, 0x2f00018c, 0xa5ac482, 0xdcce4c9, 0x3725cf9, 0x322fbe27, 0x2797c106, 
-	0x27653cdc, 0x11da563c, 0x1eccb730, 0xb41678f, 0x144483d, 0x2f606b7d, 0x288b8f57, 0x9d0d574, 
-	0x1a74669d, 0x24880019, 0xcbd417, 0x31e39bd1, 0x313deb4e, 0x37e4c402, 0xb9d9688, 0x3605f9ee, 
-	0x6482cc2, 0x21ea807, 0x1560a11a, 0x185784cf, 0x1a971932, 0xbf90ba8, 0x7ac70a6, 0xc95a16f, 
-	0x7a955cd, 0x262ec2b0, 0x32ae1344, 0x1e66ba85, 0xe4b769, 0x2f50bdd2, 0x1b169297, 0x7acfae5, 
-	0x947307a, 0x24f85eb5, 0x1c345520, 0x2ea4a5db, 0x77896e9, 0x161d86d9, 0x2fc6a1d2, 0x2d052c62, 
-	0x281814e3, 0xb299b8, 0x33ada91d, 0xdaf187c, 0x31881cd, 0x29204bb9, 0x71ca8a5, 0xb46c60d, 
-	0x84ee09, 0x1e07d68e, 0x10097040, 0x39eb7014, 0xa9b475e, 0x1a2cada3, 0x36e9fbef, 0x7af6a29, 
-	0x5f7d01, 0x710b08a, 0x34563a22, 0x176d9cdb, 0x271db6b5, 0x25f54958, 0x1fc6a22e, 0xa35a6e8, 
-	0x3618d819, 0x1851a101, 0x10521304, 0x15db98c7, 0x27b54730, 0x19f02944, 0x2aa9b70b, 0x1f8ec9ec, 
-	0x376e8f71, 0x333052d4, 0x3b691f02, 0x382ca8c, 0x138b7686, 0x2dadc709, 0x2418105b, 0x256add07, 
-	0x30fb847c, 0x24fd7fd0, 0x41848a0, 0x159649bd, 0x21487e60, 0x1a910714, 0x22b16d3c, 0x1ec51a5d, 
-	0xff78ea8, 0x22a3b189, 0x96e08bb, 0x38ffe4dd, 0x19ae13cd, 0x359d9c17, 0x231fc0fa, 0x2001ef72, 
-	0x1e9a3c08, 0x16635c4b, 0x13911f58, 0xc33f107, 0x191a5bc1, 0xcbc32bb, 0x8410ed, 0x1f88b5b, 
-	0x1da16a3, 0x2427b0d6, 0x3338a18a, 0x1a352a62, 0xc931ef, 0x15f708b4, 0x270d3a32, 0x3b32f774, 
-	0x19d7ff28, 0x2d0c4903, 0x28cc289c, 0x2e531a8, 0x29af0e3, 0x47ec0f, 0x326cfc80, 0x25673e86, 
-	0xc0ca4f0, 0x33b19957, 0x2389bf0, 0x2bd9fbbc, 0x2511fba9, 0x89e256c, 0x2fa0a836, 0x3a77e3, 
-	0x30751a14, 0x2a711d1d, 0x321f3827, 0x2e6ceec4, 0x3af33522, 0xfc2cd32, 0x39864509, 0x2b72dbc7, 
-	0x357fee94, 0x1fa6125f, 0x23246986, 0x2c86b4d6, 0x1adf77b0, 0x1494ac51, 0x2a4c8f10, 0x1aa60c8c, 
-	0x182c4288, 0x18a015eb, 0x1d00b41d, 0x30d28d67, 0x1f6f6793, 0x12cc992c, 0x26871588, 0x3860dbf8, 
-	0x3afc0f5b, 0x1636ffd0, 0x1acd682f, 0x2dafce60, 0x38a1dc0b, 0x702fdce, 0x3c8507a, 0xfb00038, 
-	0x4f44c23, 0x4ab6aab, 0xb709128, 0x1ef15112, 0x1a39e09d, 0x3176384e, 0x297d5cae, 0x276e067e, 
-	0x144affc, 0x2c44c917, 0x1a2c24a1, 0x39192143, 0x13a8a5b0, 0x364c5625, 0xded6f9b, 0x9b48680, 
-	0x1804bfe7, 0x1f3464d1, 0x355a4d88, 0x13ae838c, 0x2ede6966, 0x10eea49b, 0xc2e1d40, 0xdc0c18f, 
-	0x24b4ec23, 0x2fec4374, 0x262215da, 0xb94c0fa, 0x11d0477, 0x37c38656, 0x15ca5be4, 0x1f95e5ca, 
-	0x34e027ce, 0x13e332ac, 0xa45ebda, 0x330d9074, 0x141ec1ff, 0x973ac7d, 0x1489d042, 0x29212ebf, 
-	0x159047f2, 0x5196518, 0x12b28d42, 0x261982c4, 0x2820914e, 0x2525a415, 0x18fa2549, 0x27d29375, 
-	0x892bec6, 0x4056106, 0x3577b7d9, 0x2fc88967, 0x29d0bef, 0x3258be63, 0x26f485d2, 0x1ebe3f87, 
-	0x29c8649a, 0x16de0765, 0x9a1d765, 0x1cc7f716, 0xee1c222, 0x29b68f52, 0x33d9e1a5, 0x294af8d8, 
-	0xcc06f7e, 0x16b7794d, 0x9c8bf28, 0xfddb1b6, 0x20631306, 0xcba57a3, 0x193876fd, 0x22497ae0, 
-	0x3405c30c, 0x2b6740ab, 0x2a1be28, 0x21980d74, 0xfd64baa, 0x258b43ba, 0x230b7df9, 0x3137d119, 
-	0x363b4058, 0x14510f0b, 0x3b3e529b, 0xd377995, 0x2adaec20, 0x176cf3ca, 0x8ff6fc5, 0x1bc60bc3, 
-	0x2cc32494, 0x130f26a4, 0x17266b66, 0x17bbf70, 0x31c62fba, 0x340eb380, 0x1ee5bead, 0x22148c0, 
-	0x2119c404, 0x1632304, 0xa8630b7, 0x1b792d41, 0x210c2d2c, 0x4b4f0b1, 0xc74ab1, 0x2c687fd5, 
-	0x35f2373, 0x2a21836b, 0x3a1d4bf8, 0x1c6d8fb9, 0x177db2f9, 0x2fd58a31, 0x27a18bf4, 0x2ade909d, 
-	0xd862f94, 0x1b854b68, 0x3069b51d, 0xcc600fd, 0x2d695edd, 0x99f515b, 0x359ee3f9, 0x2f565760, 
-	0x324b45d0, 0x12ea7af5, 0x1339893d, 0x14c1d6be, 0xa9f1954, 0x1ccc215, 0x2f71f1c, 0x2be9d492, 
-	0x1e3eaaeb, 0x582ab9, 0x1e3fca6, 0xc4c717f, 0x1909804a, 0x17da29d6, 0x1176f06b, 0x129deae5, 
-	0x1e47262e, 0xc3d0bd5, 0x15720137, 0x17ca2262, 0x17b5e9f2, 0x35f5d38a, 0xad11624, 0x29599348, 
-	0x18f457bc, 0xf118243, 0x8b380d4, 0x1126796f, 0x15564d51, 0x2f4ef5d1, 0x188aea55, 0x329a575b, 
-	0x26672a66, 0x2392aacb, 0x806f297, 0x3057ad91, 0xe5642dd, 0xb32530, 0x3249f6e8, 0x11def455, 
-	0x26f04b3b, 0x1080da4f, 0x13ef6262, 0x2a32a52c, 0x39679732, 0x343c2376, 0x14c1b67f, 0x1ff84bfa, 
-	0x10f0f0e6, 0x2e82af2e, 0x24367680, 0x1db2a48b, 0xf40f66, 0x25a3e2c6, 0x131affd0, 0x12515c16, 
-	0xc6e1d56, 0x25449e93, 0x34f03867, 0x2f81bbf6, 0x14ce0e46, 0xce8a12f, 0x2cb4142, 0x32108dd, 
-	0x2d5ea2fb, 0x2b8ee65c, 0x1aed31fc, 0xf9a5ba6, 0x372dd5f7, 0x23aab2aa, 0x32d35cf6, 0x248f2ce, 
-	0x18bb5614, 0x2870bd1a, 0x7f52d40, 0xab3fedd, 0x9ceea7f, 0x70bd83e, 0x1c96be0a, 0x241f6670, 
-	0x8ff7be6, 0x2453d13, 0x2779fdda, 0x3666d048, 0x2a199b7b, 0x15a5e9a1, 0x7cd6f3a, 0x33eef05e, 
-	0x8813bce, 0x29c10170, 0x2be4ac3d, 0x35e7e834, 0x1922fb6f, 0x2cebaf38, 0x1a9b6301, 0x38bfa6c1, 
-	0x27f78582, 0x745e796, 0x1611fa6d, 0x27a8197, 0x2213e197, 0x334ef385, 0x13a2ff9d, 0x25f2c902, 
-	0x2c3f602f, 0x8cdbea4, 0x28c5614b, 0x24688c5e, 0x30d3f11c, 0x79a7f36, 0xb430bb7, 0x1fd55a6c, 
-	0x2ad46f48, 0x10347d3, 0x1f7ebb56, 0x9e4384e, 0xd66259a, 0x27bd88a9, 0x27a531c1, 0x2f6ed765, 
-	0x1dc2f74a, 0x2a08801, 0xab3e332, 0xff5a299, 0xd011759, 0x6c3705e, 0x16cf1665, 0x226f5781, 
-	0x76bc86d, 0x1821477d, 0x17167e73, 0x31ac69c7, 0x22b27c53, 0x255c0d73, 0x613f543, 0x1f439aef, 
-	0x615e961, 0x2da24bff, 0xbbea2b5, 0x17af381d, 0x24b22434, 0x1718f32c, 0x2cce9477, 0x11aa8c86, 
-	0x3a5e7cdf, 0x38d8671e, 0x8c2dd5d, 0x1fb04b9b, 0x31b835d6, 0x1f829957, 0x275e5619, 0xb82814, 
-	0x1320d8cb, 0x35b69655, 0x3b931a53, 0xa8b6f72, 0x328cf610, 0x1290ce35, 0xe873b3b, 0x39046c8c, 
-	0xa50586f, 0x33660797, 0x2a18a163, 0x32bac4a7, 0x6087db1, 0xcbd9456, 0x293c5bb1, 0x1372e6ba, 
-	0x1a0dd91f, 0x1535bac, 0x1604717e, 0xc8441a, 0x25ad5f48, 0x2af2d6c0, 0x14e15e7e, 0x3aa6cf91, 
-	0xbe169c6, 0x1c188676, 0x15b993bf, 0x31928bed, 0x336ecdb2, 0x2f03f57b, 0x223edebd, 0x66cc666, 
-	0x2a845c6c, 0x255d3148, 0x656af45, 0x2eb212f1, 0x3aea0a44, 0x29b3520c, 0x1d2722d4, 0x3b84a8f, 
-	0x3752b7ee, 0x1f43d367, 0x1c40b4fe, 0x22da8fab, 0x77605ac, 0x3967132d, 0x11b959f0, 0xa11ac84, 
-	0x95e8879, 0x30d11d83, 0x1f522508, 0x6d821b8, 0x86da0c4, 0xc56a39b, 0x26566815, 0x94ce270, 
-	0x2fe2d4e5, 0x6d5ad37, 0x3951800f, 0x39729ae8, 0x4268bb4, 0x163cbfaf, 0x152dc5a9, 0x2f299a74, 
-	0x30456970, 0x3392cb92, 0x1d674f79, 0xc9a819c, 0x316020d, 0x2de92ea4, 0x155ac7ad, 0x27423abf, 
-	0x271bc700, 0x2a7b27db, 0x29d3d765, 0x35811274, 0xf74430a, 0x1fdb05b8, 0x26da6908, 0x31d8c8b2, 
-	0x1122e4d6, 0x2e78d7de, 0x7c0e13d, 0xe239542, 0x27aeeba, 0x21ffb2b3, 0x70ae6e0, 0x3a7a6993, 
-	0x10af1fe4, 0x18bea557, 0x7c426b4, 0x17d40f95, 0x31e9f1e6, 0x375ee52f, 0x3956e19e, 0x26666bc7, 
-	0xb81ea3c, 0x2015e960, 0xd4fa756, 0x13c783f4, 0x158f9652, 0xc214760, 0x175a424e, 0x2d53eb9e, 
-	0x1c4dc730, 0x8f04cda, 0x1f317a52, 0x1eec044e, 0x31545b9c, 0x17f3bb25, 0x39412e3a, 0x946ca6b, 
-	0xa27bd64, 0x3435f4c3, 0x1ef4ba1b, 0x1643b65e, 0x30233c82, 0x10867929, 0xc8de34b, 0x36e9e84d, 
-	0x3781aeba, 0x3577d78d, 0x7a3649b, 0x1ee97077, 0x1d44e7f, 0x2cba7a55, 0x7b4eeb9, 0x1658f601, 
-	0x37429aba, 0x25a8ad1b, 0x16019072, 0x15b1bd01, 0xe4baa90, 0x2bb058bf, 0x368b3159, 0x258fdf6e, 
-	0x25ac19dd, 0x1750a8d6, 0x17106523, 0x1088aee3, 0x4b0f665, 0x4f10622, 0x1537364d, 0x35de044d, 
-	0x272b162c, 0x814c56b, 0x10797dc8, 0x1b47df9, 0x1ab16d7c, 0x2a858200, 0x21684fdd, 0x2e76fb75, 
-	0x2524a2d1, 0x201629df, 0xab76af9, 0x82842c4, 0x15371dfd, 0x2f029195, 0x2bfc01e9, 0x33eed54d, 
-	0x10e18a56, 0x38bdc437, 0x2c5ff571, 0x369beae2, 0x178f8384, 0x226243d5, 0x2f816eb3, 0x29f262e0, 
-	0x80fefb4, 0x2dc6f31f, 0xba12b25, 0x384519c4, 0x1f2f9047, 0x36ed465d, 0x26cbc637, 0x2ffde458, 
-	0x264554d3, 0x3579526f, 0x23c6cc3e, 0x235b0d64, 0x356a7de6, 0x3aae4cb1, 0x1e72da5d, 0x26cfa71f, 
-	0x28c3446d, 0x1c876d50, 0x2b4a0f7a, 0x1c2a29c9, 0x2054a3d8, 0x21344d82, 0x38215ae7, 0x22989264, 
-	0x324151b9, 0xdc55520, 0x1cf2b793, 0x152fee0c, 0x2c8c5de3, 0x1f90a82d, 0x36446427, 0x22a43305, 
-	0x12f5cf39, 0x237bf4d1, 0x2d4b6ce3, 0x252b7447, 0x2e79d111, 0x323173ac, 0x2424dafc, 0x19b0086, 
-	0x35063edd, 0x76d68f1, 0xef421e4, 0x2414eeb5, 0xa816c5b, 0x3824b4a9, 0x177c1baf, 0x34fb07f2, 
-	0x25007c68, 0x1b2bf718, 0x3ab3db4d, 0x30705b1c, 0x2994441c, 0x11efcf2a, 0x1de88662, 0x1cb0d6e4, 
-	0x73fd066, 0x3538defd, 0x1009b90d, 0x8c74590, 0x198df8c8, 0x12f4e3ca, 0x2584c913, 0x5c27d96, 
-	0x27ef7a30, 0xedade45, 0x23bad22a, 0x2a91a291, 0x25950869, 0x1c8daa64, 0x1f0a6846, 0x28d2a126, 
-	0xac35ff1, 0x1a02f876, 0x2fe25cc0, 0x423f81d, 0x29ba70e, 0x29616f70, 0x1f3b37bb, 0x36faa941, 
-	0x1d2d34eb, 0x393d7253, 0x220a916b, 0xf4ed395, 0x39d3fd4a, 0x2d14ab0, 0xcb52910, 0x3a844a5b, 
-	0x2d372856, 0x24847ce8, 0x13351901, 0x2c10e7cd, 0x3b91f594, 0x10397424, 0x37e00c79, 0x377253f9, 
-	0x67e1316, 0x28f3e59c, 0x2e183b1, 0x15c0e066, 0x2fff1883, 0x1c5c44ea, 0x31206a65, 0x381785d2, 
-	0x1e6f5508, 0x1a9f8077, 0x274770fe, 0x9c5860c, 0x3928ed0f, 0x1006189f, 0x102e0db, 0xf905413, 
-	0x1e4552e, 0x2218dd2a, 0x143ee114, 0x29a7066d, 0x2a0ad16b, 0x1e35802f, 0x1649bde, 0x1b2db4e8, 
-	0x37fdca46, 0x13c25ee8, 0x2cbf0b52, 0xae620d1, 0x613e3bd, 0x37f7cec6, 0x1dc529b8, 0xf1b80ec, 
-	0x11d11025, 0x2ca3053c, 0x100478d, 0x1eae6207, 0xbb3d571, 0xbd93eed, 0x93709fb, 0x99c73bb, 
-	0x3764ecbc, 0x1e10b03a, 0x35d7eb31, 0x26fba784, 0x1e1f95bb, 0x38dcfb2b, 0x9aebfbc, 0x2e82dba9, 
-	0x6c7579c, 0x35e514b6, 0x2b626c11, 0x260c692c, 0x168e1286, 0x2e582cf8, 0x263fa0ec, 0x10848726, 
-	0x15a07309, 0x2f76b41, 0x32b51b8e, 0xc046000, 0x1fa43a4e, 0x2bb6930d, 0x2cc1930a, 0x17c2ad27, 
-	0x1ed12f6f, 0x3aa468e1, 0x33b8374b, 0x2622493b, 0xfcf4044, 0x2076e684, 0xcb66f53, 0x3d95ada, 
-	0x24321970, 0x1971ad7e, 0x306d2d20, 0x180c703, 0x34b0e7, 0x18dc2f6c, 0x33f7fc90, 0x332c31cf, 
-	0x184489ea, 0x20b37ee1, 0x1311f6eb, 0x75120dd, 0x24b48467, 0x254a8046, 0xb172014, 0x21b72d34, 
-	0x1fd99c49, 0xa3f14e, 0xd097f20, 0x3af8f8e6, 0x1a37b4b3, 0x2355168f, 0x3b2016cc, 0x23970880, 
-	0x293207b, 0x1db7d7c6, 0x29053e66, 0x37e0710b, 0x1b64dfc0, 0x11fc930b, 0x67ae48f, 0x1e7397b0, 
-	0x17943549, 0x31bfafec, 0x1d996c50, 0x17fd5073, 0x309e688f, 0x1c7bb21, 0x2a7914ed, 0x1ec6f6e1, 
-	0x139cd296, 0x79ddfe3, 0x391722d8, 0x2b72ff6d, 0xef380a8, 0x19c8e2f2, 0xc274ce0, 0x3e4ed4f, 
-	0x30e07652, 0x12b55b70, 0x232736ee, 0x36ab401e, 0x178ed80a, 0x3580caf2, 0x12b4b06a, 0x2c461e7b, 
-	0x26d927ac, 0x2ce3deeb, 0x1ae28303, 0x31075c5, 0x27a9fb9, 0x343444b, 0x3b0ddf69, 0x1533428b, 
-	0x9261f90, 0x707ddf, 0xc434df6, 0xbcc1c26, 0x1c2cf0d, 0x1459a7d4, 0x1d334fef, 0x2920f2b4, 
-	0x39ab191a, 0x5f5f678, 0x1ce996d, 0x5d802b3, 0x369812c2, 0x9257fe9, 0xd51016a, 0x29d69e38, 
-	0x28d21e40, 0x182d7349, 0x11d5c7f0, 0x2bf45394, 0x2f79a145, 0x6f11f50, 0x2c940b28, 0x1e9cf83, 
-	0x308f8270, 0x22b166ca, 0x9a5469a, 0x1ff4d4c3, 0x25f5324b, 0x27c9ca67, 0x21e19e93, 0xfe2b05c, 
-	0x160dd639, 0x1e495635, 0xe5b690d, 0x20430a34, 0xcc9695d, 0x350dbfd0, 0x22ac0105, 0x311852d2, 
-	0x28af6e19, 0xc059ada, 0x272a705d, 0x2f2bcae3, 0x3116e9dc, 0xa6090d9, 0x2f24fa68, 0x264d48c9, 
-	0x3ae2ada2, 0xf9e1ad6, 0x2e95e190, 0x1139b14c, 0x2499237c, 0x23156c70, 0x26528903, 0x200a9608, 
-	0x31f3e0e9, 0xb223a98, 0x13e3d57, 0xef65cbe, 0x3883b82d, 0xdc69973, 0xfe4adab, 0x24a301c5, 
-	0x3c83315, 0xbb91069, 0x346dd317, 0x15f5e639, 0x2c2ad606, 0xf2e047d, 0x1f14b9b1, 0x1e70975a, 
-	0x5eee6f5, 0xeea9e5f, 0x3154394e, 0x1bec1ab, 0x4aa45c8, 0x20ff1b28, 0x155c89a5, 0x308bb204, 
-	0x2595af9b, 0x1c2b68f4, 0x3b39a745, 0x1cfe818e, 0xcb3d11c, 0x25e6b511, 0x19d94f49, 0x2b17e54f, 
-	0x19450585, 0x1424910, 0x1d75010e, 0x1b3dae0d, 0x1f3be162, 0x359f48ca, 0x39643a94, 0x21d619df, 
-	0x3277043a, 0x32063040, 0xc2c9375, 0x25b7664c, 0x2f764d15, 0x157ec12e, 0x2a8b898e, 0x38717634, 
-	0x102e9761, 0x39f7186c, 0x14cbe24a, 0x959ad1c, 0x260bd1e5, 0x93177da, 0x1b1e5f4e, 0x1725b846, 
-	0x2bff73cd, 0x34cb4c53, 0x60473fa, 0x107db169, 0x27fed778, 0x2e9b9ed1, 0x5f87ed2, 0x1a0fec16, 
-	0xea07272, 0x9f0b540, 0x2844087b, 0x38ccafd, 0x384ac160, 0x3966d3c0, 0xb489ead, 0x18cc4378, 
-	0x504586b, 0x3041be9e, 0x3b46e267, 0x60114db, 0x1df93742, 0xb4baba6, 0x219e5382, 0x1a755885, 
-	0x17ae181c, 0x1710237e, 0x35192f38, 0x3b1637ff, 0x24c7ee14, 0x235f9580, 0x1da3b7df, 0x161c90e2, 
-	0x370a44a7, 0x345ce5e8, 0xbccaf0e, 0x217ffb18, 0xcfaffbc, 0x39350a05, 0x22b18eb7, 0x1fd0edfe, 
-	0x58e384, 0x1e83d40c, 0x1d37356, 0x3a77c8df, 0x5118c22, 0xb97cf19, 0x2797e4a0, 0x11e1dfb7, 
-	0x317e9190, 0x151fe7a, 0x399877d6, 0x1bcfaa8b, 0x3780452, 0x3295c82c, 0x26adce35, 0x2a9c20c4, 
-	0x21f61d35, 0x1f314199, 0xc0b8a88, 0x2b7ec772, 0x1825b3a9, 0x22a47293, 0x24b0fe34, 0x1562f280, 
-	0x27dcd81, 0x16d9b932, 0x2fa744dc, 0xb1239cc, 0x27dffa8d, 0x16ea32, 0x35bfe040, 0x3187b48b, 
-	0x3995d9f2, 0x26952ca8, 0x1fec5bd4, 0x207bcd55, 0x11a0db59, 0x129ae439, 0x326ee8e6, 0xc1a9039, 
-	0x10f7ae4f, 0x82d6dd7, 0x2a2e6389, 0x217e17d2, 0x11a22854, 0x13ba9098, 0xe9b5798, 0xd4e62bf, 
-	0x1bd744e4, 0x19f20fa4, 0x1723a87f, 0x209a4873, 0x279608f9, 0xdc227fa, 0x8283764, 0x35c5403a, 
-	0x25a3ada5, 0xe51b29c, 0x7c8ef3d, 0x3cfa54b, 0x39c0eb11, 0xb75cc5f, 0x918c405, 0x6034d7e, 
-	0x14c159bd, 0x2717abae, 0x4aa008, 0x1dd85582, 0x256697, 0x16713e28, 0x39c2b79c, 0x10e0c55a, 
-	0x22f084cd, 0x11784ec9, 0x3b52c41e, 0x12b38c6c, 0x1d6d230a, 0xd1e372, 0x25deb208, 0xf3cb45a, 
-	0x6db46fd, 0x2430781, 0x34a4c15a, 0x200f4a72, 0xe2454a4, 0x37ef0405, 0x1e7e4c77, 0x22c1e098, 
-	0x270b6c14, 0x17fc4f33, 0x8ae0cbd, 0x32613a8d, 0x258799d6, 0x396431cc, 0xbe8e965, 0x37141022, 
-	0x1d3bd86a, 0x2a779093, 0x21b47531, 0x6f020b3, 0x2f7f09b8, 0x3873f4a8, 0x2dcaa80d, 0x312e1aaf, 
-	0x1178186a, 0x191e359f, 0x351b0eb8, 0x22db660e, 0x905d97, 0x2baf5992, 0x388e4de3, 0x128fdaa2, 
-	0x2cb0003a, 0x308e242b, 0x3b433dc2, 0xfe15eed, 0x3028e3cd, 0x1d89a4f3, 0x1bf9c981, 0x2ed180c0, 
-	0x292e31a0, 0x293358eb, 0x20b615d5, 0x145aa5fa, 0xae89b58, 0x2ec3c1b9, 0x1691801d, 0x29df8cbc, 
-	0xc594e4d, 0x1f20c4e8, 0x1972557a, 0x18582b20, 0x7369bd9, 0x1c93e552, 0x14b028ed, 0x22986533, 
-	0x2a3b213f, 0xfa6e74a, 0x202f503d, 0x3a4d33be, 0x2f83941e, 0x246b5660, 0x2f7e6d0d, 0x5a8d7a6, 
-	0x13841d3f, 0xd22288c, 0x1f39f17d, 0x264b5a18, 0x31cb8be, 0xf8d42c0, 0x22ec26dc, 0x3aa3a1d, 
-	0x2e38bc2a, 0x29a65768, 0x1fc6a6ab, 0x15a30f58, 0xa6b4f1f, 0x2d51699b, 0x133b75f2, 0x59facc5, 
-	0xa09589e, 0x1d3e88d9, 0x2295264d, 0x13b10c30, 0x1665107d, 0x16ff80fb, 0x177e5e5c, 0x35951979, 
-	0x3c93f00, 0xa0518b0, 0x242b930f, 0x292a7297, 0x29e9f000, 0x31a3a814, 0x251f39d8, 0x1f6a2a4e, 
-	0x21624d96, 0x1bccb938, 0x31013976, 0x3338691e, 0x345dd360, 0x1b2e85b, 0xb4dc98e, 0x2d98fe9c, 
-	0x18535b9b, 0x10f015fe, 0x61fc028, 0x17074ff, 0x38ae5c51, 0x178fc0d0, 0x21473c43, 0x1f8fc884, 
-	0x3cc85ae, 0x108c4d6f, 0x3ab6a0ff, 0x1d303d79, 0x17783c99, 0x2c4d4f58, 0xd58e057, 0x14fb382f, 
-	0x156d1c7b, 0xba28879, 0x67274fc, 0xdd459a4, 0x30a18ca, 0x1705f580, 0x26d86e61, 0x1e6024a6, 
-	0x8cbec2c, 0x11ee61b6, 0xbd93211, 0x1c1e4129, 0x33a9516, 0x3b81b7b5, 0x21834d77, 0xbf02abc, 
-	0xbd18d2e, 0x1f864310, 0xdb70831, 0x326407bf, 0x10c47c16, 0x840a6b4, 0x1d213c11, 0x2d2fd47d, 
-	0x13a00f, 0x29219be, 0xb7df8b4, 0xc515a87, 0x2f02b63e, 0x1a087556, 0x81fd5b9, 0x28e61c36, 
-	0xef56e13, 0x31d27bea, 0xe1a1cda, 0x2b165ec8, 0xbb1021b, 0x1db4ffad, 0x217a02a0, 0x2f9a2f7b, 
-	0x2420f4c, 0x2f2003f6, 0x17a6d2ac, 0x8eb528e, 0x13eb4105, 0x8a42f72, 0x255513b2, 0x2883dbf7, 
-	0x3844f194, 0xe4440f6, 0x15a3b243, 0x2c1aa44b, 0x2523bbd7, 0x18a6211, 0x202113c, 0x176e037, 
-	0x29ebc0d9, 0x1789b8fb, 0x13b1781b, 0x12b2f05f, 0xd4baae9, 0x372d1473, 0x3184d2c3, 0x194a0478, 
-	0x6d517a6, 0x2ec922e1, 0x323c23f4, 0x1b3e3024, 0x3a925e99, 0x1dbf8e3c, 0x2d46ed92, 0x2ec72768, 
-	0xd216097, 0x256462ec, 0x11aa1137, 0x253e0426, 0x2012390c, 0xf19ee1a, 0x2c149cab, 0xf9c9504, 
-	0x28f72079, 0x358505b3, 0x57a23fa, 0x279101f4, 0x3b763ac5, 0x33081f68, 0x14e8dfb4, 0x9356b02, 
-	0x22dbdf9d, 0xaae135b, 0x3072d32d, 0x2590dbf9, 0x34c4db56, 0x2aeb5223, 0x3b8e5d6, 0x32acb8b7, 
-	0x2318ad4c, 0x1b82342, 0x73840f6, 0x15a9faa8, 0x2581e96a, 0x1dd9ff6e, 0x31873f40, 0x2b5c77a9, 
-	0x835a8c, 0xcd6b8ba, 0x1ac8b15f, 0x32aed12a, 0x3b7e2613, 0xab62aed, 0x1225cd81, 0xa40416, 
-	0x37ddc4b, 0xb2888ba, 0xd99232f, 0x2f1ebf3d, 0x24d5403d, 0x39ad0fd, 0x1930220e, 0x19f8b914, 
-	0x1fe99cd4, 0x2e3c76b2, 0x1e832e8a, 0x260a57dc, 0x3b6a0a84, 0x38c3898a, 0x25c4ab82, 0x34cd1065, 
-	0x3762e9bd, 0x1bdc073, 0x1807876f, 0x207bcb63, 0x1dc69952, 0x365a3cc0, 0x2f0d8610, 0x2f2a92c3, 
-	0x35754a0c, 0x27731f75, 0xf3e5ab9, 0x3c19a4, 0x3065ed0d, 0x278284ce, 0x806d9db, 0x2ec3d06f, 
-	0x1be04bca, 0x304a7350, 0x1ff608f9, 0x1ff7837c, 0xd7e5be9, 0x252a2f3b, 0x20212ddb, 0x2d5747cb, 
-	0x36661ab4, 0x9ca431a, 0x925bb37, 0x69d61e8, 0x3a6b13d6, 0x20a77c4e, 0xaeb5dbb, 0xe346768, 
-	0x3184b513, 0xc698804, 0x7f086af, 0x12021f97, 0x354223bf, 0x180c3799, 0x5e380de, 0x1160bf44, 
-	0xbc49b29, 0xab04e65, 0x1fa961e8, 0x25f60c3c, 0x3b0c7f70, 0x11423017, 0x1e7d6b22, 0xda0bc2b, 
-	0x237dbe4d, 0x16c76235, 0x18d13948, 0x2cc1770a, 0x1e26023c, 0x1d73c799, 0x36a6367b, 0x36bb961, 
-	0x133b391b, 0x6ee371d, 0x3b20a03b, 0x22ca2ccc, 0x2660a15a, 0x16ed304f, 0x3b1436f1, 0x2bacb669, 
-	0x528ed60, 0x3a514496, 0x107be962, 0x39e92e84, 0x14e8b2aa, 0x9c2305a, 0xcaf011e, 0x14014ff7, 
-	0x28c6b65f, 0x350b2492, 0x1109f08, 0x3652d45d, 0x39577f6d, 0x7fdee15, 0xa619e86, 0x36b75842, 
-	0x34de0b76, 0xdb38e6f, 0x2e951d8e, 0x1318399a, 0x1d959e79, 0x35eb4e82, 0x132de7d2, 0x1f566dbd, 
-	0xf8a8e37, 0x2736d390, 0x1438c5cc, 0x1c5815c8, 0x17b76e1f, 0x23ac3b55, 0x15559658, 0x22d48f7d, 
-	0x4ff867c, 0x24114e20, 0x20cfa8c3, 0x1267c0b6, 0x13843592, 0x150f451f, 0x23168c0b, 0x2b557272, 
-	0x33f790f7, 0x147a4b5f, 0xa6b4b40, 0xa99787e, 0x1af1c026, 0x1b6e2192, 0x2d79de4d, 0xdde15a, 
-	0x844fe8e, 0x360f9266, 0x24aab5fa, 0x1098f8d3, 0x3cfa322, 0x1444de52, 0x214c520d, 0x1b198738, 
-	0xc50e9f9, 0xf52052c, 0x1ecd1367, 0xb8a1f06, 0x1e128998, 0x31b8de52, 0x2b5333de, 0x350e41b1, 
-	0x10b40aa4, 0x147c11f8, 0x2ac5f64d, 0x8410156, 0x2abd42a3, 0x15c2e034, 0x12da1bf4, 0x480bf58, 
-	0x12b366e1, 0x36c5f55d, 0x3138bcd3, 0xfd49c26, 0x55ae92e, 0x31caa8a6, 0xa75aabd, 0x1b682e3b, 
-	0x5adf25f, 0x188c6ea5, 0x11afe6bb, 0x193ad526, 0x114d1e6d, 0x39ddf528, 0x18dec5e3, 0x2034720c, 
-	0x1a970a4b, 0x39ce6ccf, 0x33d00170, 0x287b7c2d, 0x1c69674d, 0x14995ec4, 0x2d6113f4, 0xc1ad0e5, 
-	0x97f6cbb, 0x13c1aa50, 0x2dbca528, 0x2c310e6d, 0x3b760ce0, 0x156c8283, 0x1edf5445, 0x180a1a3d, 
-	0x391dd1b3, 0x338a4cf1, 0x3942a31c, 0x449723a, 0x15dab27e, 0x78e1b35, 0x2e87ebc2, 0x2d1bd1c2, 
-	0x285ac709, 0x1857f99, 0x39b0d245, 0x121ae989, 0x2080a1d3, 0x71d0f1c, 0x362097a9, 0x2310320d, 
-	0x12bb2661, 0x39ae7681, 0xad572f5, 0x158eb15f, 0x23d52d69, 0x282f0290, 0x26b44fdb, 0x944701c, 
-	0x3ab2ee28, 0x2ebfe71d, 0x1863763d, 0x2a73af74, 0x2036c9db, 0x331a8ce8, 0x35e2a4c5, 0x7ccdf92, 
-	0xebfb98e, 0x2b96648c, 0x1265ef4c, 0x374291ed, 0x3612eadc, 0x6a10936, 0x5112c7e, 0x3db3334, 
-	0x21ae4990, 0x1e58c02d, 0x2cf4e357, 0x2b427112, 0x33a8ce8b, 0x197a37a9, 0x3865c0e6, 0x2554702b, 
-	0x3045fafc, 0x21f4d6ef, 0x187df58f, 0x304ef784, 0x3a13b24, 0x120665cd, 0x18b0314a, 0x2cd9cbee, 
-	0x119def1e, 0x2746c556, 0x1d449f8d, 0x2b29be3, 0x57183ff, 0x11a5700, 0xe94f406, 0x22d9a0ee, 
-	0x384049d, 0x14fade9e, 0x2eb2dd0b, 0x8eb42b2, 0x2aa867ba, 0x1a34c00b, 0xc507677, 0x317a7e36, 
-	0x32324130, 0x3743ae85, 0x363bda65, 0x17fabe6a, 0x4a5e633, 0x243701c8, 0x21ce537e, 0x25e6ee9e, 
-	0xdb68345, 0x17116b79, 0x31701e97, 0xe67fd8f, 0x13ce04ff, 0x334e8a65, 0x29f53691, 0x1e26f480, 
-	0x375082c7, 0x278c1d66, 0x1174e492, 0x5ead651, 0x11556b62, 0x1f86f7e6, 0xf16528b, 0xbc5be41, 
-	0x3181f75c, 0x158696fc, 0x1942d61a, 0xe7d6da, 0x38603767, 0x19a1f6fd, 0x34f8462e, 0xa9d4cd9, 
-	0x112a834f, 0x33a8cd76, 0x9066fc1, 0x1f1aa4c5, 0x303b9313, 0x10c5e149, 0x105291b9, 0x1c652f28, 
-	0x2bec247a, 0x1b806239, 0x901466c, 0x3e751f0, 0x38edf959, 0xec2ab7e, 0x1ac6841c, 0x27f82d15, 
-	0x13c0b1a, 0x24cdcd0f, 0x25165c4a, 0x21866de7, 0x1f18e6bb, 0x1d0cdf76, 0x872691a, 0x24e0de80, 
-	0x230f536f, 0x1de966c3, 0x21108502, 0x347c68c2, 0x8dfce4d, 0x1ccc09a9, 0xce0d718, 0x4d4fcd1, 
-	0x133d033f, 0x2f107e5b, 0x122a53cb, 0x32bf58ba, 0x1c26ca81, 0x79d4cf0, 0x13df961f, 0x1a5f2e6e, 
-	0x22f35995, 0x33a7b223, 0x981d622, 0x1345fe6a, 0x34d52703, 0x3b5a8461, 0x6d9cbd9, 0x19212d5c, 
-	0x3292bbc4, 0x6d6bc22, 0xb735c24, 0x34b45475, 0x37cebec0, 0x36d5dec5, 0x13213891, 0x22c24f87, 
-	0x28807c9b, 0x1aed3026, 0x148d38f1, 0x234e7ca4, 0x2a6160d1, 0x552eca0, 0x20b456b6, 0x29c4c601, 
-	0x224afeb3, 0xa97330f, 0x177deba0, 0x2ca37162, 0xeb048b4, 0x3abbf21c, 0x304fa8be, 0xe10fdce, 
-	0x284645d1, 0x223866da, 0x260a9c9b, 0x235fe791, 0x18dd777, 0x24f1031e, 0x25b43c4f, 0x33cb774a, 
-	0x1614ef56, 0x2368933, 0x2b59a981, 0xf23ee66, 0x9fd6e70, 0x26c5b5e9, 0x1ce81e3e, 0xe0e7710, 
-	0xc8e94c8, 0x2821f8b0, 0x15b41df5, 0xbe984aa, 0x1cb52df9, 0x3aa0f810, 0x18958d14, 0x2ee245e3, 
-	0x20750639, 0x2e3176fc, 0x2a3684b3, 0x16d49bfa, 0x381006e9, 0x13e25113, 0x2133132f, 0x25019e3c, 
-	0x18bd910b, 0x2700493e, 0xb235b69, 0x95acf15, 0x140f34ce, 0x5dbc5e, 0xf738829, 0x2085abfb, 
-	0x3eefb03, 0x313a79a5, 0x2831b4a3, 0xc9c80a8, 0x34c60953, 0x28c7040, 0x30abd324, 0x30980cde, 
-	0x30aec2ca, 0x606a2c7, 0x227e5e41, 0x140465e3, 0x333d2314, 0x129a9ac1, 0x361bf114, 0x1df48c48, 
-	0x2a01f1ab, 0x1bb2f169, 0x156aa3cd, 0x38864f7d, 0x1dc7da8c, 0x2cc43d41, 0x3ab61048, 0x1feae49f, 
-	0x31c839fe, 0x1b4d9c3d, 0xf01c85a, 0x16319131, 0xf5998f, 0x3a8342f7, 0x95b2b48, 0x11f5c2b3, 
-	0x12df03f4, 0x213bdb62, 0x2389351b, 0x28bbdcda, 0x1858638d, 0x187089c4, 0xa29ba41, 0xfb792bf, 
-	0x4ec827f, 0x9f5e7c0, 0xba9f8c7, 0x1d948dc1, 0x18f7d962, 0x320a1e61, 0x32897ffa, 0x35d2b12f, 
-	0x9ae3ed5, 0x1caef8de, 0x34a6dd, 0x1ebda976, 0x33e32997, 0x3757bf22, 0x9dd2343, 0x33cb7a41, 
-	0x168d120c, 0x35fd212d, 0x263dd0a7, 0x29063e6c, 0x1ebeceff, 0x72f411f, 0xc133ea, 0x499198f, 
-	0x5ff0fb2, 0x273ff1f6, 0x158e9816, 0x28f07d7a, 0x2667ae22, 0x1890f8ec, 0x705c565, 0x26c97535, 
-	0x1736d64c, 0x2ed84364, 0x2de8b942, 0x1b81cc2d, 0xcbbbea8, 0x1dc37e28, 0x370d0896, 0x37fd02c4, 
-	0x6ae2f31, 0xce4ab8e, 0x1548af98, 0x13e38d1e, 0x110e653e, 0x1203345c, 0x26bcab6b, 0xeee44a, 
-	0x12bb6471, 0x37806894, 0xac39f1c, 0x3074dabb, 0x16f0916b, 0x17390842, 0x34009a10, 0x30aca29a, 
-	0x2e3c6518, 0x180ae0e5, 0x1a72dcce, 0x3b8d7a53, 0x2d264c27, 0x16b301c6, 0x2791ea4b, 0x3015fae2, 
-	0x6bf28b, 0xc1e2d9, 0x399153cc, 0x1741b54b, 0xae8c5c9, 0x16bcf5bf, 0x12c361ce, 0x7b63a5e, 
-	0x130ce294, 0x17602287, 0x3a5d8bec, 0x33b32a80, 0x378a29f6, 0x34661516, 0x27201828, 0x13b6453d, 
-	0x147f5502, 0x33f29e43, 0x5361e27, 0xca943f0, 0xeddbdc5, 0x6675a4, 0x1464a83, 0x1232af1, 
-	0x21ad0958, 0x7e9fb73, 0x12143a87, 0x36917264, 0x388a581f, 0x23204f4, 0x3a4a5045, 0x369489f3, 
-	0x1d02a21b, 0xe425f6c, 0x27e6143a, 0x180a05ea, 0x34acd809, 0x23580597, 0x29227bf0, 0x33c4573c, 
-	0x19d4fc0, 0xe293718, 0x1289ec1b, 0x72815a4, 0x303b6548, 0x32a0de04, 0xc8ad47b, 0x217b63a7, 
-	0x683c562, 0x38f150a2, 0x1571700c, 0x3001c9f9, 0x3067ac21, 0x151e263d, 0x34394e1c, 0xa1c4ba4, 
-	0x9cf569, 0x7aad100, 0x30a9236d, 0x96ca2ab, 0x35aa7beb, 0x29054c7d, 0x119f0d3, 0xb8f7ce0, 
-	0x1dd8e619, 0x304bbc7d, 0x34979fe6, 0x22482ff6, 0x34e3e397, 0x2a2464bd, 0xa32dbc, 0x33c9d9a1, 
-	0x1ef166af, 0x16bd9fc8, 0x25813afb, 0x1ce40b39, 0x21259ccc, 0x1e904f72, 0x2da85e72, 0x23a86e4a, 
-	0x1048689, 0x78a7ee4, 0xe18bb37, 0x9baaa8f, 0x168377b7, 0xe3d66ef, 0x7e8d28a, 0x9d0cff8, 
-	0x3693c9b9, 0xa9cd662, 0x3b53e11f, 0x1782b377, 0x2e636b21, 0xf2a58c0, 0x23f168e1, 0x6833a8e, 
-	0x17b7a3db, 0x3449b389, 0x2f4e86a, 0xd6bd38, 0x1181ad7, 0x135a82ba, 0xaa72f24, 0x2669e4f5, 
-	0x28cb988d, 0x13618ed5, 0x6a14fb2, 0x31badf65, 0x10ce7d36, 0x1178f96a, 0x293a0df0, 0x15b87b31, 
-	0x42fe756, 0x2719486e, 0x87ecb78, 0x28105d46, 0x1f0c1efd, 0x2a05f2ce, 0x31ea7f6a, 0x116a55c2, 
-	0x32c9e1a6, 0x3b02c891, 0xda19994, 0x32df9265, 0x2a816efa, 0x27125fcb, 0x30e80ffb, 0x106eeea8, 
-	0x12211ef, 0x50e917a, 0x15b54703, 0x1239e886, 0xb6d290c, 0xd51d33, 0x1870fc7b, 0x106e0413, 
-	0x292228ce, 0x12a01ed8, 0xdaa3e2a, 0x3afe4453, 0x3929a1e6, 0x34433dce, 0x12869bbe, 0x2f1c3437, 
-	0x1ab5863f, 0x188cd8b2, 0x47615a1, 0xdd7cb40, 0x306c9f80, 0xd02205, 0x341fc68f, 0x2343cc80, 
-	0x1085f2bc, 0x5aa41b4, 0x2a137d4a, 0xa9f73b3, 0xc1171cd, 0x3066440f, 0x66c47a0, 0xc886349, 
-	0x2f415c5a, 0x2cdba677, 0x2c458818, 0x12ebb163, 0x6c6db45, 0x16e4f35, 0xcdb3e76, 0x1104a661, 
-	0x346a9577, 0x39d4f84, 0x23813229, 0x305263a0, 0x2ae96bef, 0x15605cb8, 0x5b7797c, 0x2b72e268, 
-	0x19978d67, 0x5897966, 0x12b68483, 0x2568ce98, 0x116d0dd5, 0x12b34a99, 0x6ac057e, 0x1bd01568, 
-	0x3897f153, 0x160ffffb, 0x1d93b95d, 0x13af15f4, 0x14921790, 0x239ca955, 0x10ef74b8, 0x9e8e54d, 
-	0x24142db9, 0xa8b6604, 0x2c332f70, 0xe4d8782, 0x1a45bf9a, 0x30f0a778, 0x1f89a2f7, 0xe19921d, 
-	0x3b991d89, 0x11f4c097, 0x14a9954d, 0x2f3baf35, 0x2bbad64a, 0x3ad728af, 0x558daf4, 0x11a90b55, 
-	0x34c76a54, 0x1b32cea2, 0x10134935, 0x350c137c, 0xb3360ee, 0x225f0591, 0xc7fd90d, 0x2ccae505, 
-	0x236db537, 0x28c3ca64, 0x25c8f2dc, 0x3593d5f1, 0x147aa065, 0x18e4e9eb, 0x17085df0, 0x807d7bc, 
-	0x2ad7af26, 0xe724f34, 0x12334edc, 0x12181a8c, 0x10ff7318, 0x38f3ff7d, 0x38f01787, 0x1f0a45d, 
-	0x3764f2d2, 0x7614220, 0x29fc77f6, 0x179b8420, 0xb1fdef3, 0x2ec06c29, 0x2450a99a, 0xe7fb2af, 
-	0x1b246dc6, 0x14a7b8ca, 0x3548ef40, 0x14353ecd, 0x265ed672, 0x292339c7, 0x3667726b, 0x15eda23f, 
-	0xbc374e3, 0x2682a8a3, 0x4a70b69, 0x31c0e918, 0x2f848cb, 0x36c943cf, 0x186e8533, 0x10af208f, 
-	0xb93554a, 0xb290bb9, 0x16746262, 0x2c9ba6c9, 0x2f1544c1, 0x2de68685, 0x346f5c01, 0x1533b2f5, 
-	0x28306fbe, 0x3b125b0a, 0x31b2f45c, 0x328c1896, 0x2b1cae15, 0x2c5b745f, 0x101b296c, 0x2a791c13, 
-	0x1d8b3cda, 0x131af0ca, 0x1e7fb883, 0x1c2cfad8, 0x312267aa, 0x330cdbff, 0x3141d53a, 0x262accb1, 
-	0x309a7cfc, 0x16166aad, 0x2c31648b, 0x349c4fc7, 0x1dfd1159, 0x395a0775, 0x2a849870, 0x55afa60, 
-	0xd703f3d, 0x21ec3270, 0x2b7ed3b1, 0x1084f597, 0xb1445ac, 0x267d820e, 0x16f63419, 0x560537b, 
-	0x216f6adb, 0x237abba0, 0x19f40480, 0x19d90892, 0x384b483f, 0x12c386e, 0x2fd473f5, 0x18f33008, 
-	0x285def01, 0x1ba3a920, 0x2eb001cb, 0x25c13c88, 0x235e0d91, 0x220306ce, 0x2590d9bb, 0x1eb03543, 
-	0x2828da91, 0x94f1945, 0x30ca6f0c, 0x39cf4375, 0x356e0926, 0x53b8600, 0x2f153570, 0x35c9e5a2, 
-	0x1892c8d4, 0x17fb4a15, 0x9b131be, 0xdb660fd, 0x20a68ab8, 0x31e2d2ca, 0x7d4718a, 0xd22834b, 
-	0x543c4e1, 0x274b6f59, 0x2bcbc296, 0x3536fc23, 0x3b51744f, 0x176401f5, 0x37513905, 0x1396eedc, 
-	0x45bd249, 0x31327b70, 0xfb4c5f3, 0x23ce6c74, 0x3a006fb0, 0x159744f2, 0x1695c09e, 0xa216309, 
-	0x1df781d4, 0x160acc02, 0x14f0ae34, 0x122a39fc, 0x1f7e18e, 0x31995b9f, 0x2fd76367, 0x38ab6454, 
-	0x2feda7ce, 0x255029a1, 0x39dd3351, 0x35ea0ebd, 0x70ce6c8, 0x3ad67ff3, 0x34ed7c44, 0x268454f9, 
-	0x37b1138c, 0x27f25a46, 0x2c2c75ad, 0x12554094, 0x8edff28, 0x10be9e99, 0x17bdf265, 0x2dd40399, 
-	0x187d7d38, 0x2caafb9c, 0x27b7d48c, 0x307dfa1d, 0x4e9d5d, 0x15370c96, 0x17bf2aba, 0xfee128d, 
-	0x2a4bd43d, 0x24f33c92, 0x40c3cc0, 0x27ec1b60, 0x359da6a8, 0x2022ce15, 0x1a32b950, 0x126047bf, 
-	0x4fed828, 0xfc50181, 0x3a21519, 0x8113d47, 0x2b3a00f6, 0x2fc08427, 0x1c22de4c, 0x299f5c1e, 
-	0x2bd59295, 0x1bda26a9, 0x1c3ed787, 0x27872791, 0x102f7b8, 0x1c140e84, 0x92fcb4b, 0x341ba75a, 
-	0x1e102894, 0x2f70a395, 0x3b88ecaa, 0x25c759f2, 0x1d5509f3, 0x17843d0, 0x13e86a61, 0x1f16cb71, 
-	0x1a14a353, 0x3ab4b1a0, 0x3b8f591, 0x1d42ffc4, 0x4690921, 0x258d0795, 0xe3b8c7f, 0x2810ebaa, 
-	0x22cc2e16, 0x23951de2, 0x142369b, 0x229c7af1, 0x2263a4d8, 0x372ddd3f, 0xa8f7950, 0x369c0023, 
-	0x12165feb, 0x2085379b, 0x5384e85, 0x199c95d8, 0x1e787186, 0x5935273, 0x2e25a419, 0x1cfaa800, 
-	0x19fb7b9a, 0x32b7c207, 0x194b3ac2, 0x328fdb38, 0x21940adf, 0x2ee6c89e, 0x29e45a6b, 0x14daaa99, 
-	0x308de7c1, 0x3215c4e0, 0x1a4014be, 0x3914f26d, 0x224ea6e6, 0x33fe80f8, 0x27c48174, 0x559bbc1, 
-	0x2796f584, 0x472a4b3, 0x36c65352, 0x2d60aec9, 0x3871c2b, 0xa1d5608, 0x12f9f6a7, 0x23a82e86, 
-	0x12ae3d15, 0x15f336e6, 0x286bbdc4, 0x32bf5b2b, 0x1529f012, 0x6cccc47, 0x22157599, 0x1b9ae1d2, 
-	0x1caa1067, 0x275c313c, 0x202c2491, 0x7e357be, 0x2a7f07d3, 0x2bf49662, 0x17410a87, 0x34847f68, 
-	0xc3912b5, 0x3680ef6, 0x1f92ce48, 0x1b74eca5, 0x1eb8cbe0, 0x2dd2e95a, 0x2d4b7610, 0x2c534366, 
-	0x7824078, 0x286011b6, 0x203f9af6, 0x1cbad17e, 0x6074712, 0xb9b39a0, 0x35bb1341, 0x1bcef0c6, 
-	0x30f3c707, 0x332c5726, 0xbd5b249, 0x200de10c, 0x24d47861, 0x24ab24df, 0x2fa2819b, 0x16c5aff8, 
-	0x10b9d02e, 0x10e32a26, 0x33ba69bb, 0x3657c3ad, 0x115e43d4, 0x332f1f12, 0xdb04858, 0x31cd995, 
-	0x31bfb050, 0x77129a5, 0x1c5846f6, 0x21e813f6, 0x159f1e5c, 0x2f045372, 0x19cd0f5, 0x1dddba4c, 
-	0x1b94be1c, 0x1d21c237, 0x196f78f2, 0x1fbad841, 0x1a9c758f, 0x33daa52f, 0xe42a18c, 0x247d39b7, 
-	0x165088f2, 0x21491613, 0xd23a094, 0x3424c286, 0x34ea4bd4, 0x2fc2fb48, 0x139936cd, 0x1808452e, 
-	0x5b8fa56, 0xbe48876, 0x16bee72c, 0x10356c5a, 0x213c6976, 0x1d6dc03d, 0x16958218, 0x271029ef, 
-	0x1f101e1e, 0x1b138af5, 0x673bd3a, 0x2f2c3f13, 0xed105c7, 0x206eb766, 0x310a40d9, 0x22800540, 
-	0x3c56d46, 0x206f9a9a, 0x192e696b, 0xbe3d67a, 0x34b4bc05, 0xcc763e6, 0x37fa84de, 0x1e17858a, 
-	0x19228a24, 0xec77f3c, 0x12b1a85f, 0x316e2a02, 0xf4a9d50, 0x82bd061, 0x1281081b, 0x2f578aa3, 
-	0xa6efc99, 0x25113f44, 0x2236f5d8, 0x2e10b4fc, 0x2cacddfa, 0x30fc8e65, 0x1c6eba05, 0x558eed6, 
-	0xe07eb44, 0x33fe68f6, 0x1ad04af2, 0x1bb851f9, 0xef74c98, 0x39d58b23, 0x10bdd789, 0xbf5bb24, 
-	0x1c276eb4, 0x151f3fec, 0x2ddea807, 0x23ab6057, 0x2ce15939, 0x2320066b, 0xd403d82, 0x31de99b6, 
-	0x340ce2c5, 0x3412d125, 0x39625b6c, 0x38f32cd3, 0x238c7e00, 0x12f08be7, 0x31936d32, 0x234bc59, 
-	0x126c9cf7, 0xb1cb3e, 0x1895fed3, 0x310d0681, 0x381dea3, 0x33ba4fef, 0x457d6b1, 0x6bb6a9c, 
-	0x354b17e2, 0x2b4cdeb8, 0x30edd426, 0x2582b275, 0x119405bd, 0x1f84be62, 0x145be522, 0x1ffc29f4, 
-	0x8fc5fce, 0x51968b7, 0x2cb38302, 0x27dc3ac6, 0x16f9c649, 0x2c08a041, 0x1b7e7e21, 0x111ccf09, 
-	0xb564bc2, 0x349de036, 0xe5bf14c, 0x78df6ca, 0x21f58fdf, 0x2f4f3bc9, 0xecaa19, 0x228eb092, 
-	0x2faf2325, 0x1c92acab, 0x5763a47, 0x1d7904b1, 0x38a99b1d, 0x1fb31674, 0x3a15a065, 0x1734c70d, 
-	0x1597bdf1, 0x197bd2c3, 0x59a3b8e, 0x146d3795, 0x26225a14, 0x6fcaaa3, 0x1bdd1477, 0x20771ce9, 
-	0x35b5c50b, 0x25d0bf62, 0x9381887, 0x6245577, 0xa2f2a1c, 0x2ff3ea11, 0x2a3f7995, 0x16648b6d, 
-	0x1e191870, 0x348f79eb, 0x2102a88a, 0x360d24ee, 0x33e82bbe, 0x485db81, 0x167d6b45, 0x21d8598e, 
-	0x2965739c, 0x247975b8, 0x1e5bfda, 0xb3a5062, 0x74d91b7, 0x1ef217f4, 0x24d70e36, 0x11872acc, 
-	0x3af89444, 0x3795aa7f, 0x32f98145, 0x6b54527, 0xf37c8db, 0x2cd53ebb, 0x19f941bf, 0x16b318c2, 
-	0x2492567a, 0x37649557, 0x3ae06e12, 0x1f6a49d4, 0x16783a4d, 0x30c08d66, 0x73dcf08, 0x249bd093, 
-	0x182a28ac, 0x771412d, 0x224753d6, 0xb0b7222, 0xe3d402d, 0x19115d36, 0x1f7903b3, 0x32a0cb8c, 
-	0xe7e4d1, 0x2cdc20f, 0x1c9c93ec, 0x25ef1028, 0x87d8c49, 0x23e2ffdd, 0x24a8ea9d, 0x38e83260, 
-	0x24ef612f, 0x16b913b8, 0x3048cf6f, 0x218e9fec, 0x166a696a, 0x2558d7e8, 0x27524460, 0x219b3590, 
-	0x16a00c60, 0x14fa003a, 0x119b87b0, 0x81018a1, 0xc80306e, 0x2b50755f, 0x2eabdab0, 0x172cf6ed, 
-	0x1c96c620, 0xd1ba3e, 0x288bc47, 0x2bd47df4, 0x900e04, 0xd25e39e, 0x2c7c2e79, 0x275097b, 
-	0x2da0f993, 0x3b4d778b, 0x2bccb455, 0x34768ec2, 0x34858722, 0x186ead6a, 0x37286b3e, 0x17ece416, 
-	0x2394b4ef, 0x88d4833, 0x40dff75, 0x34e2595f, 0x11e2bb09, 0x34dffab4, 0x34c15710, 0x12f99d4c, 
-	0x765f660, 0x126b80f2, 0x3d58412, 0x953aac2, 0x346e0bc8, 0x325f8054, 0x2d352e70, 0x2b2e7018, 
-	0x379c25cf, 0x32692beb, 0x2fce6c01, 0x1c3887e8, 0x22d54137, 0x169e172c, 0x3aebc208, 0x101c0f36, 
-	0x20a8ad47, 0x2997fda6, 0x53499b9, 0xa648e69, 0x2f36f3a4, 0x27430ac3, 0x229c1def, 0x332ed293, 
-	0x14f3eee7, 0x1cb6d0ee, 0x2ff8625e, 0x2c02f13f, 0x6c79ab7, 0x32ecff1e, 0x7c5e1b4, 0x1065df7f, 
-	0x6af259, 0x1cbe3c35, 0x125941d3, 0x24258ec7, 0x276b145e, 0x2e858b50, 0x1cfdda90, 0x3826f568, 
-	0x96d7682, 0x30e74fb7, 0x2f9fa9c1, 0x1d7862ec, 0x303f2e6, 0x9b83918, 0x38942242, 0x10e00a99, 
-	0x1add152d, 0x14f2eedf, 0x2bb0b8e7, 0x31c2c662, 0x1b3c1ada, 0x1c8458ba, 0x27222a01, 0x36947135, 
-	0x142fdc5f, 0x6b78ebb, 0xa3acb0c, 0x2a6ce073, 0xb17477e, 0x83dccd3, 0x293c7088, 0x615fd6d, 
-	0x16ce502e, 0x1f10e4bd, 0x3323943a, 0x19522cd3, 0x134984e6, 0x7ebd2d9, 0x4a6db9, 0x27fa5ef3, 
-	0x370540e6, 0x26dd6f2b, 0x25719271, 0xa0bd976, 0x60aeec9, 0x170336a6, 0x64e51b6, 0x324aa9dd, 
-	0x35a33e31, 0x1c756ad5, 0x360f7408, 0x1d3c22aa, 0x2962c76f, 0x22a1314f, 0x11293439, 0x2635d97, 
-	0xcefccff, 0x2d7c57c9, 0x3941c3b6, 0x283fba3b, 0x582573a, 0x3a787ba0, 0x221d9f7d, 0x34d7b293, 
-	0x2c38da0d, 0x2546b4ea, 0xcef0ea2, 0x357dd6c, 0x68a4bd2, 0x175edd62, 0x8ffaec9, 0x24da2785, 
-	0x338c012f, 0x30ed9c96, 0x69e4135, 0x289e3634, 0x40db60e, 0x25efbb6e, 0x240e9735, 0xd027b71, 
-	0x61a6881, 0x31725144, 0xfe6d7a, 0x22249242, 0x280795db, 0x3a2e5515, 0x20747340, 0x2971d1ae, 
-	0x2aa39cf4, 0x1a9b7e62, 0x3740b7b0, 0x1c38a3ed, 0x21f3b13f, 0x2776ad0c, 0x1ec0d9d7, 0x1476fe75, 
-	0x369387e9, 0x36b6c62b, 0x2c53fbf6, 0xe5e8b4a, 0x24906686, 0x3a655fd8, 0x2579d6e4, 0x1b7b5d05, 
-	0x371638f1, 0x1e49ee2c, 0x167d4297, 0x3202185c, 0x133477d, 0xf57a7ed, 0x254764f2, 0x16a60e2c, 
-	0x378922e7, 0x1b317086, 0xf0a6b8e, 0x91d61ef, 0x242be86, 0x110696e5, 0x76321ce, 0x2a4caa29, 
-	0x55be6b7, 0x3343258e, 0x21cfb465, 0xbd49882, 0x1c9f2a79, 0x1cf98b14, 0xaa9e91a, 0x7c7f109, 
-	0x3b45db85, 0x107e3cdf, 0x319315dd, 0x143e8ff9, 0xf048be9, 0x44e8c2a, 0x1775f92c, 0x2ad75b96, 
-	0x12ed6e5a, 0xccb4092, 0x18af61a8, 0x4da6dc0, 0x451c851, 0x2c64f1f5, 0x25a95f35, 0x25fe457f, 
-	0x287768e, 0x25a38563, 0x273bcaf2, 0x2be4c6bc, 0xba2ea4f, 0x1065d2e7, 0xe9bd0c7, 0x324cb70a, 
-	0x88b0acc, 0x2488ca3e, 0x28303a96, 0xc07f542, 0xaf9f27d, 0x2b2d348c, 0xfbe0f1e, 0x29f4e016, 
-	0x331b4382, 0x30efe5f5, 0x3998862b, 0x29a96d92, 0x8e6a0e4, 0x37cce0c6, 0x160786f, 0x34c94cb4, 
-	0x1542355, 0x33d308e6, 0x1fa12f6b, 0x32bf32c7, 0x7133a42, 0x507a15d, 0x2ec502a2, 0x2b1c023b, 
-	0x60518d, 0x297921c7, 0x2a7d983c, 0x37a54a4a, 0x31c079a4, 0xe22ae74, 0x2a8bc5ad, 0x2f086ace, 
-	0x181e7db7, 0x38ddc14e, 0x119a9793, 0x3728e2d7, 0xea5edef, 0x18eb9a9, 0x1323d9dc, 0x109e0731, 
-	0xa6935e4, 0x388055b2, 0x155de2ac, 0x25a6c6a8, 0x267fbbf1, 0x9fbb6c7, 0x21a2c592, 0x27f488a7, 
-	0x105c9f61, 0x275f22c0, 0xfd18983, 0x3e3a98d, 0x1c8431be, 0x192009d, 0x22b9c8d3, 0x12cab886, 
-	0x19d8727f, 0x1f8ddcc0, 0x7648588, 0x26a1f557, 0x33c882d5, 0x222568e2, 0xbe50daf, 0x2ce94b44, 
-	0x1d32a360, 0x123db7b0, 0x2f4469e3, 0x75198e7, 0x3b4b9173, 0x13f46c34, 0x17b7af3, 0x25cda1c9, 
-	0x29f84059, 0x8b63f3, 0x81dafa4, 0x15409bae, 0x1f5795b2, 0x14e0335d, 0xcf6ff8, 0xc0e7345, 
-	0x1f5bd79f, 0xaa8f055, 0x274ad0dc, 0x2201f15b, 0x28fe483e, 0x7a5e4ca, 0x13d7da8a, 0x1fd2f534, 
-	0xa051523, 0x821db68, 0x1476c413, 0x210b3140, 0x144958cc, 0x1a890fef, 0xd2dd859, 0x2dc3a847, 
-	0x3aff4d2, 0x4ee1e3a, 0x15e7deb5, 0x39a70de5, 0x5127895, 0x25c4f98e, 0x317d5e5, 0x2e26f77d, 
-	0x3ad4b005, 0x7eaa001, 0x1b5ed75d, 0x55f9ae2, 0x24f87512, 0x1a6659dc, 0x264687ba, 0x2eff1922, 
-	0x1db70ad2, 0x1feafe0, 0x39db3150, 0x2f23c79, 0x10022f31, 0x2a6566c, 0xd59d838, 0x167a29cf, 
-	0x1eac4da4, 0x2e1bbc96, 0x2f7c0b67, 0x53c7018, 0x2c60ab73, 0x18d56eab, 0x37b4119a, 0x3bb53ff, 
-	0x9fa04f2, 0x28622407, 0x2ae976ba, 0x19b46eeb, 0x123650f0, 0xe107e26, 0x39ae7cca, 0x2e6a11c, 
-	0x1eb74cfd, 0x371ae508, 0x329671c7, 0x22254b47, 0x1d0435af, 0x1a9827f1, 0x1471023, 0x357c65b3, 
-	0x11ae3510, 0xfd257f7, 0x603e1e, 0x1703059c, 0xc9a13ad, 0x3b0b9468, 0x23694db2, 0x13cc326b, 
-	0xd24896, 0x2af4e20b, 0x1e6792e6, 0x33d62932, 0xaed8302, 0xa9ee33d, 0xc1b561b, 0x2c0b7ca, 
-	0x3b52617d, 0x1e064142, 0x2ba75e66, 0x3675fc3c, 0x312d24b9, 0x2620811a, 0x1d8ca3f3, 0x8c2f1b4, 
-	0x2354c5fc, 0x1e487cae, 0x1b67b8a3, 0x22342331, 0x3466af09, 0x19ea67d, 0x2a44cf33, 0x2e87d2c8, 
-	0x21bd4050, 0x39f0cabf, 0x1e977099, 0x33b2b8c, 0xe609e0, 0x1a521495, 0x46d80c2, 0x3ac0c47c, 
-	0x21cb143c, 0xda8d0ce, 0x31075bc9, 0x15a9258e, 0x133ac218, 0x27a74ca3, 0x2a28235, 0x36df07d1, 
-	0x1542401e, 0x193757cc, 0x2758df54, 0x304f899e, 0x1659b22f, 0x2eaf8bd4, 0x2fbaf0d, 0x16a013dd, 
-	0x25df6d85, 0x6e7faa8, 0xdcd3e38, 0x39a34ce4, 0x3931584c, 0x87d4c31, 0x2375096, 0x146de97a, 
-	0x2ec8c667, 0x2da53ae3, 0x26c64042, 0xa3e182d, 0x4c76dc2, 0x2c751f85, 0x1742b5b1, 0x2df64ad7, 
-	0x38b67b66, 0x945efb0, 0x3b8d6162, 0x64b2bf6, 0xc1d4845, 0x29918bcf, 0x32610f41, 0x10def714, 
-	0xdb530ce, 0x25bce99f, 0xd6df151, 0x312eaa2, 0x6ba22d2, 0xef7afac, 0x2b8751f6, 0x341183bf, 
-	0x9bf15fa, 0x18bdc25f, 0x2ef4a5c, 0x31fb4f49, 0x1e79ae53, 0x22664b6c, 0xb1cecd6, 0x20212f82, 
-	0x1dbec6fa, 0x36ffafe1, 0x3442404a, 0x23b82320, 0x3b2bb96c, 0x153bc10, 0x3682c1a7, 0x2f8b085f, 
-	0xd1b26cf, 0x1490f06f, 0xb2d8e9, 0x634157e, 0x19519b90, 0x29dc5e7f, 0x2f0ca129, 0x24ea550d, 
-	0x1f93d647, 0x397dd673, 0x5467560, 0x30497c5a, 0x219b9e28, 0x1031b028, 0x22a40947, 0x133e1894, 
-	0x1a8c517e, 0x19910c9d, 0x2aa3bba6, 0xd3d8e60, 0x11de10dc, 0xe5e1cf6, 0x2a74981b, 0x35cc6d40, 
-	0x2db22c3d, 0x2bacc54f, 0x6ea4d0e, 0x6d97dbe, 0x345d4f8f, 0x4dae8b6, 0x486409d, 0x155b9b38, 
-	0x11951713, 0x2a7f18dd, 0x15b92024, 0x2ccea474, 0x6ac128b, 0xfb5c78, 0x7b2c6c2, 0x35b38bfa, 
-	0x1da8ef28, 0x1c10a7c6, 0x336af8bc, 0x1beb243b, 0x1225fca, 0x163171af, 0x2f5368d8, 0x3a5afb6f, 
-	0x335c9f8c, 0x26dab4c9, 0x11eda802, 0x1afe0fc, 0x26fec227, 0x242824c, 0x23611b58, 0x3340c1d0, 
-	0x1bb9cc4a, 0x1afcf2c1, 0x1de80263, 0x2c2a8a7b, 0x1c212546, 0xf4af477, 0x27bba1d4, 0x33514aa8, 
-	0x38b2a47, 0x3054c3de, 0x360ca451, 0x12bd6292, 0x37d08b3e, 0x4f6101a, 0x35921418, 0x1c12792c, 
-	0xa0cfcc1, 0x2889e49, 0x2bc2af3e, 0x1fa71dc7, 0x2e1ff33c, 0x2d21102e, 0x5fbf9bd, 0x3401376c, 
-	0x9a13ad6, 0x3165863c, 0x2648d11, 0x720d968, 0x2ad8732a, 0xefed10d, 0x9571d30, 0x3259db8, 
-	0xd0ed0a8, 0x1c97fa2c, 0x26d02662, 0x24c0a742, 0x4ba9d18, 0x1548afc9, 0x2ad2ef02, 0x27d9dd3f, 
-	0x2afaa979, 0x3ab30609, 0x2b33145f, 0x11588acf, 0x1d86d237, 0x352441f, 0x2af76d47, 0x2e242461, 
-	0xcd34c3d, 0x277b09b9, 0x34ac406c, 0x17409be2, 0x207113af, 0x3b307113, 0x189af315, 0x55cc2, 
-	0x2a830c74, 0x3889456f, 0x16e76f73, 0xdf70384, 0x295b54, 0xb2d95b6, 0x2bc71dbb, 0x1fb4f4f5, 
-	0x3628c505, 0x2cf69911, 0x2182ac5c, 0x1a750509, 0x24f1a798, 0x1b5c2127, 0x14e953b5, 0x669c938, 
-	0x213178c3, 0x30d22fbd, 0x21e779ba, 0x2bafff15, 0x1759759f, 0xecc509e, 0x16a3d190, 0x2edd3712, 
-	0x390973f, 0x27e1a020, 0x10897b55, 0x35b42d8c, 0xe948edd, 0x29700da4, 0x3b4147c4, 0x157bdff3, 
-	0x34c0fb84, 0x8ff95e6, 0x1f18a84b, 0x4c886be, 0x32be1322, 0x32790f6b, 0x1e1d219e, 0x294ea872, 
-	0xfc2e8af, 0x2d5f2856, 0x11d6fa0d, 0x1b98fbf, 0x27232094, 0x23b38912, 0x9539d20, 0x1abf68d4, 
-	0x2c3fd460, 0x29386f7a, 0xa40d220, 0x331b89b, 0x314af41, 0x2e88e624, 0xf3b8ed8, 0x37bbf35b, 
-	0x1a794631, 0x3008117f, 0x1517ea20, 0x21abfa18, 0x2075d30d, 0x1375da51, 0x36d4a0fc, 0x2793e2cf, 
-	0x13e8e8bb, 0x19cc81c, 0xa882bda, 0x39a58567, 0x10576d04, 0x1dac75d8, 0x6de3855, 0x11a911c9, 
-	0x15075e6d, 0x88ca9b2, 0x364fd21c, 0x3ab378f, 0xad3a09d, 0x1c9298f, 0x26585af9, 0x390dd7bb, 
-	0x2351c743, 0x321ccd4f, 0x603d905, 0x38a438f6, 0x2c871905, 0x3a3e2b9f, 0x289db7b1, 0xee90335, 
-	0x1ffdf531, 0x55d102b, 0x366efe76, 0xe2ca53d, 0x12e80b4b, 0x20434f0f, 0x11eb5c88, 0x38e5a382, 
-	0x208e4928, 0x88ef9c, 0xc522e5d, 0x29fa1b41, 0x2dc2be1b, 0x334ebfec, 0x17dfbd38, 0x137e84d4, 
-	0x11536b94, 0x37f7701b, 0x37c555b5, 0xbd5323f, 0x266c672b, 0x2a1db3e3, 0x33ac3557, 0x35ae5c32, 
-	0x1e4de619, 0x28a434b6, 0x3b8c983e, 0x67cf7c3, 0x30db0786, 0x23641f95, 0x3764a448, 0x1b2cb786, 
-	0x31ba5cbc, 0x1f22ecf0, 0x123bdbaf, 0x1489ca06, 0x10345b7e, 0x18754e24, 0x332d412c, 0x738a031, 
-	0x2e6b7f99, 0x17a7ba51, 0x2144bba8, 0x2850bbd7, 0x23c50d6a, 0x312846c2, 0x3109dfce, 0x1b0b077a, 
-	0x179886b2, 0x3a27a925, 0x1602341, 0xf7d7014, 0xe9e1f45, 0x33e2a51f, 0x25ab7ab1, 0x122422d3, 
-	0x8fc71e5, 0x1e94e626, 0x11f0553c, 0x10ddc100, 0x3b1e220f, 0x6273ce0, 0x6367d78, 0x1303148c, 
-	0x40260bf, 0x333d6494, 0x2d2ae898, 0x3b8d8f71, 0x8e92a17, 0x37605cc2, 0x26030976, 0x65b51f, 
-	0x27d29502, 0x240b296d, 0x2e6bf0d, 0x10f6e149, 0x29368c01, 0x2c5a96e2, 0x152ea38d, 0x35f6ecc1, 
-	0x3563e7ff, 0xfe58636, 0x2e8082d1, 0x20d75e14, 0x1e38c166, 0x281befd3, 0x1181e8, 0x1e05de3c, 
-	0x21a2c485, 0xe160aeb, 0x271f2012, 0x280353cf, 0xb3efd69, 0x3175bb47, 0x2b740a74, 0x1e1c25f2, 
-	0x3009baef, 0x9200f41, 0x120e8747, 0x1c2b0eb5, 0x1d853178, 0x2949e2b9, 0x27ab9206, 0x1ab29ae2, 
-	0x11edc3bc, 0x392d5206, 0x7a7f07e, 0x7b2dde3, 0x227e564d, 0xbda1c48, 0xb9a61c4, 0xa06858a, 
-	0x158d9a92, 0x26efbe1, 0x18245e89, 0x34d18ba0, 0x21b79333, 0x3a9d2d47, 0x1c32fae9, 0x984f483, 
-	0x3d226b5, 0x23711818, 0x2aa76ad3, 0x28e98b77, 0xbe6a052, 0x18d89a7, 0x19017c47, 0x30f30c06, 
-	0xaf6fb49, 0x12d6ee7c, 0x4ddd15e, 0x24cd9cef, 0x1629d1d5, 0x31b6fe3b, 0x1fc8048b, 0x3c8c8a6, 
-	0x299ebe46, 0x1706c025, 0x9c45cff, 0x358f9564, 0x19af4ae0, 0x15772953, 0x1532b745, 0x20a90ab2, 
-	0x19c4daec, 0xf3383c3, 0x27c90ac4, 0x261c08a9, 0x1e138b21, 0xee53a89, 0x2e0eda1a, 0x35e42499, 
-	0x1f391c45, 0xed2f60c, 0xf87d092, 0x2c958651, 0x2f3f40cd, 0x2ade2dea, 0x267653ac, 0x10f59499, 
-	0xe05961f, 0x34284481, 0x2a82714, 0xaa0a9e7, 0x3018d7d3, 0x39ef8c42, 0x10376fa3, 0x22c83e29, 
-	0x958a017, 0x171102c1, 0x2eb5594d, 0x3b85c82a, 0x2062fd41, 0x3a761b43, 0x1620697f, 0x89fdcf, 
-	0x2d08fafc, 0x10d3d3dc, 0x2e0de872, 0x35885203, 0x9646fb0, 0x39db3f60, 0x13ee7b9f, 0x1278071d, 
-	0xa77ca59, 0x1c33034a, 0x26eb91a0, 0x11c9f734, 0x1c39d5ee, 0x23e5968e, 0x39a82110, 0x2f3e7c31, 
-	0x32b93e66, 0x2f2d97b3, 0x263b9cd4, 0x2a98563a, 0x305b34f1, 0x3b4e16b9, 0x1ca44143, 0x5a3b86f, 
-	0x2f513b68, 0x5eb8566, 0x11711f2, 0x2a743719, 0x14360ce2, 0x289f88d4, 0x1ed7f6c4, 0x2f520436, 
-	0x309caa97, 0x341e6d0c, 0x38e1b5c9, 0x37d31f59, 0x27ede0ee, 0x377e3a61, 0x8e75104, 0xa92a4e5, 
-	0x37995cfd, 0x36937ebb, 0x14406cd4, 0x1fedc102, 0x11952dd5, 0x33daa332, 0x1b4fff12, 0x19f8bcc7, 
-	0x1bb2e2b8, 0x3aa17998, 0x1375c143, 0x1ce1e5bf, 0xc2e7269, 0x2a1825ea, 0xd904084, 0x88c251, 
-	0x16d0cb5a, 0x38cde733, 0x23f8fe35, 0x7cd9cbe, 0x10d87794, 0x25448f94, 0x39b161b9, 0xca0dddb, 
-	0xd01c73c, 0x2eb75901, 0x3b5a1916, 0x33fc037a, 0x256b3cb4, 0x84e14ef, 0x1da6aa28, 0x2e07c07d, 
-	0x50c06fc, 0x1b794956, 0x2b4a2159, 0x1287b565, 0x17a02e88, 0x1c2149ec, 0x1ba2b82c, 0x200fd777, 
-	0x182b7b9f, 0x28426640, 0x985fc31, 0x1e0b7851, 0x22da95af, 0x247a47a6, 0x73d9531, 0x2389f98, 
-	0x61d7e0e, 0x17663221, 0x1a3744df, 0x45572a3, 0x394884c1, 0x2998f586, 0x17088c01, 0x2e1549f9, 
-	0x35b73c63, 0x369d7ca0, 0x1932d45c, 0xb25f5a1, 0x3b117b05, 0x2adf1c2b, 0x30559b4f, 0x273ce2e2, 
-	0x101d53dd, 0x19af93c1, 0xf4f0349, 0x3a493fad, 0x13cc05ea, 0x103f6ff3, 0x683902, 0x23d7935c, 
-	0x12d99a66, 0xdf9e2e, 0x2a9f1e9f, 0x2dd5e781, 0x31909dee, 0x2f1a9577, 0x313e179c, 0x1abc400e, 
-	0x35ca55ac, 0x22cc2275, 0x2e0d22ec, 0x2d85161a, 0x2173b3ac, 0x37eb3b99, 0x22e32a06, 0x19b39939, 
-	0x2abe68c7, 0x13239879, 0x2cfd1578, 0x110788bd, 0x2fddc712, 0x2c5b8d73, 0x34585605, 0x1edb058d, 
-	0x9f7e60, 0x30be6995, 0x1bf3fad7, 0x1963dc2f, 0x32637375, 0x2d8673be, 0x151005dd, 0x146bdaaa, 
-	0x24319177, 0x2b0272eb, 0xcbd3b5, 0x27bc6102, 0x5816f0a, 0x190359a8, 0xe2f3414, 0x56db96b, 
-	0x17d96823, 0x2750ee4e, 0x3836cd23, 0x35de67dd, 0x26281183, 0x174d7a7c, 0xb09de9c, 0x13115b48, 
-	0x37b08511, 0x3322536e, 0xee45d99, 0xefe2d20, 0x2437af77, 0x15b1cf32, 0x1198744a, 0x5d75cf7, 
-	0x374c156e, 0x26ebc28e, 0x35ce7b79, 0x2fb71e7a, 0x1cfc047, 0x2f3b951a, 0x1c365f5e, 0x1c350241, 
-	0x10692b46, 0x39af9a5e, 0x31e37552, 0x101a6fb, 0x28271afe, 0x4eb7944, 0x17c9e985, 0xd563fae, 
-	0xd71e469, 0x11217e8a, 0x3a5eb56, 0x10d4a0bc, 0x346edd8f, 0x2c0f910b, 0x362a157b, 0x20a55c08, 
-	0xbd76ee4, 0x231a712a, 0x2390cc2e, 0xef363a7, 0x1ccb9393, 0x86499c3, 0x10fb982e, 0x3a349953, 
-	0x3091e705, 0x30c97fc9, 0x383e46b8, 0x1c439372, 0x27428749, 0x222af38a, 0x1297b3ae, 0x2501e829, 
-	0x2cb68978, 0x10903116, 0x2d0d32e8, 0x1f459cc9, 0x2416e608, 0xbd36962, 0x2c7930af, 0x1823a3c2, 
-	0x327b35f3, 0xf52b058, 0x171fae38, 0x95a0090, 0x123a9bf6, 0x3302a803, 0x375983a2, 0x39f37bef, 
-	0x440da96, 0x3745084, 0xd7f8470, 0x34a81822, 0x2ffd8618, 0x30f5fd4f, 0x31ab32e2, 0x10b6eceb, 
-	0x1206ed56, 0x3fae974, 0xe38608, 0x2a38930c, 0x762bcda, 0x904fe68, 0x1b74c802, 0x97b358a, 
-	0x2c4fba3f, 0x31a50f87, 0x339ca679, 0x1079a0d9, 0x9e3be84, 0x19dfef87, 0x251d4c64, 0x8d3aa27, 
-	0xf045720, 0x389da1e8, 0x24df6b18, 0x15d98836, 0x16421038, 0x13f8b30c, 0x14ba1e5a, 0xd5d8c32, 
-	0xbe229b4, 0x322e835, 0xa250f2f, 0x1d62a4be, 0x2d636624, 0x25c44f1f, 0x1eb5b703, 0x2df45dbb, 
-	0x16e955f5, 0x46f181, 0x35904e93, 0x48738a4, 0x17c79716, 0xabef986, 0xb55b4e8, 0x10081ba9, 
-	0x1effaf6c, 0x1a191eb1, 0x31b3d147, 0x3a769a0e, 0xe28107a, 0x42b2f18, 0x20b8d0ca, 0x219f8364, 
-	0x12fc4280, 0x2cac4598, 0x22ef0128, 0x10bcaa8e, 0x20e0ffd4, 0x1eb4ee28, 0x301856f8, 0x79345f, 
-	0xaaaa06b, 0x216e7d32, 0x324e3122, 0xd3d037c, 0x38a0f97a, 0x6fdb733, 0x138d61ae, 0x1724f883, 
-	0x36f5ddd2, 0x138d37ba, 0x182b5fe6, 0x37f7d9c2, 0x25600abf, 0x18e1b329, 0x27e7a5f0, 0x38cd49a1, 
-	0x1437f78b, 0x882256f, 0x2091b314, 0x39f03c96, 0x3affa737, 0x328c5995, 0x23cc29b1, 0x233a19c7, 
-	0x30f24f9f, 0x2f16968b, 0xe41deb7, 0x21609c41, 0x2700720, 0x78b4fc, 0x105f1229, 0x10d3d699, 
-	0x184f1472, 0x30efe672, 0x1455724b, 0x2a2bfcf3, 0x19babf50, 0x3919d058, 0x22f0d61d, 0x18d33ff2, 
-	0x4b19b77, 0x317541ec, 0x2733c97, 0xf97b4db, 0xe09b798, 0x272a0d92, 0x2f43be75, 0x2e6fb0f7, 
-	0x35372ecd, 0x32b23ebf, 0x2ad57794, 0xc8183be, 0x1a9c761a, 0x2dd0c221, 0x2558e565, 0x2b64f992, 
-	0x23fd1123, 0x825ec68, 0x20af528c, 0x1dddc347, 0x16f1d7b1, 0x2ed3dafb, 0x130b9be1, 0x4f3ed45, 
-	0x2691c1eb, 0x19c2ac09, 0x2198a1f9, 0x39a522c8, 0x29df8c9c, 0x36edfc26, 0x247e30e8, 0x2597fa2f, 
-	0xe3752c8, 0x705120, 0x34068e3e, 0x22ab91dc, 0x136bc9b8, 0xd148763, 0x50830fc, 0x1e65bace, 
-	0x3b44d99, 0x25932af1, 0x6e09ad2, 0x311a987b, 0x1e3f9ee7, 0x1c6c3fd1, 0x1a0d0475, 0x2d8eec8d, 
-	0x31b05aa2, 0x3053c9cd, 0x9e38e2f, 0x234752c1, 0xe2b8436, 0xbddf3f, 0x3281ead4, 0x1709a14b, 
-	0x5e25ba7, 0xc31b5b5, 0xd9ed4c3, 0xad89ed8, 0x2d4c7688, 0x2959666c, 0x103d324e, 0x17fbda5d, 
-	0x160ca428, 0x3e53c8, 0x6aed376, 0xf67da20, 0x21a3750f, 0x16cd14e0, 0x251f8f45, 0x20d4a275, 
-	0x6c8cbfa, 0x34f3d1f2, 0x16ff51ac, 0xf658c12, 0x177fafe8, 0xa54f83a, 0x36c3fa8e, 0x303e0f30, 
-	0x1411c12a, 0x31d84e1d, 0x1e8c4bc5, 0x32e78b67, 0x330a73e6, 0x16281b9e, 0x2688deb2, 0x39b062f1, 
-	0x33214e44, 0x28525c3e, 0x545670f, 0x217f807f, 0x36331f5e, 0x16c6668b, 0x14d3de6c, 0x26c799ab, 
-	0x1c33d7e2, 0x18250568, 0xdeb0e65, 0x2601cda0, 0x390bb481, 0x17c47e11, 0x3a7f9867, 0x145a8b22, 
-	0x2be5aff2, 0x1c43babb, 0x1590e061, 0x2edac0b8, 0x32dd5728, 0x1c14e64, 0x2e7d54da, 0x1d9c9887, 
-	0x252fcc0a, 0x2c40098a, 0x2b28e9dc, 0x2a01ecb5, 0x1d698649, 0x2d2231f6, 0xaf50347, 0x1725f2f9, 
-	0x2c8a6ee0, 0x20f8dbe4, 0x14cab0f1, 0x3b3924e8, 0x2baaf8a2, 0x1791d2bd, 0xe690179, 0x328f4c23, 
-	0x245cc699, 0xd0adabe, 0x19dcfb37, 0x115aa3aa, 0x3a804e12, 0x33b04bfd, 0x11f9bff8, 0x1d6dd0cb, 
-	0x12052216, 0x27aae0cb, 0x19c55f65, 0x39536c44, 0x11841ed8, 0x10594a09, 0x387a954, 0x8506e7e, 
-	0x1f4d391c, 0x2cf7e215, 0x4592b05, 0x3a921e28, 0x2b03f022, 0x8f4bf42, 0x28609e8b, 0xc0c985a, 
-	0x1a8e4af2, 0x22556f5c, 0x3d61caf, 0x34350819, 0x15e4525, 0x17ce2c73, 0xb6f2642, 0x353a6dc5, 
-	0x2d601327, 0x23b6c91a, 0x2d6aba6c, 0x2e2235de, 0x1430132e, 0x2222acb5, 0x1bbf6f03, 0x3f1598, 
-	0x3a0242c1, 0x32445321, 0x1d58c7b3, 0xbad461c, 0x1761d73a, 0xb536186, 0x319412f7, 0xb5176f8, 
-	0x550cfad, 0x9c715ef, 0x30dcc208, 0x237611f8, 0x39ee0251, 0x2d4bb3fc, 0x7329436, 0x7052587, 
-	0x2c92fd17, 0x2968b944, 0x1c5e52dd, 0x31f5dd0a, 0x31e989b2, 0x174ee43, 0x35418bdf, 0x26641950, 
-	0xdd78008, 0x2d53e871, 0x10d7edc7, 0x35aa66e6, 0x2b291805, 0x1d4a828a, 0x3014459d, 0x327acb3d, 
-	0x35156e3d, 0x178b55a2, 0x3a835019, 0x12acef4d, 0x1d285617, 0x2e3e3f4c, 0x343969de, 0x130b9af1, 
-	0x1fa7c821, 0x16481eca, 0x1ce4ec68, 0x3ae8bc31, 0x277a4b1d, 0x32e2fda2, 0xd48c749, 0x287fea42, 
-	0x32f7240f, 0xb39dfa4, 0x2946dbcf, 0xae51984, 0x39ebf80c, 0x2bcc9b4, 0x31168d21, 0x312033e8, 
-	0x70f9f80, 0x1cc5ed90, 0x15ad76d9, 0x3b74d43, 0x19435fc1, 0x379229e1, 0x30935b9c, 0x287d1ab3, 
-	0x32e6622e, 0x76f410c, 0xb851270, 0x386a451e, 0x108a6e58, 0xc9b7eaa, 0xcf791ca, 0x2efb296e, 
-	0xe38175a, 0xedf8fd4, 0x26c25b63, 0x42ec8c7, 0x1aad4aa9, 0x128dc267, 0x2e4e036d, 0x572785c, 
-	0x1398981c, 0x13e93290, 0x21b3f02d, 0x378fa219, 0x1b4a1042, 0x2beaea56, 0x1bfdeeef, 0x3a03fb86, 
-	0x272c8aa1, 0xe53e0e, 0x23676bb2, 0x5dd4ca1, 0x36b8578e, 0xca71f86, 0x7fc14c2, 0x292d71ce, 
-	0x3529d083, 0xcf13c18, 0x1aa580a0, 0x4ab6b62, 0x1e554270, 0x25f01e63, 0x1f76e00f, 0x2874babd, 
-	0x34f266d4, 0x253ab036, 0x1ff910a5, 0x64bd5ef, 0x12dcba82, 0x8e59080, 0x20ebd580, 0x24358a54, 
-	0x7f9bd86, 0x214fde22, 0x10fa29d9, 0x262179a1, 0x1bcdf936, 0xb678cd1, 0x23c7fb50, 0x2226d800, 
-	0x150de463, 0xb29fe8e, 0x10d7019e, 0x2e85e491, 0x20ed12f6, 0x1f777b5c, 0x141c2231, 0x1e469779, 
-	0x371ec719, 0x19671575, 0x1ae68613, 0x36a7a469, 0xacc3434, 0x26f95cf5, 0x32f0f4d3, 0x26fa8e59, 
-	0x279bc41, 0x26da8d8d, 0x38ca4096, 0x2f14d900, 0x8cdf44f, 0x182231dd, 0xe93c1ff, 0x2b6a5ce6, 
-	0x2802c942, 0xb992a70, 0x4cfd791, 0x3e00b46, 0x1e77397e, 0x36ec75df, 0x1182d6ab, 0x2e0c3510, 
-	0xad05c12, 0x1ac6fa4f, 0x28a4bd07, 0x254bcb98, 0x140f3461, 0x35341a15, 0x1783d0f2, 0x18f191f7, 
-	0xde2b704, 0x39f79fac, 0x13ca7f35, 0x466770c, 0x1dff2da1, 0x32b686a6, 0x245cbb1d, 0xb15ca8c, 
-	0x35b5965a, 0x19a33281, 0x27295c59, 0xeac51ee, 0x106ce5a5, 0x27f441bf, 0xc7d1bcd, 0x2ddfdfd2, 
-	0x298d7839, 0xd367840, 0x519ade9, 0x1b4e5e6a, 0x1b0e3724, 0x1e2de084, 0x32cd181d, 0xd870809, 
-	0x17f197db, 0x34db05a8, 0x1e65619, 0x252e2c25, 0x2c5cacc4, 0x1046614, 0x1dd6c764
+	uint32 Key0;
+	uint32 Key1;
+	uint32 Counter;
 };
 
-#endif
\ No newline at end of file
+inline uint32 RandomMix32(uint32 X)
+{
+	X ^= X >> 16;
+	X *= 0x7feb352d;
+	X ^= X >> 15;
+	X *= 0x846ca68b;
+	X ^= X >> 16;
+
+	return X;
+}
+
+inline uint32 RandomHash(random_series *Series, uint32 Counter)
+{
+	uint32 Result = RandomMix32(Counter ^ Series->Key0);
+	Result = RandomMix32(Result + Series->Key1);
+
+	return Result;
+}
+
+inline random_series RandomSeed(uint32 Value)
+{
+	random_series Series;
+	Series.Key0 = RandomMix32(Value ^ 0xa3b195a7);
+	Series.Key1 = RandomMix32(Value + 0x9e3779b9);
+	Series.Counter = 0;
+
+	return Series;
+}
+
+// NOTE: Makes the next draw the one at position Counter in the stream
+inline void RandomSeek(random_series *Series, uint32 Counter)
+{
+	Series->Counter = Counter;
+}
+
+inline uint32 RandomNextUInt32(random_series *Series)
+{
+	uint32 Result = RandomHash(Series, Series->Counter++);
+	return Result;
+}
+
+inline uint32 RandomChoice(random_series *Series, uint32 ChoiceCount)
+{
+	uint32 Result = RandomNextUInt32(Series) % ChoiceCount;
+	return Result;
+}
+
+// NOTE: [0, 1)
+inline real32 RandomUnilateral(random_series *Series)
+{
+	real32 Result = (real32)(RandomNextUInt32(Series) >> 8) * (1.0f / 16777216.0f);
+	return Result;
+}
+
+// NOTE: [-1, 1)
+inline real32 RandomBilateral(random_series *Series)
+{
+	real32 Result = 2.0f*RandomUnilateral(Series) - 1.0f;
+	return Result;
+}
+
+inline real32 RandomBetween(random_series *Series, real32 Min, real32 Max)
+{
+	real32 Result = Min + (Max - Min)*RandomUnilateral(Series);
+	return Result;
+}
+
+// NOTE: [Min, Max], inclusive on both ends. The span is worked out in uint32, where it only
+// overflows for the whole int32 range, which wraps to 0 and takes every draw as it comes.
+inline int32 RandomBetween(random_series *Series, int32 Min, int32 Max)
+{
+	uint32 Span = (uint32)Max - (uint32)Min + 1;
+	uint32 Draw = RandomNextUInt32(Series);
+	if(Span)
+	{
+		Draw %= Span;
+	}
+	int32 Result = (int32)((uint32)Min + Draw);
+	return Result;
+}
+
+//
+// NOTE: Batch versions, four lanes per iteration. These produce exactly the same numbers
+// as the same count of single draws and leave the series at the same position.
+//
+
+inline __m128i RandomMulLo4x(__m128i A, uint32 B)
+{
+	// NOTE: SSE2 has no 32 bit low multiply, so do the even and odd lanes as 64 bit products
+	__m128i WideB = _mm_set1_epi32(B);
+	__m128i Even = _mm_mul_epu32(A, WideB);
+	__m128i Odd = _mm_mul_epu32(_mm_srli_epi64(A, 32), WideB);
+	__m128i Result = _mm_or_si128(_mm_and_si128(Even, _mm_set_epi32(0, -1, 0, -1)), _mm_slli_epi64(Odd, 32));
+	return Result;
+}
+
+inline __m128i RandomMix4x(__m128i X)
+{
+	X = _mm_xor_si128(X, _mm_srli_epi32(X, 16));
+	X = RandomMulLo4x(X, 0x7feb352d);
+	X = _mm_xor_si128(X, _mm_srli_epi32(X, 15));
+	X = RandomMulLo4x(X, 0x846ca68b);
+	X = _mm_xor_si128(X, _mm_srli_epi32(X, 16));
+
+	return X;
+}
+
+inline __m128i RandomNext4x(random_series *Series)
+{
+	__m128i Counter = _mm_add_epi32(_mm_set1_epi32(Series->Counter), _mm_setr_epi32(0, 1, 2, 3));
+	__m128i Result = RandomMix4x(_mm_xor_si128(Counter, _mm_set1_epi32(Series->Key0)));
+	Result = RandomMix4x(_mm_add_epi32(Result, _mm_set1_epi32(Series->Key1)));
+	Series->Counter += 4;
+
+	return Result;
+}
+
+// NOTE: The fills work on a local copy of the series, otherwise every store through Dest
+// could alias the counter and force it back out to memory
+internal void RandomFillUInt32(random_series *Series, uint32 Count, uint32 *Dest)
+{
+	random_series Local = *Series;
+	uint32 Index = 0;
+	for(; (Index + 8) <= Count; Index += 8)
+	{
+		// NOTE: Two independent batches per iteration keep both multiply chains busy
+		__m128i A = RandomNext4x(&Local);
+		__m128i B = RandomNext4x(&Local);
+		_mm_storeu_si128((__m128i *)(Dest + Index), A);
+		_mm_storeu_si128((__m128i *)(Dest + Index + 4), B);
+	}
+	for(; (Index + 4) <= Count; Index += 4)
+	{
+		_mm_storeu_si128((__m128i *)(Dest + Index), RandomNext4x(&Local));
+	}
+	for(; Index < Count; Index++)
+	{
+		Dest[Index] = RandomNextUInt32(&Local);
+	}
+	*Series = Local;
+}
+
+internal void RandomFillUnilateral(random_series *Series, uint32 Count, real32 *Dest)
+{
+	random_series Local = *Series;
+	__m128 Scale = _mm_set1_ps(1.0f / 16777216.0f);
+	uint32 Index = 0;
+	for(; (Index + 4) <= Count; Index += 4)
+	{
+		__m128i Bits = _mm_srli_epi32(RandomNext4x(&Local), 8);
+		_mm_storeu_ps(Dest + Index, _mm_mul_ps(_mm_cvtepi32_ps(Bits), Scale));
+	}
+	for(; Index < Count; Index++)
+	{
+		Dest[Index] = RandomUnilateral(&Local);
+	}
+	*Series = Local;
+}
+
+internal void RandomFillBilateral(random_series *Series, uint32 Count, real32 *Dest)
+{
+	random_series Local = *Series;
+	__m128 Scale = _mm_set1_ps(2.0f / 16777216.0f);
+	__m128 One = _mm_set1_ps(1.0f);
+	uint32 Index = 0;
+	for(; (Index + 4) <= Count; Index += 4)
+	{
+		__m128i Bits = _mm_srli_epi32(RandomNext4x(&Local), 8);
+		_mm_storeu_ps(Dest + Index, _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(Bits), Scale), One));
+	}
+	for(; Index < Count; Index++)
+	{
+		Dest[Index] = RandomBilateral(&Local);
+	}
+	*Series = Local;
+}
+
+#endif
@@ -0,0 +1,453 @@
+#ifndef HANDMADE_RECORDING_H
+#define HANDMADE_RECORDING_H
+
+#include "handmade.h"
+
+/*
+	NOTE: Input recording format (.hmi)
+
+	recording_header
+	for each keyframe:
+		compressed snapshot of game memory (the state before the keyframe's first frame)
+		input frames up to the next keyframe, each delta coded against the frame before it
+	recording_keyframe index, one entry per keyframe
+
+	Keyframes sit every KeyframeInterval frames, so seeking to a frame is one keyframe load plus
+	fewer than KeyframeInterval replayed frames. Delta coding restarts from a zeroed game_input at
+	every keyframe so decoding can begin at any of them.
+
+	Everything here only touches memory; reading and writing the file is up to the platform.
+*/
+
+#define RECORDING_MAGIC_VALUE (((uint32)'H' << 0) | ((uint32)'M' << 8) | ((uint32)'I' << 16) | ((uint32)'R' << 24))
+#define RECORDING_VERSION 3
+
+#define RECORDING_KEYFRAME_INTERVAL 300
+#define RECORDING_SNAPSHOT_BLOCK_SIZE Megabytes(1)
+
+#define RECORDING_INPUT_WORD_COUNT (sizeof(game_input) / sizeof(uint32))
+// NOTE: One run count plus a skip, length and value per word, at most 5 bytes per varint
+#define RECORDING_MAX_FRAME_SIZE (5 + 3*5*RECORDING_INPUT_WORD_COUNT)
+#define RECORDING_MAX_SNAPSHOT_BLOCK_SIZE(Size) ((Size) + (Size)/4 + 32)
+
+struct recording_header
+{
+	uint32 MagicValue;
+	uint32 Version;
+
+	uint32 InputSize;
+	uint32 KeyframeInterval;
+	uint32 FrameCount;
+	uint32 KeyframeCount;
+
+	// NOTE: Game memory holds absolute pointers, so snapshots only restore at the address they came from
+	uint64 MemoryBase;
+	uint64 MemorySize;
+	// NOTE: Where game memory splits into permanent and transient storage, the game state structs
+	// sit at the start of each so playback has to split it the same way
+	uint64 PermanentStorageSize;
+	uint64 IndexOffset;
+};
+
+struct recording_keyframe
+{
+	uint32 FrameIndex;
+	uint32 Reserved;
+
+	uint64 SnapshotOffset;
+	uint64 SnapshotSize;
+	uint64 FrameOffset;
+};
+
+struct recording_writer
+{
+	recording_header Header;
+
+	uint32 KeyframeCapacity;
+	recording_keyframe *Keyframes;
+
+	game_input PreviousInput;
+	uint64 WriteOffset;
+
+	uint64 InputBytes;
+	uint64 SnapshotBytes;
+	real32 RecordedSeconds;
+};
+
+struct recording_reader
+{
+	recording_header *Header;
+	recording_keyframe *Keyframes;
+	uint8 *Base;
+
+	uint8 *At;
+	uint32 FrameIndex;
+	uint32 NextKeyframeIndex;
+	game_input PreviousInput;
+};
+
+//
+// NOTE: Varints
+//
+
+inline uint8 *WriteVarint(uint8 *Dest, uint64 Value)
+{
+	while(Value >= 0x80)
+	{
+		*Dest++ = (uint8)(Value | 0x80);
+		Value >>= 7;
+	}
+	*Dest++ = (uint8)Value;
+
+	return Dest;
+}
+
+inline uint64 ReadVarint(uint8 **Source)
+{
+	uint64 Result = 0;
+	uint32 Shift = 0;
+	uint8 *At = *Source;
+	for(;;)
+	{
+		uint8 Byte = *At++;
+		Result |= (uint64)(Byte & 0x7F) << Shift;
+		if(!(Byte & 0x80))
+		{
+			break;
+		}
+		Shift += 7;
+	}
+	*Source = At;
+
+	return Result;
+}
+
+//
+// NOTE: Input frames
+//
+
+/*
+	NOTE: game_input is all 32 bit fields, so a frame is coded as runs of words that changed
+	since the previous frame: a run count, then for each run the words skipped, the run length
+	and the XOR of each word with its old value. An idle frame is a single zero byte.
+*/
+internal uint32 EncodeInputFrame(game_input *Previous, game_input *Input, uint8 *Dest)
+{
+	uint32 *Old = (uint32 *)Previous;
+	uint32 *New = (uint32 *)Input;
+
+	uint32 RunCount = 0;
+	for(uint32 WordIndex = 0; WordIndex < RECORDING_INPUT_WORD_COUNT; )
+	{
+		if(Old[WordIndex] != New[WordIndex])
+		{
+			RunCount++;
+			while((WordIndex < RECORDING_INPUT_WORD_COUNT) && (Old[WordIndex] != New[WordIndex]))
+			{
+				WordIndex++;
+			}
+		}
+		else
+		{
+			WordIndex++;
+		}
+	}
+
+	uint8 *At = WriteVarint(Dest, RunCount);
+	uint32 LastWordIndex = 0;
+	for(uint32 WordIndex = 0; WordIndex < RECORDING_INPUT_WORD_COUNT; )
+	{
+		if(Old[WordIndex] != New[WordIndex])
+		{
+			uint32 RunStart = WordIndex;
+			while((WordIndex < RECORDING_INPUT_WORD_COUNT) && (Old[WordIndex] != New[WordIndex]))
+			{
+				WordIndex++;
+			}
+
+			At = WriteVarint(At, RunStart - LastWordIndex);
+			At = WriteVarint(At, WordIndex - RunStart);
+			for(uint32 RunIndex = RunStart; RunIndex < WordIndex; RunIndex++)
+			{
+				At = WriteVarint(At, Old[RunIndex] ^ New[RunIndex]);
+			}
+			LastWordIndex = WordIndex;
+		}
+		else
+		{
+			WordIndex++;
+		}
+	}
+
+	uint32 Result = (uint32)(At - Dest);
+	Assert(Result <= RECORDING_MAX_FRAME_SIZE);
+	return Result;
+}
+
+internal void DecodeInputFrame(game_input *Previous, uint8 **Source, game_input *Input)
+{
+	*Input = *Previous;
+	uint32 *Words = (uint32 *)Input;
+
+	uint32 RunCount = (uint32)ReadVarint(Source);
+	uint32 WordIndex = 0;
+	for(uint32 Run = 0; Run < RunCount; Run++)
+	{
+		WordIndex += (uint32)ReadVarint(Source);
+		uint32 RunLength = (uint32)ReadVarint(Source);
+		Assert(WordIndex + RunLength <= RECORDING_INPUT_WORD_COUNT);
+		for(uint32 RunIndex = 0; RunIndex < RunLength; RunIndex++)
+		{
+			Words[WordIndex++] ^= (uint32)ReadVarint(Source);
+		}
+	}
+}
+
+//
+// NOTE: Snapshots
+//
+
+/*
+	NOTE: Game memory is mostly untouched arena space, so snapshots are coded per block as
+	alternating runs of zero and literal 64 bit words. Blocks are independent so the platform can
+	stream them through a fixed scratch buffer of RECORDING_MAX_SNAPSHOT_BLOCK_SIZE bytes.
+*/
+internal uint64 CompressSnapshotBlock(uint8 *Source, uint64 Size, uint8 *Dest)
+{
+	Assert((Size % sizeof(uint64)) == 0);
+	uint64 *Words = (uint64 *)Source;
+	uint64 WordCount = Size / sizeof(uint64);
+
+	uint8 *At = Dest;
+	for(uint64 WordIndex = 0; WordIndex < WordCount; )
+	{
+		uint64 ZeroStart = WordIndex;
+		while((WordIndex < WordCount) && (Words[WordIndex] == 0))
+		{
+			WordIndex++;
+		}
+
+		uint64 LiteralStart = WordIndex;
+		while((WordIndex < WordCount) && (Words[WordIndex] != 0))
+		{
+			WordIndex++;
+		}
+
+		At = WriteVarint(At, LiteralStart - ZeroStart);
+		At = WriteVarint(At, WordIndex - LiteralStart);
+		for(uint64 LiteralIndex = LiteralStart; LiteralIndex < WordIndex; LiteralIndex++)
+		{
+			*(uint64 *)At = Words[LiteralIndex];
+			At += sizeof(uint64);
+		}
+	}
+
+	uint64 Result = (uint64)(At - Dest);
+	Assert(Result <= RECORDING_MAX_SNAPSHOT_BLOCK_SIZE(Size));
+	return Result;
+}
+
+internal void DecompressSnapshotBlock(uint8 **Source, uint64 Size, uint8 *Dest)
+{
+	uint64 *Words = (uint64 *)Dest;
+	uint64 WordCount = Size / sizeof(uint64);
+
+	uint8 *At = *Source;
+	for(uint64 WordIndex = 0; WordIndex < WordCount; )
+	{
+		uint64 ZeroCount = ReadVarint(&At);
+		uint64 LiteralCount = ReadVarint(&At);
+		Assert(WordIndex + ZeroCount + LiteralCount <= WordCount);
+
+		// NOTE: Only words that aren't zero already are stored to, so restoring over pages nothing
+		// has touched reads the shared zero page instead of backing a gigabyte of zeroes
+		for(uint64 ZeroIndex = 0; ZeroIndex < ZeroCount; ZeroIndex++)
+		{
+			if(Words[WordIndex])
+			{
+				Words[WordIndex] = 0;
+			}
+			WordIndex++;
+		}
+		for(uint64 LiteralIndex = 0; LiteralIndex < LiteralCount; LiteralIndex++)
+		{
+			Words[WordIndex++] = *(uint64 *)At;
+			At += sizeof(uint64);
+		}
+	}
+	*Source = At;
+}
+
+//
+// NOTE: Writing
+//
+
+internal void BeginRecordingWriter(recording_writer *Writer, void *MemoryBase, uint64 MemorySize, uint64 PermanentStorageSize,
+								   uint32 KeyframeCapacity, recording_keyframe *Keyframes)
+{
+	*Writer = {};
+	Writer->Header.MagicValue = RECORDING_MAGIC_VALUE;
+	Writer->Header.Version = RECORDING_VERSION;
+	Writer->Header.InputSize = sizeof(game_input);
+	Writer->Header.KeyframeInterval = RECORDING_KEYFRAME_INTERVAL;
+	Writer->Header.MemoryBase = (uint64)MemoryBase;
+	Writer->Header.MemorySize = MemorySize;
+	Writer->Header.PermanentStorageSize = PermanentStorageSize;
+	Writer->KeyframeCapacity = KeyframeCapacity;
+	Writer->Keyframes = Keyframes;
+
+	// NOTE: The platform writes a placeholder header first and rewrites it when recording ends
+	Writer->WriteOffset = sizeof(recording_header);
+}
+
+inline bool32 RecordingNeedsKeyframe(recording_writer *Writer)
+{
+	bool32 Result = (((Writer->Header.FrameCount % Writer->Header.KeyframeInterval) == 0) &&
+					 (Writer->Header.KeyframeCount < Writer->KeyframeCapacity));
+	return Result;
+}
+
+/*
+	NOTE: A keyframe's frames can be recorded before its snapshot has been compressed, as long as
+	the platform puts them in the file after the snapshot, and calls EndRecordingKeyframe once the
+	snapshot's bytes have all been added. Delta coding restarts here for that reason rather than at
+	the end. WriteOffset is only ever a sum, so it comes out the same whichever order the snapshot
+	and the frames are counted in.
+*/
+inline void BeginRecordingKeyframe(recording_writer *Writer)
+{
+	Assert(Writer->Header.KeyframeCount < Writer->KeyframeCapacity);
+	recording_keyframe *Keyframe = Writer->Keyframes + Writer->Header.KeyframeCount;
+	Keyframe->FrameIndex = Writer->Header.FrameCount;
+	Keyframe->Reserved = 0;
+	Keyframe->SnapshotOffset = Writer->WriteOffset;
+	Keyframe->SnapshotSize = 0;
+	Keyframe->FrameOffset = 0;
+	Writer->PreviousInput = {};
+}
+
+inline void AddRecordingSnapshotBytes(recording_writer *Writer, uint64 Size)
+{
+	Writer->Keyframes[Writer->Header.KeyframeCount].SnapshotSize += Size;
+	Writer->WriteOffset += Size;
+	Writer->SnapshotBytes += Size;
+}
+
+inline void EndRecordingKeyframe(recording_writer *Writer)
+{
+	recording_keyframe *Keyframe = Writer->Keyframes + Writer->Header.KeyframeCount++;
+	Keyframe->FrameOffset = Keyframe->SnapshotOffset + Keyframe->SnapshotSize;
+}
+
+internal uint32 RecordInputFrame(recording_writer *Writer, game_input *Input, uint8 *Dest)
+{
+	uint32 Result = EncodeInputFrame(&Writer->PreviousInput, Input, Dest);
+	Writer->PreviousInput = *Input;
+	Writer->Header.FrameCount++;
+	Writer->RecordedSeconds += Input->dtForFrame;
+	Writer->WriteOffset += Result;
+	Writer->InputBytes += Result;
+
+	return Result;
+}
+
+// NOTE: The index goes at WriteOffset, after which the header is rewritten at the start of the file
+inline void EndRecordingWriter(recording_writer *Writer)
+{
+	Writer->Header.IndexOffset = Writer->WriteOffset;
+}
+
+//
+// NOTE: Reading
+//
+
+internal bool32 BeginRecordingReader(recording_reader *Reader, void *File, uint64 FileSize)
+{
+	bool32 Result = false;
+	*Reader = {};
+
+	recording_header *Header = (recording_header *)File;
+	if((FileSize >= sizeof(recording_header)) &&
+	   (Header->MagicValue == RECORDING_MAGIC_VALUE) &&
+	   (Header->Version == RECORDING_VERSION) &&
+	   (Header->InputSize == sizeof(game_input)) &&
+	   (Header->PermanentStorageSize <= Header->MemorySize) &&
+	   (Header->KeyframeCount > 0) &&
+	   (Header->IndexOffset + Header->KeyframeCount*sizeof(recording_keyframe) <= FileSize))
+	{
+		Reader->Header = Header;
+		Reader->Base = (uint8 *)File;
+		Reader->Keyframes = (recording_keyframe *)(Reader->Base + Header->IndexOffset);
+		Result = true;
+	}
+
+	return Result;
+}
+
+// NOTE: Moves the frame cursor to a keyframe without touching game memory
+internal void SetRecordingKeyframe(recording_reader *Reader, uint32 KeyframeIndex)
+{
+	Assert(KeyframeIndex < Reader->Header->KeyframeCount);
+	recording_keyframe *Keyframe = Reader->Keyframes + KeyframeIndex;
+	Reader->At = Reader->Base + Keyframe->FrameOffset;
+	Reader->FrameIndex = Keyframe->FrameIndex;
+	Reader->NextKeyframeIndex = KeyframeIndex + 1;
+	Reader->PreviousInput = {};
+}
+
+internal void LoadRecordingKeyframe(recording_reader *Reader, uint32 KeyframeIndex, void *Memory)
+{
+	Assert(KeyframeIndex < Reader->Header->KeyframeCount);
+	recording_keyframe *Keyframe = Reader->Keyframes + KeyframeIndex;
+
+	uint8 *Source = Reader->Base + Keyframe->SnapshotOffset;
+	uint8 *Dest = (uint8 *)Memory;
+	for(uint64 Offset = 0; Offset < Reader->Header->MemorySize; Offset += RECORDING_SNAPSHOT_BLOCK_SIZE)
+	{
+		uint64 BlockSize = Minimum(RECORDING_SNAPSHOT_BLOCK_SIZE, Reader->Header->MemorySize - Offset);
+		DecompressSnapshotBlock(&Source, BlockSize, Dest + Offset);
+	}
+	Assert(Source == (Reader->Base + Keyframe->FrameOffset));
+
+	SetRecordingKeyframe(Reader, KeyframeIndex);
+}
+
+/*
+	NOTE: Restores the nearest keyframe at or before FrameIndex and returns how many frames the
+	caller has to read and run through the game to arrive at FrameIndex.
+*/
+internal uint32 SeekRecording(recording_reader *Reader, uint32 FrameIndex, void *Memory)
+{
+	uint32 LastFrameIndex = Reader->Header->FrameCount ? (Reader->Header->FrameCount - 1) : 0;
+	FrameIndex = Minimum(FrameIndex, LastFrameIndex);
+
+	uint32 KeyframeIndex = FrameIndex / Reader->Header->KeyframeInterval;
+	KeyframeIndex = Minimum(KeyframeIndex, Reader->Header->KeyframeCount - 1);
+	LoadRecordingKeyframe(Reader, KeyframeIndex, Memory);
+
+	uint32 Result = FrameIndex - Reader->FrameIndex;
+	return Result;
+}
+
+internal bool32 ReadRecordedInput(recording_reader *Reader, game_input *Input)
+{
+	bool32 Result = false;
+	if(Reader->FrameIndex < Reader->Header->FrameCount)
+	{
+		// NOTE: Hop over the snapshot in front of the next run of frames
+		if((Reader->NextKeyframeIndex < Reader->Header->KeyframeCount) &&
+		   (Reader->Keyframes[Reader->NextKeyframeIndex].FrameIndex == Reader->FrameIndex))
+		{
+			SetRecordingKeyframe(Reader, Reader->NextKeyframeIndex);
+		}
+
+		DecodeInputFrame(&Reader->PreviousInput, &Reader->At, Input);
+		Reader->PreviousInput = *Input;
+		Reader->FrameIndex++;
+		Result = true;
+	}
+
+	return Result;
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef HANDMADE_SOUND_RING_H
+#define HANDMADE_SOUND_RING_H
+
+/*
+	NOTE: Sound ring shared by the platform layers.
+
+	A single producer, single consumer ring of interleaved stereo int16 frames. The game thread
+	mixes into it once per frame, and a dedicated sound thread drains it a short period at a time
+	on the device's clock, so a slow game frame only eats into what's queued instead of landing
+	straight on the speakers.
+
+	No locks. Each side only ever writes its own index, and the indices are free running frame
+	counts masked into the buffer, so full and empty can't be confused. The samples are written
+	before the index that publishes them, and read before the index that hands their space back.
+
+	When the consumer finds less queued than it needs it plays what there is, pads the period with
+	silence and counts an underrun. Nothing is counted before the producer's first write.
+*/
+
+struct sound_ring
+{
+	// NOTE: FrameCapacity has to be a power of two
+	uint32 FrameCapacity;
+	uint32 FrameMask;
+	int16 *Samples;
+
+	uint64 volatile WriteFrame;
+	uint64 volatile ReadFrame;
+
+	// NOTE: Only the consumer writes these
+	uint32 volatile UnderrunCount;
+	uint64 volatile UnderrunFrames;
+};
+
+internal void InitializeSoundRing(sound_ring *Ring, uint32 FrameCapacity, int16 *Samples)
+{
+	Assert((FrameCapacity & (FrameCapacity - 1)) == 0);
+	*Ring = {};
+	Ring->FrameCapacity = FrameCapacity;
+	Ring->FrameMask = FrameCapacity - 1;
+	Ring->Samples = Samples;
+}
+
+inline uint32 SoundRingQueuedFrames(sound_ring *Ring)
+{
+	uint32 Result = (uint32)(Ring->WriteFrame - Ring->ReadFrame);
+	return Result;
+}
+
+// NOTE: Producer side. Returns how many frames fit, anything past that is dropped.
+internal uint32 SoundRingWrite(sound_ring *Ring, int16 *Source, uint32 FrameCount)
+{
+	uint64 WriteFrame = Ring->WriteFrame;
+	uint64 ReadFrame = Ring->ReadFrame;
+	CompletePreviousReadsBeforeFutureWrites;
+
+	uint32 FreeFrames = Ring->FrameCapacity - (uint32)(WriteFrame - ReadFrame);
+	uint32 Result = Minimum(FrameCount, FreeFrames);
+	for(uint32 FrameIndex = 0; FrameIndex < Result; ++FrameIndex)
+	{
+		uint32 Slot = (uint32)((WriteFrame + FrameIndex) & Ring->FrameMask);
+		Ring->Samples[2*Slot + 0] = *Source++;
+		Ring->Samples[2*Slot + 1] = *Source++;
+	}
+
+	CompletePreviousWritesBeforeFutureWrites;
+	Ring->WriteFrame = WriteFrame + Result;
+
+	return Result;
+}
+
+// NOTE: Consumer side. Always fills all of Dest, with silence for whatever wasn't queued.
+internal uint32 SoundRingRead(sound_ring *Ring, int16 *Dest, uint32 FrameCount)
+{
+	uint64 ReadFrame = Ring->ReadFrame;
+	uint64 WriteFrame = Ring->WriteFrame;
+	CompletePreviousReadsBeforeFutureReads;
+
+	uint32 Result = Minimum(FrameCount, (uint32)(WriteFrame - ReadFrame));
+	for(uint32 FrameIndex = 0; FrameIndex < Result; ++FrameIndex)
+	{
+		uint32 Slot = (uint32)((ReadFrame + FrameIndex) & Ring->FrameMask);
+		*Dest++ = Ring->Samples[2*Slot + 0];
+		*Dest++ = Ring->Samples[2*Slot + 1];
+	}
+	for(uint32 FrameIndex = Result; FrameIndex < FrameCount; ++FrameIndex)
+	{
+		*Dest++ = 0;
+		*Dest++ = 0;
+	}
+
+	CompletePreviousReadsBeforeFutureWrites;
+	Ring->ReadFrame = ReadFrame + Result;
+
+	if((Result < FrameCount) && (WriteFrame > 0))
+	{
+		++Ring->UnderrunCount;
+		Ring->UnderrunFrames += FrameCount - Result;
+	}
+
+	return Result;
+}
+
+#endif
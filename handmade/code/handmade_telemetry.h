@@ -0,0 +1,66 @@
+#ifndef HANDMADE_TELEMETRY_H
+#define HANDMADE_TELEMETRY_H
+
+#include "handmade.h"
+#include <stdio.h>
+
+/*
+	NOTE: Memory telemetry report, for the platform to print what the game left in
+	game_memory.Telemetry (handmade_platform.h)
+
+	One line per arena with its used and peak bytes against its size, then the tile chunks that
+	hold storage of their own, then how many entities the last frame drew against how many it
+	culled, and what input it went through. The peak over a long session is what the upfront
+	allocation can be cut down to, the rest of the size is address space nobody touched.
+*/
+
+// NOTE: Returns the length written, not counting the terminator, and truncates to fit
+internal uint32 FormatMemoryTelemetry(game_memory_telemetry *Telemetry, char *Dest, uint32 DestSize)
+{
+	char *At = Dest;
+	char *End = Dest + DestSize;
+	int Written = snprintf(At, (size_t)(End - At), "Memory at frame %llu, %u entities\n",
+						   (unsigned long long)Telemetry->FrameIndex, Telemetry->EntityCount);
+	for(uint32 ArenaIndex = 0; (ArenaIndex < Telemetry->ArenaCount) && (Written >= 0) && (Written < (End - At)); ++ArenaIndex)
+	{
+		At += Written;
+
+		game_arena_telemetry *Arena = Telemetry->Arenas + ArenaIndex;
+		real64 Size = (real64)Arena->Size;
+		Written = snprintf(At, (size_t)(End - At), "  %-12s %9.2fMB used, %9.2fMB peak (%5.1f%%) of %9.2fMB, %llu pushes\n",
+						   Arena->Name, (real64)Arena->Used / (1024.0*1024.0), (real64)Arena->PeakUsed / (1024.0*1024.0),
+						   Size ? (100.0*(real64)Arena->PeakUsed / Size) : 0.0, Size / (1024.0*1024.0),
+						   (unsigned long long)Arena->AllocationCount);
+	}
+	if((Written >= 0) && (Written < (End - At)))
+	{
+		At += Written;
+		Written = snprintf(At, (size_t)(End - At), "  %-12s %9u resident, %9.2fKB\n", "Tile chunks",
+						   Telemetry->ResidentChunkCount, (real64)Telemetry->ResidentChunkBytes / 1024.0);
+	}
+	if((Written >= 0) && (Written < (End - At)))
+	{
+		At += Written;
+		Written = snprintf(At, (size_t)(End - At), "  %-12s %9u drawn, %9u culled off screen, %u on other levels\n", "Entities",
+						   Telemetry->DrawnEntityCount, Telemetry->OffScreenEntityCount, Telemetry->OtherLevelEntityCount);
+	}
+	if((Written >= 0) && (Written < (End - At)))
+	{
+		At += Written;
+		Written = snprintf(At, (size_t)(End - At), "  %-12s %9u events, %9u controllers processed, %u sim ticks\n", "Input",
+						   Telemetry->InputEventCount, Telemetry->ProcessedControllerCount, Telemetry->TickCount);
+	}
+	if((Written >= 0) && (Written < (End - At)))
+	{
+		At += Written;
+	}
+	else
+	{
+		At = End - 1;
+	}
+
+	uint32 Result = (uint32)(At - Dest);
+	return Result;
+}
+
+#endif
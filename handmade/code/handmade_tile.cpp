@@ -19,33 +19,288 @@ inline tile_chunk* GetTileChunk(tile_map *TileMap, uint32 TileChunkX, uint32 Til
 	return TileChunk;
 }
 
+inline uint32 *GetChunkPalette(tile_chunk *TileChunk)
+{
+	uint32 *Palette = (uint32 *)TileChunk->Storage;
+	return Palette;
+}
+
+inline uint32 GetTileIndexSize(uint32 PaletteCapacity)
+{
+	uint32 IndexSize = (PaletteCapacity > 256) ? sizeof(uint16) : sizeof(uint8);
+	return IndexSize;
+}
+
+inline uint8 *GetChunkIndices(tile_chunk *TileChunk)
+{
+	uint8 *Indices = TileChunk->Storage + TileChunk->PaletteCapacity*sizeof(uint32);
+	return Indices;
+}
+
+inline uint32 GetChunkPaletteIndex(tile_chunk *TileChunk, uint32 TileIndex)
+{
+	uint8 *Indices = GetChunkIndices(TileChunk);
+
+	uint32 PaletteIndex;
+	if(GetTileIndexSize(TileChunk->PaletteCapacity) == 1)
+	{
+		PaletteIndex = Indices[TileIndex];
+	}
+	else
+	{
+		PaletteIndex = ((uint16 *)Indices)[TileIndex];
+	}
+
+	return PaletteIndex;
+}
+
+inline void SetChunkPaletteIndex(tile_chunk *TileChunk, uint32 TileIndex, uint32 PaletteIndex)
+{
+	uint8 *Indices = GetChunkIndices(TileChunk);
+	if(GetTileIndexSize(TileChunk->PaletteCapacity) == 1)
+	{
+		Indices[TileIndex] = (uint8)PaletteIndex;
+	}
+	else
+	{
+		((uint16 *)Indices)[TileIndex] = (uint16)PaletteIndex;
+	}
+}
+
 inline uint32 GetTileValueUnchecked(tile_map *TileMap, tile_chunk *TileChunk, uint32 TileX, uint32 TileY)
 {
 	Assert(TileChunk);
-	Assert(TileX < TileMap->ChunkDim);
-	Assert(TileY < TileMap->ChunkDim);
+	Assert(TileX < TILE_CHUNK_DIM);
+	Assert(TileY < TILE_CHUNK_DIM);
+
+	uint32 TileMapValue = TileChunk->UniformValue;
+	if(TileChunk->Storage)
+	{
+		uint32 TileIndex = TileY*TILE_CHUNK_DIM + TileX;
+		TileMapValue = GetChunkPalette(TileChunk)[GetChunkPaletteIndex(TileChunk, TileIndex)];
+	}
 
-	uint32 TileMapValue = TileChunk->Tiles[TileY*TileMap->ChunkDim + TileX];
 	return TileMapValue;
 }
 
-inline void SetTileValueUnchecked(tile_map *TileMap, tile_chunk *TileChunk, uint32 TileX, uint32 TileY, uint32 TileValue)
+// NOTE: Chunk storage can be pushed from worker threads (lazy generation, room path fills), so
+// it always goes through the atomic push
+internal uint8 *PushTileChunkStorage(memory_arena *Arena, tile_map *TileMap, uint32 PaletteCapacity)
+{
+	memory_index StorageSize = PaletteCapacity*sizeof(uint32) +
+		TILE_CHUNK_DIM*TILE_CHUNK_DIM*GetTileIndexSize(PaletteCapacity);
+	uint8 *Storage = PushArrayAtomic(Arena, StorageSize, uint8);
+	AtomicAddU64(&TileMap->ResidentChunkBytes, StorageSize);
+
+	return Storage;
+}
+
+internal void PalettizeTileChunk(memory_arena *Arena, tile_map *TileMap, tile_chunk *TileChunk)
+{
+	Assert(!TileChunk->Storage);
+
+	TileChunk->PaletteCapacity = Minimum(TileMap->ChunkPaletteCapacity, TILE_CHUNK_DIM*TILE_CHUNK_DIM);
+	TileChunk->Storage = PushTileChunkStorage(Arena, TileMap, TileChunk->PaletteCapacity);
+	AtomicAddU64(&TileMap->ResidentChunkCount, 1);
+
+	// NOTE: Palette entry 0 is the old uniform value, so zeroed indices preserve the chunk contents
+	GetChunkPalette(TileChunk)[0] = TileChunk->UniformValue;
+	TileChunk->PaletteCount = 1;
+
+	uint8 *Indices = GetChunkIndices(TileChunk);
+	uint32 IndexBytes = TILE_CHUNK_DIM*TILE_CHUNK_DIM*GetTileIndexSize(TileChunk->PaletteCapacity);
+	for(uint32 ByteIndex = 0; ByteIndex < IndexBytes; ByteIndex++)
+	{
+		Indices[ByteIndex] = 0;
+	}
+}
+
+/*
+	NOTE: Makes room for one more palette entry in a full chunk. Entries no tile uses any more are
+	dropped first, counting the tile at SkipTileIndex as unused since it is about to be
+	overwritten. If that frees nothing the chunk moves to storage with twice the palette, and
+	indices go from one byte to two once it passes 256 entries. The palette can grow to a value
+	per tile, so there is always room for the tile being written.
+
+	The old storage stays behind in the arena, arenas don't free. Compacting in place means churning
+	through values only costs that when the chunk really does hold more of them at once.
+*/
+internal void RepackTileChunk(memory_arena *Arena, tile_map *TileMap, tile_chunk *TileChunk, uint32 SkipTileIndex)
+{
+	uint32 TileCount = TILE_CHUNK_DIM*TILE_CHUNK_DIM;
+	Assert(TileChunk->PaletteCount == TileChunk->PaletteCapacity);
+	Assert(TileChunk->PaletteCapacity <= TileCount);
+
+	// NOTE: Old palette index to new, 1 for "used" until the new indices are handed out in
+	// palette order, so compacting the palette in place never overwrites an entry not yet moved
+	uint32 Remap[TILE_CHUNK_DIM*TILE_CHUNK_DIM];
+	for(uint32 PaletteIndex = 0; PaletteIndex < TileChunk->PaletteCount; PaletteIndex++)
+	{
+		Remap[PaletteIndex] = 0;
+	}
+	for(uint32 TileIndex = 0; TileIndex < TileCount; TileIndex++)
+	{
+		if(TileIndex != SkipTileIndex)
+		{
+			Remap[GetChunkPaletteIndex(TileChunk, TileIndex)] = 1;
+		}
+	}
+
+	uint32 *Palette = GetChunkPalette(TileChunk);
+	uint32 UsedCount = 0;
+	for(uint32 PaletteIndex = 0; PaletteIndex < TileChunk->PaletteCount; PaletteIndex++)
+	{
+		if(Remap[PaletteIndex])
+		{
+			Remap[PaletteIndex] = UsedCount;
+			Palette[UsedCount++] = Palette[PaletteIndex];
+		}
+	}
+	Assert(UsedCount < TileCount);
+
+	if(UsedCount < TileChunk->PaletteCapacity)
+	{
+		for(uint32 TileIndex = 0; TileIndex < TileCount; TileIndex++)
+		{
+			uint32 PaletteIndex = (TileIndex == SkipTileIndex) ? 0 : Remap[GetChunkPaletteIndex(TileChunk, TileIndex)];
+			SetChunkPaletteIndex(TileChunk, TileIndex, PaletteIndex);
+		}
+	}
+	else
+	{
+		tile_chunk OldChunk = *TileChunk;
+		TileChunk->PaletteCapacity = Minimum(2*OldChunk.PaletteCapacity, TileCount);
+		TileChunk->Storage = PushTileChunkStorage(Arena, TileMap, TileChunk->PaletteCapacity);
+
+		uint32 *NewPalette = GetChunkPalette(TileChunk);
+		for(uint32 PaletteIndex = 0; PaletteIndex < UsedCount; PaletteIndex++)
+		{
+			NewPalette[PaletteIndex] = Palette[PaletteIndex];
+		}
+		for(uint32 TileIndex = 0; TileIndex < TileCount; TileIndex++)
+		{
+			uint32 PaletteIndex = (TileIndex == SkipTileIndex) ? 0 : Remap[GetChunkPaletteIndex(&OldChunk, TileIndex)];
+			SetChunkPaletteIndex(TileChunk, TileIndex, PaletteIndex);
+		}
+	}
+	TileChunk->PaletteCount = UsedCount;
+}
+
+inline void SetTileValueUnchecked(memory_arena *Arena, tile_map *TileMap, tile_chunk *TileChunk, 
+								  uint32 TileX, uint32 TileY, uint32 TileValue)
 {
 	Assert(TileChunk);
-	Assert(TileX < TileMap->ChunkDim);
-	Assert(TileY < TileMap->ChunkDim);
+	Assert(TileX < TILE_CHUNK_DIM);
+	Assert(TileY < TILE_CHUNK_DIM);
+
+	if(!TileChunk->Storage)
+	{
+		if(TileChunk->UniformValue == TileValue)
+		{
+			return;
+		}
+		PalettizeTileChunk(Arena, TileMap, TileChunk);
+	}
+
+	uint32 TileIndex = TileY*TILE_CHUNK_DIM + TileX;
+	uint32 *Palette = GetChunkPalette(TileChunk);
+	uint32 PaletteIndex = 0;
+	while((PaletteIndex < TileChunk->PaletteCount) && (Palette[PaletteIndex] != TileValue))
+	{
+		PaletteIndex++;
+	}
+	if(PaletteIndex == TileChunk->PaletteCount)
+	{
+		if(TileChunk->PaletteCount == TileChunk->PaletteCapacity)
+		{
+			RepackTileChunk(Arena, TileMap, TileChunk, TileIndex);
+			Palette = GetChunkPalette(TileChunk);
+		}
+		PaletteIndex = TileChunk->PaletteCount++;
+		Palette[PaletteIndex] = TileValue;
+	}
 
-	TileChunk->Tiles[TileY*TileMap->ChunkDim + TileX] = TileValue;	
+	SetChunkPaletteIndex(TileChunk, TileIndex, PaletteIndex);
+}
+
+// NOTE: Replaces the chunk contents with TileValues (TILE_CHUNK_DIM*TILE_CHUNK_DIM values, row major).
+// Safe to call from any thread as long as nobody else is writing this chunk.
+internal void StoreTileChunk(memory_arena *Arena, tile_map *TileMap, tile_chunk *TileChunk, uint32 *TileValues)
+{
+	uint32 TileCount = TILE_CHUNK_DIM*TILE_CHUNK_DIM;
+
+	bool32 IsUniform = true;
+	for(uint32 TileIndex = 1; TileIndex < TileCount; TileIndex++)
+	{
+		if(TileValues[TileIndex] != TileValues[0])
+		{
+			IsUniform = false;
+			break;
+		}
+	}
+
+	TileChunk->UniformValue = TileValues[0];
+	TileChunk->PaletteCount = 0;
+	TileChunk->Storage = 0;
+	if(!IsUniform)
+	{
+		PalettizeTileChunk(Arena, TileMap, TileChunk);
+		for(uint32 TileY = 0; TileY < TILE_CHUNK_DIM; TileY++)
+		{
+			for(uint32 TileX = 0; TileX < TILE_CHUNK_DIM; TileX++)
+			{
+				SetTileValueUnchecked(Arena, TileMap, TileChunk, TileX, TileY, TileValues[TileY*TILE_CHUNK_DIM + TileX]);
+			}
+		}
+	}
+}
+
+/*
+	NOTE: Lazily generated chunks go Ungenerated -> (Queued) -> Generating -> Generated.
+	Whoever wins the move to Generating fills the chunk, so a prefetch that hasn't started yet
+	never blocks the main thread; it only waits on a chunk some other thread is mid-way through.
+*/
+internal void EnsureTileChunkGenerated(tile_map *TileMap, tile_chunk *TileChunk, 
+									   uint32 TileChunkX, uint32 TileChunkY, uint32 TileChunkZ)
+{
+	Assert(TileMap->GenerateChunk);
+
+	uint32 State = TileChunk->State;
+	while((State == TileChunkState_Ungenerated) || (State == TileChunkState_Queued))
+	{
+		if(AtomicCompareExchangeUInt32(&TileChunk->State, TileChunkState_Generating, State) == State)
+		{
+			TileMap->GenerateChunk(TileMap, TileChunk, TileChunkX, TileChunkY, TileChunkZ);
+			CompletePreviousWritesBeforeFutureWrites;
+			TileChunk->State = TileChunkState_Generated;
+		}
+		State = TileChunk->State;
+	}
+
+	while(TileChunk->State != TileChunkState_Generated)
+	{
+		// NOTE: Another thread is generating this chunk right now
+		_mm_pause();
+	}
+	CompletePreviousReadsBeforeFutureReads;
+}
+
+// NOTE: Returns true if the chunk was claimed for a background generation entry
+internal bool32 QueueTileChunkGeneration(tile_chunk *TileChunk)
+{
+	bool32 Result = (AtomicCompareExchangeUInt32(&TileChunk->State, TileChunkState_Queued, 
+												 TileChunkState_Ungenerated) == TileChunkState_Ungenerated);
+	return Result;
 }
 
 inline tile_chunk_position GetChunkPositionFor(tile_map *TileMap, uint32 AbsTileX, uint32 AbsTileY, uint32 AbsTileZ)
 {
 	tile_chunk_position Result;
-	Result.TileChunkX = AbsTileX >> TileMap->ChunkShift;
-	Result.TileChunkY = AbsTileY >> TileMap->ChunkShift;
+	Result.TileChunkX = AbsTileX >> TILE_CHUNK_SHIFT;
+	Result.TileChunkY = AbsTileY >> TILE_CHUNK_SHIFT;
 	Result.TileChunkZ = AbsTileZ;
-	Result.RelTileX = AbsTileX & TileMap->ChunkMask;
-	Result.RelTileY = AbsTileY & TileMap->ChunkMask;
+	Result.RelTileX = AbsTileX & TILE_CHUNK_MASK;
+	Result.RelTileY = AbsTileY & TILE_CHUNK_MASK;
 
 	return Result;
 }
@@ -53,7 +308,7 @@ inline tile_chunk_position GetChunkPositionFor(tile_map *TileMap, uint32 AbsTile
 internal bool32 GetTileValue(tile_map *TileMap, tile_chunk *TileChunk, uint32 TestTileX, uint32 TestTileY)
 {
 	uint32 Result = 0;
-	if(TileChunk && TileChunk->Tiles)
+	if(TileChunk)
 	{		
 		Result = GetTileValueUnchecked(TileMap, TileChunk, TestTileX, TestTileY);		
 	}
@@ -65,6 +320,10 @@ internal uint32 GetTileValue(tile_map *TileMap, uint32 AbsTileX, uint32 AbsTileY
 {	
 	tile_chunk_position ChunkPos = GetChunkPositionFor(TileMap, AbsTileX, AbsTileY, AbsTileZ);
 	tile_chunk *TileChunk = GetTileChunk(TileMap, ChunkPos.TileChunkX, ChunkPos.TileChunkY, ChunkPos.TileChunkZ);
+	if(TileChunk && TileMap->GenerateChunk && (TileChunk->State != TileChunkState_Generated))
+	{
+		EnsureTileChunkGenerated(TileMap, TileChunk, ChunkPos.TileChunkX, ChunkPos.TileChunkY, ChunkPos.TileChunkZ);
+	}
 	uint32 Value = GetTileValue(TileMap, TileChunk, ChunkPos.RelTileX, ChunkPos.RelTileY);
 
 	return Value;
@@ -76,11 +335,12 @@ internal uint32 GetTileValue(tile_map *TileMap, tile_map_position Pos)
 	return Value;
 }
 
-internal void SetTileValue(tile_map *TileMap, tile_chunk *TileChunk, uint32 TestTileX, uint32 TestTileY, uint32 TileValue)
+internal void SetTileValue(memory_arena *Arena, tile_map *TileMap, tile_chunk *TileChunk, 
+						  uint32 TestTileX, uint32 TestTileY, uint32 TileValue)
 {
-	if(TileChunk && TileChunk->Tiles)
+	if(TileChunk && TileChunk->UniformValue)
 	{		
-		SetTileValueUnchecked(TileMap, TileChunk, TestTileX, TestTileY, TileValue);		
+		SetTileValueUnchecked(Arena, TileMap, TileChunk, TestTileX, TestTileY, TileValue);		
 	}	
 }
 
@@ -98,25 +358,28 @@ internal bool32 IsTileMapPointEmpty(tile_map *TileMap, tile_map_position CanPos)
 	return Empty;
 }
 
+// NOTE: Arena is the world's chunk arena, which chunk storage is pushed onto from worker threads too
 internal void SetTileValue(memory_arena *Arena, tile_map *TileMap, uint32 AbsTileX, uint32 AbsTileY, uint32 AbsTileZ, uint32 TileValue)
 {
     tile_chunk_position ChunkPos = GetChunkPositionFor(TileMap, AbsTileX, AbsTileY, AbsTileZ);
 	tile_chunk *TileChunk = GetTileChunk(TileMap, ChunkPos.TileChunkX, ChunkPos.TileChunkY, ChunkPos.TileChunkZ);
-	
-    // TODO: on demand tile chunk creation 
-    Assert(TileChunk);
-
-	if(!TileChunk->Tiles)
+	if(TileChunk)
 	{
-		uint32 TileCount = TileMap->ChunkDim*TileMap->ChunkDim;
-		TileChunk->Tiles = PushArray(Arena, TileCount, uint32);
-		for(uint32 TileIndex = 0; TileIndex < TileCount; TileIndex++)
+		// NOTE: A lazy chunk is generated before the write lands, otherwise generating it later would
+		// overwrite the write, or race a worker already generating it
+		if(TileMap->GenerateChunk && (TileChunk->State != TileChunkState_Generated))
 		{
-			TileChunk->Tiles[TileIndex] = 1;
+			EnsureTileChunkGenerated(TileMap, TileChunk, ChunkPos.TileChunkX, ChunkPos.TileChunkY, ChunkPos.TileChunkZ);
 		}
-	}
 
-    SetTileValue(TileMap, TileChunk, ChunkPos.RelTileX, ChunkPos.RelTileY, TileValue);
+		if(!TileChunk->Storage && !TileChunk->UniformValue)
+		{
+			// NOTE: Fresh chunks start as all floor and only get tile storage once something differs
+			TileChunk->UniformValue = 1;
+		}
+
+		SetTileValue(Arena, TileMap, TileChunk, ChunkPos.RelTileX, ChunkPos.RelTileY, TileValue);
+	}
 }
 
 // TILE MAP POSITIONING
@@ -1,6 +1,19 @@
 #ifndef HANDMADE_TILE_H
 #define HANDMADE_TILE_H
 
+// NOTE: Chunk size is fixed at compile time, so chunk lookups are constant shifts and masks
+// and per-chunk loops have known trip counts. Override TILE_CHUNK_SHIFT in the build to change it.
+#ifndef TILE_CHUNK_SHIFT
+#define TILE_CHUNK_SHIFT 4
+#endif
+#define TILE_CHUNK_DIM (1 << TILE_CHUNK_SHIFT)
+#define TILE_CHUNK_MASK (TILE_CHUNK_DIM - 1)
+
+// NOTE: A chunk's palette can grow to one entry per tile, which 16 bit indices have to address
+#if TILE_CHUNK_SHIFT > 8
+#error "TILE_CHUNK_SHIFT above 8 gives chunks more tiles than a palette index can address"
+#endif
+
 // TODO replace with v3
 typedef struct
 {
@@ -31,16 +44,38 @@ typedef struct
 	uint32 RelTileY;
 } tile_chunk_position;
 
+enum tile_chunk_state
+{
+	TileChunkState_Ungenerated,
+	TileChunkState_Queued,
+	TileChunkState_Generating,
+	TileChunkState_Generated,
+};
+
 typedef struct 
 {
-	uint32 *Tiles;
+	// NOTE: Only used by lazily generated maps, see EnsureTileChunkGenerated
+	uint32 volatile State;
+
+	// NOTE: When Storage is null every tile in the chunk has UniformValue, and a
+	// UniformValue of 0 means the chunk was never created. Otherwise Storage holds
+	// the chunk palette (PaletteCapacity uint32 values) followed by one palette
+	// index per tile, a byte wide up to 256 palette entries and two bytes past that.
+	uint32 UniformValue;
+	uint32 PaletteCount;
+	uint32 PaletteCapacity;
+	uint8 *Storage;
 } tile_chunk;
 
-typedef struct  
+struct tile_map;
+#define TILE_CHUNK_GENERATOR(name) void name(tile_map *TileMap, tile_chunk *TileChunk, uint32 TileChunkX, uint32 TileChunkY, uint32 TileChunkZ)
+typedef TILE_CHUNK_GENERATOR(tile_chunk_generator);
+
+struct tile_map
 {
-    uint32 ChunkShift;
-	uint32 ChunkMask;
-	uint32 ChunkDim;
+	// NOTE: The palette a chunk starts out with, see RepackTileChunk for what happens when
+	// it fills up
+	uint32 ChunkPaletteCapacity;
 
 	real32 TileSideInMeters;
 
@@ -49,6 +84,15 @@ typedef struct
 	uint32 TileChunkCountY;	
 	uint32 TileChunkCountZ;	
 	tile_chunk *TileChunks;
-} tile_map;
+
+	// NOTE: Chunks holding per tile storage rather than one uniform value, and the arena bytes that
+	// storage takes. Lazily generated chunks are stored from worker threads, so these are atomic.
+	uint64 volatile ResidentChunkCount;
+	uint64 volatile ResidentChunkBytes;
+
+	// NOTE: When set, chunks are filled on first touch instead of up front
+	tile_chunk_generator *GenerateChunk;
+	void *GeneratorContext;
+};
 
 #endif
\ No newline at end of file
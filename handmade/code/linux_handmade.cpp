@@ -0,0 +1,1558 @@
+/*
+	TODO  THIS IS NOT A FINAL PLATFORM LAYER
+
+	Headless Linux host. It loads the game from handmade.so, runs it at a fixed rate into an
+	offscreen buffer, and hot reloads the library when it is rebuilt. There is no window, sound
+	device or live input yet; with -play it loops a recorded .hmi input stream instead, which is
+	enough for live code editing against a recorded loop.
+
+	linux_handmade [-play <recording.hmi>] [-hz N] [-simhz N] [-frames N]
+				   [-audio null|<out.wav>] [-latency MS] [-stall MS] [-stallevery N] [-profile N]
+				   [-trace <out.json>] [-memory N] [-commit eager|lazy|reserve] [-populate] [-hugepages]
+				   [-syntheticinput N]
+
+	Rebuilds are picked up through inotify on a watcher thread instead of checking the library's
+	write time every frame.
+
+	With -audio the game's sound goes through a ring to a sound thread that plays it into nothing
+	or into a WAV file, at -latency milliseconds queued. -stall sleeps that long on every
+	-stallevery'th frame, to see how much of a slow frame the queue absorbs.
+
+	-profile collects the timed blocks of every thread and prints the call tree every N frames, and
+	once more for whatever is left at exit. 0 only prints at exit. Needs a HANDMADE_PROFILE build.
+
+	-trace writes the most recent timed blocks as Chrome trace JSON, whenever the process gets
+	SIGUSR1 and once more at exit. The file is written on a thread of its own while frames go on.
+
+	-memory prints the game's arena usage and peaks and its resident tile chunks every N frames,
+	and once more at exit. 0 only prints at exit.
+
+	-commit picks how game memory is backed. eager faults every page in at startup, lazy (the
+	default) maps it all readable and writable and lets the kernel back pages on first touch, and
+	reserve maps it PROT_NONE so the game has to commit what it uses, which its arenas do as they
+	grow. -populate makes reserve fault in what the permanent storage commits straight away. At exit
+	the host prints how long startup took and the resident set size. Playback commits the whole
+	block whatever the mode, since keyframes restore over all of it. The base address stays fixed
+	in internal builds either way, which is what lets recordings play back at all. Playback also
+	keeps a copy of game memory as the first keyframe left it and tracks the pages the loop writes
+	(handmade_dirty_pages.h), so going back to the start only copies those back; at exit it prints
+	how many that was per loop.
+
+	-hugepages marks game memory for transparent huge pages, whatever the commit mode, and puts the
+	framebuffer on a huge page of its own (handmade_large_pages.h). Game memory never gets explicit
+	huge pages, those would back all of it up front.
+
+	-syntheticinput presses and lets go of keyboard buttons N times a second at random times, each
+	one queued as an input event stamped with when it happened, and at exit prints the input to
+	photon latency: from an event to the end of the frame wait of the first frame that simulated
+	it, where a windowed host would flip. Not with -play, which has input of its own.
+*/
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "handmade.h"
+#include "handmade_recording.h"
+#include "handmade_frame_pacer.h"
+#include "handmade_sound_ring.h"
+#include "handmade_profiler.h"
+#include "handmade_telemetry.h"
+#include "handmade_large_pages.h"
+#include "handmade_dirty_pages.h"
+#include "linux_handmade.h"
+
+global_variable bool32 GlobalRunning;
+
+inline uint64 LinuxGetWallClock(void)
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	uint64 Result = (uint64)Time.tv_sec*1000000000ull + (uint64)Time.tv_nsec;
+	return Result;
+}
+
+inline real32 LinuxGetSecondsElapsed(uint64 Start, uint64 End)
+{
+	real32 Result = (real32)(End - Start) / 1000000000.0f;
+	return Result;
+}
+
+DEBUG_PLATFORM_FREE_FILE_MEMORY(DEBUGPlatformFreeFileMemory)
+{
+	if(Memory)
+	{
+		free(Memory);
+	}
+}
+
+DEBUG_PLATFORM_READ_ENTIRE_FILE(DEBUGPlatformReadEntireFile)
+{
+	debug_read_file_result Result = {};
+
+	int FileHandle = open(Filename, O_RDONLY);
+	if(FileHandle >= 0)
+	{
+		struct stat FileStatus;
+		if(fstat(FileHandle, &FileStatus) == 0)
+		{
+			uint32 FileSize32 = SafeTruncateUInt64(FileStatus.st_size);
+			Result.Contents = malloc(FileSize32);
+			if(Result.Contents)
+			{
+				uint32 BytesRead = 0;
+				while(BytesRead < FileSize32)
+				{
+					ssize_t ReadCount = read(FileHandle, (uint8 *)Result.Contents + BytesRead, FileSize32 - BytesRead);
+					if(ReadCount <= 0)
+					{
+						break;
+					}
+					BytesRead += (uint32)ReadCount;
+				}
+
+				if(BytesRead == FileSize32)
+				{
+					Result.ContentsSize = FileSize32;
+				}
+				else
+				{
+					DEBUGPlatformFreeFileMemory(Thread, Result.Contents);
+					Result.Contents = 0;
+				}
+			}
+			else
+			{
+				// TODO logging
+			}
+		}
+		else
+		{
+			// TODO logging
+		}
+		close(FileHandle);
+	}
+	else
+	{
+		// TODO logging
+	}
+
+	return Result;
+}
+
+DEBUG_PLATFORM_WRITE_ENTIRE_FILE(DEBUGPlatformWriteEntireFile)
+{
+	bool32 Result = false;
+
+	int FileHandle = open(Filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(FileHandle >= 0)
+	{
+		ssize_t BytesWritten = write(FileHandle, Memory, MemorySize);
+		Result = (BytesWritten == (ssize_t)MemorySize);
+		close(FileHandle);
+	}
+	else
+	{
+		// TODO logging
+	}
+
+	return Result;
+}
+
+PLATFORM_OPEN_FILE(LinuxOpenFile)
+{
+	platform_file_handle Result = {};
+
+	int FileHandle = open(Filename, O_RDONLY);
+	Result.NoErrors = (FileHandle >= 0);
+	Result.Platform = (void *)(intptr_t)FileHandle;
+
+	return Result;
+}
+
+/*
+	NOTE: pread leaves the file position alone, so reads from different threads can't interfere.
+
+	While playback tracks dirty pages, game memory is read-only until each page's first write, and a
+	write by the kernel itself fails with EFAULT instead of faulting into the tracker. Reads into
+	the tracked block go through a buffer on the stack and a memcpy, which faults the normal way.
+	Unprotecting the destination up front instead would race a collection on the main thread
+	protecting it again before the read lands.
+*/
+PLATFORM_READ_DATA_FROM_FILE(LinuxReadDataFromFile)
+{
+	uint64 Result = 0;
+	if(Handle->NoErrors)
+	{
+		int FileHandle = (int)(intptr_t)Handle->Platform;
+		dirty_page_tracker *Tracker = GlobalDirtyPageTracker;
+		bool32 Bounce = (Tracker && ((uint8 *)Dest < (Tracker->Base + Tracker->Size)) &&
+						 (((uint8 *)Dest + Size) > Tracker->Base));
+		uint8 BounceBuffer[Kilobytes(64)];
+		while(Result < Size)
+		{
+			uint8 *ReadDest = (uint8 *)Dest + Result;
+			uint64 ReadSize = Size - Result;
+			if(Bounce)
+			{
+				ReadDest = BounceBuffer;
+				ReadSize = Minimum(ReadSize, sizeof(BounceBuffer));
+			}
+
+			ssize_t ReadCount = pread(FileHandle, ReadDest, ReadSize, (off_t)(Offset + Result));
+			if(ReadCount < 0)
+			{
+				if(errno != EINTR)
+				{
+					// TODO logging
+					Handle->NoErrors = false;
+					break;
+				}
+			}
+			else if(ReadCount == 0)
+			{
+				break;
+			}
+			else
+			{
+				if(Bounce)
+				{
+					memcpy((uint8 *)Dest + Result, BounceBuffer, (size_t)ReadCount);
+				}
+				Result += (uint64)ReadCount;
+			}
+		}
+	}
+
+	return Result;
+}
+
+PLATFORM_CLOSE_FILE(LinuxCloseFile)
+{
+	int FileHandle = (int)(intptr_t)Handle->Platform;
+	if(FileHandle >= 0)
+	{
+		close(FileHandle);
+	}
+	Handle->NoErrors = false;
+	Handle->Platform = (void *)(intptr_t)-1;
+}
+
+internal void CatStrings(size_t SourceACount, char *SourceA,
+						 size_t SourceBCount, char *SourceB,
+						 size_t DestCount, char *Dest)
+{
+	for(size_t Index = 0; Index < SourceACount; Index++)
+	{
+		*Dest++ = *SourceA++;
+	}
+	for(size_t Index = 0; Index < SourceBCount; Index++)
+	{
+		*Dest++ = *SourceB++;
+	}
+	*Dest++ = 0;
+}
+
+internal void LinuxGetEXEFilename(linux_state *State)
+{
+	ssize_t SizeOfFilename = readlink("/proc/self/exe", State->EXEFilename, sizeof(State->EXEFilename) - 1);
+	State->EXEFilename[(SizeOfFilename > 0) ? SizeOfFilename : 0] = 0;
+	State->OnePastLastEXEFilenameSlash = State->EXEFilename;
+	for(char *Scan = State->EXEFilename; *Scan; ++Scan)
+	{
+		if(*Scan == '/')
+		{
+			State->OnePastLastEXEFilenameSlash = Scan + 1;
+		}
+	}
+}
+
+internal void LinuxBuildEXEPathFilename(linux_state *State, char *Filename, int DestCount, char *Dest)
+{
+	CatStrings(State->OnePastLastEXEFilenameSlash - State->EXEFilename, State->EXEFilename,
+			   strlen(Filename), Filename,
+			   DestCount, Dest);
+}
+
+//
+// NOTE: Game code
+//
+
+internal bool32 LinuxCopyFile(char *SourceName, char *DestName)
+{
+	bool32 Result = false;
+
+	int Source = open(SourceName, O_RDONLY);
+	if(Source >= 0)
+	{
+		int Dest = open(DestName, O_WRONLY | O_CREAT | O_TRUNC, 0755);
+		if(Dest >= 0)
+		{
+			Result = true;
+			uint8 Buffer[65536];
+			for(;;)
+			{
+				ssize_t ReadCount = read(Source, Buffer, sizeof(Buffer));
+				if(ReadCount == 0)
+				{
+					break;
+				}
+				if((ReadCount < 0) || (write(Dest, Buffer, ReadCount) != ReadCount))
+				{
+					Result = false;
+					break;
+				}
+			}
+			close(Dest);
+		}
+		close(Source);
+	}
+
+	return Result;
+}
+
+// NOTE: Loads from a copy so the build can overwrite the library while the old one is still mapped
+internal linux_game_code LinuxLoadGameCode(char *SourceSOName, char *TempSOName)
+{
+	linux_game_code Result = {};
+
+	if(LinuxCopyFile(SourceSOName, TempSOName))
+	{
+		Result.GameCodeSO = dlopen(TempSOName, RTLD_NOW | RTLD_LOCAL);
+	}
+	if(Result.GameCodeSO)
+	{
+		Result.UpdateAndRender = (game_update_and_render *)dlsym(Result.GameCodeSO, "GameUpdateAndRender");
+		Result.GetSoundSamples = (game_get_sound_samples *)dlsym(Result.GameCodeSO, "GameGetSoundSamples");
+
+		Result.IsValid = (Result.UpdateAndRender && Result.GetSoundSamples);
+	}
+
+	if(!Result.IsValid)
+	{
+		Result.UpdateAndRender = 0;
+		Result.GetSoundSamples = 0;
+	}
+
+	return Result;
+}
+
+internal void LinuxUnloadGameCode(linux_game_code *GameCode)
+{
+	if(GameCode->GameCodeSO)
+	{
+		dlclose(GameCode->GameCodeSO);
+		GameCode->GameCodeSO = 0;
+	}
+	GameCode->IsValid = false;
+	GameCode->UpdateAndRender = 0;
+	GameCode->GetSoundSamples = 0;
+}
+
+/*
+	NOTE: The watcher blocks on inotify for the library's directory, so nothing runs while the
+	game code is unchanged. Compilers and linkers can write the output more than once, so after
+	the first IN_CLOSE_WRITE/IN_MOVED_TO for the library it waits for a quiet period before
+	telling the main loop, which then swaps code between frames.
+*/
+#define LINUX_GAME_CODE_SETTLE_MILLISECONDS 20
+
+internal bool32 LinuxDrainGameCodeEvents(linux_game_code_watch *Watch)
+{
+	bool32 Result = false;
+
+	uint8 Buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	ssize_t Length = read(Watch->NotifyHandle, Buffer, sizeof(Buffer));
+	for(uint8 *At = Buffer; At < Buffer + Length; )
+	{
+		struct inotify_event *Event = (struct inotify_event *)At;
+		if(Event->len && (strcmp(Event->name, Watch->SOName) == 0))
+		{
+			Result = true;
+		}
+		At += sizeof(struct inotify_event) + Event->len;
+	}
+
+	return Result;
+}
+
+internal void *LinuxGameCodeWatchProc(void *Parameter)
+{
+	linux_game_code_watch *Watch = (linux_game_code_watch *)Parameter;
+	for(;;)
+	{
+		if(LinuxDrainGameCodeEvents(Watch))
+		{
+			uint64 LastWriteTime = LinuxGetWallClock();
+
+			struct pollfd PollHandle = {Watch->NotifyHandle, POLLIN, 0};
+			while(poll(&PollHandle, 1, LINUX_GAME_CODE_SETTLE_MILLISECONDS) > 0)
+			{
+				if(LinuxDrainGameCodeEvents(Watch))
+				{
+					LastWriteTime = LinuxGetWallClock();
+				}
+			}
+
+			Watch->LastWriteTime = LastWriteTime;
+			Watch->SignalTime = LinuxGetWallClock();
+			CompletePreviousWritesBeforeFutureWrites;
+			__sync_fetch_and_add(&Watch->ChangeCount, 1);
+		}
+	}
+
+	return 0;
+}
+
+internal bool32 LinuxBeginGameCodeWatch(linux_game_code_watch *Watch, char *SOPath)
+{
+	bool32 Result = false;
+
+	CatStrings(strlen(SOPath), SOPath, 0, "", sizeof(Watch->Directory), Watch->Directory);
+	char *LastSlash = strrchr(Watch->Directory, '/');
+	if(LastSlash)
+	{
+		*LastSlash = 0;
+		Watch->SOName = SOPath + (LastSlash - Watch->Directory) + 1;
+
+		Watch->NotifyHandle = inotify_init1(IN_CLOEXEC);
+		if((Watch->NotifyHandle >= 0) &&
+		   (inotify_add_watch(Watch->NotifyHandle, Watch->Directory, IN_CLOSE_WRITE | IN_MOVED_TO) >= 0))
+		{
+			pthread_t ThreadID;
+			Result = (pthread_create(&ThreadID, 0, LinuxGameCodeWatchProc, Watch) == 0);
+			if(Result)
+			{
+				pthread_detach(ThreadID);
+			}
+		}
+	}
+
+	return Result;
+}
+
+//
+// NOTE: Work queues
+//
+
+internal void LinuxAddEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
+{
+	uint32 NewNextEntryToWrite = (Queue->NextEntryToWrite + 1) % ArrayCount(Queue->Entries);
+	Assert(NewNextEntryToWrite != Queue->NextEntryToRead);
+	platform_work_queue_entry *Entry = Queue->Entries + Queue->NextEntryToWrite;
+	Entry->Callback = Callback;
+	Entry->Data = Data;
+	++Queue->CompletionGoal;
+
+	// NOTE: The entry has to be visible before other threads can see the new write index
+	CompletePreviousWritesBeforeFutureWrites;
+	Queue->NextEntryToWrite = NewNextEntryToWrite;
+	sem_post(&Queue->Semaphore);
+}
+
+internal bool32 LinuxDoNextWorkQueueEntry(platform_work_queue *Queue)
+{
+	bool32 WeShouldSleep = false;
+
+	uint32 OriginalNextEntryToRead = Queue->NextEntryToRead;
+	uint32 NewNextEntryToRead = (OriginalNextEntryToRead + 1) % ArrayCount(Queue->Entries);
+	if(OriginalNextEntryToRead != Queue->NextEntryToWrite)
+	{
+		uint32 Index = AtomicCompareExchangeUInt32(&Queue->NextEntryToRead,
+												   NewNextEntryToRead, OriginalNextEntryToRead);
+		if(Index == OriginalNextEntryToRead)
+		{
+			platform_work_queue_entry Entry = Queue->Entries[Index];
+			Entry.Callback(Queue, Entry.Data);
+			__sync_fetch_and_add(&Queue->CompletionCount, 1);
+		}
+	}
+	else
+	{
+		WeShouldSleep = true;
+	}
+
+	return WeShouldSleep;
+}
+
+internal void LinuxCompleteAllWork(platform_work_queue *Queue)
+{
+	while(Queue->CompletionGoal != Queue->CompletionCount)
+	{
+		LinuxDoNextWorkQueueEntry(Queue);
+	}
+
+	Queue->CompletionGoal = 0;
+	Queue->CompletionCount = 0;
+}
+
+internal void *LinuxWorkerThreadProc(void *Parameter)
+{
+	platform_work_queue *Queue = (platform_work_queue *)Parameter;
+	for(;;)
+	{
+		if(LinuxDoNextWorkQueueEntry(Queue))
+		{
+			sem_wait(&Queue->Semaphore);
+		}
+	}
+
+	return 0;
+}
+
+internal void LinuxMakeQueue(platform_work_queue *Queue, uint32 ThreadCount)
+{
+	Queue->CompletionGoal = 0;
+	Queue->CompletionCount = 0;
+	Queue->NextEntryToWrite = 0;
+	Queue->NextEntryToRead = 0;
+
+	uint32 InitialCount = 0;
+	sem_init(&Queue->Semaphore, 0, InitialCount);
+	for(uint32 ThreadIndex = 0; ThreadIndex < ThreadCount; ThreadIndex++)
+	{
+		pthread_t ThreadID;
+		pthread_create(&ThreadID, 0, LinuxWorkerThreadProc, Queue);
+		pthread_detach(ThreadID);
+	}
+}
+
+//
+// NOTE: Game memory
+//
+
+// NOTE: Older headers don't have it, older kernels turn it down and the commit goes ahead unpopulated
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+global_variable linux_commit_state GlobalCommit;
+
+internal PLATFORM_COMMIT_MEMORY(LinuxCommitMemory)
+{
+	uint64 Granularity = GlobalCommit.Granularity;
+	uint64 Start = (uint64)Base & ~(Granularity - 1);
+	uint64 End = ((uint64)Base + Size + Granularity - 1) & ~(Granularity - 1);
+	Start = Maximum(Start, (uint64)GlobalCommit.Base);
+	End = Minimum(End, (uint64)GlobalCommit.End);
+	bool32 Result = (mprotect((void *)Start, End - Start, PROT_READ | PROT_WRITE) == 0);
+	if(Result && ((uint8 *)Start < GlobalCommit.PopulateEnd))
+	{
+		madvise((void *)Start, End - Start, MADV_POPULATE_WRITE);
+	}
+
+	return Result;
+}
+
+global_variable char *LinuxCommitModeNames[] = {"eager", "lazy", "reserve"};
+
+internal bool32 LinuxParseCommitMode(char *Name, linux_commit_mode *CommitMode)
+{
+	bool32 Result = false;
+	for(uint32 ModeIndex = 0; ModeIndex < ArrayCount(LinuxCommitModeNames); ++ModeIndex)
+	{
+		if(strcmp(Name, LinuxCommitModeNames[ModeIndex]) == 0)
+		{
+			*CommitMode = (linux_commit_mode)ModeIndex;
+			Result = true;
+		}
+	}
+
+	return Result;
+}
+
+internal void *LinuxAllocateGameMemory(void *BaseAddress, uint64 Size, linux_commit_mode CommitMode)
+{
+	int Protection = PROT_READ | PROT_WRITE;
+	int Flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+	if(CommitMode == LinuxCommit_Eager)
+	{
+		Flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE;
+	}
+	else if(CommitMode == LinuxCommit_Reserve)
+	{
+		Protection = PROT_NONE;
+	}
+
+	void *Result = mmap(BaseAddress, Size, Protection, Flags, -1, 0);
+	if(Result == MAP_FAILED)
+	{
+		Result = 0;
+	}
+
+	return Result;
+}
+
+internal uint64 LinuxGetResidentBytes(void)
+{
+	uint64 Result = 0;
+
+	FILE *Statm = fopen("/proc/self/statm", "r");
+	if(Statm)
+	{
+		unsigned long long TotalPages, ResidentPages;
+		if(fscanf(Statm, "%llu %llu", &TotalPages, &ResidentPages) == 2)
+		{
+			Result = (uint64)ResidentPages*(uint64)sysconf(_SC_PAGESIZE);
+		}
+		fclose(Statm);
+	}
+
+	return Result;
+}
+
+//
+// NOTE: Input playback
+//
+
+internal bool32 LinuxBeginInputPlayback(linux_state *State, game_memory *Memory, char *Filename)
+{
+	bool32 Result = false;
+
+	thread_context Thread = {};
+	debug_read_file_result File = DEBUGPlatformReadEntireFile(&Thread, Filename);
+	if(File.Contents && BeginRecordingReader(&State->Player, File.Contents, File.ContentsSize))
+	{
+		recording_header *Header = State->Player.Header;
+		if((Header->MemoryBase == (uint64)State->GameMemoryBlock) && (Header->MemorySize == State->TotalSize) &&
+		   (Header->PermanentStorageSize == Memory->PermanentStorageSize))
+		{
+			// NOTE: A keyframe writes over all of game memory, zeroes included, and the arenas in it
+			// carry the commit sizes of the process that recorded it
+			if(Memory->PlatformCommitMemory)
+			{
+				Memory->PlatformCommitMemory(State->GameMemoryBlock, State->TotalSize);
+			}
+			State->PlaybackFile = File.Contents;
+			LoadRecordingKeyframe(&State->Player, 0, State->GameMemoryBlock);
+			Memory->IsInitialized = true;
+			Result = true;
+
+			// NOTE: Everything is committed now, and a commit's mprotect would make pages writable
+			// behind the dirty page tracker's back
+			Memory->PlatformCommitMemory = 0;
+
+			State->LoopStart = (uint8 *)mmap(0, State->TotalSize, PROT_READ | PROT_WRITE,
+											 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+			if(State->LoopStart != MAP_FAILED)
+			{
+				memcpy(State->LoopStart, State->GameMemoryBlock, State->TotalSize);
+				if(!BeginDirtyPageTracking(&State->DirtyPages, State->GameMemoryBlock, State->TotalSize))
+				{
+					munmap(State->LoopStart, State->TotalSize);
+					State->LoopStart = 0;
+				}
+			}
+			else
+			{
+				State->LoopStart = 0;
+			}
+			if(!State->LoopStart)
+			{
+				fprintf(stderr, "no dirty page tracking, every loop decompresses the first keyframe\n");
+			}
+		}
+	}
+
+	if(!Result)
+	{
+		DEBUGPlatformFreeFileMemory(&Thread, File.Contents);
+	}
+
+	return Result;
+}
+
+internal void LinuxPlayBackInput(linux_state *State, game_memory *Memory, game_input *NewInput)
+{
+	if(!ReadRecordedInput(&State->Player, NewInput))
+	{
+		// NOTE: hit the end of the stream, go back to beginning. Queued work writes game memory
+		// too, so it has to land before the dirty pages are collected.
+		LinuxCompleteAllWork(Memory->HighPriorityQueue);
+		LinuxCompleteAllWork(Memory->LowPriorityQueue);
+		if(State->LoopStart)
+		{
+			uint64 StartTime = LinuxGetWallClock();
+			dirty_page_tracker *DirtyPages = &State->DirtyPages;
+			CollectDirtyPages(DirtyPages);
+			State->LoopRestorePages += CopyDirtyPages(DirtyPages, LINUX_DIRTY_VIEW_LOOP,
+													  (uint8 *)State->GameMemoryBlock, State->LoopStart);
+			// NOTE: The copy wrote game memory back to how the loop started, no view needs to
+			// hear about that
+			CollectDirtyPages(DirtyPages);
+			ClearDirtyPages(DirtyPages, LINUX_DIRTY_VIEW_LOOP);
+			State->LoopRestoreTime += LinuxGetWallClock() - StartTime;
+			SetRecordingKeyframe(&State->Player, 0);
+		}
+		else
+		{
+			LoadRecordingKeyframe(&State->Player, 0, State->GameMemoryBlock);
+		}
+		++State->LoopCount;
+		ReadRecordedInput(&State->Player, NewInput);
+	}
+}
+
+//
+// NOTE: Synthetic input
+//
+
+// NOTE: xorshift32, the sequence only has to look random to the game
+internal uint32 LinuxNextSyntheticRandom(linux_synthetic_input *Synthetic)
+{
+	uint32 Value = Synthetic->RandomState;
+	Value ^= Value << 13;
+	Value ^= Value >> 17;
+	Value ^= Value << 5;
+	Synthetic->RandomState = Value;
+	return Value;
+}
+
+// NOTE: Uniform between half and one and a half times the mean, so over a run the events land at
+// every point in the frame
+internal uint64 LinuxNextSyntheticInterval(linux_synthetic_input *Synthetic)
+{
+	uint64 Result = Synthetic->MeanInterval/2 + (uint64)LinuxNextSyntheticRandom(Synthetic) % (Synthetic->MeanInterval + 1);
+	return Result;
+}
+
+internal void LinuxBeginSyntheticInput(linux_synthetic_input *Synthetic, real32 TransitionsPerSecond, uint64 Now)
+{
+	*Synthetic = {};
+	Synthetic->MeanInterval = (uint64)(1000000000.0f / TransitionsPerSecond);
+	Synthetic->RandomState = 0x9E3779B9;
+	Synthetic->HeldButtonIndex = -1;
+	Synthetic->NextEventTime = Now + LinuxNextSyntheticInterval(Synthetic);
+}
+
+// NOTE: Everything that happened up to Now goes into this frame's input, stamped with how far
+// into the frame it happened
+internal void LinuxGenerateSyntheticInput(linux_synthetic_input *Synthetic, game_input *Input, real32 SecondsPerFrame, uint64 Now)
+{
+	game_controller_input *Controller = GetController(Input, 0);
+	Controller->IsConnected = true;
+	for(uint32 ButtonIndex = 0; ButtonIndex < ArrayCount(Controller->Buttons); ++ButtonIndex)
+	{
+		Controller->Buttons[ButtonIndex].HalfTransitionCount = 0;
+	}
+	Input->EventCount = 0;
+	Input->EventsDropped = false;
+
+	while(Synthetic->NextEventTime <= Now)
+	{
+		uint64 EventTime = Synthetic->NextEventTime;
+		Synthetic->NextEventTime += LinuxNextSyntheticInterval(Synthetic);
+
+		// NOTE: Start first so the controller gets a player, then Move buttons pressed and let go
+		// one at a time
+		uint32 ButtonIndex;
+		bool32 IsDown;
+		if(Synthetic->TransitionCount < 2)
+		{
+			ButtonIndex = (uint32)(&Controller->Start - Controller->Buttons);
+			IsDown = (Synthetic->TransitionCount == 0);
+		}
+		else if(Synthetic->HeldButtonIndex >= 0)
+		{
+			ButtonIndex = (uint32)Synthetic->HeldButtonIndex;
+			IsDown = false;
+			Synthetic->HeldButtonIndex = -1;
+		}
+		else
+		{
+			ButtonIndex = (uint32)(&Controller->MoveUp - Controller->Buttons) + LinuxNextSyntheticRandom(Synthetic) % 4;
+			IsDown = true;
+			Synthetic->HeldButtonIndex = (int32)ButtonIndex;
+		}
+		++Synthetic->TransitionCount;
+
+		game_button_state *Button = Controller->Buttons + ButtonIndex;
+		Button->EndedDown = IsDown;
+		++Button->HalfTransitionCount;
+
+		real32 tFrame = SecondsPerFrame - LinuxGetSecondsElapsed(EventTime, Now);
+		tFrame = Maximum(tFrame, 0.0f);
+		if(PushInputEvent(Input, 0, ButtonIndex, IsDown, tFrame) &&
+		   (Synthetic->PendingCount < ArrayCount(Synthetic->PendingTimes)))
+		{
+			Synthetic->PendingTimes[Synthetic->PendingCount++] = EventTime;
+		}
+		else
+		{
+			++Synthetic->DroppedCount;
+		}
+	}
+}
+
+// NOTE: Called once the frame is out. A frame that ran no sim ticks hasn't simulated its input,
+// that waits for the next frame that does.
+internal void LinuxLandSyntheticInput(linux_synthetic_input *Synthetic, uint32 TickCount, uint64 PhotonTime)
+{
+	if(TickCount)
+	{
+		for(uint32 PendingIndex = 0; PendingIndex < Synthetic->PendingCount; ++PendingIndex)
+		{
+			uint64 Latency = PhotonTime - Synthetic->PendingTimes[PendingIndex];
+			uint32 Bucket = (uint32)Minimum(Latency / (1000*LINUX_LATENCY_BUCKET_MICROSECONDS), LINUX_LATENCY_BUCKET_COUNT - 1);
+			++Synthetic->LatencyHistogram[Bucket];
+			Synthetic->LatencySum += Latency;
+			Synthetic->MaxLatency = Maximum(Synthetic->MaxLatency, Latency);
+			++Synthetic->LandedCount;
+		}
+		Synthetic->PendingCount = 0;
+	}
+}
+
+// NOTE: Upper edge of the histogram bucket holding the given fraction of events, in microseconds
+internal uint32 LinuxSyntheticLatencyPercentile(linux_synthetic_input *Synthetic, real32 Fraction)
+{
+	uint32 Result = 0;
+	uint32 Wanted = (uint32)(Fraction*(real32)Synthetic->LandedCount);
+	uint32 Seen = 0;
+	for(uint32 Bucket = 0; Bucket < LINUX_LATENCY_BUCKET_COUNT; Bucket++)
+	{
+		Seen += Synthetic->LatencyHistogram[Bucket];
+		Result = (Bucket + 1)*LINUX_LATENCY_BUCKET_MICROSECONDS;
+		if(Seen >= Wanted)
+		{
+			break;
+		}
+	}
+
+	return Result;
+}
+
+//
+// NOTE: Sound output
+//
+
+#define LINUX_SOUND_PERIOD_FRAMES 256
+
+#pragma pack(push, 1)
+struct linux_wav_header
+{
+	uint32 RIFFID;
+	uint32 Size;
+	uint32 WAVEID;
+	uint32 FormatID;
+	uint32 FormatSize;
+	uint16 FormatTag;
+	uint16 Channels;
+	uint32 SamplesPerSec;
+	uint32 AvgBytesPerSec;
+	uint16 BlockAlign;
+	uint16 BitsPerSample;
+	uint32 DataID;
+	uint32 DataSize;
+};
+#pragma pack(pop)
+
+internal void LinuxWriteWAVHeader(linux_sound_output *SoundOutput)
+{
+	linux_wav_header Header = {};
+	Header.RIFFID = 0x46464952;
+	Header.Size = (uint32)(sizeof(Header) - 8) + SoundOutput->FileDataBytes;
+	Header.WAVEID = 0x45564157;
+	Header.FormatID = 0x20746d66;
+	Header.FormatSize = 16;
+	Header.FormatTag = 1;
+	Header.Channels = 2;
+	Header.SamplesPerSec = SoundOutput->SamplesPerSecond;
+	Header.AvgBytesPerSec = SoundOutput->SamplesPerSecond*2*sizeof(int16);
+	Header.BlockAlign = 2*sizeof(int16);
+	Header.BitsPerSample = 16;
+	Header.DataID = 0x61746164;
+	Header.DataSize = SoundOutput->FileDataBytes;
+
+	fseek(SoundOutput->File, 0, SEEK_SET);
+	fwrite(&Header, sizeof(Header), 1, SoundOutput->File);
+	fseek(SoundOutput->File, 0, SEEK_END);
+}
+
+internal void *LinuxSoundThreadProc(void *Parameter)
+{
+	linux_sound_output *SoundOutput = (linux_sound_output *)Parameter;
+
+	int16 Period[2*LINUX_SOUND_PERIOD_FRAMES];
+	uint64 PeriodNanoseconds = (1000000000ull*SoundOutput->PeriodFrames) / SoundOutput->SamplesPerSecond;
+	uint64 Deadline = FramePacerGetClock() + PeriodNanoseconds;
+	while(SoundOutput->Running)
+	{
+		FramePacerSleepUntil(Deadline);
+		Deadline += PeriodNanoseconds;
+
+		TIMED_BLOCK("Sound period");
+		SoundRingRead(&SoundOutput->Ring, Period, SoundOutput->PeriodFrames);
+		if(SoundOutput->File)
+		{
+			fwrite(Period, 2*sizeof(int16), SoundOutput->PeriodFrames, SoundOutput->File);
+			SoundOutput->FileDataBytes += SoundOutput->PeriodFrames*2*sizeof(int16);
+		}
+	}
+
+	return 0;
+}
+
+internal bool32 LinuxBeginSoundOutput(linux_sound_output *SoundOutput, char *Sink, real32 LatencySeconds)
+{
+	bool32 Result = true;
+
+	*SoundOutput = {};
+	SoundOutput->SamplesPerSecond = 48000;
+	SoundOutput->PeriodFrames = LINUX_SOUND_PERIOD_FRAMES;
+	SoundOutput->TargetQueuedFrames = (uint32)(LatencySeconds*(real32)SoundOutput->SamplesPerSecond);
+	SoundOutput->MinQueuedBeforeTopUp = 0xFFFFFFFF;
+
+	// NOTE: Room for the target plus a whole game frame's worth of slack on top
+	uint32 FrameCapacity = 4096;
+	while(FrameCapacity < 2*SoundOutput->TargetQueuedFrames)
+	{
+		FrameCapacity *= 2;
+	}
+	InitializeSoundRing(&SoundOutput->Ring, FrameCapacity, (int16 *)malloc(FrameCapacity*2*sizeof(int16)));
+	SoundOutput->MixSamples = (int16 *)malloc(FrameCapacity*2*sizeof(int16));
+
+	if(strcmp(Sink, "null") != 0)
+	{
+		SoundOutput->File = fopen(Sink, "wb");
+		if(SoundOutput->File)
+		{
+			LinuxWriteWAVHeader(SoundOutput);
+		}
+		else
+		{
+			Result = false;
+		}
+	}
+
+	if(Result)
+	{
+		SoundOutput->Running = true;
+		Result = (pthread_create(&SoundOutput->Thread, 0, LinuxSoundThreadProc, SoundOutput) == 0);
+	}
+
+	return Result;
+}
+
+internal void LinuxEndSoundOutput(linux_sound_output *SoundOutput)
+{
+	SoundOutput->Running = false;
+	pthread_join(SoundOutput->Thread, 0);
+	if(SoundOutput->File)
+	{
+		LinuxWriteWAVHeader(SoundOutput);
+		fclose(SoundOutput->File);
+	}
+}
+
+// NOTE: Game thread, once per frame. Mixes whatever the sound thread drained since last time.
+internal void LinuxFillSoundOutput(linux_sound_output *SoundOutput, linux_game_code *Game,
+								   thread_context *Thread, game_memory *Memory)
+{
+	TIMED_FUNCTION();
+
+	// NOTE: The first top up starts from empty, that one doesn't say anything about the slack
+	uint32 Queued = SoundRingQueuedFrames(&SoundOutput->Ring);
+	if(SoundOutput->TopUpCount)
+	{
+		SoundOutput->MinQueuedBeforeTopUp = Minimum(SoundOutput->MinQueuedBeforeTopUp, Queued);
+	}
+	if(Queued < SoundOutput->TargetQueuedFrames)
+	{
+		game_sound_output_buffer SoundBuffer = {};
+		SoundBuffer.SamplesPerSecond = SoundOutput->SamplesPerSecond;
+		SoundBuffer.SampleCount = (int)(SoundOutput->TargetQueuedFrames - Queued);
+		SoundBuffer.Samples = SoundOutput->MixSamples;
+		Game->GetSoundSamples(Thread, Memory, &SoundBuffer);
+		Queued += SoundRingWrite(&SoundOutput->Ring, SoundBuffer.Samples, (uint32)SoundBuffer.SampleCount);
+	}
+	++SoundOutput->TopUpCount;
+	SoundOutput->QueuedAfterTopUpSum += Queued;
+}
+
+//
+// NOTE: Profiling
+//
+
+#if HANDMADE_PROFILE
+internal debug_profile *LinuxBeginProfile(game_memory *Memory)
+{
+	debug_profile *Result = 0;
+
+	void *Table = mmap(0, sizeof(debug_table), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	void *Profile = mmap(0, sizeof(debug_profile), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if((Table != MAP_FAILED) && (Profile != MAP_FAILED))
+	{
+		Result = (debug_profile *)Profile;
+		InitializeProfile(Result, (debug_table *)Table);
+
+		// NOTE: The host records into the table through its own copy of the global
+		GlobalDebugTable = (debug_table *)Table;
+		Memory->DebugTable = (debug_table *)Table;
+		UpdateProfileClockRate(Result, FramePacerGetClock());
+		MeasureTimedBlockOverhead(Result);
+		UpdateProfileClockRate(Result, FramePacerGetClock());
+	}
+
+	return Result;
+}
+
+internal void LinuxPrintProfile(debug_profile *Profile)
+{
+	local_persist char Report[65536];
+	FormatProfileReport(Profile, Report, sizeof(Report));
+	fputs(Report, stdout);
+	fflush(stdout);
+	ResetProfile(Profile);
+}
+
+internal void LinuxPrintMemoryTelemetry(game_memory *Memory)
+{
+	char Report[1024];
+	FormatMemoryTelemetry(&Memory->Telemetry, Report, sizeof(Report));
+	fputs(Report, stdout);
+	fflush(stdout);
+}
+
+global_variable sig_atomic_t volatile GlobalTraceRequested;
+
+internal void LinuxRequestTrace(int Signal)
+{
+	GlobalTraceRequested = 1;
+}
+
+internal bool32 LinuxWriteTrace(trace_dump *Dump, char *Filename)
+{
+	bool32 Result = false;
+	FILE *File = fopen(Filename, "wb");
+	if(File)
+	{
+		Result = true;
+		char Buffer[65536];
+		uint32 Size;
+		while((Size = FormatTraceDump(Dump, Buffer, sizeof(Buffer))) != 0)
+		{
+			Result &= (fwrite(Buffer, 1, Size, File) == Size);
+		}
+		Result &= (fclose(File) == 0);
+	}
+
+	return Result;
+}
+
+internal void *LinuxTraceWriterProc(void *Parameter)
+{
+	linux_trace_writer *Writer = (linux_trace_writer *)Parameter;
+	Writer->Succeeded = LinuxWriteTrace(&Writer->Dump, Writer->Filename);
+
+	CompletePreviousWritesBeforeFutureWrites;
+	Writer->Done = true;
+	return 0;
+}
+
+internal void LinuxBeginTraceWriter(linux_trace_writer *Writer, debug_profile *Profile)
+{
+	BeginTraceDump(&Writer->Dump, Profile);
+	Writer->Done = false;
+	Writer->Busy = true;
+	if(pthread_create(&Writer->Thread, 0, LinuxTraceWriterProc, Writer) != 0)
+	{
+		// NOTE: No thread to spare, the frame takes the hit instead
+		Writer->Thread = 0;
+		LinuxTraceWriterProc(Writer);
+	}
+}
+
+internal void LinuxEndTraceWriter(linux_trace_writer *Writer)
+{
+	if(Writer->Busy)
+	{
+		if(Writer->Thread)
+		{
+			pthread_join(Writer->Thread, 0);
+		}
+		Writer->Busy = false;
+		Writer->Thread = 0;
+
+		trace_dump *Dump = &Writer->Dump;
+		if(Writer->Succeeded)
+		{
+			printf("Wrote %u timed blocks to %s, %u overwritten before they were written\n",
+				   Dump->BlockCount, Writer->Filename, Dump->LostCount);
+		}
+		else
+		{
+			printf("could not write the trace to %s\n", Writer->Filename);
+		}
+		fflush(stdout);
+	}
+}
+#endif
+
+int main(int ArgCount, char **Args)
+{
+	uint64 StartTime = LinuxGetWallClock();
+	linux_state LinuxState = {};
+	LinuxGetEXEFilename(&LinuxState);
+
+	char *PlaybackFilename = 0;
+	real32 GameUpdateHz = 30.0f;
+	real32 GameSimHz = 0.0f;
+	uint32 FrameLimit = 0;
+	char *SoundSink = 0;
+	real32 SoundLatencyMS = 50.0f;
+	uint32 StallMS = 0;
+	uint32 StallEvery = 30;
+	int32 ProfileEvery = -1;
+	char *TraceFilename = 0;
+	int32 MemoryEvery = -1;
+	linux_commit_mode CommitMode = LinuxCommit_Lazy;
+	bool32 PopulatePermanent = false;
+	bool32 UseLargePages = false;
+	real32 SyntheticInputHz = 0.0f;
+	for(int ArgIndex = 1; ArgIndex < ArgCount; ArgIndex++)
+	{
+		char *Arg = Args[ArgIndex];
+		if((strcmp(Arg, "-play") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			PlaybackFilename = Args[++ArgIndex];
+		}
+		else if((strcmp(Arg, "-hz") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			GameUpdateHz = (real32)atof(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-simhz") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			GameSimHz = (real32)atof(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-frames") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			FrameLimit = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-audio") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			SoundSink = Args[++ArgIndex];
+		}
+		else if((strcmp(Arg, "-latency") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			SoundLatencyMS = (real32)atof(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-stall") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			StallMS = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-stallevery") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			StallEvery = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-profile") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			// NOTE: Maximum evaluates its arguments twice, so parse before clamping
+			ProfileEvery = atoi(Args[++ArgIndex]);
+			ProfileEvery = Maximum(ProfileEvery, 0);
+		}
+		else if((strcmp(Arg, "-trace") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			TraceFilename = Args[++ArgIndex];
+		}
+		else if((strcmp(Arg, "-memory") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			MemoryEvery = atoi(Args[++ArgIndex]);
+			MemoryEvery = Maximum(MemoryEvery, 0);
+		}
+		else if((strcmp(Arg, "-commit") == 0) && (ArgIndex + 1 < ArgCount) &&
+				LinuxParseCommitMode(Args[ArgIndex + 1], &CommitMode))
+		{
+			++ArgIndex;
+		}
+		else if(strcmp(Arg, "-populate") == 0)
+		{
+			PopulatePermanent = true;
+		}
+		else if(strcmp(Arg, "-hugepages") == 0)
+		{
+			UseLargePages = true;
+		}
+		else if((strcmp(Arg, "-syntheticinput") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			SyntheticInputHz = (real32)atof(Args[++ArgIndex]);
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-play <recording.hmi>] [-hz N] [-simhz N] [-frames N]\n"
+					"       [-audio null|<out.wav>] [-latency MS] [-stall MS] [-stallevery N] [-profile N]\n"
+					"       [-trace <out.json>] [-memory N] [-commit eager|lazy|reserve] [-populate] [-hugepages]\n"
+					"       [-syntheticinput N]\n", Args[0]);
+			return 2;
+		}
+	}
+	if(GameUpdateHz <= 0.0f)
+	{
+		GameUpdateHz = 30.0f;
+	}
+	real32 TargetSecondsPerFrame = 1.0f / GameUpdateHz;
+	real32 SimSecondsPerTick = (GameSimHz > 0.0f) ? (1.0f / GameSimHz) : 0.0f;
+
+	char SourceGameCodeSOFullPath[LINUX_STATE_FILE_NAME_COUNT];
+	LinuxBuildEXEPathFilename(&LinuxState, "handmade.so", sizeof(SourceGameCodeSOFullPath), SourceGameCodeSOFullPath);
+	char TempGameCodeSOFullPath[LINUX_STATE_FILE_NAME_COUNT];
+	LinuxBuildEXEPathFilename(&LinuxState, "handmade_temp.so", sizeof(TempGameCodeSOFullPath), TempGameCodeSOFullPath);
+
+	uint32 WorkerThreadCount = (uint32)sysconf(_SC_NPROCESSORS_ONLN);
+	WorkerThreadCount = (WorkerThreadCount > 1) ? (WorkerThreadCount - 1) : 1;
+	platform_work_queue HighPriorityQueue = {};
+	LinuxMakeQueue(&HighPriorityQueue, WorkerThreadCount);
+	platform_work_queue LowPriorityQueue = {};
+	LinuxMakeQueue(&LowPriorityQueue, 2);
+
+#if HANDMADE_INTERNAL
+	void *BaseAddress = (void *)Terabytes((uint64)2);
+#else
+	void *BaseAddress = 0;
+#endif
+
+	game_memory GameMemory = {};
+	GameMemory.PermanentStorageSize = Megabytes(64);
+	GameMemory.TransientStorageSize = Gigabytes((uint64)1);
+	GameMemory.HighPriorityQueue = &HighPriorityQueue;
+	GameMemory.LowPriorityQueue = &LowPriorityQueue;
+	GameMemory.PlatformAddEntry = LinuxAddEntry;
+	GameMemory.PlatformCompleteAllWork = LinuxCompleteAllWork;
+	GameMemory.DEBUGPlatformFreeFileMemory = DEBUGPlatformFreeFileMemory;
+	GameMemory.DEBUGPlatformReadEntireFile = DEBUGPlatformReadEntireFile;
+	GameMemory.DEBUGPlatformWriteEntireFile = DEBUGPlatformWriteEntireFile;
+	GameMemory.PlatformOpenFile = LinuxOpenFile;
+	GameMemory.PlatformReadDataFromFile = LinuxReadDataFromFile;
+	GameMemory.PlatformCloseFile = LinuxCloseFile;
+
+	LinuxState.TotalSize = GameMemory.PermanentStorageSize + GameMemory.TransientStorageSize;
+	LinuxState.CommitMode = CommitMode;
+	LinuxState.GameMemoryBlock = LinuxAllocateGameMemory(BaseAddress, LinuxState.TotalSize, CommitMode);
+	if(!LinuxState.GameMemoryBlock)
+	{
+		fprintf(stderr, "could not allocate game memory\n");
+		return 1;
+	}
+	GameMemory.PermanentStorage = LinuxState.GameMemoryBlock;
+	GameMemory.TransientStorage = ((uint8 *)GameMemory.PermanentStorage + GameMemory.PermanentStorageSize);
+	if(CommitMode == LinuxCommit_Reserve)
+	{
+		GameMemory.PlatformCommitMemory = LinuxCommitMemory;
+		GlobalCommit.Base = (uint8 *)LinuxState.GameMemoryBlock;
+		GlobalCommit.End = GlobalCommit.Base + LinuxState.TotalSize;
+		GlobalCommit.Granularity = (uint64)sysconf(_SC_PAGESIZE);
+		if(PopulatePermanent)
+		{
+			GlobalCommit.PopulateEnd = (uint8 *)GameMemory.PermanentStorage + GameMemory.PermanentStorageSize;
+		}
+	}
+	if(UseLargePages)
+	{
+		if(AdviseLargePages(LinuxState.GameMemoryBlock, LinuxState.TotalSize))
+		{
+			GlobalCommit.Granularity = LARGE_PAGE_SIZE;
+		}
+		else
+		{
+			fprintf(stderr, "no transparent huge pages for game memory\n");
+		}
+	}
+
+	game_offscreen_buffer Buffer = {};
+	Buffer.Width = 960;
+	Buffer.Height = 540;
+	Buffer.BytesPerPixel = 4;
+	Buffer.Pitch = Buffer.Width*Buffer.BytesPerPixel;
+	if(UseLargePages)
+	{
+		large_page_backing BufferBacking;
+		Buffer.Memory = AllocateLargePages(Buffer.Pitch*Buffer.Height, &BufferBacking);
+		printf("Framebuffer on %s\n", LargePageBackingNames[BufferBacking]);
+	}
+	else
+	{
+		Buffer.Memory = mmap(0, Buffer.Pitch*Buffer.Height, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+
+	if(PlaybackFilename && !LinuxBeginInputPlayback(&LinuxState, &GameMemory, PlaybackFilename))
+	{
+		fprintf(stderr, "%s: not a recording this host can play back\n", PlaybackFilename);
+		return 1;
+	}
+
+	linux_game_code_watch GameCodeWatch = {};
+	if(!LinuxBeginGameCodeWatch(&GameCodeWatch, SourceGameCodeSOFullPath))
+	{
+		fprintf(stderr, "could not watch %s, hot reload is off\n", SourceGameCodeSOFullPath);
+	}
+	uint32 SeenGameCodeChangeCount = GameCodeWatch.ChangeCount;
+
+	linux_game_code Game = LinuxLoadGameCode(SourceGameCodeSOFullPath, TempGameCodeSOFullPath);
+	if(!Game.IsValid)
+	{
+		fprintf(stderr, "Loaded game code is invalid!\n");
+	}
+
+#if HANDMADE_PROFILE
+	debug_profile *Profile = 0;
+	linux_trace_writer TraceWriter = {};
+	TraceWriter.Filename = TraceFilename;
+	if((ProfileEvery >= 0) || TraceFilename)
+	{
+		Profile = LinuxBeginProfile(&GameMemory);
+		if(!Profile)
+		{
+			fprintf(stderr, "could not allocate the profile, profiling is off\n");
+		}
+	}
+	if(Profile && TraceFilename)
+	{
+		signal(SIGUSR1, LinuxRequestTrace);
+	}
+#else
+	if((ProfileEvery >= 0) || TraceFilename)
+	{
+		fprintf(stderr, "built without HANDMADE_PROFILE, -profile and -trace do nothing\n");
+	}
+#endif
+
+	linux_sound_output SoundOutput = {};
+	if(SoundSink && !LinuxBeginSoundOutput(&SoundOutput, SoundSink, SoundLatencyMS / 1000.0f))
+	{
+		fprintf(stderr, "could not start sound output to %s\n", SoundSink);
+		return 1;
+	}
+
+	game_input Input = {};
+	thread_context Thread = {};
+	uint64 ReloadWriteTime = 0;
+	uint64 ReloadSignalTime = 0;
+	uint64 ReloadStartTime = 0;
+	uint64 ReloadLoadedTime = 0;
+	uint64 FirstFrameEndTime = 0;
+
+	linux_synthetic_input SyntheticInput = {};
+	if(SyntheticInputHz > 0.0f)
+	{
+		if(LinuxState.PlaybackFile)
+		{
+			fprintf(stderr, "-syntheticinput does nothing while playing back a recording\n");
+		}
+		else
+		{
+			LinuxBeginSyntheticInput(&SyntheticInput, SyntheticInputHz, LinuxGetWallClock());
+		}
+	}
+
+	frame_pacer Pacer;
+	BeginFramePacer(&Pacer, TargetSecondsPerFrame);
+	GlobalRunning = true;
+	for(uint32 FrameIndex = 0; GlobalRunning; FrameIndex++)
+	{
+		if(FrameLimit && (FrameIndex >= FrameLimit))
+		{
+			break;
+		}
+
+		// NOTE: Only a counter compare per frame, the watcher thread does the waiting
+		uint32 GameCodeChangeCount = GameCodeWatch.ChangeCount;
+		if(GameCodeChangeCount != SeenGameCodeChangeCount)
+		{
+			CompletePreviousReadsBeforeFutureReads;
+			SeenGameCodeChangeCount = GameCodeChangeCount;
+			ReloadWriteTime = GameCodeWatch.LastWriteTime;
+			ReloadSignalTime = GameCodeWatch.SignalTime;
+			ReloadStartTime = LinuxGetWallClock();
+
+			// NOTE: Queued work may still be running code from the old library
+			LinuxCompleteAllWork(&HighPriorityQueue);
+			LinuxCompleteAllWork(&LowPriorityQueue);
+
+#if HANDMADE_PROFILE
+			if(Profile)
+			{
+				CollateDebugEventsBeforeUnload(Profile);
+			}
+#endif
+			LinuxUnloadGameCode(&Game);
+			Game = LinuxLoadGameCode(SourceGameCodeSOFullPath, TempGameCodeSOFullPath);
+			if(!Game.IsValid)
+			{
+				fprintf(stderr, "Loaded game code is invalid!\n");
+			}
+			ReloadLoadedTime = LinuxGetWallClock();
+		}
+
+		BEGIN_BLOCK("Input");
+		if(LinuxState.PlaybackFile)
+		{
+			LinuxPlayBackInput(&LinuxState, &GameMemory, &Input);
+		}
+		else if(SyntheticInput.MeanInterval)
+		{
+			LinuxGenerateSyntheticInput(&SyntheticInput, &Input, TargetSecondsPerFrame, LinuxGetWallClock());
+		}
+		END_BLOCK();
+		Input.dtForFrame = TargetSecondsPerFrame;
+		Input.SimSecondsPerTick = SimSecondsPerTick;
+
+		if(Game.UpdateAndRender)
+		{
+			Game.UpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+		}
+		if(FrameIndex == 0)
+		{
+			FirstFrameEndTime = LinuxGetWallClock();
+		}
+		if(SoundOutput.Running && Game.GetSoundSamples)
+		{
+			LinuxFillSoundOutput(&SoundOutput, &Game, &Thread, &GameMemory);
+		}
+		if(StallMS && StallEvery && ((FrameIndex % StallEvery) == (StallEvery - 1)))
+		{
+			TIMED_BLOCK("Stall");
+			usleep(1000*StallMS);
+		}
+
+		if(ReloadWriteTime)
+		{
+			uint64 FirstNewFrameTime = LinuxGetWallClock();
+			printf("Reloaded game code: %.2fms from last write to end of first new frame "
+				   "(settle %.2fms, wait for frame %.2fms, load %.2fms, frame %.2fms)\n",
+				   1000.0f*LinuxGetSecondsElapsed(ReloadWriteTime, FirstNewFrameTime),
+				   1000.0f*LinuxGetSecondsElapsed(ReloadWriteTime, ReloadSignalTime),
+				   1000.0f*LinuxGetSecondsElapsed(ReloadSignalTime, ReloadStartTime),
+				   1000.0f*LinuxGetSecondsElapsed(ReloadStartTime, ReloadLoadedTime),
+				   1000.0f*LinuxGetSecondsElapsed(ReloadLoadedTime, FirstNewFrameTime));
+			fflush(stdout);
+			ReloadWriteTime = 0;
+		}
+
+		BEGIN_BLOCK("Frame wait");
+		FramePacerWait(&Pacer);
+		END_BLOCK();
+
+		if(SyntheticInput.MeanInterval)
+		{
+			LinuxLandSyntheticInput(&SyntheticInput, GameMemory.Telemetry.TickCount, LinuxGetWallClock());
+		}
+
+		if((MemoryEvery > 0) && (((FrameIndex + 1) % (uint32)MemoryEvery) == 0))
+		{
+			LinuxPrintMemoryTelemetry(&GameMemory);
+		}
+
+#if HANDMADE_PROFILE
+		if(Profile)
+		{
+			CollateDebugFrame(Profile);
+			UpdateProfileClockRate(Profile, FramePacerGetClock());
+			if((ProfileEvery > 0) && (Profile->FrameCount >= (uint32)ProfileEvery))
+			{
+				LinuxPrintProfile(Profile);
+			}
+
+			if(TraceWriter.Busy && TraceWriter.Done)
+			{
+				LinuxEndTraceWriter(&TraceWriter);
+			}
+			if(GlobalTraceRequested && !TraceWriter.Busy)
+			{
+				GlobalTraceRequested = 0;
+				LinuxBeginTraceWriter(&TraceWriter, Profile);
+			}
+		}
+#endif
+	}
+
+	printf("Frame pacing over %u frames: lateness p50 %uus p90 %uus p99 %uus max %uus, "
+		   "%u overslept, sleep margin %uus\n",
+		   Pacer.FrameCount, FramePacerPercentile(&Pacer.Lateness, 0.5f), FramePacerPercentile(&Pacer.Lateness, 0.9f),
+		   FramePacerPercentile(&Pacer.Lateness, 0.99f), (uint32)(Pacer.Lateness.Max / 1000),
+		   Pacer.OversleptCount, (uint32)(Pacer.SleepMargin / 1000));
+	printf("  %u missed: overrun p50 %uus p90 %uus max %uus\n",
+		   Pacer.MissedCount, FramePacerPercentile(&Pacer.MissedLateness, 0.5f),
+		   FramePacerPercentile(&Pacer.MissedLateness, 0.9f), (uint32)(Pacer.MissedLateness.Max / 1000));
+	printf("  frame time (target %uus): p50 %uus p90 %uus p99 %uus max %uus\n",
+		   (uint32)(Pacer.TargetNanoseconds / 1000), FramePacerPercentile(&Pacer.FrameTime, 0.5f),
+		   FramePacerPercentile(&Pacer.FrameTime, 0.9f), FramePacerPercentile(&Pacer.FrameTime, 0.99f),
+		   (uint32)(Pacer.FrameTime.Max / 1000));
+
+	if(SyntheticInput.MeanInterval)
+	{
+		printf("Input to photon latency over %u events: p50 %.1fms p90 %.1fms p99 %.1fms max %.1fms, "
+			   "mean %.1fms, %u dropped, %u not simulated yet\n",
+			   SyntheticInput.LandedCount, 0.001f*(real32)LinuxSyntheticLatencyPercentile(&SyntheticInput, 0.5f),
+			   0.001f*(real32)LinuxSyntheticLatencyPercentile(&SyntheticInput, 0.9f),
+			   0.001f*(real32)LinuxSyntheticLatencyPercentile(&SyntheticInput, 0.99f),
+			   (real32)SyntheticInput.MaxLatency / 1000000.0f,
+			   (real32)SyntheticInput.LatencySum / (1000000.0f*(real32)Maximum(SyntheticInput.LandedCount, 1)),
+			   SyntheticInput.DroppedCount, SyntheticInput.PendingCount);
+	}
+
+	if(LinuxState.LoopCount && LinuxState.LoopStart)
+	{
+		printf("Playback looped %u times: %.1f dirty pages and %.3fms to restore the start per loop\n",
+			   LinuxState.LoopCount, (real64)LinuxState.LoopRestorePages / (real64)LinuxState.LoopCount,
+			   (real64)LinuxState.LoopRestoreTime / (1000000.0*(real64)LinuxState.LoopCount));
+	}
+
+	if(SoundOutput.Running)
+	{
+		LinuxEndSoundOutput(&SoundOutput);
+
+		real32 MSPerFrame = 1000.0f / (real32)SoundOutput.SamplesPerSecond;
+		real32 AverageQueued = (real32)SoundOutput.QueuedAfterTopUpSum / (real32)Maximum(SoundOutput.TopUpCount, 1);
+		printf("Sound output: latency %.1fms queued + %.1fms period, lowest queue before top up %.1fms, "
+			   "%u underruns (%.1fms of silence)\n",
+			   AverageQueued*MSPerFrame, (real32)SoundOutput.PeriodFrames*MSPerFrame,
+			   (real32)SoundOutput.MinQueuedBeforeTopUp*MSPerFrame,
+			   SoundOutput.Ring.UnderrunCount, (real32)SoundOutput.Ring.UnderrunFrames*MSPerFrame);
+	}
+
+	if(MemoryEvery >= 0)
+	{
+		LinuxPrintMemoryTelemetry(&GameMemory);
+	}
+
+	struct rusage Usage;
+	getrusage(RUSAGE_SELF, &Usage);
+	printf("Game memory: %s commit of %.0fMB, %.2fms from start to end of first frame, "
+		   "resident %.1fMB at exit, %.1fMB peak, %.1fMB on transparent huge pages\n",
+		   LinuxCommitModeNames[LinuxState.CommitMode], (real64)LinuxState.TotalSize / (1024.0*1024.0),
+		   1000.0f*LinuxGetSecondsElapsed(StartTime, FirstFrameEndTime),
+		   (real64)LinuxGetResidentBytes() / (1024.0*1024.0), (real64)Usage.ru_maxrss / 1024.0,
+		   (real64)GetLargePageResidentBytes() / (1024.0*1024.0));
+
+#if HANDMADE_PROFILE
+	if(Profile && (ProfileEvery >= 0) && Profile->FrameCount)
+	{
+		LinuxPrintProfile(Profile);
+	}
+	if(Profile && TraceFilename)
+	{
+		LinuxEndTraceWriter(&TraceWriter);
+		BeginTraceDump(&TraceWriter.Dump, Profile);
+		TraceWriter.Succeeded = LinuxWriteTrace(&TraceWriter.Dump, TraceFilename);
+		TraceWriter.Busy = true;
+		LinuxEndTraceWriter(&TraceWriter);
+	}
+#endif
+
+	LinuxUnloadGameCode(&Game);
+
+	return 0;
+}
@@ -0,0 +1,176 @@
+#ifndef LINUX_HANDMADE_H
+
+#define LINUX_STATE_FILE_NAME_COUNT 4096
+
+struct linux_game_code
+{
+	void *GameCodeSO;
+
+	// NOTE: Either of the function pointers can be NULL, you must check before
+	// calling.
+	game_update_and_render *UpdateAndRender;
+	game_get_sound_samples *GetSoundSamples;
+
+	bool32 IsValid;
+};
+
+/*
+	NOTE: Written by the watcher thread, read by the main loop between frames. ChangeCount only
+	moves once the library has stopped being written, and the times are CLOCK_MONOTONIC
+	nanoseconds so the main loop can tell how long the reload took end to end.
+*/
+struct linux_game_code_watch
+{
+	char Directory[LINUX_STATE_FILE_NAME_COUNT];
+	char *SOName;
+	int NotifyHandle;
+
+	uint32 volatile ChangeCount;
+	uint64 volatile LastWriteTime;
+	uint64 volatile SignalTime;
+};
+
+struct platform_work_queue_entry
+{
+	platform_work_queue_callback *Callback;
+	void *Data;
+};
+
+struct platform_work_queue
+{
+	uint32 volatile CompletionGoal;
+	uint32 volatile CompletionCount;
+
+	uint32 volatile NextEntryToWrite;
+	uint32 volatile NextEntryToRead;
+	sem_t Semaphore;
+
+	platform_work_queue_entry Entries[256];
+};
+
+/*
+	NOTE: Sound output without a device. The sound thread drains the ring one period at a time on
+	its own clock, as a device would, and either drops the samples or appends them to a WAV file.
+	The Queued* stats are taken by the game thread each time it tops the ring up.
+*/
+struct linux_sound_output
+{
+	sound_ring Ring;
+	uint32 SamplesPerSecond;
+	uint32 PeriodFrames;
+	uint32 TargetQueuedFrames;
+	int16 *MixSamples;
+
+	FILE *File;
+	uint32 FileDataBytes;
+
+	bool32 volatile Running;
+	pthread_t Thread;
+
+	uint32 TopUpCount;
+	uint32 MinQueuedBeforeTopUp;
+	uint64 QueuedAfterTopUpSum;
+};
+
+/*
+	NOTE: Synthetic input for -syntheticinput. Button transitions on the keyboard controller at
+	random times, each stamped with when it happened and picked up by the next frame's input like
+	a real key would be. An event's latency runs from that stamp to the end of the frame wait of
+	the first frame that simulated it, where a real host would flip.
+*/
+#define LINUX_LATENCY_BUCKET_MICROSECONDS 100
+#define LINUX_LATENCY_BUCKET_COUNT 1024
+#define LINUX_MAX_PENDING_INPUT_EVENTS 256
+
+struct linux_synthetic_input
+{
+	// NOTE: Mean nanoseconds between transitions, 0 when synthetic input is off
+	uint64 MeanInterval;
+	uint64 NextEventTime;
+	uint32 RandomState;
+	uint32 TransitionCount;
+	// NOTE: The Move button a press left down, or -1
+	int32 HeldButtonIndex;
+
+	// NOTE: When the events handed to the game but not yet simulated happened
+	uint32 PendingCount;
+	uint64 PendingTimes[LINUX_MAX_PENDING_INPUT_EVENTS];
+
+	uint32 LandedCount;
+	uint32 DroppedCount;
+	uint64 LatencySum;
+	uint64 MaxLatency;
+	// NOTE: The last bucket also holds everything later than the histogram covers
+	uint32 LatencyHistogram[LINUX_LATENCY_BUCKET_COUNT];
+};
+
+#if HANDMADE_PROFILE
+/*
+	NOTE: Writes a trace dump to a file on a thread of its own, the game thread only starts it
+	and joins it once Done is set.
+*/
+struct linux_trace_writer
+{
+	char *Filename;
+	trace_dump Dump;
+	bool32 Succeeded;
+
+	bool32 Busy;
+	bool32 volatile Done;
+	pthread_t Thread;
+};
+#endif
+
+enum linux_commit_mode
+{
+	// NOTE: Every page faulted in at startup, what committing all of game memory up front costs
+	LinuxCommit_Eager,
+	// NOTE: Mapped readable and writable, the kernel fills pages in on first touch
+	LinuxCommit_Lazy,
+	// NOTE: Mapped PROT_NONE, the game commits what it uses through PlatformCommitMemory
+	LinuxCommit_Reserve,
+};
+
+/*
+	NOTE: What LinuxCommitMemory works from in -commit reserve, set before the game first runs.
+	Commits are rounded out to Granularity, the page size, or a whole huge page when game memory is
+	marked for them, since a huge page only gets used where a 2MB aligned stretch is all committed
+	when it is first touched. They never reach outside [Base, End). Commits that start below
+	PopulateEnd are faulted in on the spot rather than page by page as the game touches them, with
+	-populate that is the permanent storage, which the game walks every frame.
+*/
+struct linux_commit_state
+{
+	uint8 *Base;
+	uint8 *End;
+	uint64 Granularity;
+	uint8 *PopulateEnd;
+};
+
+// NOTE: Which bit of dirty_page_tracker.Views each consumer of game memory's dirty pages reads
+#define LINUX_DIRTY_VIEW_LOOP 0
+
+struct linux_state
+{
+	uint64 TotalSize;
+	void *GameMemoryBlock;
+	linux_commit_mode CommitMode;
+
+	void *PlaybackFile;
+	recording_reader Player;
+
+	// NOTE: Game memory as keyframe 0 left it, and what the loop has written since
+	// (handmade_dirty_pages.h). Null when there was no room for it or tracking failed, then every
+	// wrap decompresses keyframe 0 again.
+	uint8 *LoopStart;
+	dirty_page_tracker DirtyPages;
+	uint32 LoopCount;
+	uint64 LoopRestorePages;
+	uint64 LoopRestoreTime;
+
+	char EXEFilename[LINUX_STATE_FILE_NAME_COUNT];
+	char *OnePastLastEXEFilenameSlash;
+};
+
+#define LINUX_HANDMADE_H
+#endif
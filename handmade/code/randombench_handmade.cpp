@@ -0,0 +1,418 @@
+/*
+	NOTE: Checks and throughput for the random number generator (handmade_random.h)
+
+	randombench_handmade [-draws N]
+
+	The checks come first, each a line of check,value,limit,result, and the exit code is 1 if any
+	of them fails. They draw from fixed seeds, so they come out the same on every run.
+
+	chi_square_high    the top 8 bits of N draws sorted into 256 buckets, over four seeds, against
+	chi_square_low     the 0.1% critical value for 255 degrees of freedom, and the same for the
+	                   low 8 bits
+	unilateral_mean    mean and variance of N RandomUnilateral draws against 1/2 and 1/12, within
+	unilateral_var     five standard errors, with every draw in [0, 1)
+	bilateral_mean     the same for RandomBilateral against 0 and 1/3, every draw in [-1, 1)
+	bilateral_var
+	seek               RandomSeek to every position of a 4096 draw stream, forwards and backwards,
+	                   gives the draw that was made there
+	batch_uint32       RandomFillUInt32, RandomFillUnilateral and RandomFillBilateral against the
+	batch_unilateral   same count of single draws, bit for bit, for every count up to 67 from
+	batch_bilateral    several starting positions, and the series ends up at the same position
+	between            RandomBetween stays inside small and extreme ranges, Min == Max included,
+	                   hits every value of a small one and doesn't trap on the whole int32 range
+
+	Then the throughput, in nanoseconds per number over N numbers, of the 4096 entry table the
+	generator replaced (refilled here with generator output, it was read the same way, one index
+	that wraps), single draws and the SSE2 fills. The table stays in cache, as it did in the game.
+*/
+
+#if _WIN32
+#define _CRT_SECURE_NO_WARNINGS
+#include <windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "handmade.cpp"
+#include "handmade_frame_pacer.h"
+
+#define RANDOMBENCH_TABLE_COUNT 4096
+#define RANDOMBENCH_BATCH_COUNT 4096
+
+// NOTE: The table as it was, one index into a fixed array that wraps at the end
+struct randombench_table_series
+{
+	uint32 NextIndex;
+};
+
+global_variable uint32 RandomBenchTable[RANDOMBENCH_TABLE_COUNT];
+
+inline uint32 RandomBenchTableNext(randombench_table_series *Series)
+{
+	uint32 Result = RandomBenchTable[Series->NextIndex++];
+	if(Series->NextIndex >= RANDOMBENCH_TABLE_COUNT)
+	{
+		Series->NextIndex = 0;
+	}
+
+	return Result;
+}
+
+internal bool32 RandomBenchReport(char *Name, real64 Value, real64 Limit, bool32 Passed)
+{
+	printf("%s,%.6f,%.6f,%s\n", Name, Value, Limit, Passed ? "pass" : "FAIL");
+	if(!Passed)
+	{
+		fprintf(stderr, "%s failed: %f against %f\n", Name, Value, Limit);
+	}
+
+	return Passed;
+}
+
+//
+// NOTE: Checks
+//
+
+internal bool32 RandomBenchChiSquare(uint32 DrawCount)
+{
+	// NOTE: 0.1% critical value of chi square with 255 degrees of freedom
+	real64 Limit = 330.52;
+
+	bool32 Result = true;
+	char *Names[] = {"chi_square_high", "chi_square_low"};
+	for(uint32 ShiftIndex = 0; ShiftIndex < ArrayCount(Names); ++ShiftIndex)
+	{
+		real64 WorstChiSquare = 0.0;
+		for(uint32 Seed = 0; Seed < 4; ++Seed)
+		{
+			uint32 Buckets[256] = {};
+			random_series Series = RandomSeed(Seed*7919 + 1);
+			for(uint32 DrawIndex = 0; DrawIndex < DrawCount; ++DrawIndex)
+			{
+				uint32 Draw = RandomNextUInt32(&Series);
+				++Buckets[ShiftIndex ? (Draw & 0xFF) : (Draw >> 24)];
+			}
+
+			real64 Expected = (real64)DrawCount / 256.0;
+			real64 ChiSquare = 0.0;
+			for(uint32 BucketIndex = 0; BucketIndex < ArrayCount(Buckets); ++BucketIndex)
+			{
+				real64 Difference = (real64)Buckets[BucketIndex] - Expected;
+				ChiSquare += Difference*Difference / Expected;
+			}
+			WorstChiSquare = Maximum(WorstChiSquare, ChiSquare);
+		}
+
+		if(!RandomBenchReport(Names[ShiftIndex], WorstChiSquare, Limit, WorstChiSquare < Limit))
+		{
+			Result = false;
+		}
+	}
+
+	return Result;
+}
+
+internal bool32 RandomBenchMoments(uint32 DrawCount)
+{
+	char *MeanNames[] = {"unilateral_mean", "bilateral_mean"};
+	char *VarianceNames[] = {"unilateral_var", "bilateral_var"};
+
+	bool32 Result = true;
+	for(uint32 Bilateral = 0; Bilateral < 2; ++Bilateral)
+	{
+		random_series Series = RandomSeed(42);
+		real64 Sum = 0.0;
+		real64 SumOfSquares = 0.0;
+		bool32 InRange = true;
+		for(uint32 DrawIndex = 0; DrawIndex < DrawCount; ++DrawIndex)
+		{
+			real32 Draw = Bilateral ? RandomBilateral(&Series) : RandomUnilateral(&Series);
+			InRange = InRange && (Draw >= (Bilateral ? -1.0f : 0.0f)) && (Draw < 1.0f);
+			Sum += Draw;
+			SumOfSquares += (real64)Draw*(real64)Draw;
+		}
+
+		// NOTE: Uniform on [A, B) has variance (B - A)^2/12 and fourth central moment (B - A)^4/80
+		real64 Width = Bilateral ? 2.0 : 1.0;
+		real64 ExpectedMean = Bilateral ? 0.0 : 0.5;
+		real64 ExpectedVariance = Width*Width / 12.0;
+		real64 FourthMoment = Width*Width*Width*Width / 80.0;
+		real64 Mean = Sum / (real64)DrawCount;
+		real64 Variance = SumOfSquares / (real64)DrawCount - Mean*Mean;
+		real64 MeanLimit = 5.0*sqrt(ExpectedVariance / (real64)DrawCount);
+		real64 VarianceLimit = 5.0*sqrt((FourthMoment - ExpectedVariance*ExpectedVariance) / (real64)DrawCount);
+
+		bool32 MeanPassed = InRange && (fabs(Mean - ExpectedMean) < MeanLimit);
+		bool32 VariancePassed = InRange && (fabs(Variance - ExpectedVariance) < VarianceLimit);
+		if(!RandomBenchReport(MeanNames[Bilateral], Mean - ExpectedMean, MeanLimit, MeanPassed))
+		{
+			Result = false;
+		}
+		if(!RandomBenchReport(VarianceNames[Bilateral], Variance - ExpectedVariance, VarianceLimit, VariancePassed))
+		{
+			Result = false;
+		}
+	}
+
+	return Result;
+}
+
+internal bool32 RandomBenchSeek(void)
+{
+	uint32 *Stream = (uint32 *)malloc(RANDOMBENCH_TABLE_COUNT*sizeof(uint32));
+	random_series Series = RandomSeed(1234);
+	for(uint32 Index = 0; Index < RANDOMBENCH_TABLE_COUNT; ++Index)
+	{
+		Stream[Index] = RandomNextUInt32(&Series);
+	}
+
+	uint32 MismatchCount = 0;
+	for(uint32 Step = 0; Step < 2*RANDOMBENCH_TABLE_COUNT; ++Step)
+	{
+		uint32 Position = (Step < RANDOMBENCH_TABLE_COUNT) ? Step : (2*RANDOMBENCH_TABLE_COUNT - 1 - Step);
+		RandomSeek(&Series, Position);
+		if((RandomNextUInt32(&Series) != Stream[Position]) || (Series.Counter != Position + 1))
+		{
+			++MismatchCount;
+		}
+	}
+	free(Stream);
+
+	bool32 Result = RandomBenchReport("seek", (real64)MismatchCount, 0.0, MismatchCount == 0);
+	return Result;
+}
+
+internal bool32 RandomBenchBatches(void)
+{
+	uint32 StartPositions[] = {0, 1, 3, 4097, 0xFFFFFFF0};
+	uint32 MismatchCounts[3] = {};
+	for(uint32 StartIndex = 0; StartIndex < ArrayCount(StartPositions); ++StartIndex)
+	{
+		for(uint32 Count = 0; Count <= 67; ++Count)
+		{
+			uint32 Batch[68];
+			uint32 Single[68];
+			for(uint32 FillIndex = 0; FillIndex < 3; ++FillIndex)
+			{
+				random_series BatchSeries = RandomSeed(99);
+				random_series SingleSeries = BatchSeries;
+				RandomSeek(&BatchSeries, StartPositions[StartIndex]);
+				RandomSeek(&SingleSeries, StartPositions[StartIndex]);
+
+				if(FillIndex == 0)
+				{
+					RandomFillUInt32(&BatchSeries, Count, Batch);
+				}
+				else if(FillIndex == 1)
+				{
+					RandomFillUnilateral(&BatchSeries, Count, (real32 *)Batch);
+				}
+				else
+				{
+					RandomFillBilateral(&BatchSeries, Count, (real32 *)Batch);
+				}
+				for(uint32 Index = 0; Index < Count; ++Index)
+				{
+					if(FillIndex == 0)
+					{
+						Single[Index] = RandomNextUInt32(&SingleSeries);
+					}
+					else
+					{
+						real32 Draw = (FillIndex == 1) ? RandomUnilateral(&SingleSeries) : RandomBilateral(&SingleSeries);
+						memcpy(Single + Index, &Draw, sizeof(Draw));
+					}
+				}
+
+				if((memcmp(Batch, Single, Count*sizeof(uint32)) != 0) || (BatchSeries.Counter != SingleSeries.Counter))
+				{
+					++MismatchCounts[FillIndex];
+				}
+			}
+		}
+	}
+
+	bool32 Result = true;
+	char *Names[] = {"batch_uint32", "batch_unilateral", "batch_bilateral"};
+	for(uint32 FillIndex = 0; FillIndex < ArrayCount(Names); ++FillIndex)
+	{
+		if(!RandomBenchReport(Names[FillIndex], (real64)MismatchCounts[FillIndex], 0.0, MismatchCounts[FillIndex] == 0))
+		{
+			Result = false;
+		}
+	}
+
+	return Result;
+}
+
+internal bool32 RandomBenchBetween(void)
+{
+	struct between_range
+	{
+		int32 Min;
+		int32 Max;
+	};
+	between_range Ranges[] =
+	{
+		{-3, 3},
+		{5, 5},
+		{INT32_MIN, INT32_MIN},
+		{INT32_MAX - 2, INT32_MAX},
+		{INT32_MIN, INT32_MIN + 2},
+		{-1, INT32_MAX},
+		{INT32_MIN, 0},
+		{INT32_MIN, INT32_MAX},
+	};
+
+	uint32 FailureCount = 0;
+	random_series Series = RandomSeed(7);
+	for(uint32 RangeIndex = 0; RangeIndex < ArrayCount(Ranges); ++RangeIndex)
+	{
+		between_range Range = Ranges[RangeIndex];
+		bool32 Hit[7] = {};
+		for(uint32 DrawIndex = 0; DrawIndex < 10000; ++DrawIndex)
+		{
+			int32 Draw = RandomBetween(&Series, Range.Min, Range.Max);
+			if((Draw < Range.Min) || (Draw > Range.Max))
+			{
+				++FailureCount;
+			}
+			else if(RangeIndex == 0)
+			{
+				Hit[Draw - Range.Min] = true;
+			}
+		}
+
+		if(RangeIndex == 0)
+		{
+			for(uint32 HitIndex = 0; HitIndex < ArrayCount(Hit); ++HitIndex)
+			{
+				FailureCount += !Hit[HitIndex];
+			}
+		}
+	}
+
+	bool32 Result = RandomBenchReport("between", (real64)FailureCount, 0.0, FailureCount == 0);
+	return Result;
+}
+
+//
+// NOTE: Throughput
+//
+
+internal void RandomBenchThroughput(uint32 DrawCount)
+{
+	random_series Series = RandomSeed(1);
+	for(uint32 Index = 0; Index < RANDOMBENCH_TABLE_COUNT; ++Index)
+	{
+		RandomBenchTable[Index] = RandomNextUInt32(&Series);
+	}
+	uint32 *Batch = (uint32 *)malloc(RANDOMBENCH_BATCH_COUNT*sizeof(uint32));
+
+	char *Names[] = {"table", "scalar_uint32", "batch_uint32", "scalar_unilateral", "batch_unilateral"};
+	printf("\ngenerator,numbers,ns_per_number\n");
+	for(uint32 NameIndex = 0; NameIndex < ArrayCount(Names); ++NameIndex)
+	{
+		// NOTE: Everything drawn gets folded into Sink so none of it can be thrown away
+		uint32 volatile Sink = 0;
+		uint32 Fold = 0;
+		randombench_table_series TableSeries = {};
+		random_series Series = RandomSeed(2);
+		uint64 Start = FramePacerGetClock();
+		switch(NameIndex)
+		{
+			case 0:
+			{
+				for(uint32 DrawIndex = 0; DrawIndex < DrawCount; ++DrawIndex)
+				{
+					Fold += RandomBenchTableNext(&TableSeries);
+				}
+			} break;
+
+			case 1:
+			{
+				for(uint32 DrawIndex = 0; DrawIndex < DrawCount; ++DrawIndex)
+				{
+					Fold += RandomNextUInt32(&Series);
+				}
+			} break;
+
+			case 2:
+			{
+				for(uint32 DrawIndex = 0; DrawIndex < DrawCount; DrawIndex += RANDOMBENCH_BATCH_COUNT)
+				{
+					RandomFillUInt32(&Series, RANDOMBENCH_BATCH_COUNT, Batch);
+					Fold += Batch[DrawIndex % RANDOMBENCH_BATCH_COUNT];
+				}
+			} break;
+
+			case 3:
+			{
+				real32 Sum = 0.0f;
+				for(uint32 DrawIndex = 0; DrawIndex < DrawCount; ++DrawIndex)
+				{
+					Sum += RandomUnilateral(&Series);
+				}
+				Fold = (uint32)Sum;
+			} break;
+
+			case 4:
+			{
+				for(uint32 DrawIndex = 0; DrawIndex < DrawCount; DrawIndex += RANDOMBENCH_BATCH_COUNT)
+				{
+					RandomFillUnilateral(&Series, RANDOMBENCH_BATCH_COUNT, (real32 *)Batch);
+					Fold += Batch[DrawIndex % RANDOMBENCH_BATCH_COUNT];
+				}
+			} break;
+		}
+		uint64 Nanoseconds = FramePacerGetClock() - Start;
+		Sink = Fold;
+
+		printf("%s,%u,%.3f\n", Names[NameIndex], DrawCount, (real64)Nanoseconds / (real64)DrawCount);
+		fprintf(stderr, "%-18s %6.3f ns per number\n", Names[NameIndex], (real64)Nanoseconds / (real64)DrawCount);
+	}
+
+	free(Batch);
+}
+
+int main(int ArgCount, char **Args)
+{
+	uint32 DrawCount = 16*1024*1024;
+	for(int ArgIndex = 1; ArgIndex < ArgCount; ArgIndex++)
+	{
+		char *Arg = Args[ArgIndex];
+		if((strcmp(Arg, "-draws") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			DrawCount = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else
+		{
+			DrawCount = 0;
+			break;
+		}
+	}
+	if(DrawCount < 65536)
+	{
+		fprintf(stderr, "usage: %s [-draws N], N at least 65536\n", Args[0]);
+		return 2;
+	}
+
+	printf("check,value,limit,result\n");
+	bool32 Passed = true;
+	Passed = RandomBenchChiSquare(DrawCount) && Passed;
+	Passed = RandomBenchMoments(DrawCount) && Passed;
+	Passed = RandomBenchSeek() && Passed;
+	Passed = RandomBenchBatches() && Passed;
+	Passed = RandomBenchBetween() && Passed;
+	fprintf(stderr, "checks %s\n", Passed ? "passed" : "FAILED");
+	fflush(stdout);
+
+	RandomBenchThroughput(DrawCount);
+
+	int Result = Passed ? 0 : 1;
+	return Result;
+}
@@ -0,0 +1,745 @@
+/*
+	NOTE: Headless replay runner
+
+	Loads a loop_edit_*_input.hmi recording, restores its first keyframe and runs every recorded
+	frame through GameUpdateAndRender as fast as it will go, rendering into an offscreen buffer
+	that is never shown. Per frame it prints the time spent in the game and a hash of the used game
+	state and of the framebuffer, so the same recording doubles as a perf benchmark and as a
+	determinism check.
+
+	replay_handmade <recording.hmi> [-runs N] [-width W] [-height H] [-simhz N] [-quiet] [-profile]
+				   [-trace <out.json>] [-memory]
+
+	With -runs above 1 every later run is checked frame by frame against the first one, and the
+	exit code is 1 if any hash differs.
+
+	-simhz overrides the recorded simulation tick rate while the frames stay at the recorded rate,
+	which is how the cost of ticking faster or slower than rendering is measured. 0 steps the
+	simulation once per frame.
+
+	-profile collects the game's timed blocks and prints the call tree after every run. The timings
+	then include the blocks' own cost, which the report estimates. -trace writes the timed blocks of
+	the last few hundred frames as Chrome trace JSON once every run is done.
+
+	-memory prints the game's arena usage and peaks and its resident tile chunks after every run.
+	Peaks are kept in game memory, so they include whatever the recording's keyframe was holding.
+
+	replay_handmade -roundtrip <frames> [-save <out.hmi>] [-width W] [-height H] [-simhz N]
+
+	-roundtrip records the given number of frames of scripted input itself, then plays them back
+	from the start and from seeks, and exits 1 if any frame comes out different from when it was
+	recorded. -save also writes that recording out, which is how recordings are made on Linux.
+
+	The game is linked in directly rather than loaded from the DLL, and runs single threaded since
+	no work queues are handed to it.
+*/
+
+#if _WIN32
+#define _CRT_SECURE_NO_WARNINGS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "handmade.cpp"
+#include "handmade_recording.h"
+#include "handmade_profiler.h"
+#include "handmade_telemetry.h"
+
+struct replay_frame
+{
+	uint64 Microseconds;
+	uint64 StateHash;
+	uint64 FrameHash;
+};
+
+//
+// NOTE: Platform bits
+//
+
+internal void *ReplayAllocateGameMemory(uint64 BaseAddress, uint64 Size)
+{
+	void *Result = 0;
+#if _WIN32
+	Result = VirtualAlloc((LPVOID)BaseAddress, (SIZE_T)Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	// NOTE: Without MAP_FIXED the address is only a hint, which is checked below instead of
+	// letting the mapping clobber something already there
+	Result = mmap((void *)BaseAddress, Size, PROT_READ | PROT_WRITE,
+				  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if(Result == MAP_FAILED)
+	{
+		Result = 0;
+	}
+#endif
+	if(Result && ((uint64)Result != BaseAddress))
+	{
+		// TODO free the misplaced block, the runner exits right after anyway
+		Result = 0;
+	}
+
+	return Result;
+}
+
+internal uint64 ReplayGetMicroseconds(void)
+{
+	uint64 Result;
+#if _WIN32
+	LARGE_INTEGER Frequency;
+	LARGE_INTEGER Counter;
+	QueryPerformanceFrequency(&Frequency);
+	QueryPerformanceCounter(&Counter);
+	Result = (uint64)((Counter.QuadPart*1000000) / Frequency.QuadPart);
+#else
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	Result = (uint64)Time.tv_sec*1000000 + (uint64)(Time.tv_nsec / 1000);
+#endif
+
+	return Result;
+}
+
+internal void *ReplayReadEntireFile(char *Filename, uint64 *Size)
+{
+	void *Result = 0;
+	FILE *File = fopen(Filename, "rb");
+	if(File)
+	{
+		fseek(File, 0, SEEK_END);
+		long FileSize = ftell(File);
+		fseek(File, 0, SEEK_SET);
+		if(FileSize > 0)
+		{
+			Result = malloc(FileSize);
+			if(Result && (fread(Result, 1, FileSize, File) == (size_t)FileSize))
+			{
+				*Size = (uint64)FileSize;
+			}
+			else
+			{
+				free(Result);
+				Result = 0;
+			}
+		}
+		fclose(File);
+	}
+
+	return Result;
+}
+
+DEBUG_PLATFORM_FREE_FILE_MEMORY(DEBUGPlatformFreeFileMemory)
+{
+	free(Memory);
+}
+
+DEBUG_PLATFORM_READ_ENTIRE_FILE(DEBUGPlatformReadEntireFile)
+{
+	debug_read_file_result Result = {};
+
+	uint64 Size = 0;
+	Result.Contents = ReplayReadEntireFile(Filename, &Size);
+	if(Result.Contents)
+	{
+		Result.ContentsSize = SafeTruncateUInt64(Size);
+	}
+
+	return Result;
+}
+
+DEBUG_PLATFORM_WRITE_ENTIRE_FILE(DEBUGPlatformWriteEntireFile)
+{
+	bool32 Result = false;
+	FILE *File = fopen(Filename, "wb");
+	if(File)
+	{
+		Result = (fwrite(Memory, 1, MemorySize, File) == MemorySize);
+		fclose(File);
+	}
+
+	return Result;
+}
+
+//
+// NOTE: Hashing
+//
+
+internal uint64 ReplayHash(uint64 Hash, void *Memory, memory_index Size)
+{
+	uint8 *At = (uint8 *)Memory;
+	while(Size >= sizeof(uint64))
+	{
+		uint64 Word;
+		memcpy(&Word, At, sizeof(Word));
+		Hash = (Hash ^ Word)*0x9e3779b97f4a7c15ull;
+		Hash ^= Hash >> 29;
+		At += sizeof(uint64);
+		Size -= sizeof(uint64);
+	}
+	while(Size--)
+	{
+		Hash = (Hash ^ *At++)*0x9e3779b97f4a7c15ull;
+		Hash ^= Hash >> 29;
+	}
+
+	return Hash;
+}
+
+// NOTE: Only the used parts of the arenas count, hashing all of game memory per frame would swamp the timings
+internal uint64 ReplayHashGameState(game_memory *Memory)
+{
+	game_state *GameState = (game_state *)Memory->PermanentStorage;
+	transient_state *TranState = (transient_state *)Memory->TransientStorage;
+
+	uint64 Result = 0xcbf29ce484222325ull;
+	Result = ReplayHash(Result, GameState, sizeof(*GameState));
+	// NOTE: The chunk arena is carved out of WorldArena and counted as used there whole, so it's only
+	// hashed as far as it is used itself
+	memory_arena *ChunkArena = &GameState->World->ChunkArena;
+	uint8 *ChunkArenaEnd = ChunkArena->Base + ChunkArena->Size;
+	uint8 *WorldArenaEnd = GameState->WorldArena.Base + GameState->WorldArena.Used;
+	Result = ReplayHash(Result, GameState->WorldArena.Base, ChunkArena->Base - GameState->WorldArena.Base);
+	Result = ReplayHash(Result, ChunkArena->Base, ChunkArena->Used);
+	Result = ReplayHash(Result, ChunkArenaEnd, WorldArenaEnd - ChunkArenaEnd);
+	Result = ReplayHash(Result, TranState, sizeof(*TranState));
+	Result = ReplayHash(Result, TranState->TranArena.Base, TranState->TranArena.Used);
+
+	return Result;
+}
+
+internal int ReplayCompareMicroseconds(const void *A, const void *B)
+{
+	uint64 ValueA = *(uint64 *)A;
+	uint64 ValueB = *(uint64 *)B;
+	int Result = (ValueA < ValueB) ? -1 : ((ValueA > ValueB) ? 1 : 0);
+	return Result;
+}
+
+//
+// NOTE: Round trip
+//
+
+struct replay_file_buffer
+{
+	uint8 *Base;
+	uint64 Size;
+	uint64 Capacity;
+};
+
+internal uint8 *ReplayReserve(replay_file_buffer *Buffer, uint64 Size)
+{
+	if(Buffer->Size + Size > Buffer->Capacity)
+	{
+		uint64 Capacity = Maximum(Buffer->Capacity*2, Buffer->Size + Size);
+		Buffer->Base = (uint8 *)realloc(Buffer->Base, (size_t)Capacity);
+		Assert(Buffer->Base);
+		Buffer->Capacity = Capacity;
+	}
+
+	uint8 *Result = Buffer->Base + Buffer->Size;
+	return Result;
+}
+
+internal void ReplayAppend(replay_file_buffer *Buffer, void *Data, uint64 Size)
+{
+	memcpy(ReplayReserve(Buffer, Size), Data, (size_t)Size);
+	Buffer->Size += Size;
+}
+
+// NOTE: Start pressed and let go first so the controller gets a player, then the Move buttons held
+// in turn with their events spread over the frame, and the mouse sweeping the window
+internal void ReplayScriptInput(uint32 FrameIndex, game_input *Input, int Width, int Height)
+{
+	game_controller_input *Controller = GetController(Input, 0);
+	Controller->IsConnected = true;
+	for(uint32 ButtonIndex = 0; ButtonIndex < ArrayCount(Controller->Buttons); ++ButtonIndex)
+	{
+		Controller->Buttons[ButtonIndex].HalfTransitionCount = 0;
+	}
+	Input->EventCount = 0;
+	Input->EventsDropped = false;
+
+	game_button_state *MoveButtons[] =
+	{
+		&Controller->MoveRight, &Controller->MoveDown, &Controller->MoveLeft, &Controller->MoveUp,
+	};
+	uint32 HeldIndex = (FrameIndex / 45) % ArrayCount(MoveButtons);
+	if(FrameIndex < 3)
+	{
+		HeldIndex = ArrayCount(MoveButtons);
+	}
+	for(uint32 MoveIndex = 0; MoveIndex < ArrayCount(MoveButtons); ++MoveIndex)
+	{
+		game_button_state *Button = MoveButtons[MoveIndex];
+		bool32 IsDown = (MoveIndex == HeldIndex);
+		if(Button->EndedDown != IsDown)
+		{
+			Button->EndedDown = IsDown;
+			++Button->HalfTransitionCount;
+			real32 tFrame = Input->dtForFrame*(real32)((FrameIndex*7 + MoveIndex) % 10) / 10.0f;
+			PushInputEvent(Input, 0, (uint32)(Button - Controller->Buttons), IsDown, tFrame);
+		}
+	}
+
+	if(FrameIndex < 3)
+	{
+		bool32 IsDown = (FrameIndex == 0);
+		if(Controller->Start.EndedDown != IsDown)
+		{
+			Controller->Start.EndedDown = IsDown;
+			++Controller->Start.HalfTransitionCount;
+			PushInputEvent(Input, 0, (uint32)(&Controller->Start - Controller->Buttons), IsDown, 0.0f);
+		}
+	}
+
+	Input->MouseX = (int32)((FrameIndex*7) % (uint32)Width);
+	Input->MouseY = (int32)((FrameIndex*3) % (uint32)Height);
+}
+
+/*
+	NOTE: Plays the game on scripted input for FrameCount frames while recording it to memory the way
+	the platform layers do, then plays the recording back from its first keyframe and from a seek to
+	a few frames on either side of keyframe boundaries, checking the state and framebuffer hash of
+	every frame played back against the one recorded. That runs input frame coding, snapshot
+	compression and SeekRecording end to end. With SaveFilename the recording is also written out,
+	at the same address linux_handmade -play restores it to.
+*/
+internal int ReplayRoundTrip(uint32 FrameCount, char *SaveFilename, int Width, int Height, real32 SimHz)
+{
+	game_memory GameMemory = {};
+	GameMemory.PermanentStorageSize = Megabytes(64);
+	GameMemory.TransientStorageSize = Gigabytes((uint64)1);
+	uint64 TotalSize = GameMemory.PermanentStorageSize + GameMemory.TransientStorageSize;
+	void *GameMemoryBlock = ReplayAllocateGameMemory(Terabytes((uint64)2), TotalSize);
+	if(!GameMemoryBlock)
+	{
+		fprintf(stderr, "could not map %llu bytes of game memory at 0x%llx\n",
+				(unsigned long long)TotalSize, (unsigned long long)Terabytes((uint64)2));
+		return 2;
+	}
+	GameMemory.PermanentStorage = GameMemoryBlock;
+	GameMemory.TransientStorage = (uint8 *)GameMemoryBlock + GameMemory.PermanentStorageSize;
+	GameMemory.DEBUGPlatformFreeFileMemory = DEBUGPlatformFreeFileMemory;
+	GameMemory.DEBUGPlatformReadEntireFile = DEBUGPlatformReadEntireFile;
+	GameMemory.DEBUGPlatformWriteEntireFile = DEBUGPlatformWriteEntireFile;
+
+	game_offscreen_buffer Buffer = {};
+	Buffer.Width = Width;
+	Buffer.Height = Height;
+	Buffer.BytesPerPixel = 4;
+	Buffer.Pitch = Width*Buffer.BytesPerPixel;
+	Buffer.Memory = calloc(1, (size_t)Buffer.Pitch*Height);
+	memory_index BufferSize = (memory_index)Buffer.Pitch*Height;
+	thread_context Thread = {};
+
+	game_input Input = {};
+	Input.dtForFrame = 1.0f / 30.0f;
+	Input.SimSecondsPerTick = (SimHz > 0.0f) ? (1.0f / SimHz) : 0.0f;
+	GetController(&Input, 0)->IsConnected = true;
+
+	// NOTE: Recording starts once the game is initialized, like it does on the platforms
+	GameUpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+	memset(Buffer.Memory, 0, BufferSize);
+
+	uint32 KeyframeCapacity = FrameCount / RECORDING_KEYFRAME_INTERVAL + 1;
+	recording_keyframe *Keyframes = (recording_keyframe *)calloc(KeyframeCapacity, sizeof(recording_keyframe));
+	recording_writer Writer;
+	BeginRecordingWriter(&Writer, GameMemoryBlock, TotalSize, GameMemory.PermanentStorageSize, KeyframeCapacity, Keyframes);
+
+	replay_file_buffer File = {};
+	ReplayReserve(&File, sizeof(recording_header));
+	File.Size = sizeof(recording_header);
+
+	replay_frame *Recorded = (replay_frame *)calloc(FrameCount, sizeof(replay_frame));
+	uint64 SnapshotMicroseconds = 0;
+	uint64 RecordStart = ReplayGetMicroseconds();
+	for(uint32 FrameIndex = 0; FrameIndex < FrameCount; FrameIndex++)
+	{
+		if(RecordingNeedsKeyframe(&Writer))
+		{
+			uint64 SnapshotStart = ReplayGetMicroseconds();
+			BeginRecordingKeyframe(&Writer);
+			for(uint64 Offset = 0; Offset < TotalSize; Offset += RECORDING_SNAPSHOT_BLOCK_SIZE)
+			{
+				uint64 BlockSize = Minimum(RECORDING_SNAPSHOT_BLOCK_SIZE, TotalSize - Offset);
+				uint8 *Dest = ReplayReserve(&File, RECORDING_MAX_SNAPSHOT_BLOCK_SIZE(BlockSize));
+				uint64 Size = CompressSnapshotBlock((uint8 *)GameMemoryBlock + Offset, BlockSize, Dest);
+				File.Size += Size;
+				AddRecordingSnapshotBytes(&Writer, Size);
+			}
+			EndRecordingKeyframe(&Writer);
+			SnapshotMicroseconds += ReplayGetMicroseconds() - SnapshotStart;
+		}
+
+		ReplayScriptInput(FrameIndex, &Input, Width, Height);
+		File.Size += RecordInputFrame(&Writer, &Input, ReplayReserve(&File, RECORDING_MAX_FRAME_SIZE));
+
+		GameUpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+		Recorded[FrameIndex].StateHash = ReplayHashGameState(&GameMemory);
+		Recorded[FrameIndex].FrameHash = ReplayHash(0xcbf29ce484222325ull, Buffer.Memory, BufferSize);
+	}
+	uint64 RecordMicroseconds = ReplayGetMicroseconds() - RecordStart;
+
+	EndRecordingWriter(&Writer);
+	ReplayAppend(&File, Keyframes, Writer.Header.KeyframeCount*sizeof(recording_keyframe));
+	memcpy(File.Base, &Writer.Header, sizeof(Writer.Header));
+
+	fprintf(stderr, "recorded %u frames in %.1fms, %u keyframes in %.1fms, %llu input bytes, %llu snapshot bytes\n",
+			FrameCount, RecordMicroseconds / 1000.0, Writer.Header.KeyframeCount, SnapshotMicroseconds / 1000.0,
+			(unsigned long long)Writer.InputBytes, (unsigned long long)Writer.SnapshotBytes);
+
+	int Result = 0;
+	recording_reader Reader;
+	if(!BeginRecordingReader(&Reader, File.Base, File.Size) || (Reader.Header->FrameCount != FrameCount))
+	{
+		fprintf(stderr, "the recording does not read back\n");
+		return 1;
+	}
+
+	// NOTE: The whole recording from the first keyframe
+	memset(Buffer.Memory, 0, BufferSize);
+	LoadRecordingKeyframe(&Reader, 0, GameMemoryBlock);
+	uint32 MismatchCount = 0;
+	uint32 PlayedCount = 0;
+	for(uint32 FrameIndex = 0; ReadRecordedInput(&Reader, &Input); FrameIndex++)
+	{
+		GameUpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+		if((ReplayHashGameState(&GameMemory) != Recorded[FrameIndex].StateHash) ||
+		   (ReplayHash(0xcbf29ce484222325ull, Buffer.Memory, BufferSize) != Recorded[FrameIndex].FrameHash))
+		{
+			if(MismatchCount++ == 0)
+			{
+				fprintf(stderr, "playback diverges from the recording at frame %u\n", FrameIndex);
+			}
+		}
+		PlayedCount++;
+	}
+	fprintf(stderr, "played back %u frames, %u mismatched frames\n", PlayedCount, MismatchCount);
+	if(MismatchCount || (PlayedCount != FrameCount))
+	{
+		Result = 1;
+	}
+
+	// NOTE: Seeks land on a keyframe and run forward, so the frames checked are the first and last
+	// one of a keyframe's run, the one in the middle of the recording and the very last
+	uint32 SeekFrames[] =
+	{
+		0, RECORDING_KEYFRAME_INTERVAL - 1, RECORDING_KEYFRAME_INTERVAL, FrameCount / 2, FrameCount - 1,
+	};
+	for(uint32 SeekIndex = 0; SeekIndex < ArrayCount(SeekFrames); SeekIndex++)
+	{
+		uint32 SeekFrame = SeekFrames[SeekIndex];
+		if(SeekFrame >= FrameCount)
+		{
+			continue;
+		}
+
+		uint64 SeekStart = ReplayGetMicroseconds();
+		uint32 RunCount = SeekRecording(&Reader, SeekFrame, GameMemoryBlock) + 1;
+		for(uint32 RunIndex = 0; RunIndex < RunCount; RunIndex++)
+		{
+			if(!ReadRecordedInput(&Reader, &Input))
+			{
+				break;
+			}
+			GameUpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+		}
+		uint64 SeekMicroseconds = ReplayGetMicroseconds() - SeekStart;
+
+		// NOTE: The framebuffer isn't part of game memory so a seek doesn't restore it, only the state is checked
+		bool32 Matches = ((Reader.FrameIndex == SeekFrame + 1) &&
+						  (ReplayHashGameState(&GameMemory) == Recorded[SeekFrame].StateHash));
+		fprintf(stderr, "seek to frame %u: %u frames run in %.1fms, %s\n", SeekFrame, RunCount,
+				SeekMicroseconds / 1000.0, Matches ? "state matches" : "STATE MISMATCH");
+		if(!Matches)
+		{
+			Result = 1;
+		}
+	}
+
+	if(SaveFilename)
+	{
+		FILE *SaveFile = fopen(SaveFilename, "wb");
+		bool32 Written = (SaveFile && (fwrite(File.Base, 1, (size_t)File.Size, SaveFile) == File.Size));
+		if(SaveFile)
+		{
+			fclose(SaveFile);
+		}
+		if(Written)
+		{
+			fprintf(stderr, "wrote %llu bytes to %s\n", (unsigned long long)File.Size, SaveFilename);
+		}
+		else
+		{
+			fprintf(stderr, "could not write %s\n", SaveFilename);
+			Result = 2;
+		}
+	}
+
+	return Result;
+}
+
+int main(int ArgCount, char **Args)
+{
+	char *RecordingFilename = 0;
+	int RunCount = 1;
+	int Width = 960;
+	int Height = 540;
+	bool32 Quiet = false;
+	real32 SimHz = -1.0f;
+	bool32 Profiling = false;
+	char *TraceFilename = 0;
+	bool32 ReportMemory = false;
+	uint32 RoundTripFrameCount = 0;
+	char *SaveFilename = 0;
+	for(int ArgIndex = 1; ArgIndex < ArgCount; ArgIndex++)
+	{
+		char *Arg = Args[ArgIndex];
+		if((strcmp(Arg, "-runs") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			RunCount = atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-width") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			Width = atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-height") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			Height = atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-simhz") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			SimHz = (real32)atof(Args[++ArgIndex]);
+		}
+		else if(strcmp(Arg, "-quiet") == 0)
+		{
+			Quiet = true;
+		}
+		else if(strcmp(Arg, "-profile") == 0)
+		{
+			Profiling = true;
+		}
+		else if((strcmp(Arg, "-trace") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			TraceFilename = Args[++ArgIndex];
+		}
+		else if(strcmp(Arg, "-memory") == 0)
+		{
+			ReportMemory = true;
+		}
+		else if((strcmp(Arg, "-roundtrip") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			RoundTripFrameCount = (uint32)atoi(Args[++ArgIndex]);
+		}
+		else if((strcmp(Arg, "-save") == 0) && (ArgIndex + 1 < ArgCount))
+		{
+			SaveFilename = Args[++ArgIndex];
+		}
+		else
+		{
+			RecordingFilename = Arg;
+		}
+	}
+
+	if((!RecordingFilename && !RoundTripFrameCount) || (RunCount < 1) || (Width < 1) || (Height < 1))
+	{
+		fprintf(stderr, "usage: %s <recording.hmi> [-runs N] [-width W] [-height H] [-simhz N] [-quiet] [-profile]\n"
+				"       [-trace <out.json>] [-memory]\n"
+				"       %s -roundtrip <frames> [-save <out.hmi>] [-width W] [-height H] [-simhz N]\n", Args[0], Args[0]);
+		return 2;
+	}
+
+	if(RoundTripFrameCount)
+	{
+		return ReplayRoundTrip(RoundTripFrameCount, SaveFilename, Width, Height, (SimHz > 0.0f) ? SimHz : 0.0f);
+	}
+
+	uint64 FileSize = 0;
+	void *File = ReplayReadEntireFile(RecordingFilename, &FileSize);
+	recording_reader Reader;
+	if(!File || !BeginRecordingReader(&Reader, File, FileSize))
+	{
+		fprintf(stderr, "%s: not a readable recording\n", RecordingFilename);
+		return 2;
+	}
+
+	recording_header *Header = Reader.Header;
+	void *GameMemoryBlock = ReplayAllocateGameMemory(Header->MemoryBase, Header->MemorySize);
+	if(!GameMemoryBlock)
+	{
+		fprintf(stderr, "could not map %llu bytes of game memory at 0x%llx\n",
+				(unsigned long long)Header->MemorySize, (unsigned long long)Header->MemoryBase);
+		return 2;
+	}
+
+	game_memory GameMemory = {};
+	GameMemory.PermanentStorageSize = Header->PermanentStorageSize;
+	GameMemory.TransientStorageSize = Header->MemorySize - GameMemory.PermanentStorageSize;
+	GameMemory.PermanentStorage = GameMemoryBlock;
+	GameMemory.TransientStorage = (uint8 *)GameMemoryBlock + GameMemory.PermanentStorageSize;
+	GameMemory.DEBUGPlatformFreeFileMemory = DEBUGPlatformFreeFileMemory;
+	GameMemory.DEBUGPlatformReadEntireFile = DEBUGPlatformReadEntireFile;
+	GameMemory.DEBUGPlatformWriteEntireFile = DEBUGPlatformWriteEntireFile;
+
+	game_offscreen_buffer Buffer = {};
+	Buffer.Width = Width;
+	Buffer.Height = Height;
+	Buffer.BytesPerPixel = 4;
+	Buffer.Pitch = Width*Buffer.BytesPerPixel;
+	Buffer.Memory = calloc(1, (size_t)Buffer.Pitch*Height);
+
+	uint32 FrameCount = Header->FrameCount;
+	replay_frame *FirstRun = (replay_frame *)calloc(FrameCount + 1, sizeof(replay_frame));
+	uint64 *Timings = (uint64 *)calloc(FrameCount + 1, sizeof(uint64));
+	thread_context Thread = {};
+
+#if HANDMADE_PROFILE
+	debug_profile *Profile = 0;
+	if(Profiling || TraceFilename)
+	{
+		debug_table *DebugTable = (debug_table *)calloc(1, sizeof(debug_table));
+		Profile = (debug_profile *)calloc(1, sizeof(debug_profile));
+		InitializeProfile(Profile, DebugTable);
+		GlobalDebugTable = DebugTable;
+		GameMemory.DebugTable = DebugTable;
+		UpdateProfileClockRate(Profile, 1000*ReplayGetMicroseconds());
+		MeasureTimedBlockOverhead(Profile);
+	}
+	char *ProfileReport = (char *)malloc(65536);
+#else
+	if(Profiling || TraceFilename)
+	{
+		fprintf(stderr, "built without HANDMADE_PROFILE, -profile and -trace do nothing\n");
+	}
+#endif
+
+	if(!Quiet)
+	{
+		printf("run,frame,microseconds,state_hash,frame_hash\n");
+	}
+
+	int Result = 0;
+	for(int RunIndex = 0; RunIndex < RunCount; RunIndex++)
+	{
+		memset(Buffer.Memory, 0, (size_t)Buffer.Pitch*Height);
+		LoadRecordingKeyframe(&Reader, 0, GameMemoryBlock);
+		GameMemory.IsInitialized = true;
+
+		game_state *GameState = (game_state *)GameMemory.PermanentStorage;
+		uint64 FirstTick = GameState->SimTickCount;
+
+		uint32 MismatchCount = 0;
+#if HANDMADE_PROFILE
+		if(Profile)
+		{
+			ResetProfile(Profile);
+		}
+#endif
+		uint64 RunStart = ReplayGetMicroseconds();
+		game_input Input;
+		for(uint32 FrameIndex = 0; ReadRecordedInput(&Reader, &Input); FrameIndex++)
+		{
+			if(SimHz >= 0.0f)
+			{
+				Input.SimSecondsPerTick = (SimHz > 0.0f) ? (1.0f / SimHz) : 0.0f;
+			}
+
+			uint64 FrameStart = ReplayGetMicroseconds();
+			GameUpdateAndRender(&Thread, &GameMemory, &Input, &Buffer);
+			uint64 FrameEnd = ReplayGetMicroseconds();
+#if HANDMADE_PROFILE
+			if(Profile)
+			{
+				CollateDebugFrame(Profile);
+				UpdateProfileClockRate(Profile, 1000*ReplayGetMicroseconds());
+			}
+#endif
+
+			replay_frame Frame;
+			Frame.Microseconds = FrameEnd - FrameStart;
+			Frame.StateHash = ReplayHashGameState(&GameMemory);
+			Frame.FrameHash = ReplayHash(0xcbf29ce484222325ull, Buffer.Memory, (memory_index)Buffer.Pitch*Height);
+			Timings[FrameIndex] = Frame.Microseconds;
+
+			if(RunIndex == 0)
+			{
+				FirstRun[FrameIndex] = Frame;
+			}
+			else if((Frame.StateHash != FirstRun[FrameIndex].StateHash) ||
+					(Frame.FrameHash != FirstRun[FrameIndex].FrameHash))
+			{
+				if(MismatchCount++ == 0)
+				{
+					fprintf(stderr, "run %d diverges from run 0 at frame %u\n", RunIndex, FrameIndex);
+				}
+				Result = 1;
+			}
+
+			if(!Quiet)
+			{
+				printf("%d,%u,%llu,%016llx,%016llx\n", RunIndex, FrameIndex, (unsigned long long)Frame.Microseconds,
+					   (unsigned long long)Frame.StateHash, (unsigned long long)Frame.FrameHash);
+			}
+		}
+		uint64 RunMicroseconds = ReplayGetMicroseconds() - RunStart;
+		uint64 TickCount = GameState->SimTickCount - FirstTick;
+
+		qsort(Timings, FrameCount, sizeof(uint64), ReplayCompareMicroseconds);
+		uint64 TotalMicroseconds = 0;
+		for(uint32 FrameIndex = 0; FrameIndex < FrameCount; FrameIndex++)
+		{
+			TotalMicroseconds += Timings[FrameIndex];
+		}
+		if(FrameCount)
+		{
+			fprintf(stderr, "run %d: %u frames, %llu sim ticks in %.1fms (game %.1fms), per frame min %lluus p50 %lluus p95 %lluus max %lluus, "
+					"final state %016llx, %u mismatched frames\n",
+					RunIndex, FrameCount, (unsigned long long)TickCount, RunMicroseconds / 1000.0, TotalMicroseconds / 1000.0,
+					(unsigned long long)Timings[0], (unsigned long long)Timings[FrameCount / 2],
+					(unsigned long long)Timings[(FrameCount*95) / 100], (unsigned long long)Timings[FrameCount - 1],
+					(unsigned long long)FirstRun[FrameCount - 1].StateHash, MismatchCount);
+		}
+		if(ReportMemory)
+		{
+			char MemoryReport[1024];
+			FormatMemoryTelemetry(&GameMemory.Telemetry, MemoryReport, sizeof(MemoryReport));
+			fputs(MemoryReport, stderr);
+		}
+#if HANDMADE_PROFILE
+		if(Profile && Profiling)
+		{
+			FormatProfileReport(Profile, ProfileReport, 65536);
+			fputs(ProfileReport, stderr);
+		}
+#endif
+	}
+
+#if HANDMADE_PROFILE
+	if(Profile && TraceFilename)
+	{
+		// NOTE: Nothing else is running, so the dump is written straight out
+		trace_dump Dump;
+		BeginTraceDump(&Dump, Profile);
+		FILE *TraceFile = fopen(TraceFilename, "wb");
+		if(TraceFile)
+		{
+			uint32 Size;
+			while((Size = FormatTraceDump(&Dump, ProfileReport, 65536)) != 0)
+			{
+				fwrite(ProfileReport, 1, Size, TraceFile);
+			}
+			fclose(TraceFile);
+			fprintf(stderr, "wrote %u timed blocks to %s\n", Dump.BlockCount, TraceFilename);
+		}
+		else
+		{
+			fprintf(stderr, "could not write %s\n", TraceFilename);
+		}
+	}
+#endif
+
+	return Result;
+}
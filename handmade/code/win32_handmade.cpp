@@ -28,10 +28,17 @@
 */
 #include <windows.h>
 #include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
 #include <xinput.h>
 #include <dsound.h>
 
 #include "handmade.h"
+#include "handmade_recording.h"
+#include "handmade_frame_pacer.h"
+#include "handmade_profiler.h"
+#include "handmade_telemetry.h"
+#include "handmade_dirty_pages.h"
 #include "win32_handmade.h"
 
 global_variable bool GlobalRunning;
@@ -98,6 +105,9 @@ X_INPUT_SET_STATE(XInputSetStateStub)
 global_variable x_input_set_state *XInputSetState_ = XInputSetStateStub;
 #define XInputSetState XInputSetState_
 
+// NOTE: In frames, how often a controller slot that was empty is polled again
+#define XINPUT_RECONNECT_POLL_FRAMES 60
+
 DEBUG_PLATFORM_FREE_FILE_MEMORY(DEBUGPlatformFreeFileMemory)
 {
 	if (Memory)
@@ -178,6 +188,53 @@ DEBUG_PLATFORM_WRITE_ENTIRE_FILE(DEBUGPlatformWriteEntireFile)
 	return Result;
 }
 
+PLATFORM_OPEN_FILE(Win32OpenFile)
+{
+	platform_file_handle Result = {};
+
+	HANDLE FileHandle = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, 0,
+									OPEN_EXISTING, 0, 0);
+	Result.NoErrors = (FileHandle != INVALID_HANDLE_VALUE);
+	Result.Platform = FileHandle;
+
+	return Result;
+}
+
+// NOTE: The offset goes in through an OVERLAPPED, so there's no shared file pointer to race on
+PLATFORM_READ_DATA_FROM_FILE(Win32ReadDataFromFile)
+{
+	uint64 Result = 0;
+	if(Handle->NoErrors)
+	{
+		OVERLAPPED Overlapped = {};
+		Overlapped.Offset = (uint32)(Offset & 0xFFFFFFFF);
+		Overlapped.OffsetHigh = (uint32)(Offset >> 32);
+
+		DWORD BytesRead;
+		if(ReadFile((HANDLE)Handle->Platform, Dest, SafeTruncateUInt64(Size), &BytesRead, &Overlapped))
+		{
+			Result = BytesRead;
+		}
+		else if(GetLastError() != ERROR_HANDLE_EOF)
+		{
+			// TODO Logging
+			Handle->NoErrors = false;
+		}
+	}
+
+	return Result;
+}
+
+PLATFORM_CLOSE_FILE(Win32CloseFile)
+{
+	if(Handle->Platform != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle((HANDLE)Handle->Platform);
+	}
+	Handle->NoErrors = false;
+	Handle->Platform = INVALID_HANDLE_VALUE;
+}
+
 inline FILETIME Win32GetLastWriteTime(char *Filename)
 {
 	FILETIME LastWriteTime = {};
@@ -457,10 +514,7 @@ internal void Win32BuildEXEPathFilename(win32_state *State, char *Filename, int
 internal void Win32GetInputFileLocation(win32_state *State, bool32 InputStream, int SlotIndex, int DestCount, char *Dest)
 {	
 	char Temp[64];
-	if(InputStream)
-	{
-		wsprintf(Temp, "loop_edit_%d_%s.hmi", SlotIndex, InputStream ? "input" : "state");
-	}	
+	wsprintf(Temp, "loop_edit_%d_%s.hmi", SlotIndex, InputStream ? "input" : "state");
 	Win32BuildEXEPathFilename(State, Temp, DestCount, Dest);
 }
 
@@ -471,83 +525,375 @@ internal win32_replay_buffer *Win32GetReplayBuffer(win32_state *State, unsigned
 	return Result;
 }
 
+/*
+	NOTE: Game memory is allocated with MEM_WRITE_WATCH, so after a full copy between game memory
+	and a replay buffer, the next copy with that same buffer (either direction) only has to move
+	the pages written since (handmade_dirty_pages.h). Loop restarts then cost what the loop
+	touched, not TotalSize.
+*/
+internal void Win32SyncReplayBuffer(win32_state *State, win32_replay_buffer *ReplayBuffer, bool32 ToReplayBuffer)
+{
+	uint8 *GameMemory = (uint8 *)State->GameMemoryBlock;
+	uint8 *Snapshot = (uint8 *)ReplayBuffer->MemoryBlock;
+	uint64 PagesCopied = 0;
+	LARGE_INTEGER StartCounter;
+	QueryPerformanceCounter(&StartCounter);
+
+	// NOTE: Queued work writes game memory too, so let it land before the dirty pages are collected
+	game_memory *Memory = State->GameMemory;
+	if(Memory && Memory->PlatformCompleteAllWork)
+	{
+		Memory->PlatformCompleteAllWork(Memory->HighPriorityQueue);
+		Memory->PlatformCompleteAllWork(Memory->LowPriorityQueue);
+	}
+
+	dirty_page_tracker *DirtyPages = &State->DirtyPages;
+	if(DirtyPages->Views)
+	{
+		CollectDirtyPages(DirtyPages);
+	}
+
+	if((State->SyncedReplayBuffer == ReplayBuffer) && DirtyPages->Views)
+	{
+		if(ToReplayBuffer)
+		{
+			PagesCopied = CopyDirtyPages(DirtyPages, WIN32_DIRTY_VIEW_REPLAY, Snapshot, GameMemory);
+		}
+		else
+		{
+			PagesCopied = CopyDirtyPages(DirtyPages, WIN32_DIRTY_VIEW_REPLAY, GameMemory, Snapshot);
+		}
+	}
+	else
+	{
+		if(ToReplayBuffer)
+		{
+			CopyMemory(Snapshot, GameMemory, State->TotalSize);
+		}
+		else
+		{
+			CopyMemory(GameMemory, Snapshot, State->TotalSize);
+		}
+		State->SyncedReplayBuffer = ReplayBuffer;
+	}
+
+	if(DirtyPages->Views)
+	{
+		if(!ToReplayBuffer)
+		{
+			// NOTE: Restoring wrote game memory. It matches the replay buffer now, but any other
+			// view has to hear about it.
+			CollectDirtyPages(DirtyPages);
+		}
+		ClearDirtyPages(DirtyPages, WIN32_DIRTY_VIEW_REPLAY);
+	}
+
+#if HANDMADE_INTERNAL
+	LARGE_INTEGER EndCounter;
+	QueryPerformanceCounter(&EndCounter);
+	char TextBuffer[256];
+	wsprintf(TextBuffer, "Replay sync %s: %u pages, %u us\n", ToReplayBuffer ? "save" : "restore",
+			 (uint32)PagesCopied, (uint32)((1000000*(EndCounter.QuadPart - StartCounter.QuadPart)) / GlobalPerfCountFrequency));
+	OutputDebugStringA(TextBuffer);
+#endif
+}
+
 internal void Win32BeginRecordingInput(win32_state *Win32State, int InputRecordingIndex)
 {
 	win32_replay_buffer *ReplayBuffer = Win32GetReplayBuffer(Win32State, InputRecordingIndex);
-	if(ReplayBuffer->MemoryBlock)
+	win32_keyframe_writer *KeyframeWriter = &Win32State->KeyframeWriter;
+
+	// NOTE: The shadow is as big as game memory, so it's only committed while recording. The first
+	// keyframe copies all of game memory into it, so it doesn't have to start out with anything.
+	Assert(!KeyframeWriter->Shadow);
+	KeyframeWriter->Shadow = (uint8 *)VirtualAlloc(0, (size_t)Win32State->TotalSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if(ReplayBuffer->MemoryBlock && Win32State->RecordingKeyframes &&
+	   KeyframeWriter->Shadow && KeyframeWriter->Scratch && KeyframeWriter->PendingFrames)
 	{
 		Win32State->InputRecordingIndex = InputRecordingIndex;			
 		
 		char Filename[WIN32_STATE_FILE_NAME_COUNT];
 		Win32GetInputFileLocation(Win32State, true, InputRecordingIndex, WIN32_STATE_FILE_NAME_COUNT, Filename);
 		Win32State->RecordingHandle = CreateFileA(Filename, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, 0, 0);
+		KeyframeWriter->File = Win32State->RecordingHandle;
 
-#if 0
-		LARGE_INTEGER FilePosition;
-		FilePosition.QuadPart = Win32State->TotalSize;
-		SetFilePointerEx(Win32State->RecordingHandle, FilePosition, 0, FILE_BEGIN);
-#endif
+		recording_writer *Writer = &Win32State->Recorder;
+		BeginRecordingWriter(Writer, Win32State->GameMemoryBlock, Win32State->TotalSize, Win32State->GameMemory->PermanentStorageSize,
+							 WIN32_RECORDING_KEYFRAME_CAPACITY, Win32State->RecordingKeyframes);
+		DWORD BytesWritten;
+		WriteFile(Win32State->RecordingHandle, &Writer->Header, sizeof(Writer->Header), &BytesWritten, 0);
 		
-		CopyMemory(ReplayBuffer->MemoryBlock, Win32State->GameMemoryBlock, Win32State->TotalSize);
-	}	
+		Win32SyncReplayBuffer(Win32State, ReplayBuffer, true);
+	}
+	else if(KeyframeWriter->Shadow)
+	{
+		VirtualFree(KeyframeWriter->Shadow, 0, MEM_RELEASE);
+		KeyframeWriter->Shadow = 0;
+	}
+}
+
+DWORD WINAPI Win32KeyframeWriterProc(LPVOID Parameter)
+{
+	win32_keyframe_writer *Writer = (win32_keyframe_writer *)Parameter;
+
+	Writer->SnapshotSize = 0;
+	for(uint64 Offset = 0; Offset < Writer->Size; Offset += RECORDING_SNAPSHOT_BLOCK_SIZE)
+	{
+		uint64 BlockSize = Minimum(RECORDING_SNAPSHOT_BLOCK_SIZE, Writer->Size - Offset);
+		uint64 CompressedSize = CompressSnapshotBlock(Writer->Shadow + Offset, BlockSize, Writer->Scratch);
+
+		DWORD BytesWritten;
+		WriteFile(Writer->File, Writer->Scratch, (DWORD)CompressedSize, &BytesWritten, 0);
+		Writer->SnapshotSize += CompressedSize;
+	}
+
+	CompletePreviousWritesBeforeFutureWrites;
+	Writer->Done = true;
+	return 0;
+}
+
+// NOTE: Once the snapshot being written is in the file, or straight away with Wait, closes the
+// keyframe and puts the frames recorded meanwhile after it
+internal void Win32FinishRecordingKeyframe(win32_state *Win32State, bool32 Wait)
+{
+	win32_keyframe_writer *KeyframeWriter = &Win32State->KeyframeWriter;
+	if(KeyframeWriter->Thread && (Wait || KeyframeWriter->Done))
+	{
+		WaitForSingleObject(KeyframeWriter->Thread, INFINITE);
+		CloseHandle(KeyframeWriter->Thread);
+		KeyframeWriter->Thread = 0;
+
+		recording_writer *Writer = &Win32State->Recorder;
+		AddRecordingSnapshotBytes(Writer, KeyframeWriter->SnapshotSize);
+		EndRecordingKeyframe(Writer);
+
+		DWORD BytesWritten;
+		WriteFile(Win32State->RecordingHandle, KeyframeWriter->PendingFrames, KeyframeWriter->PendingFrameSize, &BytesWritten, 0);
+		KeyframeWriter->PendingFrameSize = 0;
+	}
 }
 
 internal void Win32EndRecordingInput(win32_state *Win32State)
 {
+	Win32FinishRecordingKeyframe(Win32State, true);
+
+	recording_writer *Writer = &Win32State->Recorder;
+	EndRecordingWriter(Writer);
+
+	DWORD BytesWritten;
+	WriteFile(Win32State->RecordingHandle, Writer->Keyframes, 
+			  Writer->Header.KeyframeCount*sizeof(recording_keyframe), &BytesWritten, 0);
+	LARGE_INTEGER FilePosition = {};
+	SetFilePointerEx(Win32State->RecordingHandle, FilePosition, 0, FILE_BEGIN);
+	WriteFile(Win32State->RecordingHandle, &Writer->Header, sizeof(Writer->Header), &BytesWritten, 0);
 	CloseHandle(Win32State->RecordingHandle);	
+
+	// NOTE: The keyframe writer's thread is done with it after the wait above
+	win32_keyframe_writer *KeyframeWriter = &Win32State->KeyframeWriter;
+	VirtualFree(KeyframeWriter->Shadow, 0, MEM_RELEASE);
+	KeyframeWriter->Shadow = 0;
+
+#if HANDMADE_INTERNAL
+	uint32 RecordedMilliseconds = (uint32)(1000.0f*Writer->RecordedSeconds);
+	if(RecordedMilliseconds)
+	{
+		char TextBuffer[256];
+		wsprintf(TextBuffer, "Recorded %u frames: %u input bytes, %u snapshot bytes, %u input bytes/minute, %u bytes/minute\n",
+				 Writer->Header.FrameCount, (uint32)Writer->InputBytes, (uint32)Writer->SnapshotBytes,
+				 (uint32)((60000*Writer->InputBytes) / RecordedMilliseconds),
+				 (uint32)((60000*Writer->WriteOffset) / RecordedMilliseconds));
+		OutputDebugStringA(TextBuffer);
+	}
+#endif
+
 	Win32State->InputRecordingIndex = 0;
 }
 
-internal void Win32RecordInput(win32_state *Win32State, game_input *NewInput)
+/*
+	NOTE: The frame a keyframe lands on only pays for bringing the shadow up to date with game
+	memory, the pages written since the last keyframe, or all of it for a recording's first. The
+	compression runs on the keyframe writer's thread.
+*/
+internal void Win32WriteRecordingKeyframe(win32_state *Win32State, game_memory *Memory)
 {
-	DWORD BytesWritten;
-	WriteFile(Win32State->RecordingHandle, NewInput, sizeof(*NewInput), &BytesWritten, 0);	
+	LARGE_INTEGER StartCounter;
+	QueryPerformanceCounter(&StartCounter);
+
+	// NOTE: Queued work writes game memory too, so let it land before taking the snapshot
+	if(Memory->PlatformCompleteAllWork)
+	{
+		Memory->PlatformCompleteAllWork(Memory->HighPriorityQueue);
+		Memory->PlatformCompleteAllWork(Memory->LowPriorityQueue);
+	}
+
+	recording_writer *Writer = &Win32State->Recorder;
+	win32_keyframe_writer *KeyframeWriter = &Win32State->KeyframeWriter;
+	Assert(!KeyframeWriter->Thread);
+	BeginRecordingKeyframe(Writer);
+
+	uint8 *GameMemory = (uint8 *)Win32State->GameMemoryBlock;
+	dirty_page_tracker *DirtyPages = &Win32State->DirtyPages;
+	uint64 PagesCopied = 0;
+	if(DirtyPages->Views)
+	{
+		CollectDirtyPages(DirtyPages);
+	}
+	if(DirtyPages->Views && Writer->Header.KeyframeCount)
+	{
+		PagesCopied = CopyDirtyPages(DirtyPages, WIN32_DIRTY_VIEW_KEYFRAME, KeyframeWriter->Shadow, GameMemory);
+	}
+	else
+	{
+		CopyMemory(KeyframeWriter->Shadow, GameMemory, Win32State->TotalSize);
+		if(DirtyPages->Views)
+		{
+			ClearDirtyPages(DirtyPages, WIN32_DIRTY_VIEW_KEYFRAME);
+		}
+	}
+
+	KeyframeWriter->Size = Win32State->TotalSize;
+	KeyframeWriter->Done = false;
+	KeyframeWriter->Thread = CreateThread(0, 0, Win32KeyframeWriterProc, KeyframeWriter, 0, 0);
+
+#if HANDMADE_INTERNAL
+	LARGE_INTEGER EndCounter;
+	QueryPerformanceCounter(&EndCounter);
+	char TextBuffer[256];
+	wsprintf(TextBuffer, "Keyframe %u: %u pages into the shadow, %u us\n", Writer->Header.KeyframeCount,
+			 (uint32)PagesCopied, (uint32)((1000000*(EndCounter.QuadPart - StartCounter.QuadPart)) / GlobalPerfCountFrequency));
+	OutputDebugStringA(TextBuffer);
+#endif
+}
+
+internal void Win32RecordInput(win32_state *Win32State, game_memory *Memory, game_input *NewInput)
+{
+	recording_writer *Writer = &Win32State->Recorder;
+	win32_keyframe_writer *KeyframeWriter = &Win32State->KeyframeWriter;
+
+	// NOTE: A snapshot still being written has to be in the file before the next keyframe's, and
+	// the frames waiting on it can't outgrow the pending buffer
+	bool32 MustFinish = (((Writer->Header.FrameCount % Writer->Header.KeyframeInterval) == 0) ||
+						 ((KeyframeWriter->PendingFrameSize + RECORDING_MAX_FRAME_SIZE) > WIN32_PENDING_FRAME_CAPACITY));
+	Win32FinishRecordingKeyframe(Win32State, MustFinish);
+	if(RecordingNeedsKeyframe(Writer))
+	{
+		Win32WriteRecordingKeyframe(Win32State, Memory);
+	}
+
+	uint8 Frame[RECORDING_MAX_FRAME_SIZE];
+	uint32 FrameSize = RecordInputFrame(Writer, NewInput, Frame);
+	if(KeyframeWriter->Thread)
+	{
+		CopyMemory(KeyframeWriter->PendingFrames + KeyframeWriter->PendingFrameSize, Frame, FrameSize);
+		KeyframeWriter->PendingFrameSize += FrameSize;
+	}
+	else
+	{
+		DWORD BytesWritten;
+		WriteFile(Win32State->RecordingHandle, Frame, FrameSize, &BytesWritten, 0);	
+	}
+}
+
+internal void Win32EndInputPlayback(win32_state *Win32State)
+{
+	thread_context Thread = {};
+	DEBUGPlatformFreeFileMemory(&Thread, Win32State->PlaybackFile);
+	Win32State->PlaybackFile = 0;
+	Win32State->InputPlaybackIndex = 0;
 }
 
 internal void Win32BeginInputPlayback(win32_state *Win32State, int InputPlaybackIndex)
 {
 	win32_replay_buffer *ReplayBuffer = Win32GetReplayBuffer(Win32State, InputPlaybackIndex);
-	if(ReplayBuffer)
+	if(ReplayBuffer->MemoryBlock)
 	{
-		Win32State->InputPlaybackIndex = InputPlaybackIndex;	
 		char Filename[WIN32_STATE_FILE_NAME_COUNT];
 		Win32GetInputFileLocation(Win32State, true, InputPlaybackIndex, WIN32_STATE_FILE_NAME_COUNT, Filename);
-		Win32State->PlaybackHandle = CreateFileA(Filename, GENERIC_READ, 0, 0, OPEN_EXISTING, 0, 0);
 
-#if 0
-		LARGE_INTEGER FilePosition;
-		FilePosition.QuadPart = Win32State->TotalSize;
-		SetFilePointerEx(Win32State->PlaybackHandle, FilePosition, 0, FILE_BEGIN);		
-#endif
+		// NOTE: Recordings are small next to game memory, so the whole file is kept in memory for seeking
+		thread_context Thread = {};
+		debug_read_file_result File = DEBUGPlatformReadEntireFile(&Thread, Filename);
+		if(File.Contents && BeginRecordingReader(&Win32State->Player, File.Contents, File.ContentsSize) &&
+		   (Win32State->Player.Header->MemorySize == Win32State->TotalSize) &&
+		   (Win32State->Player.Header->PermanentStorageSize == Win32State->GameMemory->PermanentStorageSize))
+		{
+			Win32State->InputPlaybackIndex = InputPlaybackIndex;	
+			Win32State->PlaybackFile = File.Contents;
+			SetRecordingKeyframe(&Win32State->Player, 0);
 
-		CopyMemory(Win32State->GameMemoryBlock, ReplayBuffer->MemoryBlock, Win32State->TotalSize);
+			Win32SyncReplayBuffer(Win32State, ReplayBuffer, false);
+		}
+		else
+		{
+			// TODO diagnostic
+			DEBUGPlatformFreeFileMemory(&Thread, File.Contents);
+		}
 	}	
 }
 
-internal void Win32EndInputPlayback(win32_state *Win32State)
+internal void Win32PlayBackInput(win32_state *Win32State, game_input *NewInput)
 {
-	CloseHandle(Win32State->PlaybackHandle);
-	Win32State->InputPlaybackIndex = 0;
+	if(!ReadRecordedInput(&Win32State->Player, NewInput))
+	{
+		// NOTE: hit the end of the stream, go back to beginning
+		win32_replay_buffer *ReplayBuffer = Win32GetReplayBuffer(Win32State, Win32State->InputPlaybackIndex);
+		Win32SyncReplayBuffer(Win32State, ReplayBuffer, false);
+		SetRecordingKeyframe(&Win32State->Player, 0);
+		ReadRecordedInput(&Win32State->Player, NewInput);
+	}
 }
 
-internal void Win32PlayBackInput(win32_state *Win32State, game_input *NewInput)
+/*
+	NOTE: Jumps playback by whole keyframe intervals. The keyframe at or before the target is
+	decompressed straight into game memory and the remaining frames are run through the game.
+*/
+internal void Win32SeekInputPlayback(win32_state *Win32State, game_memory *Memory, win32_game_code *Game,
+									 thread_context *Thread, game_offscreen_buffer *Buffer, int KeyframeDelta)
 {
-	DWORD BytesRead = 0;
-	if(ReadFile(Win32State->PlaybackHandle, NewInput, sizeof(*NewInput), &BytesRead, 0))
+	LARGE_INTEGER StartCounter;
+	QueryPerformanceCounter(&StartCounter);
+
+	if(Memory->PlatformCompleteAllWork)
 	{
-	if(BytesRead != sizeof(*NewInput))		
+		Memory->PlatformCompleteAllWork(Memory->HighPriorityQueue);
+		Memory->PlatformCompleteAllWork(Memory->LowPriorityQueue);
+	}
+
+	recording_reader *Player = &Win32State->Player;
+	int32 TargetFrame = (int32)Player->FrameIndex + KeyframeDelta*(int32)Player->Header->KeyframeInterval;
+	if(TargetFrame < 0)
+	{
+		TargetFrame = 0;
+	}
+	uint32 ReplayCount = SeekRecording(Player, (uint32)TargetFrame, Win32State->GameMemoryBlock);
+
+	// NOTE: Game memory no longer matches any replay buffer
+	Win32State->SyncedReplayBuffer = 0;
+
+	for(uint32 ReplayIndex = 0; ReplayIndex < ReplayCount; ReplayIndex++)
+	{
+		game_input Input;
+		if(ReadRecordedInput(Player, &Input) && Game->UpdateAndRender)
 		{
-			// NOTE: hit the end of the stream, go back to beginning
-			int PlayingIndex = Win32State->InputPlaybackIndex;
-			Win32EndInputPlayback(Win32State);
-			Win32BeginInputPlayback(Win32State, PlayingIndex);
+			Game->UpdateAndRender(Thread, Memory, &Input, Buffer);
 		}
 	}
+
+#if HANDMADE_INTERNAL
+	LARGE_INTEGER EndCounter;
+	QueryPerformanceCounter(&EndCounter);
+	char TextBuffer[256];
+	wsprintf(TextBuffer, "Seek to frame %u: %u frames replayed, %u us\n", Player->FrameIndex, ReplayCount,
+			 (uint32)((1000000*(EndCounter.QuadPart - StartCounter.QuadPart)) / GlobalPerfCountFrequency));
+	OutputDebugStringA(TextBuffer);
+#endif
 }
 
 internal void Win32FillSoundBuffer(win32_sound_output *SoundOutput, DWORD ByteToLock,
 								   DWORD BytesToWrite, game_sound_output_buffer *SourceBuffer)
 {
+	TIMED_FUNCTION();
+
 	VOID *Region1;
 	DWORD Region1Size;
 	VOID *Region2;
@@ -596,6 +942,17 @@ internal void Win32ProcessKeyboardMessage(game_button_state *NewState, bool32 Is
 	}	
 }
 
+// NOTE: The keyboard is controller 0
+internal void Win32ProcessKeyboardButton(game_input *Input, game_button_state *NewState, bool32 IsDown, real32 tFrame)
+{
+	if(NewState->EndedDown != IsDown)
+	{
+		Win32ProcessKeyboardMessage(NewState, IsDown);
+		uint32 ButtonIndex = (uint32)(NewState - GetController(Input, 0)->Buttons);
+		PushInputEvent(Input, 0, ButtonIndex, IsDown, tFrame);
+	}
+}
+
 LRESULT CALLBACK win32MainWindowCallback(
 	HWND Window,
 	UINT Message,
@@ -672,8 +1029,14 @@ LRESULT CALLBACK win32MainWindowCallback(
 	return Result;
 }
 
-internal void Win32ProcessPendingMessages(win32_state *Win32State, game_controller_input *KeyboardController)
+internal void Win32ProcessPendingMessages(win32_state *Win32State, game_input *Input)
 {
+	game_controller_input *KeyboardController = GetController(Input, 0);
+
+	// NOTE: Messages are only pumped once a frame, but each one carries the tick count from when
+	// it was posted, so key events go in the queue at roughly when they happened. The tick count
+	// is in milliseconds.
+	DWORD Now = GetTickCount();
 	MSG Message;
 	while (PeekMessage(&Message, 0, 0, 0, PM_REMOVE))
 	{
@@ -696,53 +1059,55 @@ internal void Win32ProcessPendingMessages(win32_state *Win32State, game_controll
 
 				if (WasDown != IsDown)
 				{
+					real32 tFrame = Input->dtForFrame - 0.001f*(real32)(Now - Message.time);
+					tFrame = Maximum(tFrame, 0.0f);
 					if (VKCode == 'W')
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->MoveUp, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->MoveUp, IsDown, tFrame);
 					}
 					else if (VKCode == 'A')
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->MoveLeft, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->MoveLeft, IsDown, tFrame);
 					}
 					else if (VKCode == 'S')
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->MoveDown, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->MoveDown, IsDown, tFrame);
 					}
 					else if (VKCode == 'D')
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->MoveRight, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->MoveRight, IsDown, tFrame);
 					}
 					else if (VKCode == 'Q')
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->LeftShoulder, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->LeftShoulder, IsDown, tFrame);
 					}
 					else if (VKCode == 'E')
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->RightShoulder, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->RightShoulder, IsDown, tFrame);
 					}
 					else if (VKCode == VK_UP)
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->ActionUp, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->ActionUp, IsDown, tFrame);
 					}
 					else if (VKCode == VK_LEFT)
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->ActionLeft, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->ActionLeft, IsDown, tFrame);
 					}
 					else if (VKCode == VK_DOWN)
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->ActionDown, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->ActionDown, IsDown, tFrame);
 					}
 					else if (VKCode == VK_RIGHT)
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->ActionRight, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->ActionRight, IsDown, tFrame);
 					}
 					else if (VKCode == VK_ESCAPE)
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->Back, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->Back, IsDown, tFrame);
 					}
 					else if (VKCode == VK_SPACE)
 					{
-						Win32ProcessKeyboardMessage(&KeyboardController->Start, IsDown);
+						Win32ProcessKeyboardButton(Input, &KeyboardController->Start, IsDown, tFrame);
 					}
 #if HANDMADE_INTERNAL					
 					else if (VKCode == 'P')
@@ -751,6 +1116,13 @@ internal void Win32ProcessPendingMessages(win32_state *Win32State, game_controll
 							GlobalPause = !GlobalPause;
 						}
 					}
+					else if((VKCode == VK_OEM_4) || (VKCode == VK_OEM_6))
+					{
+						if(IsDown && Win32State->InputPlaybackIndex)
+						{
+							Win32State->PlaybackSeekKeyframes += (VKCode == VK_OEM_4) ? -1 : 1;
+						}
+					}
 					else if(VKCode == 'L')
 					{
 						if(IsDown)
@@ -773,6 +1145,15 @@ internal void Win32ProcessPendingMessages(win32_state *Win32State, game_controll
 							}						
 						}
 					}
+#if HANDMADE_PROFILE
+					else if(VKCode == 'T')
+					{
+						if(IsDown)
+						{
+							Win32State->TraceRequested = true;
+						}
+					}
+#endif
 #endif					
 					
 				}
@@ -805,6 +1186,87 @@ internal void Win32ProcessPendingMessages(win32_state *Win32State, game_controll
 	}
 }
 
+// NOTE: Only the main thread adds entries, any thread may take them
+internal void Win32AddEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
+{
+	uint32 NewNextEntryToWrite = (Queue->NextEntryToWrite + 1) % ArrayCount(Queue->Entries);
+	Assert(NewNextEntryToWrite != Queue->NextEntryToRead);
+	platform_work_queue_entry *Entry = Queue->Entries + Queue->NextEntryToWrite;
+	Entry->Callback = Callback;
+	Entry->Data = Data;
+	++Queue->CompletionGoal;
+
+	// NOTE: The entry has to be visible before other threads can see the new write index
+	_WriteBarrier();
+	Queue->NextEntryToWrite = NewNextEntryToWrite;
+	ReleaseSemaphore(Queue->SemaphoreHandle, 1, 0);
+}
+
+internal bool32 Win32DoNextWorkQueueEntry(platform_work_queue *Queue)
+{
+	bool32 WeShouldSleep = false;
+
+	uint32 OriginalNextEntryToRead = Queue->NextEntryToRead;
+	uint32 NewNextEntryToRead = (OriginalNextEntryToRead + 1) % ArrayCount(Queue->Entries);
+	if(OriginalNextEntryToRead != Queue->NextEntryToWrite)
+	{
+		uint32 Index = InterlockedCompareExchange((LONG volatile *)&Queue->NextEntryToRead,
+												  NewNextEntryToRead, OriginalNextEntryToRead);
+		if(Index == OriginalNextEntryToRead)
+		{
+			platform_work_queue_entry Entry = Queue->Entries[Index];
+			Entry.Callback(Queue, Entry.Data);
+			InterlockedIncrement((LONG volatile *)&Queue->CompletionCount);
+		}
+	}
+	else
+	{
+		WeShouldSleep = true;
+	}
+
+	return WeShouldSleep;
+}
+
+internal void Win32CompleteAllWork(platform_work_queue *Queue)
+{
+	while(Queue->CompletionGoal != Queue->CompletionCount)
+	{
+		Win32DoNextWorkQueueEntry(Queue);
+	}
+
+	Queue->CompletionGoal = 0;
+	Queue->CompletionCount = 0;
+}
+
+DWORD WINAPI Win32WorkerThreadProc(LPVOID lpParameter)
+{
+	platform_work_queue *Queue = (platform_work_queue *)lpParameter;
+	for(;;)
+	{
+		if(Win32DoNextWorkQueueEntry(Queue))
+		{
+			WaitForSingleObjectEx(Queue->SemaphoreHandle, INFINITE, FALSE);
+		}
+	}
+}
+
+internal void Win32MakeQueue(platform_work_queue *Queue, uint32 ThreadCount)
+{
+	Queue->CompletionGoal = 0;
+	Queue->CompletionCount = 0;
+	Queue->NextEntryToWrite = 0;
+	Queue->NextEntryToRead = 0;
+
+	uint32 InitialCount = 0;
+	Queue->SemaphoreHandle = CreateSemaphoreEx(0, InitialCount, ThreadCount, 0, 0, SEMAPHORE_ALL_ACCESS);
+	for(uint32 ThreadIndex = 0; ThreadIndex < ThreadCount; ThreadIndex++)
+	{
+		DWORD ThreadID;
+		HANDLE ThreadHandle = CreateThread(0, 0, Win32WorkerThreadProc, Queue, 0, &ThreadID);
+		CloseHandle(ThreadHandle);
+	}
+}
+
 inline LARGE_INTEGER Win32GetWallClock(void)
 {
 	LARGE_INTEGER Result;
@@ -926,6 +1388,35 @@ internal void Win32GetEXEFilename(win32_state *State)
 	}	
 }
 
+#if HANDMADE_PROFILE
+DWORD WINAPI Win32TraceWriterProc(LPVOID Parameter)
+{
+	win32_trace_writer *Writer = (win32_trace_writer *)Parameter;
+
+	Writer->Succeeded = false;
+	HANDLE FileHandle = CreateFileA(Writer->Filename, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, 0, 0);
+	if(FileHandle != INVALID_HANDLE_VALUE)
+	{
+		Writer->Succeeded = true;
+		char Buffer[65536];
+		uint32 Size;
+		while((Size = FormatTraceDump(&Writer->Dump, Buffer, sizeof(Buffer))) != 0)
+		{
+			DWORD BytesWritten;
+			if(!WriteFile(FileHandle, Buffer, Size, &BytesWritten, 0) || (BytesWritten != Size))
+			{
+				Writer->Succeeded = false;
+			}
+		}
+		CloseHandle(FileHandle);
+	}
+
+	CompletePreviousWritesBeforeFutureWrites;
+	Writer->Done = true;
+	return 0;
+}
+#endif
+
 int CALLBACK WinMain(
 	HINSTANCE Instance,
 	HINSTANCE PrevInstance,
@@ -952,6 +1443,18 @@ int CALLBACK WinMain(
 
 	Win32LoadXInput();
 
+	// NOTE: One worker per logical core, the main thread helps out in CompleteAllWork
+	SYSTEM_INFO SystemInfo;
+	GetSystemInfo(&SystemInfo);
+	uint32 WorkerThreadCount = (SystemInfo.dwNumberOfProcessors > 1) ? (SystemInfo.dwNumberOfProcessors - 1) : 1;
+
+	platform_work_queue HighPriorityQueue = {};
+	Win32MakeQueue(&HighPriorityQueue, WorkerThreadCount);
+
+	// NOTE: Background work (chunk prefetch) that nobody waits on
+	platform_work_queue LowPriorityQueue = {};
+	Win32MakeQueue(&LowPriorityQueue, 2);
+
 
 #if HANDMADE_INTERNAL
 	DEBUGGlobalShowCursor = true;
@@ -999,6 +1502,18 @@ int CALLBACK WinMain(
 			real32 GameUpdateHz = (MonitorRefreshHz/2.0f);
 			real32 TargetSecondsPerFrame = 1.0f / (GameUpdateHz);
 
+			// NOTE: The simulation ticks at its own fixed rate whatever the monitor runs at, -simhz
+			// sets it like it does on Linux and 0 goes back to one variable step per frame
+			real32 GameSimHz = 60.0f;
+			for(int ArgIndex = 1; ArgIndex < __argc; ArgIndex++)
+			{
+				if((strcmp(__argv[ArgIndex], "-simhz") == 0) && (ArgIndex + 1 < __argc))
+				{
+					GameSimHz = (real32)atof(__argv[++ArgIndex]);
+				}
+			}
+			real32 SimSecondsPerTick = (GameSimHz > 0.0f) ? (1.0f / GameSimHz) : 0.0f;
+
 			win32_sound_output SoundOutput = {};
 
 			SoundOutput.SamplesPerSecond = 48000;			
@@ -1030,9 +1545,29 @@ int CALLBACK WinMain(
 			GameMemory.DEBUGPlatformFreeFileMemory = DEBUGPlatformFreeFileMemory;
 			GameMemory.DEBUGPlatformReadEntireFile = DEBUGPlatformReadEntireFile;
 			GameMemory.DEBUGPlatformWriteEntireFile = DEBUGPlatformWriteEntireFile; 
+			GameMemory.PlatformOpenFile = Win32OpenFile;
+			GameMemory.PlatformReadDataFromFile = Win32ReadDataFromFile;
+			GameMemory.PlatformCloseFile = Win32CloseFile;
+			GameMemory.HighPriorityQueue = &HighPriorityQueue;
+			GameMemory.LowPriorityQueue = &LowPriorityQueue;
+			GameMemory.PlatformAddEntry = Win32AddEntry;
+			GameMemory.PlatformCompleteAllWork = Win32CompleteAllWork;
 
 			Win32State.TotalSize = GameMemory.TransientStorageSize + GameMemory.PermanentStorageSize;
-			Win32State.GameMemoryBlock = VirtualAlloc(BaseAddress, (size_t)Win32State.TotalSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			Win32State.GameMemoryBlock = VirtualAlloc(BaseAddress, (size_t)Win32State.TotalSize, 
+													  MEM_COMMIT | MEM_RESERVE | MEM_WRITE_WATCH, PAGE_READWRITE);
+
+			if(Win32State.GameMemoryBlock)
+			{
+				BeginDirtyPageTracking(&Win32State.DirtyPages, Win32State.GameMemoryBlock, Win32State.TotalSize);
+			}
+			Win32State.GameMemory = &GameMemory;
+			Win32State.RecordingKeyframes = (recording_keyframe *)VirtualAlloc(0, WIN32_RECORDING_KEYFRAME_CAPACITY*sizeof(recording_keyframe),
+																			   MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			win32_keyframe_writer *KeyframeWriter = &Win32State.KeyframeWriter;
+			KeyframeWriter->Scratch = (uint8 *)VirtualAlloc(0, RECORDING_MAX_SNAPSHOT_BLOCK_SIZE(RECORDING_SNAPSHOT_BLOCK_SIZE),
+															MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			KeyframeWriter->PendingFrames = (uint8 *)VirtualAlloc(0, WIN32_PENDING_FRAME_CAPACITY, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
 			GameMemory.PermanentStorage = Win32State.GameMemoryBlock;
 			GameMemory.TransientStorage = ((uint8 *)GameMemory.PermanentStorage + GameMemory.PermanentStorageSize);
 
@@ -1040,7 +1575,7 @@ int CALLBACK WinMain(
 			{
 				win32_replay_buffer *ReplayBuffer = &Win32State.ReplayBuffers[ReplayIndex];
 								
-				Win32GetInputFileLocation(&Win32State, ReplayIndex, false,
+				Win32GetInputFileLocation(&Win32State, false, ReplayIndex,
 											 sizeof(ReplayBuffer->Filename), ReplayBuffer->Filename);
 				LARGE_INTEGER MaxSize;
 				MaxSize.QuadPart = Win32State.TotalSize;				
@@ -1059,6 +1594,28 @@ int CALLBACK WinMain(
 				}				
 			}
 
+#if HANDMADE_PROFILE
+			// NOTE: Always collecting in profile builds, the report goes to the debugger every few seconds
+			debug_table *DebugTable = (debug_table *)VirtualAlloc(0, sizeof(debug_table), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			debug_profile *Profile = (debug_profile *)VirtualAlloc(0, sizeof(debug_profile), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			if(DebugTable && Profile)
+			{
+				InitializeProfile(Profile, DebugTable);
+				GlobalDebugTable = DebugTable;
+				GameMemory.DebugTable = DebugTable;
+				UpdateProfileClockRate(Profile, FramePacerGetClock());
+				MeasureTimedBlockOverhead(Profile);
+			}
+			else
+			{
+				Profile = 0;
+			}
+
+			// NOTE: T writes the last few hundred frames of timed blocks next to the exe
+			win32_trace_writer TraceWriter = {};
+			Win32BuildEXEPathFilename(&Win32State, "handmade_trace.json", sizeof(TraceWriter.Filename), TraceWriter.Filename);
+#endif
+
 			if (Samples && GameMemory.PermanentStorage && GameMemory.TransientStorage)
 			{
 				game_input Input[2] = {};
@@ -1076,6 +1633,15 @@ int CALLBACK WinMain(
 				bool32 SoundIsValid = false;				
 
 				int64 LastCycleCount = __rdtsc();
+				uint32 XInputPollFrame = 0;
+
+				frame_pacer FramePacer;
+				BeginFramePacer(&FramePacer, TargetSecondsPerFrame);
+				if(!SleepIsGranular)
+				{
+					// NOTE: Without 1ms scheduling Sleep is too coarse to trust, so spin the whole frame
+					FramePacer.SleepMargin = 0xFFFFFFFFFFFFFFFFull;
+				}
 				
 				char *SourceDLLName = "handmade.dll";
 				win32_game_code Game = Win32LoadGameCode(GameCodeDLLPath, TempGameCodeDLLPath);
@@ -1083,10 +1649,20 @@ int CALLBACK WinMain(
 				while (GlobalRunning)
 				{
 					NewInput->dtForFrame = TargetSecondsPerFrame;
+					NewInput->SimSecondsPerTick = SimSecondsPerTick;
 
 					FILETIME NewDLLWriteTime = Win32GetLastWriteTime(SourceDLLName);
 					if(CompareFileTime(&NewDLLWriteTime, &Game.DLLLastWriteTime) != 0)
 					{
+						// NOTE: Queued work may still be running code from the old DLL
+						Win32CompleteAllWork(&HighPriorityQueue);
+						Win32CompleteAllWork(&LowPriorityQueue);
+#if HANDMADE_PROFILE
+						if(Profile)
+						{
+							CollateDebugEventsBeforeUnload(Profile);
+						}
+#endif
 						Win32UnloadGameCode(&Game);
 						Game = Win32LoadGameCode(GameCodeDLLPath, TempGameCodeDLLPath);						
 						if(!Game.IsValid)
@@ -1106,11 +1682,14 @@ int CALLBACK WinMain(
 						NewKeyboardController->Buttons[ButtonIndex].EndedDown =
 							OldKeyboardController->Buttons[ButtonIndex].EndedDown;
 					}
-					Win32ProcessPendingMessages(&Win32State, NewKeyboardController);
+					NewInput->EventCount = 0;
+					NewInput->EventsDropped = false;
+					Win32ProcessPendingMessages(&Win32State, NewInput);
 
 					// IMPORTANT: This executes a global pause, restarts the while loop
 					if(GlobalPause) continue;	
 
+					BEGIN_BLOCK("Input");
 
 					POINT MouseP;
 					GetCursorPos(&MouseP);
@@ -1125,7 +1704,10 @@ int CALLBACK WinMain(
 					Win32ProcessKeyboardMessage(&NewInput->MouseButtons[3], GetKeyState(VK_XBUTTON1) & (1 << 15));
 					Win32ProcessKeyboardMessage(&NewInput->MouseButtons[4], GetKeyState(VK_XBUTTON2) & (1 << 15));					
 
-					// TODO should we poll this more frequently? Need to not poll disconnected controllers
+					// NOTE: XInputGetState on an empty slot is slow, so slots that were empty last frame are
+					// only tried again every XINPUT_RECONNECT_POLL_FRAMES frames for a newly plugged pad
+					// TODO should we poll this more frequently?
+					++XInputPollFrame;
 					DWORD MaxControllerCount = XUSER_MAX_COUNT;
 					if (MaxControllerCount > (ArrayCount(NewInput->Controllers) - 1))
 					{
@@ -1138,7 +1720,8 @@ int CALLBACK WinMain(
 						game_controller_input *OldController = GetController(OldInput, OurControllerIndex);
 						game_controller_input *NewController = GetController(NewInput, OurControllerIndex);
 
-						if (XInputGetState(ControllerIndex, &ControllerState) == ERROR_SUCCESS)
+						bool32 ShouldPoll = (OldController->IsConnected || ((XInputPollFrame % XINPUT_RECONNECT_POLL_FRAMES) == 0));
+						if (ShouldPoll && (XInputGetState(ControllerIndex, &ControllerState) == ERROR_SUCCESS))
 						{	
 							NewController->IsConnected = true;	
 							NewController->IsAnalog = OldController->IsAnalog;
@@ -1207,6 +1790,16 @@ int CALLBACK WinMain(
 
 							// bool Start = (Pad->wButtons & XINPUT_GAMEPAD_START);
 							// bool Back = (Pad->wButtons & XINPUT_GAMEPAD_BACK);
+
+							// NOTE: Polled once a frame, so all a pad can say is that it changed by now
+							for(uint32 ButtonIndex = 0; ButtonIndex < ArrayCount(NewController->Buttons); ++ButtonIndex)
+							{
+								game_button_state *Button = NewController->Buttons + ButtonIndex;
+								if(Button->HalfTransitionCount)
+								{
+									PushInputEvent(NewInput, OurControllerIndex, ButtonIndex, Button->EndedDown, NewInput->dtForFrame);
+								}
+							}
 						}
 						else
 						{
@@ -1226,19 +1819,36 @@ int CALLBACK WinMain(
 
 					if(Win32State.InputRecordingIndex)
 					{
-						Win32RecordInput(&Win32State, NewInput);
+						Win32RecordInput(&Win32State, &GameMemory, NewInput);
 					}
 
 					if(Win32State.InputPlaybackIndex)
 					{
+						if(Win32State.PlaybackSeekKeyframes)
+						{
+							Win32SeekInputPlayback(&Win32State, &GameMemory, &Game, &Thread, &Buffer, 
+												   Win32State.PlaybackSeekKeyframes);
+							Win32State.PlaybackSeekKeyframes = 0;
+						}
 						Win32PlayBackInput(&Win32State, NewInput);
 					}
+					END_BLOCK();
 
 					if(Game.UpdateAndRender)
 					{
 						Game.UpdateAndRender(&Thread, &GameMemory, NewInput, &Buffer);
+
+#if HANDMADE_INTERNAL
+						if((GameMemory.Telemetry.FrameIndex % 300) == 0)
+						{
+							char MemoryReport[1024];
+							FormatMemoryTelemetry(&GameMemory.Telemetry, MemoryReport, sizeof(MemoryReport));
+							OutputDebugStringA(MemoryReport);
+						}
+#endif
 					}					
 
+					BEGIN_BLOCK("Sound");
 					LARGE_INTEGER AudioWallClock = Win32GetWallClock();
 					real32 FromBeginToAudioSeconds = Win32GetSecondsElapsed(AudioWallClock, Win32GetWallClock());
 
@@ -1350,47 +1960,27 @@ int CALLBACK WinMain(
 					{
 						SoundIsValid = false;
 					}					
+					END_BLOCK();
 
-					LARGE_INTEGER WorkCounter = Win32GetWallClock();
-					real32 WorkSecondsElapsed = Win32GetSecondsElapsed(LastCounter, WorkCounter);				
-
-					real32 SecondsElapsedForFrame = WorkSecondsElapsed;	
-
-					if(SecondsElapsedForFrame < TargetSecondsPerFrame)
-					{
-						if(SleepIsGranular)
-						{
-							DWORD SleepMS = (DWORD)(1000.0f * (TargetSecondsPerFrame - SecondsElapsedForFrame));
-							if(SleepMS > 0) {Sleep(SleepMS);}							
-						}
-						real32 TestSecondsElapsedForFrame = Win32GetSecondsElapsed(LastCounter, Win32GetWallClock());
-
-						if(TestSecondsElapsedForFrame < TargetSecondsPerFrame)
-						{
-							// TODO Log missed sleep here
-						}
-
-						while(SecondsElapsedForFrame < TargetSecondsPerFrame)
-						{										
-							// We meltin CPU B)									
-							SecondsElapsedForFrame = Win32GetSecondsElapsed(LastCounter, Win32GetWallClock());					
-						}
-					}
-					else
+					BEGIN_BLOCK("Frame wait");
+					if(FramePacerWait(&FramePacer))
 					{
 						// TODO MISSED FRAME RATE!!!
 						// Logging
 					}
+					END_BLOCK();
 
 					LARGE_INTEGER EndCounter = Win32GetWallClock();
 					real32 MSPerFrame = 1000.0f*Win32GetSecondsElapsed(LastCounter, EndCounter);					
 					LastCounter = EndCounter;										
 
+					BEGIN_BLOCK("Display");
 					Dimension = Win32GetWindowDimension(Window);
 					HDC DeviceContext = GetDC(Window);
 					win32DisplayBufferInWindow(&GlobalBackbuffer, DeviceContext, 
 												Dimension.Width, Dimension.Height);	
 					ReleaseDC(Window, DeviceContext);		
+					END_BLOCK();
 
 					FlipWallClock = Win32GetWallClock();
 
@@ -1432,7 +2022,59 @@ int CALLBACK WinMain(
 					sprintf_s(FPSBuffer, "ms/f: %f, FPS: %f, MC/f: %f\n", MSPerFrame, FPS, MCPF);
 					OutputDebugStringA(FPSBuffer);	
 #endif					
+
+#if HANDMADE_PROFILE
+					if(Profile)
+					{
+						CollateDebugFrame(Profile);
+						UpdateProfileClockRate(Profile, FramePacerGetClock());
+						if(Profile->FrameCount >= 300)
+						{
+							local_persist char ProfileReport[65536];
+							FormatProfileReport(Profile, ProfileReport, sizeof(ProfileReport));
+							OutputDebugStringA(ProfileReport);
+							ResetProfile(Profile);
+						}
+
+						if(TraceWriter.Thread && TraceWriter.Done)
+						{
+							CloseHandle(TraceWriter.Thread);
+							TraceWriter.Thread = 0;
+
+							char TraceBuffer[512];
+							wsprintf(TraceBuffer, "%s %u timed blocks to %s, %u overwritten before they were written\n",
+									 TraceWriter.Succeeded ? "Wrote" : "Failed writing", TraceWriter.Dump.BlockCount,
+									 TraceWriter.Filename, TraceWriter.Dump.LostCount);
+							OutputDebugStringA(TraceBuffer);
+						}
+						if(Win32State.TraceRequested && !TraceWriter.Thread)
+						{
+							Win32State.TraceRequested = false;
+							BeginTraceDump(&TraceWriter.Dump, Profile);
+							TraceWriter.Done = false;
+							TraceWriter.Thread = CreateThread(0, 0, Win32TraceWriterProc, &TraceWriter, 0, 0);
+						}
+					}
+#endif
 				}
+
+#if HANDMADE_INTERNAL
+				char PacingBuffer[256];
+				wsprintf(PacingBuffer, "Frame pacing over %u frames: lateness p50 %uus p90 %uus p99 %uus max %uus, %u overslept\n",
+						 FramePacer.FrameCount, FramePacerPercentile(&FramePacer.Lateness, 0.5f), 
+						 FramePacerPercentile(&FramePacer.Lateness, 0.9f), FramePacerPercentile(&FramePacer.Lateness, 0.99f),
+						 (uint32)(FramePacer.Lateness.Max / 1000), FramePacer.OversleptCount);
+				OutputDebugStringA(PacingBuffer);
+				wsprintf(PacingBuffer, "  %u missed: overrun p50 %uus p90 %uus max %uus\n",
+						 FramePacer.MissedCount, FramePacerPercentile(&FramePacer.MissedLateness, 0.5f),
+						 FramePacerPercentile(&FramePacer.MissedLateness, 0.9f), (uint32)(FramePacer.MissedLateness.Max / 1000));
+				OutputDebugStringA(PacingBuffer);
+				wsprintf(PacingBuffer, "  frame time (target %uus): p50 %uus p90 %uus p99 %uus max %uus\n",
+						 (uint32)(FramePacer.TargetNanoseconds / 1000), FramePacerPercentile(&FramePacer.FrameTime, 0.5f),
+						 FramePacerPercentile(&FramePacer.FrameTime, 0.9f), FramePacerPercentile(&FramePacer.FrameTime, 0.99f),
+						 (uint32)(FramePacer.FrameTime.Max / 1000));
+				OutputDebugStringA(PacingBuffer);
+#endif
 			}
 			else
 			{
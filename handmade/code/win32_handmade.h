@@ -61,6 +61,14 @@ struct win32_recorded_input
 };
 
 #define WIN32_STATE_FILE_NAME_COUNT MAX_PATH
+#define WIN32_RECORDING_KEYFRAME_CAPACITY 4096
+
+// NOTE: Which bit of dirty_page_tracker.Views each consumer of game memory's dirty pages reads
+#define WIN32_DIRTY_VIEW_REPLAY 0
+#define WIN32_DIRTY_VIEW_KEYFRAME 1
+
+// NOTE: A keyframe interval's worth of frames at their largest, more than a snapshot ever takes
+#define WIN32_PENDING_FRAME_CAPACITY (RECORDING_KEYFRAME_INTERVAL*RECORDING_MAX_FRAME_SIZE)
 
 struct win32_replay_buffer
 {
@@ -70,17 +78,85 @@ struct win32_replay_buffer
 	void *MemoryBlock;
 };
 
+struct platform_work_queue_entry
+{
+	platform_work_queue_callback *Callback;
+	void *Data;
+};
+
+struct platform_work_queue
+{
+	uint32 volatile CompletionGoal;
+	uint32 volatile CompletionCount;
+
+	uint32 volatile NextEntryToWrite;
+	uint32 volatile NextEntryToRead;
+	HANDLE SemaphoreHandle;
+
+	platform_work_queue_entry Entries[256];
+};
+
+/*
+	NOTE: Compresses a keyframe's snapshot into the recording on a thread of its own. Shadow is a
+	copy of game memory that each keyframe only copies the pages written since the last one into,
+	and the thread compresses from that while the game goes on. Frames recorded meanwhile wait in
+	PendingFrames, they belong in the file after the snapshot. Thread is only non-null while a
+	snapshot is being written, Shadow only while recording.
+*/
+struct win32_keyframe_writer
+{
+	HANDLE File;
+	uint8 *Shadow;
+	uint64 Size;
+	uint8 *Scratch;
+	uint64 SnapshotSize;
+
+	uint32 PendingFrameSize;
+	uint8 *PendingFrames;
+
+	HANDLE Thread;
+	bool32 volatile Done;
+};
+
+#if HANDMADE_PROFILE
+// NOTE: Thread is only non-null while a dump is being written
+struct win32_trace_writer
+{
+	char Filename[WIN32_STATE_FILE_NAME_COUNT];
+	trace_dump Dump;
+	bool32 Succeeded;
+
+	HANDLE Thread;
+	bool32 volatile Done;
+};
+#endif
+
 struct win32_state
 {	
 	uint64 TotalSize;
 	void *GameMemoryBlock;
 	win32_replay_buffer ReplayBuffers[4];
 
+	// NOTE: The replay buffer whose contents matched game memory when its dirty page view was
+	// last cleared. Syncing with it again only has to copy the pages written since.
+	win32_replay_buffer *SyncedReplayBuffer;
+	dirty_page_tracker DirtyPages;
+	// NOTE: For draining the work queues before game memory is copied anywhere
+	game_memory *GameMemory;
+
 	HANDLE RecordingHandle;
 	int InputRecordingIndex;
+	recording_writer Recorder;
+	recording_keyframe *RecordingKeyframes;
+	win32_keyframe_writer KeyframeWriter;
 
-	HANDLE PlaybackHandle;
+	void *PlaybackFile;
 	int InputPlaybackIndex;
+	recording_reader Player;
+	int PlaybackSeekKeyframes;
+
+	// NOTE: Set by the T key, the main loop starts a trace dump once the frame is collated
+	bool32 TraceRequested;
 
 	char EXEFilename[MAX_PATH];
 	char *OnePastLastEXEFilenameSlash;
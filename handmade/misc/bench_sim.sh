@@ -0,0 +1,23 @@
+#!/bin/sh
+
+# NOTE: Replays one recording with the simulation ticking at 30, 60 and 120Hz while frames stay at
+# the recording's own rate, plus once stepped per frame for reference. Run build.sh first.
+# usage: bench_sim.sh <recording.hmi> [runs]
+
+Recording="$1"
+Runs="${2:-3}"
+if [ -z "$Recording" ]; then
+	echo "usage: $0 <recording.hmi> [runs]" >&2
+	exit 2
+fi
+
+Build="$(cd "$(dirname "$0")/../../build" && pwd)"
+Data="$(cd "$(dirname "$0")/../data" && pwd)"
+Recording="$(cd "$(dirname "$Recording")" && pwd)/$(basename "$Recording")"
+
+# NOTE: The game loads its bitmaps relative to the data directory
+cd "$Data"
+for SimHz in 0 30 60 120; do
+	echo "simhz $SimHz" >&2
+	"$Build/replay_handmade" "$Recording" -runs "$Runs" -simhz "$SimHz" -quiet || exit 1
+done
@@ -0,0 +1,17 @@
+#!/bin/sh
+
+# NOTE: Only the headless host and tools build outside Windows. Optimized, since the replay runner is a benchmark.
+CommonCompilerFlags="-O2 -g -fno-exceptions -fno-rtti -Wall -Wno-unused-function -Wno-unused-variable -Wno-unused-but-set-variable -Wno-write-strings -Wno-sign-compare -DHANDMADE_SLOW=1 -DHANDMADE_INTERNAL=1 -DHANDMADE_PROFILE=1"
+
+Code="$(cd "$(dirname "$0")/../code" && pwd)"
+mkdir -p "$Code/../../build"
+cd "$Code/../../build"
+
+c++ $CommonCompilerFlags "$Code/replay_handmade.cpp" -o replay_handmade
+c++ $CommonCompilerFlags "$Code/audiobench_handmade.cpp" -o audiobench_handmade
+c++ $CommonCompilerFlags "$Code/bench_handmade.cpp" -o bench_handmade -lpthread
+c++ $CommonCompilerFlags "$Code/randombench_handmade.cpp" -o randombench_handmade
+
+# NOTE: Link to a temporary name and rename, so the host's watcher sees one finished library appear
+c++ $CommonCompilerFlags -shared -fPIC "$Code/handmade.cpp" -o handmade.so.link && mv handmade.so.link handmade.so
+c++ $CommonCompilerFlags "$Code/linux_handmade.cpp" -o linux_handmade -ldl -lpthread